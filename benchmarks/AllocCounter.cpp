@@ -0,0 +1,52 @@
+#include "AllocCounter.hpp"
+
+#include <atomic>
+#include <cstdlib>
+#include <malloc.h>
+#include <new>
+
+namespace bench {
+
+    static std::atomic<std::uint64_t> g_allocations{0};
+    static std::atomic<std::uint64_t> g_bytes{0};
+    static std::atomic<std::uint64_t> g_liveBytes{0};
+    static std::atomic<std::uint64_t> g_peakBytes{0};
+
+    AllocSnapshot allocSnapshot() {
+        return {g_allocations.load(std::memory_order_relaxed), g_bytes.load(std::memory_order_relaxed),
+                g_liveBytes.load(std::memory_order_relaxed), g_peakBytes.load(std::memory_order_relaxed)};
+    }
+
+    void resetPeak() {
+        g_peakBytes.store(g_liveBytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+    static void* countedAlloc(std::size_t size) {
+        void* pointer = std::malloc(size == 0 ? 1 : size);
+        if (pointer == nullptr) throw std::bad_alloc();
+
+        // O tamanho real do bloco é usado nos dois sentidos, pois operator
+        // delete nem sempre recebe o tamanho pedido.
+        std::uint64_t usable = malloc_usable_size(pointer);
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_bytes.fetch_add(size, std::memory_order_relaxed);
+        std::uint64_t live = g_liveBytes.fetch_add(usable, std::memory_order_relaxed) + usable;
+        std::uint64_t peak = g_peakBytes.load(std::memory_order_relaxed);
+        while (live > peak && !g_peakBytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {}
+        return pointer;
+    }
+
+    static void countedFree(void* pointer) {
+        if (pointer == nullptr) return;
+        g_liveBytes.fetch_sub(malloc_usable_size(pointer), std::memory_order_relaxed);
+        std::free(pointer);
+    }
+
+}
+
+void* operator new(std::size_t size) { return bench::countedAlloc(size); }
+void* operator new[](std::size_t size) { return bench::countedAlloc(size); }
+void operator delete(void* pointer) noexcept { bench::countedFree(pointer); }
+void operator delete[](void* pointer) noexcept { bench::countedFree(pointer); }
+void operator delete(void* pointer, std::size_t) noexcept { bench::countedFree(pointer); }
+void operator delete[](void* pointer, std::size_t) noexcept { bench::countedFree(pointer); }
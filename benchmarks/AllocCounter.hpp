@@ -0,0 +1,22 @@
+#pragma once
+
+#include <cstdint>
+
+namespace bench {
+
+    // Contadores globais de alocação, alimentados pela substituição de
+    // operator new/delete em AllocCounter.cpp.
+    struct AllocSnapshot {
+        std::uint64_t allocations;
+        std::uint64_t bytes;
+        // Bytes vivos no momento e o pico desde o último resetPeak().
+        std::uint64_t liveBytes;
+        std::uint64_t peakBytes;
+    };
+
+    AllocSnapshot allocSnapshot();
+
+    // Reinicia o pico para o valor atual de bytes vivos.
+    void resetPeak();
+
+}
@@ -0,0 +1,98 @@
+#include "BenchUtil.hpp"
+#include "ArrayKernels.hpp"
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+// Kernels dos arrays numéricos sobre um milhão de elementos, comparados
+// com o laço escalar equivalente, e o caminho completo a partir de Lox.
+
+static std::vector<double> randomNumbers(std::size_t count) {
+    std::mt19937_64 random(42);
+    std::uniform_real_distribution<double> distribution(-1000.0, 1000.0);
+    std::vector<double> data(count);
+    for (double& value : data) value = distribution(random);
+    return data;
+}
+
+static void BM_SumScalar(benchmark::State& state) {
+    std::vector<double> data = randomNumbers(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        double total = 0.0;
+        for (double value : data) total += value;
+        benchmark::DoNotOptimize(total);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_SumScalar)->Arg(1 << 20);
+
+static void BM_SumKernel(benchmark::State& state) {
+    std::vector<double> data = randomNumbers(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lox::sumNumbers(data.data(), data.size()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_SumKernel)->Arg(1 << 20);
+
+static void BM_MinScalar(benchmark::State& state) {
+    std::vector<double> data = randomNumbers(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(*std::min_element(data.begin(), data.end()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_MinScalar)->Arg(1 << 20);
+
+static void BM_MinKernel(benchmark::State& state) {
+    std::vector<double> data = randomNumbers(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(lox::minNumbers(data.data(), data.size()));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * data.size()));
+}
+BENCHMARK(BM_MinKernel)->Arg(1 << 20);
+
+static void BM_SortKernel(benchmark::State& state) {
+    std::vector<double> original = randomNumbers(static_cast<std::size_t>(state.range(0)));
+    std::vector<double> data;
+    for (auto _ : state) {
+        state.PauseTiming();
+        data = original;
+        state.ResumeTiming();
+        lox::sortNumbers(data.data(), data.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * original.size()));
+}
+BENCHMARK(BM_SortKernel)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+static void BM_SearchKernel(benchmark::State& state) {
+    std::vector<double> data = randomNumbers(static_cast<std::size_t>(state.range(0)));
+    std::sort(data.begin(), data.end());
+    std::size_t next = 0;
+    for (auto _ : state) {
+        double needle = data[next];
+        next = (next + 7919) % data.size();
+        benchmark::DoNotOptimize(lox::searchNumbers(data.data(), data.size(), needle));
+    }
+}
+BENCHMARK(BM_SearchKernel)->Arg(1 << 20);
+
+// Programa Lox que cria um array de um milhão de números e o processa com
+// as funções nativas.
+static void BM_LoxArrayBuiltins(benchmark::State& state) {
+    std::string source =
+        "var a = array(" + std::to_string(state.range(0)) + ", 1.5);"
+        "a[17] = -3;"
+        "var total = sum(a) + min(a) + max(a);"
+        "sort(a);"
+        "var found = bsearch(a, -3);";
+    bench::SilenceStream silenceOut(std::cout);
+    for (auto _ : state) {
+        bench::runLox(source);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+}
+BENCHMARK(BM_LoxArrayBuiltins)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
@@ -0,0 +1,142 @@
+#include "BenchUtil.hpp"
+#include "SourceGenerator.hpp"
+#include "ast/ASTPrinter.hpp"
+#include "ast/ASTSerializer.hpp"
+
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Saída da AST sobre programas sintéticos de vários MiB: --print-ast,
+// --dump-ast=json e --dump-ast=binary, e a leitura do binário comparada com
+// passar o mesmo programa pelo Scanner e Parser (BM_ParseForDump). Os
+// argumentos são (formato, tamanho em KiB); a vazão é sobre o código-fonte,
+// e output_bytes é o tamanho da saída.
+
+using bench::SourceShape;
+
+// Descarta a saída, contando os bytes.
+class CountingBuffer : public std::streambuf {
+public:
+    std::size_t bytes = 0;
+
+protected:
+    int overflow(int c) override {
+        ++bytes;
+        return c;
+    }
+    std::streamsize xsputn(const char*, std::streamsize n) override {
+        bytes += static_cast<std::size_t>(n);
+        return n;
+    }
+};
+
+struct DumpInput {
+    std::string source;
+    std::vector<std::unique_ptr<lox::Stmt>> statements;
+};
+
+static const DumpInput& dumpInput(SourceShape shape, std::size_t kib) {
+    static std::map<std::pair<int, std::size_t>, DumpInput> cache;
+    auto key = std::make_pair(static_cast<int>(shape), kib);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        DumpInput input;
+        input.source = bench::generateSource(shape, kib * 1024);
+        Scanner scanner(input.source);
+        TokenStream tokens = scanner.scanTokens();
+        lox::Parser parser(tokens);
+        input.statements = parser.parse();
+        it = cache.emplace(key, std::move(input)).first;
+    }
+    return it->second;
+}
+
+template<typename Write>
+static void runDump(benchmark::State& state, Write write) {
+    auto shape = static_cast<SourceShape>(state.range(0));
+    const DumpInput& input = dumpInput(shape, static_cast<std::size_t>(state.range(1)));
+    std::size_t outputBytes = 0;
+    for (auto _ : state) {
+        CountingBuffer buffer;
+        std::ostream out(&buffer);
+        write(out, input.statements);
+        outputBytes = buffer.bytes;
+    }
+    state.counters["output_bytes"] = static_cast<double>(outputBytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.source.size()));
+    state.SetLabel(bench::shapeName(shape));
+}
+
+static void BM_PrintAst(benchmark::State& state) {
+    runDump(state, [](std::ostream& out, const std::vector<std::unique_ptr<lox::Stmt>>& statements) {
+        lox::ASTPrinter printer;
+        for (const auto& stmt : statements) {
+            printer.print(*stmt, out);
+            out << '\n';
+        }
+    });
+}
+
+static void BM_DumpAstJson(benchmark::State& state) {
+    runDump(state, lox::writeAstJson);
+}
+
+static void BM_DumpAstBinary(benchmark::State& state) {
+    runDump(state, lox::writeAstBinary);
+}
+
+static void BM_LoadAstBinary(benchmark::State& state) {
+    auto shape = static_cast<SourceShape>(state.range(0));
+    const DumpInput& input = dumpInput(shape, static_cast<std::size_t>(state.range(1)));
+    std::ostringstream binary;
+    lox::writeAstBinary(binary, input.statements);
+    const std::string data = binary.str();
+
+    for (auto _ : state) {
+        std::istringstream in(data);
+        auto statements = lox::readAstBinary(in);
+        benchmark::DoNotOptimize(statements.data());
+
+        state.PauseTiming();
+        statements.clear();
+        state.ResumeTiming();
+    }
+    state.counters["binary_bytes"] = static_cast<double>(data.size());
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.source.size()));
+    state.SetLabel(bench::shapeName(shape));
+}
+
+static void BM_ParseForDump(benchmark::State& state) {
+    auto shape = static_cast<SourceShape>(state.range(0));
+    const DumpInput& input = dumpInput(shape, static_cast<std::size_t>(state.range(1)));
+    for (auto _ : state) {
+        Scanner scanner(input.source);
+        TokenStream tokens = scanner.scanTokens();
+        lox::Parser parser(tokens);
+        auto statements = parser.parse();
+        benchmark::DoNotOptimize(statements.data());
+
+        state.PauseTiming();
+        statements.clear();
+        state.ResumeTiming();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * input.source.size()));
+    state.SetLabel(bench::shapeName(shape));
+}
+
+static void DumpArgs(benchmark::internal::Benchmark* benchmark) {
+    for (SourceShape shape : {SourceShape::FlatStatements, SourceShape::NestedBlocks, SourceShape::LongExpressions}) {
+        benchmark->Args({static_cast<int>(shape), 4096});
+    }
+    benchmark->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_PrintAst)->Apply(DumpArgs);
+BENCHMARK(BM_DumpAstJson)->Apply(DumpArgs);
+BENCHMARK(BM_DumpAstBinary)->Apply(DumpArgs);
+BENCHMARK(BM_LoadAstBinary)->Apply(DumpArgs);
+BENCHMARK(BM_ParseForDump)->Apply(DumpArgs);
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "AllocCounter.hpp"
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+
+#include <benchmark/benchmark.h>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace bench {
+
+    // Descarta tudo o que for escrito no stream enquanto o objeto existir.
+    class SilenceStream {
+    public:
+        explicit SilenceStream(std::ostream& stream) : m_stream(stream), m_old(stream.rdbuf(&m_null)) {}
+        ~SilenceStream() { m_stream.rdbuf(m_old); }
+
+    private:
+        struct NullBuffer : std::streambuf {
+            int overflow(int c) override { return c; }
+            std::streamsize xsputn(const char*, std::streamsize n) override { return n; }
+        };
+
+        NullBuffer m_null;
+        std::ostream& m_stream;
+        std::streambuf* m_old;
+    };
+
+    // Executa o pipeline completo Scanner -> Parser -> Interpreter.
+    inline void runLox(const std::string& source, bool specialize = true, lox::JitOptions jit = {},
+                       lox::ExecutionLimits limits = {}) {
+        Scanner scanner(source);
+        TokenStream tokens = scanner.scanTokens();
+        lox::Parser parser(tokens);
+        auto statements = parser.parse();
+        lox::Interpreter interpreter;
+        interpreter.setSpecialization(specialize);
+        interpreter.setJit(jit);
+        interpreter.setLimits(limits);
+        interpreter.interpret(statements);
+    }
+
+    inline std::string readExample(const std::string& name) {
+        std::ifstream file(std::string(LOX_EXAMPLES_DIR) + "/" + name);
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+
+    // Publica alocações e bytes alocados por iteração desde 'before'.
+    inline void reportAllocations(benchmark::State& state, const AllocSnapshot& before) {
+        AllocSnapshot after = allocSnapshot();
+        state.counters["allocs/op"] = benchmark::Counter(
+            static_cast<double>(after.allocations - before.allocations), benchmark::Counter::kAvgIterations);
+        state.counters["bytes/op"] = benchmark::Counter(
+            static_cast<double>(after.bytes - before.bytes), benchmark::Counter::kAvgIterations);
+    }
+
+}
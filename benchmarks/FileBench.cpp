@@ -0,0 +1,132 @@
+#include "BenchUtil.hpp"
+#include "File.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <string>
+#include <unistd.h>
+
+// Contagem de linhas e bytes de um arquivo de log gerado com o tamanho do
+// argumento, em MiB (o de 2048 é gerado só se o benchmark for selecionado e
+// ocupa 2 GiB em /tmp até o fim do processo). Logo depois de gerado o
+// arquivo está no page cache, então o teto é a velocidade da memória, não a
+// do disco; para medir o disco, descarte o cache antes (echo 3 >
+// /proc/sys/vm/drop_caches) e rode com --benchmark_repetitions=1.
+//   BM_ScanMapped   - LoxFile::nextLine em C++: memchr sobre o mmap;
+//   BM_ScanGetline  - std::getline de um ifstream, que copia cada linha;
+//   BM_LoxNextLine  - script Lox com nextLine (sem cópia);
+//   BM_LoxReadLine  - script Lox com readLine (uma String por linha).
+
+class LogFiles {
+public:
+    ~LogFiles() {
+        for (const auto& entry : m_paths) std::remove(entry.second.c_str());
+    }
+
+    const std::string& get(std::int64_t mebibytes) {
+        auto found = m_paths.find(mebibytes);
+        if (found != m_paths.end()) return found->second;
+        std::string path = "/tmp/lox-file-bench-" + std::to_string(getpid()) + "-" + std::to_string(mebibytes) + ".log";
+        write(path, static_cast<std::size_t>(mebibytes) << 20);
+        return m_paths.emplace(mebibytes, path).first->second;
+    }
+
+private:
+    static void write(const std::string& path, std::size_t size) {
+        static const char* const levels[] = {"INFO", "WARN", "DEBUG", "ERROR"};
+        std::string block;
+        for (int i = 0; block.size() < (1u << 20); ++i) {
+            block += "2024-05-01T12:" + std::to_string(10 + i % 50) + ":00Z " + levels[i % 4] + " request id=" +
+                     std::to_string(i * 7919) + " path=/api/v1/items/" + std::to_string(i % 1000) + "\n";
+        }
+        std::ofstream out(path, std::ios::binary);
+        for (std::size_t written = 0; written < size; written += block.size()) out << block;
+    }
+
+    std::map<std::int64_t, std::string> m_paths;
+};
+
+static const std::string& logFile(std::int64_t mebibytes) {
+    static LogFiles files;
+    return files.get(mebibytes);
+}
+
+static std::size_t fileSize(const std::string& path) {
+    return lox::LoxFile(lox::String(path.c_str())).contents().size();
+}
+
+static void reportScan(benchmark::State& state, std::size_t bytes, std::size_t lines) {
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * bytes));
+    state.counters["lines"] = static_cast<double>(lines);
+}
+
+static void BM_ScanMapped(benchmark::State& state) {
+    const std::string& path = logFile(state.range(0));
+    std::size_t bytes = 0;
+    std::size_t lines = 0;
+    for (auto _ : state) {
+        lox::LoxFile file(lox::String(path.c_str()));
+        bytes = 0;
+        lines = 0;
+        std::string_view line;
+        while (file.nextLine(line)) {
+            bytes += line.size() + 1;
+            ++lines;
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+    reportScan(state, bytes, lines);
+}
+BENCHMARK(BM_ScanMapped)->Arg(64)->Arg(2048)->Unit(benchmark::kMillisecond);
+
+static void BM_ScanGetline(benchmark::State& state) {
+    const std::string& path = logFile(state.range(0));
+    std::size_t bytes = 0;
+    std::size_t lines = 0;
+    for (auto _ : state) {
+        std::ifstream in(path, std::ios::binary);
+        bytes = 0;
+        lines = 0;
+        std::string line;
+        while (std::getline(in, line)) {
+            bytes += line.size() + 1;
+            ++lines;
+        }
+        benchmark::DoNotOptimize(bytes);
+    }
+    reportScan(state, bytes, lines);
+}
+BENCHMARK(BM_ScanGetline)->Arg(64)->Arg(2048)->Unit(benchmark::kMillisecond);
+
+// length é o tamanho da linha em bytes, a partir do valor de next(f).
+static std::string countingScript(const std::string& path, const std::string& next, const std::string& length) {
+    return "var f = open(\"" + path + "\"); var lines = 0; var bytes = 0;\n"
+           "var line = " + next + "(f);\n"
+           "while (line != nil) { lines = lines + 1; bytes = bytes + " + length + " + 1; line = " + next + "(f); }\n"
+           "print lines; print bytes;\n";
+}
+
+static void runCountingScript(benchmark::State& state, const std::string& source) {
+    bench::SilenceStream silenceOut(std::cout);
+    bench::AllocSnapshot before = bench::allocSnapshot();
+    for (auto _ : state) {
+        bench::runLox(source);
+    }
+    bench::reportAllocations(state, before);
+}
+
+static void BM_LoxNextLine(benchmark::State& state) {
+    const std::string& path = logFile(state.range(0));
+    runCountingScript(state, countingScript(path, "nextLine", "line"));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * fileSize(path)));
+}
+BENCHMARK(BM_LoxNextLine)->Arg(64)->Unit(benchmark::kMillisecond);
+
+static void BM_LoxReadLine(benchmark::State& state) {
+    const std::string& path = logFile(state.range(0));
+    runCountingScript(state, countingScript(path, "readLine", "len(line)"));
+    state.SetBytesProcessed(static_cast<std::int64_t>(state.iterations() * fileSize(path)));
+}
+BENCHMARK(BM_LoxReadLine)->Arg(64)->Unit(benchmark::kMillisecond);
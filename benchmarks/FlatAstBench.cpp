@@ -0,0 +1,96 @@
+#include "BenchUtil.hpp"
+#include "ast/FlatAst.hpp"
+
+#include <cstdint>
+#include <string>
+
+// Execução pela árvore de ponteiros (visitor) e pela FlatAst (switch na
+// tag), sobre a mesma AST já analisada e sem os laços especializados, que
+// só existem para a árvore. Argumento:
+//   0 - laço aritmético pequeno: o custo é o despacho por nó;
+//   1 - laço cujo corpo tem 4000 statements (a AST não cabe no cache L2):
+//       o custo passa a ser o acesso aos nós;
+//   2 - exemplos/04_fibonacci.lox.
+// tree_bytes/flat_bytes são a memória das duas formas da AST (node_bytes,
+// só o vetor de nós, que é o que o switch percorre) e tree_allocs as
+// alocações da árvore.
+
+static std::string flatWorkload(std::int64_t kind) {
+    if (kind == 0) {
+        return "var i = 0; var acc = 0;"
+               "while (i < 100000) { acc = acc + i * 2 - acc / 3; i = i + 1; }";
+    }
+    if (kind == 1) {
+        std::string source;
+        for (int v = 0; v < 16; ++v) source += "var v" + std::to_string(v) + " = " + std::to_string(v) + ";\n";
+        source += "var i = 0;\nwhile (i < 20) {\n";
+        for (int s = 0; s < 4000; ++s) {
+            std::string a = "v" + std::to_string(s % 16);
+            std::string b = "v" + std::to_string((s * 7 + 3) % 16);
+            source += "  " + a + " = " + a + " + " + b + " * 2 - (" + a + " / 3);\n";
+        }
+        source += "  i = i + 1;\n}\n";
+        return source;
+    }
+    return bench::readExample("04_fibonacci.lox");
+}
+
+static std::vector<std::unique_ptr<lox::Stmt>> parseWorkload(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    return parser.parse();
+}
+
+static void reportAstSize(benchmark::State& state, const lox::FlatAst& flat) {
+    bench::AllocSnapshot before = bench::allocSnapshot();
+    auto tree = lox::expandFlatAst(flat);
+    bench::AllocSnapshot after = bench::allocSnapshot();
+    benchmark::DoNotOptimize(tree.data());
+
+    std::size_t nodeBytes = flat.nodes.size() * sizeof(lox::FlatNode);
+    std::size_t flatBytes = nodeBytes + flat.lists.size() * sizeof(lox::NodeIndex) + flat.tokens.size() * sizeof(Token) +
+                            flat.constants.size() * sizeof(lox::Value) + flat.statements.size() * sizeof(lox::NodeIndex);
+    state.counters["nodes"] = static_cast<double>(flat.nodes.size());
+    state.counters["node_bytes"] = static_cast<double>(nodeBytes);
+    state.counters["tree_bytes"] = static_cast<double>(after.bytes - before.bytes);
+    state.counters["tree_allocs"] = static_cast<double>(after.allocations - before.allocations);
+    state.counters["flat_bytes"] = static_cast<double>(flatBytes);
+}
+
+static void BM_TreeExecute(benchmark::State& state) {
+    auto statements = parseWorkload(flatWorkload(state.range(0)));
+    bench::SilenceStream silenceOut(std::cout);
+    bench::AllocSnapshot before = bench::allocSnapshot();
+    for (auto _ : state) {
+        lox::Interpreter interpreter;
+        interpreter.setSpecialization(false);
+        interpreter.interpret(statements);
+    }
+    bench::reportAllocations(state, before);
+    reportAstSize(state, lox::flattenAst(statements));
+}
+BENCHMARK(BM_TreeExecute)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
+
+static void BM_FlatExecute(benchmark::State& state) {
+    lox::FlatAst flat = lox::flattenAst(parseWorkload(flatWorkload(state.range(0))));
+    bench::SilenceStream silenceOut(std::cout);
+    bench::AllocSnapshot before = bench::allocSnapshot();
+    for (auto _ : state) {
+        lox::Interpreter interpreter;
+        interpreter.interpret(flat);
+    }
+    bench::reportAllocations(state, before);
+    reportAstSize(state, flat);
+}
+BENCHMARK(BM_FlatExecute)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
+
+// Custo da conversão, a pagar uma vez por programa.
+static void BM_FlattenAst(benchmark::State& state) {
+    auto statements = parseWorkload(flatWorkload(state.range(0)));
+    for (auto _ : state) {
+        lox::FlatAst flat = lox::flattenAst(statements);
+        benchmark::DoNotOptimize(flat.nodes.data());
+    }
+}
+BENCHMARK(BM_FlattenAst)->Arg(1)->Unit(benchmark::kMicrosecond);
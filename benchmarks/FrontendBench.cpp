@@ -0,0 +1,146 @@
+#include "BenchUtil.hpp"
+#include "SourceGenerator.hpp"
+
+#include <map>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Benchmarks do front-end isolado: scan, parse e destruição da AST são
+// medidos separadamente sobre programas sintéticos. Os argumentos são
+// (formato, tamanho em KiB); a vazão aparece como bytes_per_second.
+
+using bench::SourceShape;
+
+static const std::string& cachedSource(SourceShape shape, std::size_t kib) {
+    static std::map<std::pair<int, std::size_t>, std::string> cache;
+    auto key = std::make_pair(static_cast<int>(shape), kib);
+    auto it = cache.find(key);
+    if (it == cache.end()) {
+        it = cache.emplace(key, bench::generateSource(shape, kib * 1024)).first;
+    }
+    return it->second;
+}
+
+// Publica o pico de memória (acima do que já estava vivo) da última iteração.
+static void reportPeak(benchmark::State& state, std::uint64_t baseline) {
+    bench::AllocSnapshot snapshot = bench::allocSnapshot();
+    state.counters["peak_bytes"] = static_cast<double>(snapshot.peakBytes - baseline);
+}
+
+// Número de alocações feitas na última iteração medida.
+static void reportAllocationCount(benchmark::State& state, std::uint64_t before, std::uint64_t after) {
+    state.counters["allocs"] = static_cast<double>(after - before);
+}
+
+static void BM_Scan(benchmark::State& state) {
+    auto shape = static_cast<SourceShape>(state.range(0));
+    const std::string& source = cachedSource(shape, static_cast<std::size_t>(state.range(1)));
+    bench::SilenceStream silenceErr(std::cerr);
+
+    std::uint64_t baseline = 0;
+    std::size_t tokenBytes = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        bench::resetPeak();
+        baseline = bench::allocSnapshot().liveBytes;
+        state.ResumeTiming();
+
+        Scanner scanner(source);
+        TokenStream tokens = scanner.scanTokens();
+        benchmark::DoNotOptimize(tokens.size());
+        tokenBytes = tokens.memoryBytes();
+    }
+    reportPeak(state, baseline);
+    state.counters["token_bytes"] = static_cast<double>(tokenBytes);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+    state.SetLabel(bench::shapeName(shape));
+}
+
+static void BM_Parse(benchmark::State& state) {
+    auto shape = static_cast<SourceShape>(state.range(0));
+    const std::string& source = cachedSource(shape, static_cast<std::size_t>(state.range(1)));
+    bench::SilenceStream silenceErr(std::cerr);
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+
+    std::uint64_t baseline = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        bench::resetPeak();
+        baseline = bench::allocSnapshot().liveBytes;
+        state.ResumeTiming();
+
+        std::uint64_t before = bench::allocSnapshot().allocations;
+        lox::Parser parser(tokens);
+        auto statements = parser.parse();
+        benchmark::DoNotOptimize(statements.data());
+
+        // A destruição da AST fica fora da medição (ver BM_AstTeardown).
+        state.PauseTiming();
+        reportAllocationCount(state, before, bench::allocSnapshot().allocations);
+        statements.clear();
+        state.ResumeTiming();
+    }
+    reportPeak(state, baseline);
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+    state.SetLabel(bench::shapeName(shape));
+}
+
+static void BM_AstTeardown(benchmark::State& state) {
+    auto shape = static_cast<SourceShape>(state.range(0));
+    const std::string& source = cachedSource(shape, static_cast<std::size_t>(state.range(1)));
+    bench::SilenceStream silenceErr(std::cerr);
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+
+    for (auto _ : state) {
+        state.PauseTiming();
+        lox::Parser parser(tokens);
+        auto statements = parser.parse();
+        state.ResumeTiming();
+
+        statements.clear();
+        benchmark::ClobberMemory();
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+    state.SetLabel(bench::shapeName(shape));
+}
+
+// Parse de programas formados só por expressões longas, em tamanhos que
+// cabem (ou não) na cache: mede o custo por token do parser de expressões.
+static void BM_ParseExpressions(benchmark::State& state) {
+    const std::string& source = cachedSource(SourceShape::LongExpressions, static_cast<std::size_t>(state.range(0)));
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+
+    std::uint64_t allocations = 0;
+    for (auto _ : state) {
+        std::uint64_t before = bench::allocSnapshot().allocations;
+        lox::Parser parser(tokens);
+        auto statements = parser.parse();
+        allocations = bench::allocSnapshot().allocations - before;
+        benchmark::DoNotOptimize(statements.data());
+
+        state.PauseTiming();
+        statements.clear();
+        state.ResumeTiming();
+    }
+    state.counters["allocs"] = static_cast<double>(allocations);
+    state.counters["tokens"] = static_cast<double>(tokens.size());
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * tokens.size()));
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+
+static void FrontendArgs(benchmark::internal::Benchmark* benchmark) {
+    for (int shape = 0; shape <= static_cast<int>(SourceShape::CommentHeavy); ++shape) {
+        benchmark->Args({shape, 1024});
+    }
+    benchmark->Unit(benchmark::kMillisecond);
+}
+
+BENCHMARK(BM_Scan)->Apply(FrontendArgs);
+BENCHMARK(BM_Parse)->Apply(FrontendArgs);
+BENCHMARK(BM_AstTeardown)->Apply(FrontendArgs);
+BENCHMARK(BM_ParseExpressions)->Arg(16)->Arg(256)->Unit(benchmark::kMillisecond);
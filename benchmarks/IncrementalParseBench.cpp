@@ -0,0 +1,77 @@
+#include "BenchUtil.hpp"
+#include "IncrementalParser.hpp"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+
+// Latência de uma nova versão no modo --watch, sobre um arquivo de 100 mil
+// linhas. BM_WatchFullParse é a referência (arquivo inteiro pelo Scanner e
+// Parser); BM_WatchEdit alterna entre duas versões do arquivo, então cada
+// iteração é uma edição de verdade. Argumento de BM_WatchEdit:
+//   0 - um número trocado no meio do arquivo (linhas não mudam); o número
+//       é outro a cada iteração, então a declaração nunca está no cache;
+//   1 - uma linha nova no começo (todas as declarações deslocam);
+//   2 - duas edições distantes, no começo e no fim.
+
+static constexpr int kLines = 100000;
+
+static std::string watchedSource() {
+    std::string source;
+    source.reserve(kLines * 32);
+    for (int i = 0; i < kLines / 4; ++i) {
+        std::string name = "v" + std::to_string(i);
+        source += "var " + name + " = " + std::to_string(i) + " * 2 + 1;\n";
+        source += "if (" + name + " > 10) {\n";
+        source += "  " + name + " = " + name + " - 1;\n";
+        source += "}\n";
+    }
+    return source;
+}
+
+// Versão editada número n do arquivo.
+static std::string editedSource(const std::string& original, std::int64_t kind, std::int64_t n) {
+    std::string edited = original;
+    if (kind == 0) {
+        std::size_t at = edited.find("var v12500 = 12500");
+        edited.replace(at, 18, "var v12500 = " + std::to_string(100000 + n % 100000));
+    } else if (kind == 1) {
+        edited.insert(0, "print \"inicio\";\n");
+    } else {
+        edited.insert(0, "print \"inicio\";\n");
+        std::size_t at = edited.find("var v24000 = 24000");
+        edited.replace(at, 18, "var v24000 = 99999");
+    }
+    return edited;
+}
+
+static void BM_WatchFullParse(benchmark::State& state) {
+    std::string source = watchedSource();
+    for (auto _ : state) {
+        lox::IncrementalParser parser;
+        lox::ReparseStats stats = parser.update(source);
+        benchmark::DoNotOptimize(stats.declarations);
+    }
+    state.counters["lines"] = kLines;
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations() * source.size()));
+}
+BENCHMARK(BM_WatchFullParse)->Unit(benchmark::kMillisecond);
+
+static void BM_WatchEdit(benchmark::State& state) {
+    const std::string original = watchedSource();
+    lox::IncrementalParser parser;
+    parser.update(original);
+    std::int64_t n = 0;
+    std::size_t reparsed = 0;
+    for (auto _ : state) {
+        state.PauseTiming();
+        std::string next = ++n % 2 == 1 ? editedSource(original, state.range(0), n) : original;
+        state.ResumeTiming();
+        lox::ReparseStats stats = parser.update(std::move(next));
+        reparsed = std::max(reparsed, stats.reparsed);
+        benchmark::DoNotOptimize(stats.declarations);
+    }
+    state.counters["lines"] = kLines;
+    state.counters["reparsed"] = static_cast<double>(reparsed);
+}
+BENCHMARK(BM_WatchEdit)->Arg(0)->Arg(1)->Arg(2)->Unit(benchmark::kMillisecond);
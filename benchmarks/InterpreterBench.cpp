@@ -0,0 +1,186 @@
+#include "BenchUtil.hpp"
+
+#include <cstdint>
+#include <string>
+
+// Benchmarks de ponta a ponta: cada iteração executa um programa Lox
+// completo (scan, parse e interpretação) com a saída descartada.
+
+static void runWorkload(benchmark::State& state, const std::string& source, bool specialize = true,
+                        lox::JitOptions jit = {}, lox::ExecutionLimits limits = {}) {
+    bench::SilenceStream silenceOut(std::cout);
+    bench::SilenceStream silenceErr(std::cerr);
+    bench::AllocSnapshot before = bench::allocSnapshot();
+    for (auto _ : state) {
+        bench::runLox(source, specialize, jit, limits);
+    }
+    bench::reportAllocations(state, before);
+}
+
+static std::string arithmeticLoop(std::int64_t iterations) {
+    return "var i = 0;"
+           "var acc = 0;"
+           "while (i < " + std::to_string(iterations) + ") {"
+           "  acc = acc + i * 2 - acc / 3;"
+           "  i = i + 1;"
+           "}";
+}
+
+static void BM_ArithmeticLoop(benchmark::State& state) {
+    runWorkload(state, arithmeticLoop(state.range(0)));
+}
+BENCHMARK(BM_ArithmeticLoop)->Arg(1000)->Arg(10000);
+
+// O mesmo laço pela AST, sem a especialização numérica (NumericLoop).
+static void BM_ArithmeticLoopUnspecialized(benchmark::State& state) {
+    runWorkload(state, arithmeticLoop(state.range(0)), false);
+}
+BENCHMARK(BM_ArithmeticLoopUnspecialized)->Arg(1000)->Arg(10000);
+
+// Especializado, mas só no programa de registradores (sem o JIT x86-64).
+static void BM_ArithmeticLoopNoJit(benchmark::State& state) {
+    lox::JitOptions jit;
+    jit.enabled = false;
+    runWorkload(state, arithmeticLoop(state.range(0)), true, jit);
+}
+BENCHMARK(BM_ArithmeticLoopNoJit)->Arg(1000)->Arg(10000);
+
+// Custo dos safepoints com combustível e timeout (que nunca estouram), pela
+// AST e no código de máquina; comparar com os dois acima.
+static lox::ExecutionLimits generousLimits() {
+    lox::ExecutionLimits limits;
+    limits.fuel = 1u << 30;
+    limits.timeoutMs = 60000;
+    return limits;
+}
+
+static void BM_ArithmeticLoopLimitedUnspecialized(benchmark::State& state) {
+    runWorkload(state, arithmeticLoop(state.range(0)), false, {}, generousLimits());
+}
+BENCHMARK(BM_ArithmeticLoopLimitedUnspecialized)->Arg(1000)->Arg(10000);
+
+static void BM_ArithmeticLoopLimited(benchmark::State& state) {
+    runWorkload(state, arithmeticLoop(state.range(0)), true, {}, generousLimits());
+}
+BENCHMARK(BM_ArithmeticLoopLimited)->Arg(1000)->Arg(10000);
+
+static void BM_NestedBlocks(benchmark::State& state) {
+    std::string source =
+        "var i = 0;"
+        "var total = 0;"
+        "while (i < " + std::to_string(state.range(0)) + ") {"
+        "  var a = i;"
+        "  {"
+        "    var b = a + 1;"
+        "    {"
+        "      var c = b + 1;"
+        "      { total = total + a + b + c; }"
+        "    }"
+        "  }"
+        "  i = i + 1;"
+        "}";
+    runWorkload(state, source);
+}
+BENCHMARK(BM_NestedBlocks)->Arg(1000)->Arg(10000);
+
+static void BM_StringBuilding(benchmark::State& state) {
+    std::string source =
+        "var i = 0;"
+        "var s = \"\";"
+        "while (i < " + std::to_string(state.range(0)) + ") {"
+        "  s = s + \"x\";"
+        "  i = i + 1;"
+        "}";
+    runWorkload(state, source);
+}
+BENCHMARK(BM_StringBuilding)->Arg(100)->Arg(1000);
+
+// O mesmo com quota de memória: a contabilidade é cobrada em toda alocação,
+// e a pressão na quota antecipa coletas.
+static void BM_StringBuildingMemoryLimit(benchmark::State& state) {
+    std::string source =
+        "var i = 0;"
+        "var s = \"\";"
+        "while (i < " + std::to_string(state.range(0)) + ") {"
+        "  s = s + \"x\";"
+        "  i = i + 1;"
+        "}";
+    lox::ExecutionLimits limits;
+    limits.memoryBytes = 256 * 1024;
+    runWorkload(state, source, true, {}, limits);
+}
+BENCHMARK(BM_StringBuildingMemoryLimit)->Arg(100)->Arg(1000);
+
+static void BM_VariableHeavy(benchmark::State& state) {
+    std::string source;
+    for (int v = 0; v < 20; ++v) {
+        source += "var v" + std::to_string(v) + " = " + std::to_string(v) + ";";
+    }
+    source += "var i = 0; while (i < " + std::to_string(state.range(0)) + ") {";
+    for (int v = 1; v < 20; ++v) {
+        source += "v" + std::to_string(v) + " = v" + std::to_string(v - 1) + " + v" + std::to_string(v) + ";";
+    }
+    source += "i = i + 1; }";
+    runWorkload(state, source);
+}
+BENCHMARK(BM_VariableHeavy)->Arg(100)->Arg(1000);
+
+static void BM_FibonacciExample(benchmark::State& state) {
+    runWorkload(state, bench::readExample("04_fibonacci.lox"));
+}
+BENCHMARK(BM_FibonacciExample);
+
+// O mesmo laço contado escrito com while e com for; o for usa o caminho
+// rápido de ForStmt::counted.
+static void BM_WhileCounter(benchmark::State& state) {
+    std::string source =
+        "var acc = 0;"
+        "var i = 0;"
+        "while (i < " + std::to_string(state.range(0)) + ") {"
+        "  acc = acc + i;"
+        "  i = i + 1;"
+        "}";
+    runWorkload(state, source);
+}
+BENCHMARK(BM_WhileCounter)->Arg(10000);
+
+static void BM_ForCounter(benchmark::State& state) {
+    std::string source =
+        "var acc = 0;"
+        "for (var i = 0; i < " + std::to_string(state.range(0)) + "; i = i + 1) {"
+        "  acc = acc + i;"
+        "}";
+    runWorkload(state, source);
+}
+BENCHMARK(BM_ForCounter)->Arg(10000);
+
+// Condições compostas em if/while: comparações combinadas com and/or.
+static void BM_CompoundConditions(benchmark::State& state) {
+    std::string source =
+        "var i = 0;"
+        "var hits = 0;"
+        "var limit = " + std::to_string(state.range(0)) + ";"
+        "while (i < limit and !(i < 0)) {"
+        "  if ((i > 10 and i < 500) or i == 7 or i >= limit - 3) hits = hits + 1;"
+        "  i = i + 1;"
+        "}";
+    runWorkload(state, source);
+}
+BENCHMARK(BM_CompoundConditions)->Arg(10000);
+
+// Globais lidas e atribuídas em um laço dentro de blocos aninhados
+// (argumento: profundidade). Sem os caches de Variable/Assign, cada acesso
+// passa pela tabela de cada escopo intermediário antes de chegar aos globais.
+static void BM_GlobalsInNestedBlocks(benchmark::State& state) {
+    std::string open;
+    std::string close;
+    for (std::int64_t depth = 0; depth < state.range(0); ++depth) {
+        open += "{ var local" + std::to_string(depth) + " = " + std::to_string(depth) + "; ";
+        close += "} ";
+    }
+    std::string source =
+        "var total = 0; var step = 3; var scale = 2;" + open +
+        "var j = 0; while (j < 10000) { total = total + step * scale - total / 7; j = j + 1; } " + close;
+    runWorkload(state, source, false);
+}
+BENCHMARK(BM_GlobalsInNestedBlocks)->Arg(1)->Arg(4)->Arg(8);
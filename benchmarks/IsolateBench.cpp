@@ -0,0 +1,72 @@
+#include "BenchUtil.hpp"
+#include "Channel.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+
+// Escalabilidade dos isolates: o mesmo trabalho total dividido entre
+// range(0) workers, que devolvem o resultado por mensagem. O índice no array
+// mantém o laço na AST (não é especializado), para o trabalho dominar o
+// custo de criar as threads. Com trabalho independente o tempo de relógio
+// deve cair quase na proporção do número de núcleos (contador cores).
+static std::string parallelSum(std::int64_t workers, std::int64_t totalIterations) {
+    std::int64_t chunk = totalIterations / workers;
+    // Strings Lox não têm aspas escapadas: o worker só usa números.
+    std::string worker =
+        "var start = receive(); var i = start; var acc = 0; var steps = [1, 2];"
+        "while (i < start + " + std::to_string(chunk) + ") {"
+        "  acc = acc + i * steps[0] - steps[1]; i = i + 1;"
+        "}"
+        "send(parent(), acc);";
+    std::string source = "var w = 0; var total = 0;";
+    source += "while (w < " + std::to_string(workers) + ") {"
+              "  send(spawn(\"" + worker + "\"), w * " + std::to_string(chunk) + ");"
+              "  w = w + 1;"
+              "}";
+    source += "while (w > 0) { total = total + receive(); w = w - 1; }";
+    return source;
+}
+
+static void BM_IsolateScaling(benchmark::State& state) {
+    const std::int64_t totalIterations = 400000;
+    std::string source = parallelSum(state.range(0), totalIterations);
+    for (auto _ : state) {
+        bench::runLox(source);
+    }
+    state.SetItemsProcessed(state.iterations() * totalIterations);
+    state.counters["cores"] = static_cast<double>(std::thread::hardware_concurrency());
+}
+BENCHMARK(BM_IsolateScaling)->Arg(1)->Arg(2)->Arg(4)->Arg(8)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// Vazão da fila sem locks entre range(0) produtores e um consumidor.
+static void BM_BoundedQueueThroughput(benchmark::State& state) {
+    const int producers = static_cast<int>(state.range(0));
+    const std::int64_t perProducer = 100000;
+    for (auto _ : state) {
+        lox::BoundedQueue<std::int64_t> queue(1024);
+        std::vector<std::thread> threads;
+        for (int p = 0; p < producers; ++p) {
+            threads.emplace_back([&queue, perProducer] {
+                lox::Backoff backoff;
+                for (std::int64_t i = 0; i < perProducer; ++i) {
+                    std::int64_t value = i;
+                    while (!queue.tryPush(value)) backoff.pause();
+                }
+            });
+        }
+        std::int64_t received = 0;
+        std::int64_t value = 0;
+        while (received < producers * perProducer) {
+            if (queue.tryPop(value)) {
+                ++received;
+            } else {
+                std::this_thread::yield();
+            }
+        }
+        for (std::thread& thread : threads) thread.join();
+        benchmark::DoNotOptimize(value);
+    }
+    state.SetItemsProcessed(state.iterations() * producers * perProducer);
+}
+BENCHMARK(BM_BoundedQueueThroughput)->Arg(1)->Arg(4)->UseRealTime()->Unit(benchmark::kMillisecond);
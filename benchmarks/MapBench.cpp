@@ -0,0 +1,73 @@
+#include "BenchUtil.hpp"
+#include "Map.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// LoxMap contra std::unordered_map com as mesmas chaves, e uma agregação
+// (contagem por chave) escrita em Lox.
+
+static std::vector<std::string> makeKeys(std::size_t count) {
+    std::vector<std::string> keys;
+    keys.reserve(count);
+    for (std::size_t i = 0; i < count; ++i) {
+        keys.push_back("key" + std::to_string(i * 7919));
+    }
+    return keys;
+}
+
+static void BM_UnorderedMapCount(benchmark::State& state) {
+    std::vector<std::string> keys = makeKeys(static_cast<std::size_t>(state.range(0)));
+    for (auto _ : state) {
+        std::unordered_map<std::string, lox::Value> counts;
+        for (int round = 0; round < 4; ++round) {
+            for (const std::string& key : keys) {
+                auto it = counts.find(key);
+                double count = it != counts.end() ? std::get<double>(it->second) : 0.0;
+                counts[key] = count + 1.0;
+            }
+        }
+        benchmark::DoNotOptimize(counts.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size() * 4));
+}
+BENCHMARK(BM_UnorderedMapCount)->Arg(1000)->Arg(100000);
+
+static void BM_LoxMapCount(benchmark::State& state) {
+    std::vector<std::string> keys = makeKeys(static_cast<std::size_t>(state.range(0)));
+    std::vector<lox::Value> values;
+    for (const std::string& key : keys) values.emplace_back(lox::String(key));
+    for (auto _ : state) {
+        lox::LoxMap counts;
+        for (int round = 0; round < 4; ++round) {
+            for (const lox::Value& key : values) {
+                const lox::Value* count = counts.find(key);
+                counts.set(key, (count != nullptr ? std::get<double>(*count) : 0.0) + 1.0);
+            }
+        }
+        benchmark::DoNotOptimize(counts.size());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * keys.size() * 4));
+}
+BENCHMARK(BM_LoxMapCount)->Arg(1000)->Arg(100000);
+
+static void BM_LoxCountByKey(benchmark::State& state) {
+    std::string source =
+        "var counts = map();"
+        "var i = 0;"
+        "while (i < " + std::to_string(state.range(0)) + ") {"
+        "  var key = 0;"
+        "  while (key < 100) {"
+        "    counts[key] = get(counts, key, 0) + 1;"
+        "    key = key + 1;"
+        "  }"
+        "  i = i + 100;"
+        "}";
+    bench::SilenceStream silenceOut(std::cout);
+    for (auto _ : state) {
+        bench::runLox(source);
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations() * state.range(0)));
+}
+BENCHMARK(BM_LoxCountByKey)->Arg(10000);
@@ -0,0 +1,94 @@
+#include "BenchUtil.hpp"
+#include "ScriptServer.hpp"
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <fcntl.h>
+#include <spawn.h>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Latência de um script pequeno: processo lox_cpp novo a cada execução
+// (cold) contra o mesmo script enviado a um servidor --serve já no ar
+// (warm). O trabalho acontece em outros processos, então o tempo medido
+// é o de relógio (UseRealTime).
+
+extern char** environ;
+
+static const std::string& smallScript() {
+    static const std::string source = bench::readExample("04_fibonacci.lox");
+    return source;
+}
+
+static void BM_ColdProcessRun(benchmark::State& state) {
+    std::string path = "/tmp/lox-bench-" + std::to_string(getpid()) + ".lox";
+    {
+        std::ofstream file(path);
+        file << smallScript();
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    char* argv[] = {const_cast<char*>(LOX_CPP_PATH), path.data(), nullptr};
+
+    for (auto _ : state) {
+        pid_t pid = 0;
+        if (posix_spawn(&pid, LOX_CPP_PATH, &actions, nullptr, argv, environ) != 0) {
+            state.SkipWithError("could not spawn lox_cpp");
+            break;
+        }
+        int status = 0;
+        waitpid(pid, &status, 0);
+    }
+
+    posix_spawn_file_actions_destroy(&actions);
+    std::remove(path.c_str());
+}
+BENCHMARK(BM_ColdProcessRun)->UseRealTime()->Unit(benchmark::kMicrosecond);
+
+// Espera o servidor aceitar conexões (um script vazio serve de ping).
+static bool waitForServer(const std::string& socketPath) {
+    for (int attempt = 0; attempt < 400; ++attempt) {
+        std::ostringstream out, err;
+        try {
+            lox::runRemote(socketPath, "", out, err);
+            return true;
+        } catch (const std::runtime_error&) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+    }
+    return false;
+}
+
+static void BM_WarmServerRun(benchmark::State& state) {
+    std::string socketPath = "/tmp/lox-bench-" + std::to_string(getpid()) + ".sock";
+    pid_t server = fork();
+    if (server == 0) {
+        lox::ScriptServer scriptServer(socketPath);
+        scriptServer.listen();
+        scriptServer.serve();
+        _exit(0);
+    }
+    if (!waitForServer(socketPath)) {
+        state.SkipWithError("server did not start");
+    }
+
+    std::ostringstream out, err;
+    for (auto _ : state) {
+        out.str("");
+        int status = lox::runRemote(socketPath, smallScript(), out, err);
+        if (status != 0) {
+            state.SkipWithError("script failed on the server");
+            break;
+        }
+    }
+
+    kill(server, SIGTERM);
+    waitpid(server, nullptr, 0);
+}
+BENCHMARK(BM_WarmServerRun)->UseRealTime()->Unit(benchmark::kMicrosecond);
@@ -0,0 +1,144 @@
+#include "SourceGenerator.hpp"
+
+#include <random>
+
+namespace bench {
+
+    const char* shapeName(SourceShape shape) {
+        switch (shape) {
+            case SourceShape::FlatStatements: return "flat";
+            case SourceShape::NestedBlocks: return "nested";
+            case SourceShape::LongExpressions: return "long_expr";
+            case SourceShape::StringHeavy: return "strings";
+            case SourceShape::CommentHeavy: return "comments";
+        }
+        return "unknown";
+    }
+
+    namespace {
+
+        const char* const kWords[] = {
+            "lorem", "ipsum", "dolor", "sit", "amet", "consectetur", "adipiscing", "elit",
+            "sed", "do", "eiusmod", "tempor", "incididunt", "ut", "labore", "magna",
+        };
+        const char* const kOperators[] = {" + ", " - ", " * ", " / "};
+
+        class Generator {
+        public:
+            Generator(std::size_t targetBytes, std::uint32_t seed) : m_target(targetBytes), m_random(seed) {
+                m_out.reserve(targetBytes + 1024);
+            }
+
+            bool done() const { return m_out.size() >= m_target; }
+            std::string take() { return std::move(m_out); }
+
+            int pick(int n) { return std::uniform_int_distribution<int>(0, n - 1)(m_random); }
+            const char* word() { return kWords[pick(16)]; }
+            const char* op() { return kOperators[pick(4)]; }
+
+            void number() { m_out += std::to_string(pick(1000)); m_out += "."; m_out += std::to_string(pick(100)); }
+            void append(const std::string& text) { m_out += text; }
+            void indent(int depth) { m_out.append(static_cast<std::size_t>(depth) * 2, ' '); }
+
+            void flatStatement(int id) {
+                if (id % 4 == 3) {
+                    m_out += "print v" + std::to_string(id - 1) + ";\n";
+                    return;
+                }
+                m_out += "var v" + std::to_string(id) + " = ";
+                number();
+                if (id > 0) {
+                    int other = pick(id);
+                    if (other % 4 == 3) other--;  // índices múltiplos de 4 menos 1 são prints
+                    m_out += std::string(op()) + "v" + std::to_string(other);
+                }
+                m_out += ";\n";
+            }
+
+            void nestedBlocks(int depth) {
+                for (int level = 0; level < depth; ++level) {
+                    indent(level);
+                    m_out += "{\n";
+                    indent(level + 1);
+                    m_out += "var d" + std::to_string(level) + " = ";
+                    if (level == 0) number(); else m_out += "d" + std::to_string(level - 1) + " + 1";
+                    m_out += ";\n";
+                }
+                for (int level = depth - 1; level >= 0; --level) {
+                    indent(level + 1);
+                    m_out += "print d" + std::to_string(level) + ";\n";
+                    indent(level);
+                    m_out += "}\n";
+                }
+            }
+
+            void longExpression(int id, int terms) {
+                m_out += "var e" + std::to_string(id) + " = ";
+                number();
+                for (int term = 1; term < terms; ++term) {
+                    m_out += op();
+                    if (pick(8) == 0) {
+                        m_out += "(";
+                        number();
+                        m_out += op();
+                        number();
+                        m_out += ")";
+                    } else if (id > 0 && pick(4) == 0) {
+                        m_out += "e" + std::to_string(pick(id));
+                    } else {
+                        number();
+                    }
+                    if (term % 16 == 0) m_out += "\n    ";
+                }
+                m_out += ";\n";
+            }
+
+            void stringStatement(int id) {
+                m_out += "var s" + std::to_string(id) + " = \"";
+                int words = 8 + pick(24);
+                for (int w = 0; w < words; ++w) {
+                    if (w > 0) m_out += ' ';
+                    m_out += word();
+                }
+                m_out += "\"";
+                if (id > 0) m_out += " + s" + std::to_string(pick(id));
+                m_out += ";\n";
+            }
+
+            void commentBlock(int id) {
+                int lines = 3 + pick(5);
+                for (int line = 0; line < lines; ++line) {
+                    m_out += "// ";
+                    int words = 6 + pick(10);
+                    for (int w = 0; w < words; ++w) {
+                        m_out += word();
+                        m_out += ' ';
+                    }
+                    m_out += "\n";
+                }
+                m_out += "var c" + std::to_string(id) + " = " + std::to_string(id) + "; // fim\n";
+            }
+
+        private:
+            std::size_t m_target;
+            std::mt19937 m_random;
+            std::string m_out;
+        };
+
+    }
+
+    std::string generateSource(SourceShape shape, std::size_t targetBytes, std::uint32_t seed) {
+        Generator generator(targetBytes, seed);
+        for (int id = 0; !generator.done(); ++id) {
+            switch (shape) {
+                case SourceShape::FlatStatements: generator.flatStatement(id); break;
+                case SourceShape::NestedBlocks: generator.nestedBlocks(32); break;
+                case SourceShape::LongExpressions: generator.longExpression(id, 512); break;
+                case SourceShape::StringHeavy: generator.stringStatement(id); break;
+                case SourceShape::CommentHeavy: generator.commentBlock(id); break;
+            }
+        }
+        return generator.take();
+    }
+
+}
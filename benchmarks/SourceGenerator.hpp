@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace bench {
+
+    // Formatos de programas Lox sintéticos para medir o front-end.
+    enum class SourceShape {
+        FlatStatements,   // muitas declarações e prints curtos, um por linha
+        NestedBlocks,     // blocos aninhados em profundidade
+        LongExpressions,  // poucas declarações com expressões enormes
+        StringHeavy,      // literais de string longos e concatenações
+        CommentHeavy,     // mais comentários do que código
+    };
+
+    const char* shapeName(SourceShape shape);
+
+    // Gera um programa Lox válido com aproximadamente targetBytes bytes.
+    // A mesma semente sempre produz o mesmo programa.
+    std::string generateSource(SourceShape shape, std::size_t targetBytes, std::uint32_t seed = 42);
+
+}
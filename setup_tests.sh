@@ -17,14 +17,14 @@ cat > ScannerTests.cpp << 'EOF'
 TEST(ScannerTests, TestVariableDeclaration) {
     std::string source = "var language = \"Lox\";";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     ASSERT_EQ(tokens.size(), 6);
     EXPECT_EQ(tokens[0].type, TokenType::VAR);
     EXPECT_EQ(tokens[1].type, TokenType::IDENTIFIER);
     EXPECT_EQ(tokens[2].type, TokenType::EQUAL);
     EXPECT_EQ(tokens[3].type, TokenType::STRING);
-    EXPECT_EQ(std::get<std::string>(tokens[3].literal), "Lox");
+    EXPECT_EQ(std::get<std::string>(tokens.literal(3)), "Lox");
     EXPECT_EQ(tokens[4].type, TokenType::SEMICOLON);
     EXPECT_EQ(tokens[5].type, TokenType::END_OF_FILE);
 }
@@ -32,7 +32,7 @@ TEST(ScannerTests, TestVariableDeclaration) {
 TEST(ScannerTests, TestArithmeticOperators) {
     std::string source = "1 + 2 * (3 - 4) / 5";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     std::vector<TokenType> expected_types = {
         TokenType::NUMBER, TokenType::PLUS, TokenType::NUMBER, TokenType::STAR,
@@ -51,7 +51,7 @@ TEST(ScannerTests, TestAllSingleCharTokens) {
     // CORREÇÃO: Adicionados espaços em "! < = >" para remover a ambiguidade
     std::string source = "(){},.-+;*/! < = >";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     std::vector<TokenType> expected_types = {
         TokenType::LEFT_PAREN, TokenType::RIGHT_PAREN, TokenType::LEFT_BRACE,
@@ -70,7 +70,7 @@ TEST(ScannerTests, TestAllSingleCharTokens) {
 TEST(ScannerTests, TestTwoCharTokens) {
     std::string source = "!= == <= >=";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     std::vector<TokenType> expected_types = {
         TokenType::BANG_EQUAL, TokenType::EQUAL_EQUAL,
@@ -91,7 +91,7 @@ TEST(ScannerTests, TestCommentsAndLineNumbers) {
         "var b = 2;\n"
         "// another one";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     ASSERT_EQ(tokens.size(), 11);
     EXPECT_EQ(tokens[0].line, 1);
@@ -104,7 +104,7 @@ TEST(ScannerTests, TestCommentsAndLineNumbers) {
 TEST(ScannerTests, TestKeywords) {
     std::string source = "and class else false for fun if nil or print return super this true var while";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
     
     std::vector<TokenType> expected_types = {
         TokenType::AND, TokenType::CLASS, TokenType::ELSE, TokenType::FALSE, TokenType::FOR,
@@ -132,7 +132,7 @@ cat > ParserTests.cpp << 'EOF'
 std::string parseAndPrint(const std::string& source) {
     lox::ASTPrinter printer;
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
     lox::Parser parser(tokens);
     auto statements = parser.parse();
     if (!statements.empty()) {
@@ -200,7 +200,7 @@ void runInterpreter(const std::string& source, std::stringstream& buffer) {
 
     lox::Interpreter interpreter;
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
     lox::Parser parser(tokens);
     auto statements = parser.parse();
     interpreter.interpret(statements);
@@ -0,0 +1,74 @@
+#include "Array.hpp"
+
+#include <iterator>
+
+namespace lox {
+
+    LoxArray::LoxArray(std::vector<Value> values) {
+        for (const Value& value : values) {
+            if (!std::holds_alternative<double>(value)) {
+                m_numeric = false;
+                m_values.assign(std::make_move_iterator(values.begin()), std::make_move_iterator(values.end()));
+                return;
+            }
+        }
+        m_numbers.reserve(values.size());
+        for (const Value& value : values) {
+            m_numbers.push_back(std::get<double>(value));
+        }
+    }
+
+    LoxArray::LoxArray(std::size_t size, const Value& fill) {
+        if (auto number = std::get_if<double>(&fill)) {
+            m_numbers.assign(size, *number);
+        } else {
+            m_numeric = false;
+            m_values.assign(size, fill);
+        }
+    }
+
+    Value LoxArray::get(std::size_t index) const {
+        if (m_numeric) return m_numbers[index];
+        return m_values[index];
+    }
+
+    void LoxArray::set(std::size_t index, const Value& value) {
+        if (m_numeric) {
+            if (auto number = std::get_if<double>(&value)) {
+                m_numbers[index] = *number;
+                return;
+            }
+            makeGeneric();
+        }
+        m_values[index] = value;
+    }
+
+    void LoxArray::push(const Value& value) {
+        if (m_numeric) {
+            if (auto number = std::get_if<double>(&value)) {
+                m_numbers.push_back(*number);
+                return;
+            }
+            makeGeneric();
+        }
+        m_values.push_back(value);
+    }
+
+    void LoxArray::makeGeneric() {
+        m_values.reserve(m_numbers.size() + 1);
+        for (double number : m_numbers) {
+            m_values.emplace_back(number);
+        }
+        m_numbers.clear();
+        m_numbers.shrink_to_fit();
+        m_numeric = false;
+    }
+
+    void LoxArray::trace(Heap& heap) {
+        if (m_numeric) return;
+        for (const Value& value : m_values) {
+            heap.markValue(value);
+        }
+    }
+
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "Heap.hpp"
+#include "Value.hpp"
+#include <cstddef>
+#include <vector>
+
+namespace lox {
+
+    // Array Lox, alocado no heap do interpretador. Enquanto todos os
+    // elementos são números eles ficam em um vetor contíguo de double, que os
+    // kernels de ArrayKernels.hpp percorrem diretamente; o primeiro elemento
+    // de outro tipo converte o array (de vez) para armazenamento em Value.
+    class LoxArray : public GcObject {
+    public:
+        // Armazenamento cobrado do MemoryQuota corrente (MemoryQuota.hpp).
+        using NumberVector = std::vector<double, QuotaAllocator<double>>;
+        using ValueVector = std::vector<Value, QuotaAllocator<Value>>;
+
+        LoxArray() = default;
+        explicit LoxArray(std::vector<Value> values);
+        LoxArray(std::size_t size, const Value& fill);
+
+        std::size_t size() const { return m_numeric ? m_numbers.size() : m_values.size(); }
+        bool isNumeric() const { return m_numeric; }
+
+        Value get(std::size_t index) const;
+        void set(std::size_t index, const Value& value);
+        void push(const Value& value);
+
+        // Acesso direto ao armazenamento; numbers() só vale se isNumeric().
+        NumberVector& numbers() { return m_numbers; }
+        const NumberVector& numbers() const { return m_numbers; }
+        ValueVector& values() { return m_values; }
+        const ValueVector& values() const { return m_values; }
+
+        // No modo genérico, marca os elementos que são objetos do heap.
+        void trace(Heap& heap) override;
+
+    private:
+        void makeGeneric();
+
+        bool m_numeric = true;
+        NumberVector m_numbers;
+        ValueVector m_values;
+    };
+
+}
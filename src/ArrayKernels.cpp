@@ -0,0 +1,120 @@
+#include "ArrayKernels.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace lox {
+
+#if defined(__GNUC__) || defined(__clang__)
+#define LOX_VECTOR_KERNELS 1
+    typedef double Double4 __attribute__((vector_size(4 * sizeof(double))));
+    // min/max usam a largura nativa do SSE2/NEON: com 4 lanes e sem AVX o
+    // GCC escalariza a comparação de vetores.
+    typedef double Double2 __attribute__((vector_size(2 * sizeof(double))));
+
+    // Por referência: retornar o vetor por valor muda a ABI sem AVX (-Wpsabi).
+    static inline void load4(Double4& vector, const double* data) {
+        std::memcpy(&vector, data, sizeof(vector));
+    }
+
+    static inline void load2(Double2& vector, const double* data) {
+        std::memcpy(&vector, data, sizeof(vector));
+    }
+#else
+#define LOX_VECTOR_KERNELS 0
+#endif
+
+    double sumNumbers(const double* data, std::size_t count) {
+        std::size_t i = 0;
+        double total = 0.0;
+#if LOX_VECTOR_KERNELS
+        // Dois acumuladores independentes escondem a latência da soma.
+        Double4 first = {0.0, 0.0, 0.0, 0.0};
+        Double4 second = {0.0, 0.0, 0.0, 0.0};
+        for (; i + 8 <= count; i += 8) {
+            Double4 a, b;
+            load4(a, data + i);
+            load4(b, data + i + 4);
+            first += a;
+            second += b;
+        }
+        Double4 partial = first + second;
+        total = (partial[0] + partial[1]) + (partial[2] + partial[3]);
+#endif
+        for (; i < count; ++i) total += data[i];
+        return total;
+    }
+
+    double minNumbers(const double* data, std::size_t count) {
+        std::size_t i = 0;
+        double result = data[0];
+#if LOX_VECTOR_KERNELS
+        if (count >= 8) {
+            // Quatro acumuladores, como em sumNumbers: cada comparação depende
+            // só da anterior do mesmo acumulador.
+            Double2 best[4], next[4];
+            for (int lane = 0; lane < 4; ++lane) load2(best[lane], data + 2 * lane);
+            for (i = 8; i + 8 <= count; i += 8) {
+                for (int lane = 0; lane < 4; ++lane) {
+                    load2(next[lane], data + i + 2 * lane);
+                    best[lane] = next[lane] < best[lane] ? next[lane] : best[lane];
+                }
+            }
+            for (int lane = 1; lane < 4; ++lane) {
+                best[0] = best[lane] < best[0] ? best[lane] : best[0];
+            }
+            result = std::min(best[0][0], best[0][1]);
+        }
+#endif
+        for (; i < count; ++i) result = std::min(result, data[i]);
+        return result;
+    }
+
+    double maxNumbers(const double* data, std::size_t count) {
+        std::size_t i = 0;
+        double result = data[0];
+#if LOX_VECTOR_KERNELS
+        if (count >= 8) {
+            // Quatro acumuladores, como em sumNumbers: cada comparação depende
+            // só da anterior do mesmo acumulador.
+            Double2 best[4], next[4];
+            for (int lane = 0; lane < 4; ++lane) load2(best[lane], data + 2 * lane);
+            for (i = 8; i + 8 <= count; i += 8) {
+                for (int lane = 0; lane < 4; ++lane) {
+                    load2(next[lane], data + i + 2 * lane);
+                    best[lane] = next[lane] > best[lane] ? next[lane] : best[lane];
+                }
+            }
+            for (int lane = 1; lane < 4; ++lane) {
+                best[0] = best[lane] > best[0] ? best[lane] : best[0];
+            }
+            result = std::max(best[0][0], best[0][1]);
+        }
+#endif
+        for (; i < count; ++i) result = std::max(result, data[i]);
+        return result;
+    }
+
+    void sortNumbers(double* data, std::size_t count) {
+        double* numbers = std::partition(data, data + count, [](double value) { return !std::isnan(value); });
+        std::sort(data, numbers);
+    }
+
+    long searchNumbers(const double* data, std::size_t count, double value) {
+        if (count == 0) return -1;
+        // lower_bound com o intervalo reduzido à metade a cada passo; o
+        // compilador troca o if por um cmov.
+        const double* base = data;
+        std::size_t length = count;
+        while (length > 1) {
+            std::size_t half = length / 2;
+            if (base[half] < value) base += half;
+            length -= half;
+        }
+        std::size_t index = static_cast<std::size_t>(base - data) + (*base < value ? 1 : 0);
+        if (index < count && data[index] == value) return static_cast<long>(index);
+        return -1;
+    }
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstddef>
+
+namespace lox {
+
+    // Kernels sobre o armazenamento contíguo de arrays numéricos. sum, min e
+    // max usam vetores SIMD (extensões de vetor do GCC/Clang, que viram
+    // SSE2/AVX/NEON conforme o alvo) com laços escalares para o resto; em
+    // outros compiladores ficam só os laços escalares.
+
+    // Soma com vários acumuladores: o resultado pode diferir da soma
+    // sequencial nos últimos bits, como em qualquer redução vetorizada.
+    double sumNumbers(const double* data, std::size_t count);
+
+    // Menor/maior elemento; count deve ser maior que zero.
+    double minNumbers(const double* data, std::size_t count);
+    double maxNumbers(const double* data, std::size_t count);
+
+    // Ordenação crescente in-place (introsort de std::sort), com os NaN no
+    // fim: std::sort com NaN não teria uma ordem fraca estrita (comportamento
+    // indefinido), então eles são separados antes.
+    void sortNumbers(double* data, std::size_t count);
+
+    // Busca binária sem desvios em um intervalo ordenado. Retorna o índice
+    // de um elemento igual a value ou -1.
+    long searchNumbers(const double* data, std::size_t count, double value);
+
+}
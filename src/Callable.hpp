@@ -4,16 +4,16 @@
 #include <vector>
 #include <string>
 #include "Value.hpp"
+#include "Heap.hpp"
 
 // Forward declaration para evitar include circular
 namespace lox {
     class Interpreter;
 }
 
-class LoxCallable {
+// Chamáveis vivem no heap do interpretador e são liberados pelo coletor.
+class LoxCallable : public lox::GcObject {
 public:
-    virtual ~LoxCallable() = default;
-
     /**
      * @brief Executa a lógica do objeto chamável.
      * @param interpreter A instância do interpretador que está executando a chamada.
@@ -34,4 +34,7 @@ public:
      * @return Uma string.
      */
     virtual std::string toString() const = 0;
+
+    // Por padrão, um chamável não referencia outros objetos do heap.
+    void trace(lox::Heap&) override {}
 };
\ No newline at end of file
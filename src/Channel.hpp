@@ -0,0 +1,110 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <thread>
+#include <utility>
+
+namespace lox {
+
+    // Fila limitada sem locks para vários produtores e vários consumidores
+    // (o anel com números de sequência de D. Vyukov). Cada célula guarda um
+    // número de sequência que diz de quem é a vez: do produtor da posição
+    // pos quando vale pos, do consumidor quando vale pos + 1. Produtores e
+    // consumidores só disputam o próprio contador com compare-exchange.
+    template<typename T>
+    class BoundedQueue {
+    public:
+        // capacity é arredondada para a próxima potência de 2.
+        explicit BoundedQueue(std::size_t capacity) {
+            std::size_t size = 2;
+            while (size < capacity) size *= 2;
+            m_mask = size - 1;
+            m_cells = std::make_unique<Cell[]>(size);
+            for (std::size_t i = 0; i < size; ++i) m_cells[i].sequence.store(i, std::memory_order_relaxed);
+        }
+
+        BoundedQueue(const BoundedQueue&) = delete;
+        BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+        // false se a fila estiver cheia (value não é consumido).
+        bool tryPush(T& value) {
+            std::size_t position = m_enqueue.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = m_cells[position & m_mask];
+                std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+                if (difference == 0) {
+                    if (m_enqueue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        cell.data = std::move(value);
+                        cell.sequence.store(position + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    position = m_enqueue.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        // false se a fila estiver vazia.
+        bool tryPop(T& out) {
+            std::size_t position = m_dequeue.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = m_cells[position & m_mask];
+                std::size_t sequence = cell.sequence.load(std::memory_order_acquire);
+                auto difference = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position + 1);
+                if (difference == 0) {
+                    if (m_dequeue.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                        out = std::move(cell.data);
+                        cell.data = T{};
+                        cell.sequence.store(position + m_mask + 1, std::memory_order_release);
+                        return true;
+                    }
+                } else if (difference < 0) {
+                    return false;
+                } else {
+                    position = m_dequeue.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        std::size_t capacity() const { return m_mask + 1; }
+
+    private:
+        struct Cell {
+            std::atomic<std::size_t> sequence{0};
+            T data{};
+        };
+
+        // Os contadores em linhas de cache separadas: produtores e
+        // consumidores não invalidam a linha uns dos outros.
+        alignas(64) std::atomic<std::size_t> m_enqueue{0};
+        alignas(64) std::atomic<std::size_t> m_dequeue{0};
+        std::unique_ptr<Cell[]> m_cells;
+        std::size_t m_mask = 0;
+    };
+
+    // Espera ativa curta e depois cada vez mais longa, para uma fila vazia ou
+    // cheia não ocupar um núcleo inteiro.
+    class Backoff {
+    public:
+        void pause() {
+            if (m_rounds < 64) {
+                ++m_rounds;
+                std::this_thread::yield();
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(m_sleepUs));
+            if (m_sleepUs < 1000) m_sleepUs *= 2;
+        }
+
+    private:
+        int m_rounds = 0;
+        int m_sleepUs = 10;
+    };
+
+}
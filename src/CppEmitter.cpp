@@ -0,0 +1,580 @@
+#include "CppEmitter.hpp"
+
+#include "Natives.hpp"
+
+#include <cmath>
+#include <cstdio>
+
+namespace lox {
+
+    static const Expr& unwrap(const Expr& expr) {
+        if (expr.kind == ExprKind::Grouping) return unwrap(*static_cast<const Grouping&>(expr).expression);
+        return expr;
+    }
+
+    static bool isConstant(const Expr& expr) {
+        return unwrap(expr).kind == ExprKind::Literal;
+    }
+
+    // Altera alguma variável (atribuição ou incremento).
+    static bool writes(const Expr& expr) {
+        switch (expr.kind) {
+            case ExprKind::Assign:
+            case ExprKind::Increment:
+                return true;
+            case ExprKind::Grouping:
+                return writes(*static_cast<const Grouping&>(expr).expression);
+            case ExprKind::Unary:
+                return writes(*static_cast<const Unary&>(expr).right);
+            case ExprKind::Binary: {
+                const auto& binary = static_cast<const Binary&>(expr);
+                return writes(*binary.left) || writes(*binary.right);
+            }
+            case ExprKind::Logical: {
+                const auto& logical = static_cast<const Logical&>(expr);
+                return writes(*logical.left) || writes(*logical.right);
+            }
+            default:
+                return false;
+        }
+    }
+
+    // Literal double do C++ que lê de volta exatamente o mesmo valor.
+    static std::string numberLiteral(double value) {
+        if (std::isinf(value)) return value > 0 ? "HUGE_VAL" : "(-HUGE_VAL)";
+        char buffer[32];
+        std::snprintf(buffer, sizeof buffer, "%.17g", value);
+        std::string text = buffer;
+        if (text.find_first_of(".e") == std::string::npos) text += ".0";
+        return text;
+    }
+
+    // Bytes fora do ASCII imprimível viram escapes octais, então o literal
+    // tem os mesmos bytes da string Lox em qualquer charset de execução.
+    static std::string stringLiteral(std::string_view value) {
+        std::string text = "String(\"";
+        for (unsigned char c : value) {
+            if (c == '"' || c == '\\') {
+                text += '\\';
+                text += static_cast<char>(c);
+            } else if (c >= 0x20 && c < 0x7f) {
+                text += static_cast<char>(c);
+            } else {
+                char escape[8];
+                std::snprintf(escape, sizeof escape, "\\%03o", c);
+                text += escape;
+            }
+        }
+        return text + "\", " + std::to_string(value.size()) + ")";
+    }
+
+    static std::string sanitize(const std::string& name) {
+        std::string result;
+        for (char c : name) {
+            bool word = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+            result += word ? c : '_';
+        }
+        return result;
+    }
+
+    [[noreturn]] static void unsupported(int line, const std::string& what) {
+        throw CppEmitError(line, what + " is not supported by --emit-cpp.");
+    }
+
+    std::string CppEmitter::emit(const std::vector<std::unique_ptr<Stmt>>& program) {
+        m_variables.clear();
+        m_scopes.assign(1, {});
+        m_declarations.clear();
+        m_uses.clear();
+        m_stores.clear();
+        m_out.clear();
+        m_indent = 0;
+        m_temporaries = 0;
+
+        resolveBlock(program);
+        inferNumericVariables();
+
+        line("// Gerado por lox_cpp --emit-cpp. Para compilar:");
+        line("//     c++ -std=c++17 -O2 -I <lox>/src programa.cpp <build>/liblox_runtime.a");
+        line("#include \"LoxRuntime.hpp\"");
+        line("");
+        line("#include <cmath>");
+        line("#include <string>");
+        line("");
+        line("using namespace lox;");
+        line("");
+        line("static void program() {");
+        ++m_indent;
+        for (const auto& stmt : program) emitStmt(*stmt);
+        --m_indent;
+        line("}");
+        line("");
+        line("int main() {");
+        line("    return rt::run(program);");
+        line("}");
+        return m_out;
+    }
+
+    // --- Resolução dos nomes ---
+
+    CppEmitter::Variable* CppEmitter::find(const std::string& name) const {
+        for (auto scope = m_scopes.rbegin(); scope != m_scopes.rend(); ++scope) {
+            auto found = scope->find(name);
+            if (found != scope->end()) return found->second;
+        }
+        return nullptr;
+    }
+
+    void CppEmitter::resolveBlock(const std::vector<std::unique_ptr<Stmt>>& statements) {
+        for (const auto& stmt : statements) resolve(*stmt);
+    }
+
+    void CppEmitter::resolve(const Stmt& stmt) {
+        switch (stmt.kind) {
+            case StmtKind::Expression:
+                resolve(*static_cast<const ExpressionStmt&>(stmt).expression);
+                break;
+            case StmtKind::Print:
+                resolve(*static_cast<const PrintStmt&>(stmt).expression);
+                break;
+            case StmtKind::Var: {
+                const auto& var = static_cast<const VarStmt&>(stmt);
+                // O initializer ainda enxerga a declaração anterior do nome.
+                if (var.initializer) resolve(*var.initializer);
+                m_variables.push_back(std::make_unique<Variable>());
+                Variable* variable = m_variables.back().get();
+                variable->cppName = "v" + std::to_string(m_variables.size()) + "_" + sanitize(var.name.lexeme);
+                if (var.initializer) {
+                    m_stores.emplace_back(variable, var.initializer.get());
+                } else {
+                    variable->numeric = false;
+                }
+                m_scopes.back()[var.name.lexeme] = variable;
+                m_declarations[&stmt] = variable;
+                break;
+            }
+            case StmtKind::Block:
+                m_scopes.emplace_back();
+                resolveBlock(static_cast<const BlockStmt&>(stmt).statements);
+                m_scopes.pop_back();
+                break;
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                resolve(*branch.condition);
+                resolve(*branch.thenBranch);
+                if (branch.elseBranch) resolve(*branch.elseBranch);
+                break;
+            }
+            case StmtKind::While: {
+                const auto& loop = static_cast<const WhileStmt&>(stmt);
+                resolve(*loop.condition);
+                resolve(*loop.body);
+                break;
+            }
+            case StmtKind::For: {
+                const auto& loop = static_cast<const ForStmt&>(stmt);
+                m_scopes.emplace_back();
+                if (loop.initializer) resolve(*loop.initializer);
+                if (loop.condition) resolve(*loop.condition);
+                if (loop.increment) resolve(*loop.increment);
+                resolve(*loop.body);
+                m_scopes.pop_back();
+                break;
+            }
+        }
+    }
+
+    void CppEmitter::resolve(const Expr& expr) {
+        switch (expr.kind) {
+            case ExprKind::Literal:
+                break;
+            case ExprKind::Variable: {
+                const Token& name = static_cast<const lox::Variable&>(expr).name;
+                Variable* variable = find(name.lexeme);
+                if (variable == nullptr && isNativeName(name.lexeme)) unsupported(name.line, "Native function '" + name.lexeme + "'");
+                m_uses[&expr] = variable;
+                break;
+            }
+            case ExprKind::Assign: {
+                const auto& assign = static_cast<const Assign&>(expr);
+                resolve(*assign.value);
+                Variable* variable = find(assign.name.lexeme);
+                if (variable == nullptr && isNativeName(assign.name.lexeme)) {
+                    unsupported(assign.name.line, "Native function '" + assign.name.lexeme + "'");
+                }
+                if (variable != nullptr) m_stores.emplace_back(variable, assign.value.get());
+                m_uses[&expr] = variable;
+                break;
+            }
+            case ExprKind::Increment: {
+                const Token& name = static_cast<const Increment&>(expr).name;
+                Variable* variable = find(name.lexeme);
+                if (variable == nullptr && isNativeName(name.lexeme)) unsupported(name.line, "Native function '" + name.lexeme + "'");
+                m_uses[&expr] = variable;
+                break;
+            }
+            case ExprKind::Grouping:
+                resolve(*static_cast<const Grouping&>(expr).expression);
+                break;
+            case ExprKind::Unary:
+                resolve(*static_cast<const Unary&>(expr).right);
+                break;
+            case ExprKind::Binary: {
+                const auto& binary = static_cast<const Binary&>(expr);
+                resolve(*binary.left);
+                resolve(*binary.right);
+                break;
+            }
+            case ExprKind::Logical: {
+                const auto& logical = static_cast<const Logical&>(expr);
+                resolve(*logical.left);
+                resolve(*logical.right);
+                break;
+            }
+            case ExprKind::Call:
+                unsupported(static_cast<const Call&>(expr).paren.line, "Function call");
+            case ExprKind::ArrayLiteral:
+                unsupported(static_cast<const ArrayLiteral&>(expr).bracket.line, "Array literal");
+            case ExprKind::Index:
+                unsupported(static_cast<const Index&>(expr).bracket.line, "Indexing");
+            case ExprKind::IndexSet:
+                unsupported(static_cast<const IndexSet&>(expr).target->bracket.line, "Indexing");
+        }
+    }
+
+    // Começa supondo que toda variável inicializada é double e desfaz a
+    // suposição para as que recebem algum valor não numérico, até nenhuma
+    // mudar (uma variável atribuída de outra depende do tipo dela).
+    void CppEmitter::inferNumericVariables() {
+        bool changed = true;
+        while (changed) {
+            changed = false;
+            for (const auto& [variable, value] : m_stores) {
+                if (variable->numeric && kindOf(*value) != Kind::Number) {
+                    variable->numeric = false;
+                    changed = true;
+                }
+            }
+        }
+    }
+
+    // --- Tipos e efeitos das expressões ---
+
+    CppEmitter::Kind CppEmitter::kindOf(const Expr& expr) const {
+        switch (expr.kind) {
+            case ExprKind::Literal: {
+                const Value& value = static_cast<const Literal&>(expr).value;
+                if (std::holds_alternative<double>(value)) return Kind::Number;
+                if (std::holds_alternative<bool>(value)) return Kind::Bool;
+                return Kind::Value;
+            }
+            case ExprKind::Variable:
+            case ExprKind::Assign: {
+                Variable* variable = m_uses.at(&expr);
+                return variable != nullptr && variable->numeric ? Kind::Number : Kind::Value;
+            }
+            case ExprKind::Increment:
+                return m_uses.at(&expr) != nullptr ? Kind::Number : Kind::Value;
+            case ExprKind::Grouping:
+                return kindOf(*static_cast<const Grouping&>(expr).expression);
+            case ExprKind::Unary:
+                return static_cast<const Unary&>(expr).op.type == TokenType::MINUS ? Kind::Number : Kind::Bool;
+            case ExprKind::Binary: {
+                const auto& binary = static_cast<const Binary&>(expr);
+                switch (binary.op.type) {
+                    case TokenType::MINUS:
+                    case TokenType::STAR:
+                    case TokenType::SLASH:
+                        return Kind::Number;
+                    case TokenType::PLUS:
+                        return kindOf(*binary.left) == Kind::Number && kindOf(*binary.right) == Kind::Number
+                                   ? Kind::Number
+                                   : Kind::Value;
+                    default:
+                        return Kind::Bool;
+                }
+            }
+            case ExprKind::Logical: {
+                const auto& logical = static_cast<const Logical&>(expr);
+                return kindOf(*logical.left) == Kind::Bool && kindOf(*logical.right) == Kind::Bool ? Kind::Bool
+                                                                                                   : Kind::Value;
+            }
+            default:
+                return Kind::Value;
+        }
+    }
+
+    // Não lança erro nem altera variáveis: pode ser avaliada fora de ordem.
+    bool CppEmitter::pure(const Expr& expr) const {
+        switch (expr.kind) {
+            case ExprKind::Literal:
+                return true;
+            case ExprKind::Variable:
+                return m_uses.at(&expr) != nullptr;
+            case ExprKind::Grouping:
+                return pure(*static_cast<const Grouping&>(expr).expression);
+            case ExprKind::Unary: {
+                const auto& unary = static_cast<const Unary&>(expr);
+                return pure(*unary.right) && (unary.op.type == TokenType::BANG || kindOf(*unary.right) == Kind::Number);
+            }
+            case ExprKind::Binary: {
+                const auto& binary = static_cast<const Binary&>(expr);
+                if (!pure(*binary.left) || !pure(*binary.right)) return false;
+                switch (binary.op.type) {
+                    case TokenType::EQUAL_EQUAL:
+                    case TokenType::BANG_EQUAL:
+                        return true;
+                    case TokenType::SLASH:
+                        return false;
+                    default:
+                        return kindOf(*binary.left) == Kind::Number && kindOf(*binary.right) == Kind::Number;
+                }
+            }
+            case ExprKind::Logical: {
+                const auto& logical = static_cast<const Logical&>(expr);
+                return pure(*logical.left) && pure(*logical.right);
+            }
+            default:
+                return false;
+        }
+    }
+
+    // --- Geração ---
+
+    void CppEmitter::line(const std::string& text) {
+        if (!text.empty()) m_out.append(static_cast<std::size_t>(m_indent) * 4, ' ');
+        m_out += text;
+        m_out += '\n';
+    }
+
+    std::string CppEmitter::temporary() {
+        return "t" + std::to_string(++m_temporaries);
+    }
+
+    static std::string asValue(const std::string& text, bool isValue) {
+        return isValue ? text : "Value(" + text + ")";
+    }
+
+    std::string CppEmitter::condition(const Expr& expr) {
+        Code code = emitExpr(expr);
+        return code.kind == Kind::Bool ? code.text : "rt::truthy(" + code.text + ")";
+    }
+
+    void CppEmitter::emitStmt(const Stmt& stmt) {
+        switch (stmt.kind) {
+            case StmtKind::Expression:
+                line("static_cast<void>(" + emitExpr(*static_cast<const ExpressionStmt&>(stmt).expression).text + ");");
+                break;
+            case StmtKind::Print:
+                line("rt::print(" + emitExpr(*static_cast<const PrintStmt&>(stmt).expression).text + ");");
+                break;
+            case StmtKind::Var: {
+                const auto& var = static_cast<const VarStmt&>(stmt);
+                Variable* variable = m_declarations.at(&stmt);
+                std::string type = variable->numeric ? "double " : "Value ";
+                if (var.initializer) {
+                    line(type + variable->cppName + " = " + emitExpr(*var.initializer).text + ";");
+                } else {
+                    line(type + variable->cppName + ";");
+                }
+                break;
+            }
+            case StmtKind::Block:
+                line("{");
+                ++m_indent;
+                for (const auto& inner : static_cast<const BlockStmt&>(stmt).statements) emitStmt(*inner);
+                --m_indent;
+                line("}");
+                break;
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                line("if (" + condition(*branch.condition) + ") {");
+                ++m_indent;
+                emitStmt(*branch.thenBranch);
+                --m_indent;
+                if (branch.elseBranch) {
+                    line("} else {");
+                    ++m_indent;
+                    emitStmt(*branch.elseBranch);
+                    --m_indent;
+                }
+                line("}");
+                break;
+            }
+            case StmtKind::While: {
+                const auto& loop = static_cast<const WhileStmt&>(stmt);
+                line("while (" + condition(*loop.condition) + ") {");
+                ++m_indent;
+                emitStmt(*loop.body);
+                --m_indent;
+                line("}");
+                break;
+            }
+            case StmtKind::For: {
+                // O initializer fica em um escopo próprio, como no Interpreter.
+                const auto& loop = static_cast<const ForStmt&>(stmt);
+                line("{");
+                ++m_indent;
+                if (loop.initializer) emitStmt(*loop.initializer);
+                line("while (" + (loop.condition ? condition(*loop.condition) : std::string("true")) + ") {");
+                ++m_indent;
+                emitStmt(*loop.body);
+                if (loop.increment) line("static_cast<void>(" + emitExpr(*loop.increment).text + ");");
+                --m_indent;
+                line("}");
+                --m_indent;
+                line("}");
+                break;
+            }
+        }
+    }
+
+    CppEmitter::Code CppEmitter::emitExpr(const Expr& expr) {
+        switch (expr.kind) {
+            case ExprKind::Literal: {
+                const Value& value = static_cast<const Literal&>(expr).value;
+                if (auto number = std::get_if<double>(&value)) return {numberLiteral(*number), Kind::Number};
+                if (auto boolean = std::get_if<bool>(&value)) return {*boolean ? "true" : "false", Kind::Bool};
+                if (auto string = std::get_if<String>(&value)) return {"Value(" + stringLiteral(*string) + ")", Kind::Value};
+                return {"Value()", Kind::Value};
+            }
+            case ExprKind::Variable: {
+                const Token& name = static_cast<const lox::Variable&>(expr).name;
+                Variable* variable = m_uses.at(&expr);
+                if (variable == nullptr) {
+                    return {"rt::undefinedVariable(\"" + name.lexeme + "\", " + std::to_string(name.line) + ")", Kind::Value};
+                }
+                return {variable->cppName, kindOf(expr)};
+            }
+            case ExprKind::Assign: {
+                const auto& assign = static_cast<const Assign&>(expr);
+                Code value = emitExpr(*assign.value);
+                Variable* variable = m_uses.at(&expr);
+                if (variable == nullptr) {
+                    // O valor é avaliado antes do erro, como no Interpreter.
+                    return {"(static_cast<void>(" + value.text + "), rt::undefinedVariable(\"" + assign.name.lexeme +
+                                "\", " + std::to_string(assign.name.line) + "))",
+                            Kind::Value};
+                }
+                return {"(" + variable->cppName + " = " + value.text + ")", kindOf(expr)};
+            }
+            case ExprKind::Increment: {
+                const auto& increment = static_cast<const Increment&>(expr);
+                Variable* variable = m_uses.at(&expr);
+                if (variable == nullptr) {
+                    return {"rt::undefinedVariable(\"" + increment.name.lexeme + "\", " +
+                                std::to_string(increment.name.line) + ")",
+                            Kind::Value};
+                }
+                if (variable->numeric) {
+                    return {"(" + variable->cppName + " += " + numberLiteral(increment.step) + ")", Kind::Number};
+                }
+                return {"rt::increment(" + variable->cppName + ", " + numberLiteral(increment.step) + ", " +
+                            (increment.op.type == TokenType::PLUS ? "true" : "false") + ", " +
+                            std::to_string(increment.op.line) + ")",
+                        Kind::Number};
+            }
+            case ExprKind::Grouping: {
+                Code inner = emitExpr(*static_cast<const Grouping&>(expr).expression);
+                return {"(" + inner.text + ")", inner.kind};
+            }
+            case ExprKind::Unary: {
+                const auto& unary = static_cast<const Unary&>(expr);
+                Code right = emitExpr(*unary.right);
+                if (unary.op.type == TokenType::BANG) {
+                    if (right.kind == Kind::Bool) return {"(!" + right.text + ")", Kind::Bool};
+                    return {"(!rt::truthy(" + right.text + "))", Kind::Bool};
+                }
+                if (right.kind == Kind::Number) return {"(-" + right.text + ")", Kind::Number};
+                return {"(-rt::number(" + asValue(right.text, right.kind == Kind::Value) + ", " +
+                            std::to_string(unary.op.line) + "))",
+                        Kind::Number};
+            }
+            case ExprKind::Binary:
+                return emitBinary(static_cast<const Binary&>(expr));
+            case ExprKind::Logical:
+                return emitLogical(static_cast<const Logical&>(expr));
+            default:
+                // resolve() já rejeitou os outros nós.
+                unsupported(0, exprKindName(expr.kind));
+        }
+    }
+
+    CppEmitter::Code CppEmitter::emitBinary(const Binary& binary) {
+        Code left = emitExpr(*binary.left);
+        Code right = emitExpr(*binary.right);
+
+        // O C++ não garante a ordem dos operandos; quando ela importa (um
+        // lado pode lançar erro ou alterar uma variável que o outro lê) o
+        // lado esquerdo é avaliado antes, em uma temporária dentro de um
+        // lambda.
+        bool sequenced = !(isConstant(*binary.left) || isConstant(*binary.right) ||
+                           (pure(*binary.left) && !writes(*binary.right)));
+        std::string prefix;
+        std::string suffix;
+        if (sequenced) {
+            std::string name = temporary();
+            prefix = "[&] { auto " + name + " = " + left.text + "; return ";
+            suffix = "; }()";
+            left.text = name;
+        }
+
+        bool numbers = left.kind == Kind::Number && right.kind == Kind::Number;
+        std::string line = std::to_string(binary.op.line);
+        std::string a = asValue(left.text, left.kind == Kind::Value);
+        std::string b = asValue(right.text, right.kind == Kind::Value);
+        auto arithmetic = [&](const char* op, const char* function) -> std::string {
+            if (numbers) return "(" + left.text + " " + op + " " + right.text + ")";
+            return std::string("rt::") + function + "(" + a + ", " + b + ", " + line + ")";
+        };
+
+        Code result;
+        switch (binary.op.type) {
+            case TokenType::MINUS: result = {arithmetic("-", "subtract"), Kind::Number}; break;
+            case TokenType::STAR: result = {arithmetic("*", "multiply"), Kind::Number}; break;
+            case TokenType::SLASH:
+                result = {numbers ? "rt::divide(" + left.text + ", " + right.text + ", " + line + ")"
+                                  : "rt::divide(" + a + ", " + b + ", " + line + ")",
+                          Kind::Number};
+                break;
+            case TokenType::PLUS:
+                result = {numbers ? "(" + left.text + " + " + right.text + ")" : "rt::add(" + a + ", " + b + ", " + line + ")",
+                          numbers ? Kind::Number : Kind::Value};
+                break;
+            case TokenType::LESS: result = {arithmetic("<", "less"), Kind::Bool}; break;
+            case TokenType::LESS_EQUAL: result = {arithmetic("<=", "lessEqual"), Kind::Bool}; break;
+            case TokenType::GREATER: result = {arithmetic(">", "greater"), Kind::Bool}; break;
+            case TokenType::GREATER_EQUAL: result = {arithmetic(">=", "greaterEqual"), Kind::Bool}; break;
+            case TokenType::EQUAL_EQUAL:
+            case TokenType::BANG_EQUAL: {
+                bool equal = binary.op.type == TokenType::EQUAL_EQUAL;
+                if (left.kind == right.kind && left.kind != Kind::Value) {
+                    result = {"(" + left.text + (equal ? " == " : " != ") + right.text + ")", Kind::Bool};
+                } else {
+                    result = {std::string(equal ? "" : "!") + "rt::equal(" + a + ", " + b + ")", Kind::Bool};
+                }
+                break;
+            }
+            default:
+                throw CppEmitError(binary.op.line, "Invalid binary operator.");
+        }
+        result.text = prefix + result.text + suffix;
+        return result;
+    }
+
+    CppEmitter::Code CppEmitter::emitLogical(const Logical& logical) {
+        Code left = emitExpr(*logical.left);
+        Code right = emitExpr(*logical.right);
+        bool isOr = logical.op.type == TokenType::OR;
+        if (left.kind == Kind::Bool && right.kind == Kind::Bool) {
+            return {"(" + left.text + (isOr ? " || " : " && ") + right.text + ")", Kind::Bool};
+        }
+        // O resultado é o valor de um dos lados, não um bool.
+        std::string name = temporary();
+        return {"[&]() -> Value { Value " + name + " = " + left.text + "; if (" + (isOr ? "" : "!") + "rt::truthy(" +
+                    name + ")) return " + name + "; return " + asValue(right.text, right.kind == Kind::Value) +
+                    "; }()",
+                Kind::Value};
+    }
+
+}
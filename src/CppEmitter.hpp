@@ -0,0 +1,85 @@
+#pragma once
+
+#include "ast/Stmt.hpp"
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lox {
+
+    // Construção que o C++ gerado não suporta (chamadas, arrays, mapas).
+    class CppEmitError : public std::runtime_error {
+    public:
+        CppEmitError(int line, const std::string& message) : std::runtime_error(message), line(line) {}
+
+        const int line;
+    };
+
+    // Backend de --emit-cpp: gera uma unidade de tradução C++ que faz o mesmo
+    // que o Interpreter faria com o programa, para ser compilada com o
+    // compilador do sistema e ligada com a biblioteca lox_runtime
+    // (LoxRuntime.hpp):
+    //
+    //     c++ -std=c++17 -O2 -I src prog.cpp build/liblox_runtime.a
+    //
+    // Sem funções definidas pelo usuário os escopos são estáticos, então
+    // cada declaração vira uma variável local C++ com nome próprio. Uma
+    // variável cujo initializer e todas as atribuições são números vira um
+    // `double`; as demais são lox::Value. As operações entre doubles são
+    // emitidas direto em C++ e as outras chamam o runtime, que tem as
+    // mesmas mensagens de erro do Interpreter. A ordem de avaliação da
+    // esquerda para a direita é preservada quando um lado pode lançar erro
+    // ou ter efeito.
+    //
+    // Chamadas, arrays, mapas e as funções nativas lançam CppEmitError.
+    class CppEmitter {
+    public:
+        std::string emit(const std::vector<std::unique_ptr<Stmt>>& program);
+
+    private:
+        struct Variable {
+            std::string cppName;
+            bool numeric = true;
+        };
+
+        enum class Kind { Number, Bool, Value };
+
+        struct Code {
+            std::string text;
+            Kind kind;
+        };
+
+        void resolve(const Stmt& stmt);
+        void resolve(const Expr& expr);
+        void resolveBlock(const std::vector<std::unique_ptr<Stmt>>& statements);
+        Variable* find(const std::string& name) const;
+        void inferNumericVariables();
+
+        Kind kindOf(const Expr& expr) const;
+        bool pure(const Expr& expr) const;
+
+        void emitStmt(const Stmt& stmt);
+        Code emitExpr(const Expr& expr);
+        Code emitBinary(const Binary& binary);
+        Code emitLogical(const Logical& logical);
+        std::string condition(const Expr& expr);
+        std::string temporary();
+        void line(const std::string& text);
+
+        std::vector<std::unique_ptr<Variable>> m_variables;
+        std::vector<std::unordered_map<std::string, Variable*>> m_scopes;
+        // Variável de cada declaração e de cada uso (nullptr: sem declaração
+        // visível, erro de execução "Undefined variable").
+        std::unordered_map<const Stmt*, Variable*> m_declarations;
+        std::unordered_map<const Expr*, Variable*> m_uses;
+        // Valores atribuídos a cada variável, para a inferência de double.
+        std::vector<std::pair<Variable*, const Expr*>> m_stores;
+
+        std::string m_out;
+        int m_indent = 0;
+        int m_temporaries = 0;
+    };
+
+}
@@ -1,44 +1,118 @@
 #include "Environment.hpp"
 #include "RuntimeError.hpp"
+#include "Stats.hpp"
+#include <atomic>
 #include <string>
 
 namespace lox {
 
-    Environment::Environment() : m_enclosing(nullptr) {}
+    static std::uint64_t nextGlobalVersion() {
+        static std::atomic<std::uint64_t> version{0};
+        return version.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    Environment::Environment() : m_enclosing(nullptr), m_globals(this), m_globalVersion(nextGlobalVersion()) {
+        Stats::envAllocation();
+    }
 
-    Environment::Environment(std::shared_ptr<Environment> enclosing)
-        : m_enclosing(std::move(enclosing)) {}
+    Environment::Environment(Environment* enclosing)
+        : m_enclosing(enclosing), m_globals(enclosing->m_globals) {
+        Stats::envAllocation();
+    }
 
     void Environment::define(const std::string& name, const Value& value) {
+        Stats::valueCopy(value);
         m_values[name] = value;
+        // Um local com o nome de um global invalida todos os caches. Basta
+        // olhar na definição: um cache só é preenchido quando nenhum escopo
+        // da cadeia tem o nome, e sem funções um escopo que já existia nesse
+        // momento continua na cadeia de todos os nós executados dentro dele.
+        if (m_globals != this && m_globals->m_values.find(name) != m_globals->m_values.end()) {
+            m_globals->m_globalVersion = nextGlobalVersion();
+        }
     }
 
-    const Value& Environment::get(const Token& name) {
-        auto it = m_values.find(name.lexeme);
-        if (it != m_values.end()) {
-            return it->second;
+    Value* Environment::resolve(const std::string& name, GlobalCache& cache) {
+        Stats::envLookup();
+        for (Environment* environment = this; environment != nullptr; environment = environment->m_enclosing) {
+            Stats::envScope();
+            Stats::envProbe(environment->m_values, name);
+            auto it = environment->m_values.find(name);
+            if (it != environment->m_values.end()) {
+                if (environment == m_globals) {
+                    cache.slot = &it->second;
+                    cache.version = m_globals->m_globalVersion;
+                }
+                return &it->second;
+            }
         }
+        return nullptr;
+    }
 
-        if (m_enclosing != nullptr) {
-            return m_enclosing->get(name);
+    Value* Environment::lookup(const std::string& name) {
+        Stats::envLookup();
+        for (Environment* environment = this; environment != nullptr; environment = environment->m_enclosing) {
+            Stats::envScope();
+            Stats::envProbe(environment->m_values, name);
+            auto it = environment->m_values.find(name);
+            if (it != environment->m_values.end()) {
+                return &it->second;
+            }
         }
+        return nullptr;
+    }
+
+    const Value& Environment::get(const Token& name) {
+        return getRef(name);
+    }
 
+    Value& Environment::getRef(const Token& name) {
+        if (Value* value = lookup(name.lexeme)) {
+            return *value;
+        }
         throw RuntimeError(name, "Undefined variable '" + name.lexeme + "'.");
     }
 
-    void Environment::assign(const Token& name, const Value& value) {
-        auto it = m_values.find(name.lexeme);
-        if (it != m_values.end()) {
-            it->second = value;
-            return;
+    const Value& Environment::get(const Token& name, GlobalCache& cache) {
+        if (cache.version == m_globals->m_globalVersion) {
+            Stats::globalCacheHit();
+            return *cache.slot;
+        }
+        if (Value* value = resolve(name.lexeme, cache)) {
+            return *value;
+        }
+        throw RuntimeError(name, "Undefined variable '" + name.lexeme + "'.");
+    }
+
+    void Environment::assign(const Token& name, const Value& value, GlobalCache& cache) {
+        Value* slot;
+        if (cache.version == m_globals->m_globalVersion) {
+            Stats::globalCacheHit();
+            slot = cache.slot;
+        } else {
+            slot = resolve(name.lexeme, cache);
         }
+        if (slot == nullptr) {
+            throw RuntimeError(name, "Undefined variable '" + name.lexeme + "'.");
+        }
+        Stats::valueCopy(value);
+        *slot = value;
+    }
 
-        if (m_enclosing != nullptr) {
-            m_enclosing->assign(name, value);
+    void Environment::assign(const Token& name, const Value& value) {
+        if (Value* slot = lookup(name.lexeme)) {
+            Stats::valueCopy(value);
+            *slot = value;
             return;
         }
-        
         throw RuntimeError(name, "Undefined variable '" + name.lexeme + "'.");
     }
 
+    void Environment::trace(Heap& heap) {
+        heap.markObject(m_enclosing);
+        for (const auto& entry : m_values) {
+            heap.markValue(entry.second);
+        }
+    }
+
 } 
\ No newline at end of file
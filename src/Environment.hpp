@@ -2,18 +2,21 @@
 
 #include "Value.hpp"
 #include "Token.hpp"
-#include <memory>
+#include "Heap.hpp"
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 
 namespace lox {
 
-    class Environment : public std::enable_shared_from_this<Environment> {
+    // Ambientes são objetos do heap: o coletor os libera quando nenhum
+    // escopo ativo (ou objeto vivo) ainda os referencia.
+    class Environment : public GcObject {
     public:
         // Construtor para o escopo global (sem pai)
         Environment();
         // Construtor para escopos aninhados (com um pai)
-        explicit Environment(std::shared_ptr<Environment> enclosing);
+        explicit Environment(Environment* enclosing);
 
         // Define uma nova variável no escopo ATUAL.
         void define(const std::string& name, const Value& value);
@@ -21,15 +24,51 @@ namespace lox {
         // Busca o valor de uma variável, procurando nos escopos pais se necessário.
         const Value& get(const Token& name);
 
+        // Como get() e assign(), com o cache de globais de um nó Variable ou
+        // Assign: se a versão dos globais não mudou desde que o nome foi
+        // resolvido no escopo global, o valor é lido direto, sem hash. Os
+        // caches não são sincronizados: uma AST é executada por uma thread
+        // de cada vez.
+        const Value& get(const Token& name, GlobalCache& cache);
+        void assign(const Token& name, const Value& value, GlobalCache& cache);
+
+        // Como get(), mas permite alterar o valor no lugar (Increment e laços
+        // contados). A referência continua válida enquanto o escopo existir.
+        Value& getRef(const Token& name);
+
         // Atribui um novo valor a uma variável EXISTENTE, procurando nos escopos pais.
         void assign(const Token& name, const Value& value);
 
+        // Procura a variável nos escopos, do atual para os pais; nullptr se não
+        // existir. Não lança erro: usado pelas guardas dos laços especializados.
+        Value* lookup(const std::string& name);
+
+        Environment* enclosing() const { return m_enclosing; }
+
+        // Marca o escopo pai e todos os valores deste escopo.
+        void trace(Heap& heap) override;
+
     private:
         // Ponteiro para o escopo pai (ex: o escopo de um bloco dentro de uma função)
-        std::shared_ptr<Environment> m_enclosing;
+        Environment* m_enclosing;
+
+        // Escopo global da cadeia (this no próprio escopo global).
+        Environment* m_globals;
+
+        // Versão dos globais, usada só no escopo global. Muda quando um
+        // escopo interno define um nome que também é global e passa a
+        // escondê-lo. Os números vêm de um contador do processo e nunca se
+        // repetem, então um cache preenchido por outro Interpreter (a mesma
+        // AST no modo --watch) nunca é aceito.
+        std::uint64_t m_globalVersion = 0;
+
+        // Como lookup(), preenchendo o cache se o nome estiver no escopo global.
+        Value* resolve(const std::string& name, GlobalCache& cache);
         
-        // Tabela hash que mapeia nomes de variáveis para seus valores.
-        std::unordered_map<std::string, Value> m_values;
+        // Tabela hash que mapeia nomes de variáveis para seus valores; os nós
+        // são cobrados do MemoryQuota corrente na criação do escopo.
+        std::unordered_map<std::string, Value, std::hash<std::string>, std::equal_to<std::string>,
+                           QuotaAllocator<std::pair<const std::string, Value>>> m_values;
     };
 
-} 
\ No newline at end of file
+} 
@@ -0,0 +1,90 @@
+#include "ExecutionLimits.hpp"
+
+#include "RuntimeError.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+namespace lox {
+
+    void ExecutionBudget::start(const ExecutionLimits& limits) {
+        stop();
+        m_limits = limits;
+        m_expired.store(false, std::memory_order_relaxed);
+        m_fuelLeft = limits.fuel;
+
+        // A contagem inclui o safepoint que chega a zero, que não é pago.
+        if (limits.fuel > 0) {
+            m_countdown = take() + 1;
+        } else if (limits.timeoutMs > 0) {
+            m_countdown = kTimeSlice;
+        } else {
+            m_countdown = std::numeric_limits<std::uint64_t>::max();
+        }
+
+        s_running = this;
+        if (limits.timeoutMs > 0) {
+            m_stopping = false;
+            m_deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(limits.timeoutMs);
+            m_watchdog = std::thread([this] {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (!m_wake.wait_until(lock, m_deadline, [this] { return m_stopping; })) {
+                    m_expired.store(true, std::memory_order_release);
+                }
+            });
+        }
+    }
+
+    void ExecutionBudget::stop() {
+        if (s_running == this) s_running = nullptr;
+        if (!m_watchdog.joinable()) return;
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_wake.notify_one();
+        m_watchdog.join();
+    }
+
+    std::uint64_t ExecutionBudget::take() {
+        std::uint64_t paid = std::min(m_fuelLeft, kTimeSlice);
+        m_fuelLeft -= paid;
+        return paid;
+    }
+
+    ExecutionLimits ExecutionBudget::limitsForChild() const {
+        ExecutionLimits limits = m_limits;
+        if (limits.timeoutMs > 0) {
+            auto left = std::chrono::ceil<std::chrono::milliseconds>(m_deadline - std::chrono::steady_clock::now());
+            limits.timeoutMs = static_cast<std::uint64_t>(std::max<std::int64_t>(left.count(), 1));
+        }
+        return limits;
+    }
+
+    void ExecutionBudget::refill(int line) {
+        std::string message = exhausted();
+        if (!message.empty()) throw RuntimeError(Token(TokenType::WHILE, "", line), message);
+    }
+
+    std::string ExecutionBudget::exhausted() {
+        if (m_expired.load(std::memory_order_acquire)) {
+            m_countdown = 1;   // o próximo safepoint falha de novo
+            return "Execution timed out after " + std::to_string(m_limits.timeoutMs) + " ms.";
+        }
+        if (m_limits.fuel > 0) {
+            if (m_fuelLeft == 0) {
+                m_countdown = 1;
+                return "Execution fuel exhausted (" + std::to_string(m_limits.fuel) + " safepoints).";
+            }
+            // Este safepoint usa o primeiro da nova fatia.
+            m_countdown = take();
+        } else if (m_limits.timeoutMs > 0) {
+            m_countdown = kTimeSlice;
+        } else {
+            m_countdown = std::numeric_limits<std::uint64_t>::max();
+        }
+        return {};
+    }
+
+}
@@ -0,0 +1,98 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <string>
+#include <thread>
+
+namespace lox {
+
+    // Limites de execução de um Interpreter; 0 = sem limite.
+    struct ExecutionLimits {
+        // Safepoints (voltas de laço e entradas de bloco) que o programa pode
+        // executar. Determinístico: o mesmo programa para no mesmo ponto.
+        std::uint64_t fuel = 0;
+        // Tempo de parede, vigiado por uma thread.
+        std::uint64_t timeoutMs = 0;
+        // Bytes vivos cobrados do MemoryQuota do interpretador. Ao contrário
+        // dos outros dois, não recomeça a cada interpret(): vale para tudo o
+        // que o interpretador mantém alocado.
+        std::uint64_t memoryBytes = 0;
+    };
+
+    // Orçamento de execução consultado nos safepoints. O caminho comum é um
+    // decremento e um desvio quase sempre não tomado (tick()); o caminho
+    // lento roda quando a contagem chega a zero: a cada fatia de
+    // kTimeSlice safepoints com timeout, ou quando o combustível pago acaba.
+    // Ele lê a flag atômica que a thread de vigia liga no prazo e lança
+    // RuntimeError na linha do safepoint.
+    //
+    // Sem limites a contagem começa no máximo de uint64_t e nunca chega a
+    // zero.
+    class ExecutionBudget {
+    public:
+        static constexpr std::uint64_t kTimeSlice = 1024;
+
+        ExecutionBudget() = default;
+        ~ExecutionBudget() { stop(); }
+
+        ExecutionBudget(const ExecutionBudget&) = delete;
+        ExecutionBudget& operator=(const ExecutionBudget&) = delete;
+
+        // Zera o orçamento e, com timeout, começa a vigiar o prazo. Até
+        // stop(), este é o orçamento em execução da thread (running()).
+        void start(const ExecutionLimits& limits);
+        // Para a vigia (se houver). Pode ser chamado mais de uma vez.
+        void stop();
+
+        // Orçamento do interpret() em andamento nesta thread, ou nullptr;
+        // usado pelas funções nativas, que não recebem o Interpreter.
+        static ExecutionBudget* running() { return s_running; }
+
+        // Limites de um isolate criado agora: o mesmo combustível e a mesma
+        // quota de memória, e o tempo que falta até o prazo deste orçamento.
+        ExecutionLimits limitsForChild() const;
+
+        void tick(int line) {
+            if (--m_countdown == 0) refill(line);
+        }
+
+        // Caminho lento do safepoint; lança RuntimeError se um limite estourou.
+        void refill(int line);
+
+        // Para esperas bloqueantes fora dos safepoints (receive()): cada
+        // pausa conta como um safepoint e o prazo é conferido a cada uma.
+        // Retorna a mensagem do limite que estourou, ou uma string vazia.
+        std::string waitTick() {
+            if (m_expired.load(std::memory_order_acquire) || --m_countdown == 0) return exhausted();
+            return {};
+        }
+
+        // Contagem usada diretamente pelo código do JIT (NumericLoop).
+        std::uint64_t* countdown() { return &m_countdown; }
+
+    private:
+        // Paga até uma fatia de combustível; retorna quanto pagou.
+        std::uint64_t take();
+        // Caminho lento sem lançar: a mensagem do limite estourado, ou vazia.
+        std::string exhausted();
+
+        static inline thread_local ExecutionBudget* s_running = nullptr;
+
+        std::uint64_t m_countdown = std::numeric_limits<std::uint64_t>::max();
+        std::uint64_t m_fuelLeft = 0;
+        ExecutionLimits m_limits;
+        std::chrono::steady_clock::time_point m_deadline;
+
+        std::atomic<bool> m_expired{false};
+        std::thread m_watchdog;
+        std::mutex m_mutex;
+        std::condition_variable m_wake;
+        bool m_stopping = false;
+    };
+
+}
@@ -0,0 +1,77 @@
+#include "File.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <system_error>
+#include <unistd.h>
+
+namespace lox {
+
+    static std::system_error fileError(int error, const String& path) {
+        return std::system_error(error, std::generic_category(), std::string(path.data(), path.size()));
+    }
+
+    LoxFile::LoxFile(const String& path) : m_path(path) {
+        int fd = ::open(m_path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) throw fileError(errno, m_path);
+
+        // Só arquivos regulares podem ser mapeados (não pipes nem diretórios).
+        struct stat info;
+        int error = 0;
+        if (fstat(fd, &info) != 0) {
+            error = errno;
+        } else if (S_ISDIR(info.st_mode)) {
+            error = EISDIR;
+        } else if (!S_ISREG(info.st_mode)) {
+            error = EINVAL;
+        }
+        if (error != 0) {
+            ::close(fd);
+            throw fileError(error, m_path);
+        }
+
+        // mmap não aceita tamanho 0: um arquivo vazio fica sem mapeamento.
+        m_length = static_cast<std::size_t>(info.st_size);
+        if (m_length > 0) {
+            void* data = mmap(nullptr, m_length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (data == MAP_FAILED) {
+                error = errno;
+                ::close(fd);
+                throw fileError(error, m_path);
+            }
+            // As linhas são lidas em ordem: o kernel pode ler adiante e
+            // descartar as páginas já percorridas.
+            madvise(data, m_length, MADV_SEQUENTIAL);
+            m_data = static_cast<const char*>(data);
+        }
+        ::close(fd);
+    }
+
+    LoxFile::~LoxFile() {
+        close();
+    }
+
+    bool LoxFile::nextLine(std::string_view& line) {
+        if (m_position >= m_length) return false;
+        const char* start = m_data + m_position;
+        std::size_t remaining = m_length - m_position;
+        auto newline = static_cast<const char*>(std::memchr(start, '\n', remaining));
+        std::size_t length = newline != nullptr ? static_cast<std::size_t>(newline - start) : remaining;
+        m_position += newline != nullptr ? length + 1 : length;
+        if (newline != nullptr && length > 0 && start[length - 1] == '\r') --length;
+        line = std::string_view(start, length);
+        return true;
+    }
+
+    void LoxFile::close() {
+        if (m_data != nullptr) munmap(const_cast<char*>(m_data), m_length);
+        m_data = nullptr;
+        m_length = 0;
+        m_position = 0;
+        m_open = false;
+    }
+
+}
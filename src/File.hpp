@@ -0,0 +1,54 @@
+#pragma once
+
+#include "Heap.hpp"
+#include "Value.hpp"
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+namespace lox {
+
+    // Arquivo aberto por open(), alocado no heap do interpretador: o conteúdo
+    // inteiro mapeado na memória (mmap, só leitura) e um cursor de linhas.
+    // As linhas são views dentro do mapeamento; só viram String (uma cópia)
+    // quando o script pede o texto (readLine). O descritor é fechado logo
+    // depois do mmap, então um arquivo aberto ocupa só espaço de
+    // endereçamento até close() ou até o coletor liberar o objeto. As páginas
+    // mapeadas não são cobradas do MemoryQuota.
+    class LoxFile : public GcObject {
+    public:
+        // Lança std::system_error se o arquivo não puder ser aberto ou mapeado.
+        explicit LoxFile(const String& path);
+        ~LoxFile() override;
+
+        LoxFile(const LoxFile&) = delete;
+        LoxFile& operator=(const LoxFile&) = delete;
+
+        bool isOpen() const { return m_open; }
+        const String& path() const { return m_path; }
+
+        // O arquivo inteiro; vazio depois de close().
+        std::string_view contents() const { return {m_data, m_length}; }
+
+        // Avança para a próxima linha, sem o '\n' (nem o '\r' de um "\r\n").
+        // O '\n' do fim do arquivo não gera uma linha vazia. Retorna false no
+        // fim do arquivo ou depois de close().
+        bool nextLine(std::string_view& line);
+
+        // Desfaz o mapeamento: as views obtidas antes deixam de valer.
+        void close();
+
+        std::string toString() const { return "<file " + std::string(m_path.data(), m_path.size()) + ">"; }
+
+        // Não referencia outros objetos do heap.
+        void trace(Heap&) override {}
+
+    private:
+        String m_path;
+        const char* m_data = nullptr;   // nullptr também para arquivo vazio
+        std::size_t m_length = 0;
+        std::size_t m_position = 0;
+        bool m_open = true;
+    };
+
+}
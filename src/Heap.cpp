@@ -0,0 +1,98 @@
+#include "Heap.hpp"
+#include "Callable.hpp"
+#include "Array.hpp"
+#include "Map.hpp"
+#include "File.hpp"
+
+#include <algorithm>
+#include <chrono>
+
+namespace lox {
+
+    Heap::Heap(GcConfig config, MemoryQuota* quota)
+        : m_config(config),
+          m_quota(quota),
+          m_resource(quota != nullptr ? quota : std::pmr::new_delete_resource()),
+          m_nextCollection(config.initialThreshold) {}
+
+    Heap::~Heap() {
+        GcObject* object = m_objects;
+        while (object != nullptr) {
+            GcObject* next = object->m_next;
+            destroy(object);
+            object = next;
+        }
+    }
+
+    void Heap::destroy(GcObject* object) {
+        std::size_t size = object->m_size;
+        object->~GcObject();
+        m_resource->deallocate(object, size, kObjectAlignment);
+    }
+
+    void Heap::collect(const std::function<void(Heap&)>& markRoots) {
+        auto start = std::chrono::steady_clock::now();
+        std::size_t before = m_bytesAllocated;
+
+        markRoots(*this);
+        traceReferences();
+        sweep();
+
+        m_nextCollection = std::max(
+            m_config.initialThreshold,
+            static_cast<std::size_t>(static_cast<double>(liveBytes()) * m_config.growthFactor));
+
+        if (m_quota != nullptr) m_quotaAfterCollection = m_quota->current();
+
+        std::chrono::duration<double, std::milli> pause = std::chrono::steady_clock::now() - start;
+        m_stats.collections++;
+        m_stats.bytesFreed += before - m_bytesAllocated;
+        m_stats.lastPauseMs = pause.count();
+        m_stats.totalPauseMs += pause.count();
+        m_stats.maxPauseMs = std::max(m_stats.maxPauseMs, pause.count());
+    }
+
+    void Heap::markObject(GcObject* object) {
+        if (object == nullptr || object->m_marked) return;
+        object->m_marked = true;
+        m_grayStack.push_back(object);
+    }
+
+    void Heap::markValue(const Value& value) {
+        if (auto callable = std::get_if<LoxCallable*>(&value)) {
+            markObject(*callable);
+        } else if (auto array = std::get_if<LoxArray*>(&value)) {
+            markObject(*array);
+        } else if (auto map = std::get_if<LoxMap*>(&value)) {
+            markObject(*map);
+        } else if (auto file = std::get_if<LoxFile*>(&value)) {
+            markObject(*file);
+        }
+    }
+
+    void Heap::traceReferences() {
+        while (!m_grayStack.empty()) {
+            GcObject* object = m_grayStack.back();
+            m_grayStack.pop_back();
+            object->trace(*this);
+        }
+    }
+
+    void Heap::sweep() {
+        GcObject** link = &m_objects;
+        while (*link != nullptr) {
+            GcObject* object = *link;
+            if (object->m_marked) {
+                object->m_marked = false;
+                link = &object->m_next;
+                continue;
+            }
+            *link = object->m_next;
+            m_bytesAllocated -= object->m_size;
+            --m_objectCount;
+            m_stats.objectsFreed++;
+            destroy(object);
+        }
+    }
+
+}
@@ -0,0 +1,141 @@
+#pragma once
+
+#include "MemoryQuota.hpp"
+#include "Value.hpp"
+#include <cstddef>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace lox {
+
+    class Heap;
+
+    // Cabeçalho comum a todo objeto gerenciado pelo coletor de lixo.
+    // Os objetos formam uma lista intrusiva (m_next) percorrida na fase de varredura.
+    class GcObject {
+    public:
+        virtual ~GcObject() = default;
+
+        // Marca (via heap.mark*) todos os objetos referenciados por este.
+        virtual void trace(Heap& heap) = 0;
+
+    private:
+        friend class Heap;
+
+        GcObject* m_next = nullptr;
+        std::size_t m_size = 0;
+        bool m_marked = false;
+    };
+
+    // Parâmetros ajustáveis do coletor.
+    struct GcConfig {
+        // Quantidade de bytes alocados antes da primeira coleta.
+        std::size_t initialThreshold = 1024 * 1024;
+        // Após cada coleta, o próximo limite é (bytes vivos * growthFactor).
+        double growthFactor = 2.0;
+        // Coleta em todo safepoint; útil para depurar raízes esquecidas.
+        bool stress = false;
+    };
+
+    // Estatísticas acumuladas das coletas, incluindo os tempos de pausa.
+    struct GcStats {
+        std::size_t collections = 0;
+        std::size_t objectsFreed = 0;
+        std::size_t bytesFreed = 0;
+        double totalPauseMs = 0.0;
+        double maxPauseMs = 0.0;
+        double lastPauseMs = 0.0;
+    };
+
+    // Heap com coleta de lixo por marcação e varredura (mark-and-sweep).
+    // A coleta nunca acontece dentro de make(): quem possui as raízes decide
+    // quando chamar collect(). O Interpreter só coleta nos safepoints entre
+    // statements, onde nenhum valor em avaliação vive fora das raízes (os
+    // ambientes); por isso objetos recém-criados por funções nativas e
+    // valores intermediários de uma expressão não precisam ser registrados
+    // como raízes. Coletar em qualquer outro ponto exigiria raízes para eles.
+    //
+    // Com uma quota, os objetos são alocados nela e o limite da próxima
+    // coleta é medido pelos bytes vivos da quota (liveBytes()), que incluem
+    // o armazenamento de arrays, mapas, strings e ambientes, não só os
+    // cabeçalhos dos objetos: um array que cresce afasta a próxima coleta
+    // em vez de ser percorrido de novo a cada poucos bytes de lixo. A coleta
+    // também é pedida quando o uso da quota passa da metade do que restava
+    // depois da última coleta, para o lixo ser liberado antes de o limite
+    // estourar.
+    class Heap {
+    public:
+        explicit Heap(GcConfig config = {}, MemoryQuota* quota = nullptr);
+        ~Heap();
+
+        Heap(const Heap&) = delete;
+        Heap& operator=(const Heap&) = delete;
+
+        template<typename T, typename... Args>
+        T* make(Args&&... args) {
+            static_assert(alignof(T) <= kObjectAlignment, "objetos do heap usam o alinhamento de max_align_t");
+            void* memory = m_resource->allocate(sizeof(T), kObjectAlignment);
+            T* object;
+            try {
+                object = new (memory) T(std::forward<Args>(args)...);
+            } catch (...) {
+                m_resource->deallocate(memory, sizeof(T), kObjectAlignment);
+                throw;
+            }
+            object->m_size = sizeof(T);
+            object->m_next = m_objects;
+            m_objects = object;
+            m_bytesAllocated += sizeof(T);
+            ++m_objectCount;
+            return object;
+        }
+
+        bool shouldCollect() const {
+            return m_config.stress || liveBytes() > m_nextCollection || underMemoryPressure();
+        }
+
+        // Bytes que contam para o limite de coleta: os da quota, ou só os
+        // objetos do heap quando não há quota.
+        std::size_t liveBytes() const { return m_quota != nullptr ? m_quota->current() : m_bytesAllocated; }
+
+        // Executa uma coleta completa. markRoots deve marcar todas as raízes
+        // externas ao heap.
+        void collect(const std::function<void(Heap&)>& markRoots);
+
+        void markObject(GcObject* object);
+        void markValue(const Value& value);
+
+        const GcConfig& config() const { return m_config; }
+        const GcStats& stats() const { return m_stats; }
+        std::size_t bytesAllocated() const { return m_bytesAllocated; }
+        std::size_t objectCount() const { return m_objectCount; }
+
+    private:
+        static constexpr std::size_t kObjectAlignment = alignof(std::max_align_t);
+
+        bool underMemoryPressure() const {
+            if (m_quota == nullptr || m_quota->limit() == 0) return false;
+            return m_quota->current() > m_quota->limit() / 2 + m_quotaAfterCollection / 2;
+        }
+
+        void traceReferences();
+        void sweep();
+        void destroy(GcObject* object);
+
+        GcConfig m_config;
+        GcStats m_stats;
+        MemoryQuota* m_quota;
+        std::pmr::memory_resource* m_resource;
+        std::size_t m_quotaAfterCollection = 0;
+
+        GcObject* m_objects = nullptr;
+        std::vector<GcObject*> m_grayStack;
+
+        std::size_t m_bytesAllocated = 0;
+        std::size_t m_objectCount = 0;
+        std::size_t m_nextCollection;
+    };
+
+}
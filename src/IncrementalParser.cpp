@@ -0,0 +1,434 @@
+#include "IncrementalParser.hpp"
+
+#include "Parser.hpp"
+#include "Scanner.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <sstream>
+#include <string_view>
+
+namespace lox {
+
+    static std::uint64_t contentHash(const char* data, std::size_t size) {
+        std::uint64_t hash = 1469598103934665603ULL;
+        for (std::size_t i = 0; i < size; ++i) {
+            hash = (hash ^ static_cast<unsigned char>(data[i])) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    static void shiftLines(Stmt& stmt, int delta);
+
+    static void shiftLines(Expr& expr, int delta) {
+        switch (expr.kind) {
+            case ExprKind::ArrayLiteral: {
+                auto& array = static_cast<ArrayLiteral&>(expr);
+                array.bracket.line += delta;
+                for (const auto& element : array.elements) shiftLines(*element, delta);
+                break;
+            }
+            case ExprKind::Assign: {
+                auto& assign = static_cast<Assign&>(expr);
+                assign.name.line += delta;
+                shiftLines(*assign.value, delta);
+                break;
+            }
+            case ExprKind::Binary: {
+                auto& binary = static_cast<Binary&>(expr);
+                binary.op.line += delta;
+                shiftLines(*binary.left, delta);
+                shiftLines(*binary.right, delta);
+                break;
+            }
+            case ExprKind::Call: {
+                auto& call = static_cast<Call&>(expr);
+                call.paren.line += delta;
+                shiftLines(*call.callee, delta);
+                for (const auto& argument : call.arguments) shiftLines(*argument, delta);
+                break;
+            }
+            case ExprKind::Grouping:
+                shiftLines(*static_cast<Grouping&>(expr).expression, delta);
+                break;
+            case ExprKind::Increment: {
+                auto& increment = static_cast<Increment&>(expr);
+                increment.name.line += delta;
+                increment.op.line += delta;
+                break;
+            }
+            case ExprKind::Index: {
+                auto& index = static_cast<Index&>(expr);
+                index.bracket.line += delta;
+                shiftLines(*index.object, delta);
+                shiftLines(*index.index, delta);
+                break;
+            }
+            case ExprKind::IndexSet: {
+                auto& set = static_cast<IndexSet&>(expr);
+                shiftLines(*set.target, delta);
+                shiftLines(*set.value, delta);
+                break;
+            }
+            case ExprKind::Literal:
+                break;
+            case ExprKind::Logical: {
+                auto& logical = static_cast<Logical&>(expr);
+                logical.op.line += delta;
+                shiftLines(*logical.left, delta);
+                shiftLines(*logical.right, delta);
+                break;
+            }
+            case ExprKind::Unary: {
+                auto& unary = static_cast<Unary&>(expr);
+                unary.op.line += delta;
+                shiftLines(*unary.right, delta);
+                break;
+            }
+            case ExprKind::Variable:
+                static_cast<Variable&>(expr).name.line += delta;
+                break;
+        }
+    }
+
+    static void shiftLines(Stmt& stmt, int delta) {
+        stmt.line += delta;
+        switch (stmt.kind) {
+            case StmtKind::Block:
+                for (const auto& inner : static_cast<BlockStmt&>(stmt).statements) {
+                    if (inner) shiftLines(*inner, delta);
+                }
+                break;
+            case StmtKind::Expression:
+                shiftLines(*static_cast<ExpressionStmt&>(stmt).expression, delta);
+                break;
+            case StmtKind::For: {
+                auto& loop = static_cast<ForStmt&>(stmt);
+                if (loop.initializer) shiftLines(*loop.initializer, delta);
+                if (loop.condition) shiftLines(*loop.condition, delta);
+                if (loop.increment) shiftLines(*loop.increment, delta);
+                shiftLines(*loop.body, delta);
+                break;
+            }
+            case StmtKind::If: {
+                auto& branch = static_cast<IfStmt&>(stmt);
+                shiftLines(*branch.condition, delta);
+                shiftLines(*branch.thenBranch, delta);
+                if (branch.elseBranch) shiftLines(*branch.elseBranch, delta);
+                break;
+            }
+            case StmtKind::Print:
+                shiftLines(*static_cast<PrintStmt&>(stmt).expression, delta);
+                break;
+            case StmtKind::Var: {
+                auto& var = static_cast<VarStmt&>(stmt);
+                var.name.line += delta;
+                if (var.initializer) shiftLines(*var.initializer, delta);
+                break;
+            }
+            case StmtKind::While: {
+                auto& loop = static_cast<WhileStmt&>(stmt);
+                shiftLines(*loop.condition, delta);
+                shiftLines(*loop.body, delta);
+                break;
+            }
+        }
+    }
+
+    static bool isIdentifierChar(char c) {
+        return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+    }
+
+    // Pula espaços e comentários a partir de position.
+    static std::size_t skipBlank(const std::string& source, std::size_t position) {
+        while (position < source.size()) {
+            char c = source[position];
+            if (c == ' ' || c == '\t' || c == '\r' || c == '\n') {
+                ++position;
+            } else if (c == '/' && position + 1 < source.size() && source[position + 1] == '/') {
+                while (position < source.size() && source[position] != '\n') ++position;
+            } else {
+                break;
+            }
+        }
+        return position;
+    }
+
+    IncrementalParser::Declaration IncrementalParser::split(const std::string& source, std::size_t begin, int& line) {
+        Declaration declaration;
+        declaration.begin = begin;
+        declaration.line = line;
+        const std::size_t size = source.size();
+        int depth = 0;
+        std::size_t i = begin;
+        while (i < size) {
+            char c = source[i++];
+            switch (c) {
+                case '\n':
+                    line++;
+                    break;
+                case '"':
+                    while (i < size && source[i] != '"') {
+                        if (source[i] == '\n') line++;
+                        ++i;
+                    }
+                    if (i < size) ++i;
+                    break;
+                case '/':
+                    if (i < size && source[i] == '/') {
+                        while (i < size && source[i] != '\n') ++i;
+                    }
+                    break;
+                case '(': case '[': case '{':
+                    depth++;
+                    break;
+                case ')': case ']':
+                    depth--;
+                    break;
+                case '}': case ';': {
+                    if (c == '}') depth--;
+                    if (depth > 0) break;
+                    depth = 0;
+                    // `if (c) a; else b;` e `if (c) { } else { }` continuam
+                    // na mesma declaração.
+                    std::size_t next = skipBlank(source, i);
+                    bool elseFollows = source.compare(next, 4, "else") == 0
+                                       && (next + 4 >= size || !isIdentifierChar(source[next + 4]));
+                    if (elseFollows) break;
+                    // Espaços e comentários no fim do arquivo ficam com a
+                    // última declaração.
+                    declaration.end = next < size ? i : size;
+                    declaration.scanEnd = std::min(next + 5, size + 1);
+                    return declaration;
+                }
+                default:
+                    break;
+            }
+        }
+        declaration.end = size;
+        declaration.scanEnd = size + 1;
+        return declaration;
+    }
+
+    std::vector<std::unique_ptr<Stmt>> IncrementalParser::parse(const std::string& source, Declaration& declaration,
+                                                                std::ostringstream& diagnostics) {
+        std::string text = source.substr(declaration.begin, declaration.end - declaration.begin);
+        auto before = diagnostics.tellp();
+        Scanner scanner(text, declaration.line);
+        TokenStream tokens = scanner.scanTokens();
+        Parser parser(tokens);
+        auto statements = parser.parse();
+
+        declaration.diagnostics.clear();
+        if (diagnostics.tellp() != before) declaration.diagnostics = diagnostics.str().substr(static_cast<std::size_t>(before));
+        declaration.hadError = parser.hadError();
+        declaration.statementCount = statements.size();
+        return statements;
+    }
+
+    // Aponta std::cerr para outro stream até o fim do escopo, mesmo que o
+    // Parser ou uma alocação lance no meio.
+    struct RedirectCerr {
+        std::streambuf* old;
+        explicit RedirectCerr(std::ostream& to) : old(std::cerr.rdbuf(to.rdbuf())) {}
+        ~RedirectCerr() { std::cerr.rdbuf(old); }
+    };
+
+    ReparseStats IncrementalParser::update(std::string source) {
+        auto start = std::chrono::steady_clock::now();
+        ReparseStats stats;
+        const std::string& old = m_source;
+
+        // Scanner e Parser reportam erros em std::cerr; o texto fica com a
+        // declaração e é repetido enquanto ela não mudar.
+        std::ostringstream diagnostics;
+        RedirectCerr redirect(diagnostics);
+
+        // Região alterada: entre o prefixo e o sufixo comuns.
+        const std::size_t limit = std::min(old.size(), source.size());
+        const std::size_t prefix = static_cast<std::size_t>(
+            std::mismatch(old.begin(), old.begin() + limit, source.begin()).first - old.begin());
+        const std::size_t suffix = static_cast<std::size_t>(
+            std::mismatch(old.rbegin(), old.rbegin() + (limit - prefix), source.rbegin()).first - old.rbegin());
+        const std::size_t oldSuffixStart = old.size() - suffix;
+        const std::size_t newSuffixStart = source.size() - suffix;
+
+        std::vector<Declaration> declarations;
+        std::vector<std::unique_ptr<Stmt>> statements;
+        declarations.reserve(m_declarations.size() + 1);
+        statements.reserve(m_statements.size() + 1);
+        auto moveStatements = [this, &statements](std::size_t from, std::size_t count, int lineDelta) {
+            for (std::size_t i = from; i < from + count; ++i) {
+                if (lineDelta != 0 && m_statements[i]) shiftLines(*m_statements[i], lineDelta);
+                statements.push_back(std::move(m_statements[i]));
+            }
+        };
+
+        // Mantidas: a divisão delas não leu nada da região alterada.
+        std::size_t first = 0;
+        std::size_t oldStatement = 0;
+        while (first < m_declarations.size() && m_declarations[first].scanEnd <= prefix) {
+            moveStatements(oldStatement, m_declarations[first].statementCount, 0);
+            oldStatement += m_declarations[first].statementCount;
+            declarations.push_back(std::move(m_declarations[first]));
+            ++first;
+        }
+
+        // Redivide a partir da primeira declaração afetada até uma fronteira
+        // que também existia na versão anterior, já dentro do sufixo comum.
+        std::size_t position = first < m_declarations.size() ? m_declarations[first].begin : 0;
+        int line = first < m_declarations.size() ? m_declarations[first].line : 1;
+        std::size_t resync = first;
+        bool resynced = false;
+        std::vector<Declaration> changed;
+        while (position < source.size()) {
+            if (position >= newSuffixStart) {
+                std::size_t oldPosition = position - newSuffixStart + oldSuffixStart;
+                while (resync < m_declarations.size() && m_declarations[resync].begin < oldPosition) ++resync;
+                if (resync < m_declarations.size() && m_declarations[resync].begin == oldPosition) {
+                    resynced = true;
+                    break;
+                }
+            }
+            changed.push_back(split(source, position, line));
+            position = changed.back().end;
+        }
+        if (!resynced) resync = m_declarations.size();
+
+        // As declarações antigas da região, pelo hash do texto. Com duas
+        // edições distantes a região cobre quase tudo, e a maior parte
+        // dela volta daqui sem copiar texto.
+        struct Removed {
+            std::uint64_t hash;
+            std::size_t declaration;
+            std::size_t statement;
+            bool taken;
+        };
+        std::vector<Removed> removed;
+        removed.reserve(resync - first);
+        for (std::size_t i = first; i < resync; ++i) {
+            const Declaration& declaration = m_declarations[i];
+            // As que tiveram mensagens são sempre analisadas de novo.
+            if (declaration.diagnostics.empty()) {
+                removed.push_back({contentHash(old.data() + declaration.begin, declaration.end - declaration.begin),
+                                   i, oldStatement, false});
+            }
+            oldStatement += declaration.statementCount;
+        }
+        std::sort(removed.begin(), removed.end(), [](const Removed& a, const Removed& b) {
+            return a.hash != b.hash ? a.hash < b.hash : a.declaration < b.declaration;
+        });
+
+        for (Declaration& declaration : changed) {
+            const char* text = source.data() + declaration.begin;
+            const std::size_t size = declaration.end - declaration.begin;
+            const std::uint64_t hash = contentHash(text, size);
+            const std::string_view view(text, size);
+
+            auto candidate = std::lower_bound(removed.begin(), removed.end(), hash,
+                                              [](const Removed& entry, std::uint64_t key) { return entry.hash < key; });
+            for (; candidate != removed.end() && candidate->hash == hash; ++candidate) {
+                const Declaration& previous = m_declarations[candidate->declaration];
+                if (!candidate->taken
+                    && std::string_view(old).substr(previous.begin, previous.end - previous.begin) == view) {
+                    break;
+                }
+            }
+            if (candidate != removed.end() && candidate->hash == hash) {
+                const Declaration& previous = m_declarations[candidate->declaration];
+                moveStatements(candidate->statement, previous.statementCount, declaration.line - previous.line);
+                declaration.statementCount = previous.statementCount;
+                candidate->taken = true;
+                stats.fromCache++;
+                declarations.push_back(std::move(declaration));
+                continue;
+            }
+
+            auto range = m_cache.equal_range(hash);
+            auto cached = std::find_if(range.first, range.second,
+                                       [view](const auto& entry) { return entry.second.text == view; });
+            if (cached != range.second) {
+                int delta = declaration.line - cached->second.line;
+                for (auto& stmt : cached->second.statements) {
+                    if (delta != 0 && stmt) shiftLines(*stmt, delta);
+                    statements.push_back(std::move(stmt));
+                }
+                declaration.statementCount = cached->second.statements.size();
+                m_cache.erase(cached);
+                stats.fromCache++;
+            } else {
+                auto parsed = parse(source, declaration, diagnostics);
+                statements.insert(statements.end(), std::make_move_iterator(parsed.begin()),
+                                  std::make_move_iterator(parsed.end()));
+                stats.reparsed++;
+            }
+            declarations.push_back(std::move(declaration));
+        }
+
+        // O que não foi reaproveitado fica no cache para as próximas versões
+        // (desfazer, código movido de volta).
+        for (const Removed& entry : removed) {
+            if (entry.taken) continue;
+            const Declaration& previous = m_declarations[entry.declaration];
+            Cached cached{old.substr(previous.begin, previous.end - previous.begin), previous.line, {}};
+            for (std::size_t i = entry.statement; i < entry.statement + previous.statementCount; ++i) {
+                cached.statements.push_back(std::move(m_statements[i]));
+            }
+            m_cache.emplace(entry.hash, std::move(cached));
+        }
+
+        // Mantidas com deslocamento: o texto é o mesmo, só a posição mudou.
+        if (resync < m_declarations.size()) {
+            const std::size_t byteDelta = source.size() - old.size();   // módulo 2^n
+            const int lineDelta = line - m_declarations[resync].line;
+            for (std::size_t i = resync; i < m_declarations.size(); ++i) {
+                Declaration& declaration = m_declarations[i];
+                const std::size_t count = declaration.statementCount;
+                declaration.begin += byteDelta;
+                declaration.end += byteDelta;
+                declaration.scanEnd += byteDelta;
+                declaration.line += lineDelta;
+                if (lineDelta != 0 && !declaration.diagnostics.empty()) {
+                    // As mensagens citam as linhas antigas.
+                    auto parsed = parse(source, declaration, diagnostics);
+                    statements.insert(statements.end(), std::make_move_iterator(parsed.begin()),
+                                      std::make_move_iterator(parsed.end()));
+                    stats.reparsed++;
+                } else {
+                    moveStatements(oldStatement, count, lineDelta);
+                }
+                oldStatement += count;
+                declarations.push_back(std::move(declaration));
+            }
+        }
+
+        // O cache guarda só declarações que saíram do programa (para desfazer
+        // uma edição ou mover código); as atuais estão em declarations. Passou
+        // de kMaxCached, o histórico inteiro é descartado: custa re-analisar
+        // o que voltar depois, nunca o programa atual.
+        if (m_cache.size() > kMaxCached) m_cache.clear();
+
+        m_source = std::move(source);
+        m_declarations = std::move(declarations);
+        m_statements = std::move(statements);
+
+        stats.declarations = m_declarations.size();
+        stats.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return stats;
+    }
+
+    bool IncrementalParser::hadError() const {
+        return std::any_of(m_declarations.begin(), m_declarations.end(),
+                           [](const Declaration& declaration) { return declaration.hadError; });
+    }
+
+    std::string IncrementalParser::diagnostics() const {
+        std::string text;
+        for (const Declaration& declaration : m_declarations) text += declaration.diagnostics;
+        return text;
+    }
+
+}
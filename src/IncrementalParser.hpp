@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ast/Stmt.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lox {
+
+    // Resultado de uma chamada de IncrementalParser::update().
+    struct ReparseStats {
+        std::size_t declarations = 0;   // declarações de topo do programa novo
+        std::size_t reparsed = 0;       // passaram de novo pelo Scanner e Parser
+        std::size_t fromCache = 0;      // achadas no cache pelo hash do conteúdo
+        double milliseconds = 0;
+    };
+
+    // Mantém um programa analisado entre versões sucessivas do mesmo arquivo
+    // (modo --watch). O código-fonte é dividido em declarações de topo; a
+    // cada versão, só as declarações dentro da região alterada são
+    // analisadas de novo:
+    //
+    //   - a região alterada vai do primeiro byte diferente ao início do
+    //     sufixo comum entre a versão anterior e a nova;
+    //   - declarações antes dela são mantidas como estão, e as depois dela
+    //     são mantidas com as linhas deslocadas;
+    //   - as da região são redivididas até reencontrar uma fronteira antiga
+    //     no sufixo. Cada uma é procurada no cache, indexado pelo hash do
+    //     texto (cobre desfazer, código movido e edições em pontos
+    //     distantes); só o que não estiver lá passa pelo Scanner e Parser.
+    //
+    // A divisão olha só para ';' e '}' fora de parênteses, colchetes e
+    // chaves (e um 'else' logo depois). Em um programa sem erros o
+    // resultado é igual ao de analisar o arquivo inteiro; com erros de
+    // sintaxe, a recuperação acontece por declaração e as mensagens podem
+    // diferir.
+    class IncrementalParser {
+    public:
+        ReparseStats update(std::string source);
+
+        // O programa da última versão; pertence ao IncrementalParser.
+        const std::vector<std::unique_ptr<Stmt>>& statements() const { return m_statements; }
+
+        // Verdadeiro se alguma declaração tem erro de sintaxe.
+        bool hadError() const;
+        // Mensagens do Scanner e do Parser, na ordem do arquivo.
+        std::string diagnostics() const;
+
+    private:
+        // Trecho [begin, end) do código-fonte com uma declaração de topo (e
+        // os espaços e comentários antes dela). scanEnd é até onde a divisão
+        // precisou ler para achar o fim; se passa do tamanho do texto, o fim
+        // do arquivo fez parte da decisão.
+        struct Declaration {
+            std::size_t begin = 0;
+            std::size_t end = 0;
+            std::size_t scanEnd = 0;
+            int line = 1;
+            std::size_t statementCount = 0;   // em m_statements
+            bool hadError = false;
+            std::string diagnostics;
+        };
+
+        struct Cached {
+            std::string text;
+            int line;
+            std::vector<std::unique_ptr<Stmt>> statements;
+        };
+
+        static constexpr std::size_t kMaxCached = 4096;
+
+        // Acha a declaração que começa em begin; line entra como a linha de
+        // begin e sai como a linha do fim dela.
+        static Declaration split(const std::string& source, std::size_t begin, int& line);
+        // Passa a declaração pelo Scanner e Parser; as mensagens vão para
+        // diagnostics (que está no lugar de std::cerr) e para a declaração.
+        static std::vector<std::unique_ptr<Stmt>> parse(const std::string& source, Declaration& declaration,
+                                                        std::ostringstream& diagnostics);
+
+        std::string m_source;
+        std::vector<Declaration> m_declarations;
+        std::vector<std::unique_ptr<Stmt>> m_statements;
+        std::unordered_multimap<std::uint64_t, Cached> m_cache;
+    };
+
+}
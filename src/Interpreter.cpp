@@ -2,6 +2,14 @@
 #include "ast/Stmt.hpp"
 #include "ast/Expr.hpp"
 #include "RuntimeError.hpp"
+#include "LineProfiler.hpp"
+#include "SamplingProfiler.hpp"
+#include "Stats.hpp"
+#include "Array.hpp"
+#include "Map.hpp"
+#include "Natives.hpp"
+#include "NumericLoop.hpp"
+#include "ast/FlatAst.hpp"
 
 #include "Interpreter.hpp"
 
@@ -9,6 +17,8 @@
 #include <vector>
 #include <memory>
 #include <any>
+#include <cmath>
+#include <string>
 
 namespace lox {
 
@@ -24,12 +34,102 @@ void checkNumberOperands(const Token& op, const Value& left, const Value& right)
     }
 }
 
-Interpreter::Interpreter() {
-    m_globals = std::make_shared<Environment>();
+static LoxArray& checkArray(const Token& bracket, const Value& value) {
+    if (auto array = std::get_if<LoxArray*>(&value)) return **array;
+    throw RuntimeError(bracket, "Only arrays and maps can be indexed.");
+}
+
+static const Value& checkKey(const Token& bracket, const Value& key) {
+    if (!LoxMap::isValidKey(key)) {
+        throw RuntimeError(bracket, "Map keys must be strings or numbers (not NaN).");
+    }
+    return key;
+}
+
+static std::size_t checkIndex(const Token& bracket, const LoxArray& array, const Value& index) {
+    auto number = std::get_if<double>(&index);
+    if (number == nullptr || std::floor(*number) != *number) {
+        throw RuntimeError(bracket, "Array index must be an integer.");
+    }
+    if (*number < 0 || *number >= static_cast<double>(array.size())) {
+        throw RuntimeError(bracket, "Array index out of range.");
+    }
+    return static_cast<std::size_t>(*number);
+}
+
+// Laço contado: o contador ainda está dentro do limite?
+static bool countedTest(TokenType op, double counter, double bound) {
+    switch (op) {
+        case TokenType::LESS: return counter < bound;
+        case TokenType::LESS_EQUAL: return counter <= bound;
+        case TokenType::GREATER: return counter > bound;
+        default: return counter >= bound;
+    }
+}
+
+// Para o watchdog do timeout ao sair de interpret(), com ou sem erro.
+struct StopWatchdog {
+    ExecutionBudget& budget;
+    ~StopWatchdog() { budget.stop(); }
+};
+
+static void reportRuntimeError(const RuntimeError& error) {
+    std::cerr << "RuntimeError: " << error.what() << "\n[line " << error.token.line << "]" << std::endl;
+}
+
+// Garante que os frames dos profilers são fechados mesmo com RuntimeError.
+struct ProfilerScope {
+    LineProfiler* profiler;
+    SamplingProfiler* sampler;
+    ProfilerScope(LineProfiler* profiler, SamplingProfiler* sampler, StmtKind kind, int line)
+        : profiler(profiler), sampler(sampler) {
+        if (sampler) sampler->stack().push(kind, line);
+        if (profiler) profiler->enter(line);
+    }
+    ~ProfilerScope() {
+        if (profiler) profiler->exit();
+        if (sampler) sampler->stack().pop();
+    }
+};
+
+// Frame da pilha sombra quando só o SamplingProfiler está ativo: um push
+// e um pop inline, sem passar por executeInstrumented.
+struct SampledFrame {
+    ExecutionStack& stack;
+    SampledFrame(ExecutionStack& stack, StmtKind kind, int line) : stack(stack) { stack.push(kind, line); }
+    ~SampledFrame() { stack.pop(); }
+};
+
+Interpreter::Interpreter(GcConfig gcConfig) : m_heap(gcConfig, &m_memory) {
+    MemoryQuota::Scope memory(&m_memory);
+    m_globals = m_heap.make<Environment>();
     m_environment = m_globals;
+    defineNatives(m_heap, *m_globals);
+}
+
+Interpreter::~Interpreter() = default;
+
+void Interpreter::collectGarbage() {
+    m_heap.collect([this](Heap& heap) { markRoots(heap); });
+}
+
+void Interpreter::markRoots(Heap& heap) {
+    heap.markObject(m_globals);
+    heap.markObject(m_environment);
+    for (Environment* environment : m_environmentStack) {
+        heap.markObject(environment);
+    }
 }
 
-void Interpreter::interpret(const std::vector<std::unique_ptr<Stmt>>& statements) {
+bool Interpreter::interpret(const std::vector<std::unique_ptr<Stmt>>& statements) {
+    m_numericLoops.clear();
+    if (m_specialize) {
+        compileNumericLoops(statements, m_numericLoops, m_jit);
+    }
+    m_specializationStats.compiledLoops = m_numericLoops.size();
+    MemoryQuota::Scope memory(&m_memory);
+    m_budget.start(m_limits);
+    StopWatchdog stopWatchdog{m_budget};
     try {
         for (const auto& statement : statements) {
             if (statement) {
@@ -37,30 +137,143 @@ void Interpreter::interpret(const std::vector<std::unique_ptr<Stmt>>& statements
             }
         }
     } catch (const RuntimeError& error) {
-        std::cerr << "RuntimeError: " << error.what() << "\n[line " << error.token.line << "]" << std::endl;
+        reportRuntimeError(error);
+        return false;
     }
+    return true;
 }
 
 Value Interpreter::evaluate(const Expr& expr) {
+    Stats::exprVisit(expr.kind);
     return std::any_cast<Value>(expr.accept(*this));
 }
 
+Value Interpreter::operand(const Expr& expr) {
+    switch (expr.kind) {
+        case ExprKind::Literal:
+            Stats::exprVisit(expr.kind);
+            Stats::valueCopy(static_cast<const Literal&>(expr).value);
+            return static_cast<const Literal&>(expr).value;
+        case ExprKind::Variable: {
+            Stats::exprVisit(expr.kind);
+            const auto& variable = static_cast<const Variable&>(expr);
+            const Value& value = m_environment->get(variable.name, variable.cache);
+            Stats::valueCopy(value);
+            return value;
+        }
+        default:
+            return evaluate(expr);
+    }
+}
+
+bool Interpreter::condition(const Expr& expr) {
+    switch (expr.kind) {
+        case ExprKind::Logical: {
+            Stats::exprVisit(expr.kind);
+            const auto& logical = static_cast<const Logical&>(expr);
+            // O valor de `a or b` é a ou b, e é verdadeiro se um dos dois for.
+            if (logical.op.type == TokenType::OR) {
+                return condition(*logical.left) || condition(*logical.right);
+            }
+            return condition(*logical.left) && condition(*logical.right);
+        }
+        case ExprKind::Binary: {
+            const auto& binary = static_cast<const Binary&>(expr);
+            TokenType op = binary.op.type;
+            if (op != TokenType::LESS && op != TokenType::LESS_EQUAL && op != TokenType::GREATER &&
+                op != TokenType::GREATER_EQUAL && op != TokenType::EQUAL_EQUAL && op != TokenType::BANG_EQUAL) {
+                break;
+            }
+            Stats::exprVisit(expr.kind);
+            Value left = operand(*binary.left);
+            Value right = operand(*binary.right);
+            if (op == TokenType::EQUAL_EQUAL) return valuesEqual(left, right);
+            if (op == TokenType::BANG_EQUAL) return !valuesEqual(left, right);
+            checkNumberOperands(binary.op, left, right);
+            double a = std::get<double>(left);
+            double b = std::get<double>(right);
+            switch (op) {
+                case TokenType::LESS: return a < b;
+                case TokenType::LESS_EQUAL: return a <= b;
+                case TokenType::GREATER: return a > b;
+                default: return a >= b;
+            }
+        }
+        case ExprKind::Unary: {
+            const auto& unary = static_cast<const Unary&>(expr);
+            if (unary.op.type != TokenType::BANG) break;
+            Stats::exprVisit(expr.kind);
+            return !condition(*unary.right);
+        }
+        case ExprKind::Grouping:
+            Stats::exprVisit(expr.kind);
+            return condition(*static_cast<const Grouping&>(expr).expression);
+        default:
+            break;
+    }
+    return isTruthy(operand(expr));
+}
+
 void Interpreter::execute(const Stmt& stmt) {
+    // Safepoint: entre statements nenhum temporário vive fora das raízes.
+    if (m_heap.shouldCollect()) {
+        collectGarbage();
+    }
+    Stats::stmtVisit(stmt.kind);
+    try {
+        if (m_instrumented) {
+            executeInstrumented(stmt);
+            return;
+        }
+        if (m_sampled != nullptr) {
+            SampledFrame frame(*m_sampled, stmt.kind, stmt.line);
+            stmt.accept(*this);
+            return;
+        }
+        stmt.accept(*this);
+    } catch (const MemoryLimitExceeded& error) {
+        // A alocação que passou da quota vira um erro de execução comum, na
+        // linha do statement mais interno.
+        throw RuntimeError(Token(TokenType::END_OF_FILE, "", stmt.line), error.what());
+    }
+}
+
+void Interpreter::setProfiler(LineProfiler* profiler) {
+    m_profiler = profiler;
+    updateInstrumentation();
+}
+
+void Interpreter::setSampler(SamplingProfiler* sampler) {
+    m_sampler = sampler;
+    updateInstrumentation();
+}
+
+// Com o LineProfiler, executeInstrumented cuida dos dois profilers; só com
+// o SamplingProfiler, execute empilha o frame direto em m_sampled.
+void Interpreter::updateInstrumentation() {
+    m_instrumented = m_profiler != nullptr;
+    m_sampled = m_profiler == nullptr && m_sampler != nullptr ? &m_sampler->stack() : nullptr;
+}
+
+void Interpreter::executeInstrumented(const Stmt& stmt) {
+    ProfilerScope scope(m_profiler, m_sampler, stmt.kind, stmt.line);
     stmt.accept(*this);
 }
 
-void Interpreter::executeBlock(const std::vector<std::unique_ptr<Stmt>>& statements, std::shared_ptr<Environment> environment) {
-    std::shared_ptr<Environment> previous = this->m_environment;
+void Interpreter::executeBlock(const std::vector<std::unique_ptr<Stmt>>& statements, Environment* environment) {
+    m_environmentStack.push_back(this->m_environment);
     try {
         this->m_environment = environment;
         for (const auto& statement : statements) {
             execute(*statement);
         }
     } catch (...) {
-        this->m_environment = previous;
+        this->m_environment = m_environmentStack.back();
+        m_environmentStack.pop_back();
         throw;
     }
-    this->m_environment = previous;
+    this->m_environment = m_environmentStack.back();
+    m_environmentStack.pop_back();
 }
 
 bool Interpreter::isTruthy(const Value& value) {
@@ -94,12 +307,91 @@ std::any Interpreter::visitVarStmt(const VarStmt& stmt) {
 }
 
 std::any Interpreter::visitBlockStmt(const BlockStmt& stmt) {
-    executeBlock(stmt.statements, std::make_shared<Environment>(m_environment));
+    m_budget.tick(stmt.line);
+    executeBlock(stmt.statements, m_heap.make<Environment>(m_environment));
+    return Value{std::monostate{}};
+}
+
+std::any Interpreter::visitForStmt(const ForStmt& stmt) {
+    if (runNumericLoop(stmt)) {
+        return Value{std::monostate{}};
+    }
+    // O initializer vive em um escopo do próprio laço, como em um bloco.
+    m_environmentStack.push_back(this->m_environment);
+    try {
+        this->m_environment = m_heap.make<Environment>(this->m_environment);
+        if (stmt.initializer != nullptr) {
+            execute(*stmt.initializer);
+        }
+        if (!stmt.counted || !runCountedLoop(stmt)) {
+            while (stmt.condition == nullptr || condition(*stmt.condition)) {
+                execute(*stmt.body);
+                if (stmt.increment != nullptr) {
+                    evaluate(*stmt.increment);
+                }
+                m_budget.tick(stmt.line);
+            }
+        }
+    } catch (...) {
+        this->m_environment = m_environmentStack.back();
+        m_environmentStack.pop_back();
+        throw;
+    }
+    this->m_environment = m_environmentStack.back();
+    m_environmentStack.pop_back();
     return Value{std::monostate{}};
 }
 
+// Laço contado (ver ForStmt::counted): o contador fica em um double local e
+// só é copiado para a variável antes de cada iteração. Condição e incremento
+// não passam pelo visitor; o limite é reavaliado a cada volta, como na forma
+// genérica. Retorna false, sem executar nada, se a variável não começa como
+// número: a forma genérica reporta o erro da comparação.
+bool Interpreter::runCountedLoop(const ForStmt& stmt) {
+    const auto& loop = static_cast<const Binary&>(*stmt.condition);
+    const auto& increment = static_cast<const Increment&>(*stmt.increment);
+    Value& variable = m_environment->getRef(increment.name);
+    auto start = std::get_if<double>(&variable);
+    if (start == nullptr) return false;
+
+    double counter = *start;
+    for (;;) {
+        Value limit = operand(*loop.right);
+        auto bound = std::get_if<double>(&limit);
+        if (bound == nullptr) {
+            throw RuntimeError(loop.op, "Operands must be numbers.");
+        }
+        if (!countedTest(loop.op.type, counter, *bound)) break;
+
+        execute(*stmt.body);
+        counter += increment.step;
+        variable = counter;
+        m_budget.tick(stmt.line);
+    }
+    return true;
+}
+
+// O LineProfiler precisa ver cada statement, então com ele ativo a AST é
+// sempre percorrida. O SamplingProfiler não impede a especialização: o
+// frame do próprio laço já foi empilhado por execute, e as amostras
+// tiradas durante numeric.run caem nele.
+bool Interpreter::runNumericLoop(const Stmt& loop) {
+    if (m_numericLoops.empty() || m_instrumented) return false;
+    auto it = m_numericLoops.find(&loop);
+    if (it == m_numericLoops.end()) return false;
+    NumericLoop& numeric = *it->second;
+    bool wasNative = numeric.isNative();
+    if (!numeric.run(*m_environment, m_budget)) {
+        ++m_specializationStats.deopts;
+        return false;
+    }
+    ++m_specializationStats.runs;
+    if (!wasNative && numeric.isNative()) ++m_specializationStats.nativeLoops;
+    return true;
+}
+
 std::any Interpreter::visitIfStmt(const IfStmt& stmt) {
-    if (isTruthy(evaluate(*stmt.condition))) {
+    if (condition(*stmt.condition)) {
         execute(*stmt.thenBranch);
     } else if (stmt.elseBranch != nullptr) {
         execute(*stmt.elseBranch);
@@ -108,91 +400,473 @@ std::any Interpreter::visitIfStmt(const IfStmt& stmt) {
 }
 
 std::any Interpreter::visitWhileStmt(const WhileStmt& stmt) {
-    while (isTruthy(evaluate(*stmt.condition))) {
+    if (runNumericLoop(stmt)) {
+        return Value{std::monostate{}};
+    }
+    // Safepoints: entrada de bloco e o fim de cada volta (desvio para trás).
+    while (condition(*stmt.condition)) {
         execute(*stmt.body);
+        m_budget.tick(stmt.line);
     }
     return Value{std::monostate{}};
 }
 
+std::any Interpreter::visitArrayLiteralExpr(const ArrayLiteral& expr) {
+    std::vector<Value> elements;
+    elements.reserve(expr.elements.size());
+    for (const auto& element : expr.elements) {
+        elements.push_back(evaluate(*element));
+    }
+    return Value{m_heap.make<LoxArray>(std::move(elements))};
+}
+
+std::any Interpreter::visitIncrementExpr(const Increment& expr) {
+    return increment(expr.name, expr.op, expr.step);
+}
+
+Value Interpreter::increment(const Token& name, const Token& op, double step) {
+    Value& variable = m_environment->getRef(name);
+    auto number = std::get_if<double>(&variable);
+    if (number == nullptr) {
+        // Mesmas mensagens de `name = name + step` e `name = name - step`.
+        throw RuntimeError(op, op.type == TokenType::PLUS
+                                   ? "Operands must be two numbers or two strings."
+                                   : "Operands must be numbers.");
+    }
+    *number += step;
+    return variable;
+}
+
+std::any Interpreter::visitIndexExpr(const Index& expr) {
+    Value object = evaluate(*expr.object);
+    Value index = evaluate(*expr.index);
+    return indexGet(expr.bracket, object, index);
+}
+
+Value Interpreter::indexGet(const Token& bracket, const Value& object, const Value& index) {
+    if (auto map = std::get_if<LoxMap*>(&object)) {
+        // Chave ausente lê nil, como uma variável sem inicializador.
+        const Value* value = (*map)->find(checkKey(bracket, index));
+        return value != nullptr ? *value : Value{std::monostate{}};
+    }
+    LoxArray& array = checkArray(bracket, object);
+    return array.get(checkIndex(bracket, array, index));
+}
+
+std::any Interpreter::visitIndexSetExpr(const IndexSet& expr) {
+    Value object = evaluate(*expr.target->object);
+    Value index = evaluate(*expr.target->index);
+    Value value = evaluate(*expr.value);
+    return indexSet(expr.target->bracket, object, index, value);
+}
+
+Value Interpreter::indexSet(const Token& bracket, const Value& object, const Value& index, const Value& value) {
+    if (auto map = std::get_if<LoxMap*>(&object)) {
+        (*map)->set(checkKey(bracket, index), value);
+        return value;
+    }
+    LoxArray& array = checkArray(bracket, object);
+    array.set(checkIndex(bracket, array, index), value);
+    return value;
+}
+
 std::any Interpreter::visitAssignExpr(const Assign& expr) {
     Value value = evaluate(*expr.value);
-    m_environment->assign(expr.name, value);
+    m_environment->assign(expr.name, value, expr.cache);
     return value;
 }
 
 std::any Interpreter::visitVariableExpr(const Variable& expr) {
-    return m_environment->get(expr.name);
+    const Value& value = m_environment->get(expr.name, expr.cache);
+    Stats::valueCopy(value);
+    return value;
 }
 
 std::any Interpreter::visitLiteralExpr(const Literal& expr) {
+    Stats::valueCopy(expr.value);
     return expr.value;
 }
 
+std::any Interpreter::visitLogicalExpr(const Logical& expr) {
+    Value left = evaluate(*expr.left);
+    if (expr.op.type == TokenType::OR) {
+        if (isTruthy(left)) return left;
+    } else if (!isTruthy(left)) {
+        return left;
+    }
+    return evaluate(*expr.right);
+}
+
 std::any Interpreter::visitGroupingExpr(const Grouping& expr) {
     return evaluate(*expr.expression);
 }
 
 std::any Interpreter::visitUnaryExpr(const Unary& expr) {
     Value right = evaluate(*expr.right);
-    switch (expr.op.type) {
+    return unaryOperation(expr.op.type, expr.op, right);
+}
+
+Value Interpreter::unaryOperation(TokenType op, const Token& token, const Value& right) {
+    switch (op) {
         case TokenType::MINUS:
-            checkNumberOperand(expr.op, right);
+            checkNumberOperand(token, right);
             return Value{-std::get<double>(right)};
         case TokenType::BANG:
             return Value{!isTruthy(right)};
         default:
-            throw RuntimeError(expr.op, "Invalid unary operator.");
+            throw RuntimeError(token, "Invalid unary operator.");
     }
 }
 
 std::any Interpreter::visitBinaryExpr(const Binary& expr) {
     Value left = evaluate(*expr.left);
     Value right = evaluate(*expr.right);
+    return binaryOperation(expr.op.type, expr.op, left, right);
+}
 
-    switch (expr.op.type) {
+Value Interpreter::binaryOperation(TokenType op, const Token& token, const Value& left, const Value& right) {
+    switch (op) {
         case TokenType::GREATER:
-            checkNumberOperands(expr.op, left, right);
+            checkNumberOperands(token, left, right);
             return Value{std::get<double>(left) > std::get<double>(right)};
         case TokenType::GREATER_EQUAL:
-            checkNumberOperands(expr.op, left, right);
+            checkNumberOperands(token, left, right);
             return Value{std::get<double>(left) >= std::get<double>(right)};
         case TokenType::LESS:
-            checkNumberOperands(expr.op, left, right);
+            checkNumberOperands(token, left, right);
             return Value{std::get<double>(left) < std::get<double>(right)};
         case TokenType::LESS_EQUAL:
-            checkNumberOperands(expr.op, left, right);
+            checkNumberOperands(token, left, right);
             return Value{std::get<double>(left) <= std::get<double>(right)};
         case TokenType::BANG_EQUAL:
             return Value{!valuesEqual(left, right)};
         case TokenType::EQUAL_EQUAL:
             return Value{valuesEqual(left, right)};
         case TokenType::MINUS:
-            checkNumberOperands(expr.op, left, right);
+            checkNumberOperands(token, left, right);
             return Value{std::get<double>(left) - std::get<double>(right)};
         case TokenType::SLASH:
-            checkNumberOperands(expr.op, left, right);
+            checkNumberOperands(token, left, right);
             if (std::get<double>(right) == 0.0) {
-                throw RuntimeError(expr.op, "Division by zero.");
+                throw RuntimeError(token, "Division by zero.");
             }
             return Value{std::get<double>(left) / std::get<double>(right)};
         case TokenType::STAR:
-            checkNumberOperands(expr.op, left, right);
+            checkNumberOperands(token, left, right);
             return Value{std::get<double>(left) * std::get<double>(right)};
         case TokenType::PLUS:
             if (std::holds_alternative<double>(left) && std::holds_alternative<double>(right)) {
                 return Value{std::get<double>(left) + std::get<double>(right)};
             }
-            if (std::holds_alternative<std::string>(left) && std::holds_alternative<std::string>(right)) {
-                return Value{std::get<std::string>(left) + std::get<std::string>(right)};
+            if (std::holds_alternative<String>(left) && std::holds_alternative<String>(right)) {
+                return Value{std::get<String>(left) + std::get<String>(right)};
             }
-            throw RuntimeError(expr.op, "Operands must be two numbers or two strings.");
+            throw RuntimeError(token, "Operands must be two numbers or two strings.");
         default:
-            throw RuntimeError(expr.op, "Invalid binary operator.");
+            throw RuntimeError(token, "Invalid binary operator.");
     }
 }
 
 std::any Interpreter::visitCallExpr(const Call& expr) {
-    throw RuntimeError(expr.paren, "Can only call functions and classes.");
+    Value callee = evaluate(*expr.callee);
+
+    std::vector<Value> arguments;
+    arguments.reserve(expr.arguments.size());
+    for (const auto& argument : expr.arguments) {
+        arguments.push_back(evaluate(*argument));
+    }
+
+    return callValue(expr.paren, callee, arguments);
+}
+
+Value Interpreter::callValue(const Token& paren, const Value& callee, const std::vector<Value>& arguments) {
+    auto function = std::get_if<LoxCallable*>(&callee);
+    if (function == nullptr) {
+        throw RuntimeError(paren, "Can only call functions and classes.");
+    }
+    if (static_cast<int>(arguments.size()) != (*function)->arity()) {
+        throw RuntimeError(paren, "Expected " + std::to_string((*function)->arity()) +
+                                  " arguments but got " + std::to_string(arguments.size()) + ".");
+    }
+
+    try {
+        return (*function)->call(*this, arguments);
+    } catch (const NativeError& error) {
+        throw RuntimeError(paren, error.what());
+    }
+}
+
+// --- Execução da FlatAst ---
+
+bool Interpreter::interpret(const FlatAst& program) {
+    // Os laços especializados são indexados pelos nós da árvore.
+    m_numericLoops.clear();
+    m_specializationStats.compiledLoops = 0;
+    MemoryQuota::Scope memory(&m_memory);
+    m_budget.start(m_limits);
+    StopWatchdog stopWatchdog{m_budget};
+    try {
+        for (NodeIndex statement : program.statements) {
+            execute(program, statement);
+        }
+    } catch (const RuntimeError& error) {
+        reportRuntimeError(error);
+        return false;
+    }
+    return true;
+}
+
+void Interpreter::execute(const FlatAst& ast, NodeIndex index) {
+    if (m_heap.shouldCollect()) {
+        collectGarbage();
+    }
+    const FlatNode& node = ast.nodes[index];
+    Stats::stmtVisit(stmtKind(node.tag));
+    try {
+        if (m_instrumented) {
+            ProfilerScope scope(m_profiler, m_sampler, stmtKind(node.tag), node.line);
+            executeNode(ast, node);
+            return;
+        }
+        if (m_sampled != nullptr) {
+            SampledFrame frame(*m_sampled, stmtKind(node.tag), node.line);
+            executeNode(ast, node);
+            return;
+        }
+        executeNode(ast, node);
+    } catch (const MemoryLimitExceeded& error) {
+        throw RuntimeError(Token(TokenType::END_OF_FILE, "", node.line), error.what());
+    }
 }
 
-}
\ No newline at end of file
+void Interpreter::executeNode(const FlatAst& ast, const FlatNode& node) {
+    switch (node.tag) {
+        case FlatTag::Block:
+            m_budget.tick(node.line);
+            executeBlock(ast, node, m_heap.make<Environment>(m_environment));
+            break;
+        case FlatTag::Expression:
+            evaluate(ast, node.a);
+            break;
+        case FlatTag::For:
+            executeFor(ast, node);
+            break;
+        case FlatTag::If:
+            if (condition(ast, node.a)) {
+                execute(ast, node.b);
+            } else if (node.c != kNoNode) {
+                execute(ast, node.c);
+            }
+            break;
+        case FlatTag::Print: {
+            Value value = evaluate(ast, node.a);
+            std::cout << valueToString(value) << std::endl;
+            break;
+        }
+        case FlatTag::Var: {
+            Value value = std::monostate{};
+            if (node.a != kNoNode) {
+                value = evaluate(ast, node.a);
+            }
+            m_environment->define(ast.tokens[node.data].lexeme, value);
+            break;
+        }
+        case FlatTag::While:
+            while (condition(ast, node.a)) {
+                execute(ast, node.b);
+                m_budget.tick(node.line);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+void Interpreter::executeBlock(const FlatAst& ast, const FlatNode& block, Environment* environment) {
+    m_environmentStack.push_back(this->m_environment);
+    try {
+        this->m_environment = environment;
+        const NodeIndex* statements = ast.list(block.a);
+        for (std::uint32_t i = 0; i < block.b; ++i) {
+            execute(ast, statements[i]);
+        }
+    } catch (...) {
+        this->m_environment = m_environmentStack.back();
+        m_environmentStack.pop_back();
+        throw;
+    }
+    this->m_environment = m_environmentStack.back();
+    m_environmentStack.pop_back();
+}
+
+void Interpreter::executeFor(const FlatAst& ast, const FlatNode& loop) {
+    m_environmentStack.push_back(this->m_environment);
+    try {
+        this->m_environment = m_heap.make<Environment>(this->m_environment);
+        if (loop.a != kNoNode) {
+            execute(ast, loop.a);
+        }
+        if (!loop.counted || !runCountedLoop(ast, loop)) {
+            while (loop.b == kNoNode || condition(ast, loop.b)) {
+                execute(ast, loop.data);
+                if (loop.c != kNoNode) {
+                    evaluate(ast, loop.c);
+                }
+                m_budget.tick(loop.line);
+            }
+        }
+    } catch (...) {
+        this->m_environment = m_environmentStack.back();
+        m_environmentStack.pop_back();
+        throw;
+    }
+    this->m_environment = m_environmentStack.back();
+    m_environmentStack.pop_back();
+}
+
+// Mesmo caminho de runCountedLoop(const ForStmt&).
+bool Interpreter::runCountedLoop(const FlatAst& ast, const FlatNode& loop) {
+    const FlatNode& test = ast.nodes[loop.b];
+    const FlatNode& increment = ast.nodes[loop.c];
+    Value& variable = m_environment->getRef(ast.tokens[increment.data]);
+    auto start = std::get_if<double>(&variable);
+    if (start == nullptr) return false;
+
+    double step = std::get<double>(ast.constants[increment.b]);
+    double counter = *start;
+    for (;;) {
+        Value limit = evaluate(ast, test.b);
+        auto bound = std::get_if<double>(&limit);
+        if (bound == nullptr) {
+            throw RuntimeError(ast.tokens[test.data], "Operands must be numbers.");
+        }
+        if (!countedTest(test.op, counter, *bound)) break;
+
+        execute(ast, loop.data);
+        counter += step;
+        variable = counter;
+        m_budget.tick(loop.line);
+    }
+    return true;
+}
+
+bool Interpreter::condition(const FlatAst& ast, NodeIndex index) {
+    const FlatNode& node = ast.nodes[index];
+    switch (node.tag) {
+        case FlatTag::Logical:
+            Stats::exprVisit(ExprKind::Logical);
+            if (node.op == TokenType::OR) {
+                return condition(ast, node.a) || condition(ast, node.b);
+            }
+            return condition(ast, node.a) && condition(ast, node.b);
+        case FlatTag::Binary: {
+            TokenType op = node.op;
+            if (op != TokenType::LESS && op != TokenType::LESS_EQUAL && op != TokenType::GREATER &&
+                op != TokenType::GREATER_EQUAL && op != TokenType::EQUAL_EQUAL && op != TokenType::BANG_EQUAL) {
+                break;
+            }
+            Stats::exprVisit(ExprKind::Binary);
+            Value left = evaluate(ast, node.a);
+            Value right = evaluate(ast, node.b);
+            if (op == TokenType::EQUAL_EQUAL) return valuesEqual(left, right);
+            if (op == TokenType::BANG_EQUAL) return !valuesEqual(left, right);
+            checkNumberOperands(ast.tokens[node.data], left, right);
+            double a = std::get<double>(left);
+            double b = std::get<double>(right);
+            switch (op) {
+                case TokenType::LESS: return a < b;
+                case TokenType::LESS_EQUAL: return a <= b;
+                case TokenType::GREATER: return a > b;
+                default: return a >= b;
+            }
+        }
+        case FlatTag::Unary:
+            if (node.op != TokenType::BANG) break;
+            Stats::exprVisit(ExprKind::Unary);
+            return !condition(ast, node.a);
+        case FlatTag::Grouping:
+            Stats::exprVisit(ExprKind::Grouping);
+            return condition(ast, node.a);
+        default:
+            break;
+    }
+    return isTruthy(evaluate(ast, index));
+}
+
+Value Interpreter::evaluate(const FlatAst& ast, NodeIndex index) {
+    const FlatNode& node = ast.nodes[index];
+    Stats::exprVisit(exprKind(node.tag));
+    switch (node.tag) {
+        case FlatTag::ArrayLiteral: {
+            std::vector<Value> elements;
+            elements.reserve(node.b);
+            const NodeIndex* children = ast.list(node.a);
+            for (std::uint32_t i = 0; i < node.b; ++i) {
+                elements.push_back(evaluate(ast, children[i]));
+            }
+            return Value{m_heap.make<LoxArray>(std::move(elements))};
+        }
+        case FlatTag::Assign: {
+            Value value = evaluate(ast, node.a);
+            m_environment->assign(ast.tokens[node.data], value, ast.globalCaches[node.b]);
+            return value;
+        }
+        case FlatTag::Binary: {
+            Value left = evaluate(ast, node.a);
+            Value right = evaluate(ast, node.b);
+            return binaryOperation(node.op, ast.tokens[node.data], left, right);
+        }
+        case FlatTag::Call: {
+            Value callee = evaluate(ast, node.a);
+            std::vector<Value> arguments;
+            arguments.reserve(node.c);
+            const NodeIndex* children = ast.list(node.b);
+            for (std::uint32_t i = 0; i < node.c; ++i) {
+                arguments.push_back(evaluate(ast, children[i]));
+            }
+            return callValue(ast.tokens[node.data], callee, arguments);
+        }
+        case FlatTag::Grouping:
+            return evaluate(ast, node.a);
+        case FlatTag::Increment:
+            return increment(ast.tokens[node.data], ast.tokens[node.a], std::get<double>(ast.constants[node.b]));
+        case FlatTag::Index: {
+            Value object = evaluate(ast, node.a);
+            Value key = evaluate(ast, node.b);
+            return indexGet(ast.tokens[node.data], object, key);
+        }
+        case FlatTag::IndexSet: {
+            const FlatNode& target = ast.nodes[node.a];
+            Value object = evaluate(ast, target.a);
+            Value key = evaluate(ast, target.b);
+            Value value = evaluate(ast, node.b);
+            return indexSet(ast.tokens[target.data], object, key, value);
+        }
+        case FlatTag::Literal:
+            Stats::valueCopy(ast.constants[node.data]);
+            return ast.constants[node.data];
+        case FlatTag::Logical: {
+            Value left = evaluate(ast, node.a);
+            if (node.op == TokenType::OR) {
+                if (isTruthy(left)) return left;
+            } else if (!isTruthy(left)) {
+                return left;
+            }
+            return evaluate(ast, node.b);
+        }
+        case FlatTag::Unary: {
+            Value right = evaluate(ast, node.a);
+            return unaryOperation(node.op, ast.tokens[node.data], right);
+        }
+        case FlatTag::Variable: {
+            const Value& value = m_environment->get(ast.tokens[node.data], ast.globalCaches[node.b]);
+            Stats::valueCopy(value);
+            return value;
+        }
+        default:
+            break;
+    }
+    return Value{std::monostate{}};
+}
+
+}
@@ -1,52 +1,129 @@
 #pragma once
 
 #include "Value.hpp"
+#include "Token.hpp"
+#include "Heap.hpp"
+#include "ExecutionLimits.hpp"
+#include "MemoryQuota.hpp"
+#include "NumericLoop.hpp"
 #include "ast/Visitor.hpp"
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <any>
 
-// Forward declaration para a classe Environment no namespace GLOBAL.
-class Environment;
-
 namespace lox {
 
+    class Environment;
+    class LineProfiler;
+    class SamplingProfiler;
+    class ExecutionStack;
+
     // Forward declarations para todos os nós da AST DENTRO do namespace lox.
+    struct Expr;
+    struct Stmt;
+
     // Expressões
+    struct ArrayLiteral;
     struct Assign;
     struct Binary;
     struct Call;
     struct Grouping;
+    struct Increment;
+    struct Index;
+    struct IndexSet;
     struct Literal;
+    struct Logical;
     struct Unary;
     struct Variable;
 
     // Statements
     struct BlockStmt;
     struct ExpressionStmt;
+    struct ForStmt;
     struct IfStmt;
     struct PrintStmt;
     struct VarStmt;
     struct WhileStmt;
 
+    // AST em arrays (ast/FlatAst.hpp)
+    struct FlatAst;
+    struct FlatNode;
+    using NodeIndex = std::uint32_t;
+
     class Interpreter : public Visitor {
     public:
-        Interpreter();
-        void interpret(const std::vector<std::unique_ptr<Stmt>>& statements);
+        explicit Interpreter(GcConfig gcConfig = {});
+        ~Interpreter();
+        // Retorna false se a execução parou por um RuntimeError.
+        bool interpret(const std::vector<std::unique_ptr<Stmt>>& statements);
+
+        // Executa a forma em arrays da AST (flattenAst), com o mesmo
+        // comportamento. Os laços especializados (NumericLoop) são compilados
+        // da árvore e não se aplicam aqui.
+        bool interpret(const FlatAst& program);
+
+        // Força uma coleta completa do heap a partir das raízes do interpretador.
+        void collectGarbage();
+        const Heap& heap() const { return m_heap; }
+        Heap& heap() { return m_heap; }
+
+        // Ativa (ou desativa, com nullptr) o profiler por linha. O profiler não
+        // pertence ao interpretador e deve sobreviver às chamadas de interpret().
+        void setProfiler(LineProfiler* profiler);
+
+        // Mantém a pilha de statements que o profiler por amostragem lê.
+        void setSampler(SamplingProfiler* sampler);
+
+        // Laços especializados para doubles (NumericLoop.hpp), recompilados a
+        // cada interpret(). Ligado por padrão; desligar serve para comparar.
+        void setSpecialization(bool enabled) { m_specialize = enabled; }
+
+        // JIT x86-64 dos laços especializados quentes (JitOptions em
+        // NumericLoop.hpp). Vale a partir do próximo interpret().
+        void setJit(JitOptions options) { m_jit = options; }
+
+        // Combustível e tempo de parede de cada interpret() e quota de memória
+        // do interpretador (ExecutionLimits.hpp). Estourar um limite lança
+        // RuntimeError na linha do laço, bloco ou statement.
+        void setLimits(ExecutionLimits limits) {
+            m_limits = limits;
+            m_memory.setLimit(static_cast<std::size_t>(limits.memoryBytes));
+        }
+
+        // Bytes em uso e pico do que foi cobrado da quota: objetos do heap,
+        // tabelas dos ambientes, strings, arrays e mapas.
+        const MemoryUsage& memoryUsage() const { return m_memory.usage(); }
+
+        struct SpecializationStats {
+            std::size_t compiledLoops = 0;  // no último programa
+            std::size_t runs = 0;           // execuções especializadas
+            std::size_t deopts = 0;         // guardas que falharam (voltou para a AST)
+            std::size_t nativeLoops = 0;    // laços que passaram para código de máquina
+        };
+        const SpecializationStats& specializationStats() const { return m_specializationStats; }
 
         // --- Implementações do Visitor para Expressões ---
         // Todos os métodos de visita agora retornam std::any.
+        std::any visitArrayLiteralExpr(const ArrayLiteral& expr) override;
         std::any visitAssignExpr(const Assign& expr) override;
         std::any visitBinaryExpr(const Binary& expr) override;
         std::any visitCallExpr(const Call& expr) override;
         std::any visitGroupingExpr(const Grouping& expr) override;
+        std::any visitIncrementExpr(const Increment& expr) override;
+        std::any visitIndexExpr(const Index& expr) override;
+        std::any visitIndexSetExpr(const IndexSet& expr) override;
         std::any visitLiteralExpr(const Literal& expr) override;
+        std::any visitLogicalExpr(const Logical& expr) override;
         std::any visitUnaryExpr(const Unary& expr) override;
         std::any visitVariableExpr(const Variable& expr) override;
 
         // --- Implementações do Visitor para Statements ---
         std::any visitBlockStmt(const BlockStmt& stmt) override;
         std::any visitExpressionStmt(const ExpressionStmt& stmt) override;
+        std::any visitForStmt(const ForStmt& stmt) override;
         std::any visitIfStmt(const IfStmt& stmt) override;
         std::any visitPrintStmt(const PrintStmt& stmt) override;
         std::any visitVarStmt(const VarStmt& stmt) override;
@@ -55,19 +132,72 @@ namespace lox {
     private:
         friend class LoxFunction;
 
-        // Ponteiros para os ambientes de escopo.
-        // std::shared_ptr<Environment> agora se refere corretamente à classe no namespace global.
-        std::shared_ptr<Environment> m_globals;
-        std::shared_ptr<Environment> m_environment;
+        // Quota de memória; deve ser destruída depois de tudo o que foi
+        // alocado nela (o heap e os valores dentro dele).
+        MemoryQuota m_memory;
+
+        // Heap de objetos Lox; deve ser destruído depois dos ponteiros abaixo.
+        Heap m_heap;
+
+        // Ponteiros para os ambientes de escopo (objetos do heap).
+        Environment* m_globals;
+        Environment* m_environment;
+
+        // Ambientes suspensos por executeBlock; também são raízes da coleta.
+        std::vector<Environment*> m_environmentStack;
+
+        LineProfiler* m_profiler = nullptr;
+        SamplingProfiler* m_sampler = nullptr;
+        // Verdadeiro com o LineProfiler ativo: cada statement passa por
+        // executeInstrumented e os laços não são especializados.
+        bool m_instrumented = false;
+        // Pilha sombra do SamplingProfiler quando ele é o único ativo.
+        ExecutionStack* m_sampled = nullptr;
+
+        bool m_specialize = true;
+        JitOptions m_jit;
+
+        ExecutionLimits m_limits;
+        ExecutionBudget m_budget;
+        std::unordered_map<const Stmt*, std::unique_ptr<NumericLoop>> m_numericLoops;
+        SpecializationStats m_specializationStats;
 
         // Funções auxiliares para avaliar e executar os nós da árvore.
         Value evaluate(const Expr& expr);
+        // Avalia uma condição (if, while, for) direto para bool: comparações,
+        // and/or, ! e parênteses viram decisões sem Value nem std::any.
+        bool condition(const Expr& expr);
+        // Como evaluate, mas lê literais e variáveis sem passar pelo visitor.
+        Value operand(const Expr& expr);
         void execute(const Stmt& stmt);
-        void executeBlock(const std::vector<std::unique_ptr<Stmt>>& statements, std::shared_ptr<Environment> environment);
+        void executeInstrumented(const Stmt& stmt);
+        void updateInstrumentation();
+        void executeBlock(const std::vector<std::unique_ptr<Stmt>>& statements, Environment* environment);
+        void markRoots(Heap& heap);
+        bool runCountedLoop(const ForStmt& stmt);
+        // Executa a versão especializada do laço, se houver e a guarda passar.
+        bool runNumericLoop(const Stmt& loop);
+
+        // Execução da FlatAst: as mesmas regras dos métodos visit*, com um
+        // switch na tag do nó no lugar do accept virtual.
+        Value evaluate(const FlatAst& ast, NodeIndex index);
+        bool condition(const FlatAst& ast, NodeIndex index);
+        void execute(const FlatAst& ast, NodeIndex index);
+        void executeNode(const FlatAst& ast, const FlatNode& node);
+        void executeBlock(const FlatAst& ast, const FlatNode& block, Environment* environment);
+        void executeFor(const FlatAst& ast, const FlatNode& loop);
+        bool runCountedLoop(const FlatAst& ast, const FlatNode& loop);
 
-        // Funções de apoio à lógica da linguagem.
+        // Funções de apoio à lógica da linguagem, compartilhadas pelas duas
+        // formas da AST. Os tokens só são lidos para as mensagens de erro.
         bool isTruthy(const Value& value);
         bool valuesEqual(const Value& a, const Value& b);
+        Value binaryOperation(TokenType op, const Token& token, const Value& left, const Value& right);
+        Value unaryOperation(TokenType op, const Token& token, const Value& right);
+        Value indexGet(const Token& bracket, const Value& object, const Value& index);
+        Value indexSet(const Token& bracket, const Value& object, const Value& index, const Value& value);
+        Value callValue(const Token& paren, const Value& callee, const std::vector<Value>& arguments);
+        Value increment(const Token& name, const Token& op, double step);
     };
 
 }
\ No newline at end of file
@@ -0,0 +1,295 @@
+#include "Isolate.hpp"
+
+#include "Array.hpp"
+#include "Interpreter.hpp"
+#include "Map.hpp"
+#include "Natives.hpp"
+#include "Parser.hpp"
+#include "Scanner.hpp"
+
+#include <cmath>
+#include <csignal>
+#include <iostream>
+#include <mutex>
+#include <pthread.h>
+#include <unordered_map>
+
+namespace lox {
+
+    // Copia os objetos alcançáveis de um valor para os nós da mensagem; cada
+    // objeto vira um nó só, referenciado por índice. Os nós são preenchidos
+    // a partir de uma pilha explícita de objetos pendentes, não por
+    // recursão, então a profundidade de aninhamento não depende da pilha de
+    // chamadas (materialize também é iterativo).
+    class MessageWriter {
+    public:
+        explicit MessageWriter(Message& message) : m_message(message) {}
+
+        Message::Item root(const Value& value) {
+            Message::Item result = item(value);
+            while (!m_pending.empty()) {
+                Pending pending = m_pending.back();
+                m_pending.pop_back();
+                fill(pending);
+            }
+            return result;
+        }
+
+    private:
+        struct Pending {
+            const GcObject* object;
+            std::uint32_t node;
+        };
+
+        // Itens escalares são copiados; arrays e mapas viram uma referência
+        // ao nó, preenchido depois.
+        Message::Item item(const Value& value) {
+            if (std::holds_alternative<std::monostate>(value)) return std::monostate{};
+            if (auto boolean = std::get_if<bool>(&value)) return *boolean;
+            if (auto number = std::get_if<double>(&value)) return *number;
+            if (auto string = std::get_if<String>(&value)) return std::string(string->data(), string->size());
+            if (auto array = std::get_if<LoxArray*>(&value)) return node(*array, false);
+            if (auto map = std::get_if<LoxMap*>(&value)) return node(*map, true);
+            throw NativeError("send() can only send nil, booleans, numbers, strings, arrays and maps.");
+        }
+
+        Message::Item node(const GcObject* object, bool map) {
+            auto seen = m_nodes.find(object);
+            if (seen != m_nodes.end()) return Message::Ref{seen->second};
+            auto index = static_cast<std::uint32_t>(m_message.m_nodes.size());
+            m_nodes.emplace(object, index);
+            m_message.m_nodes.push_back(Message::Node{map, {}});
+            m_pending.push_back(Pending{object, index});
+            return Message::Ref{index};
+        }
+
+        void fill(const Pending& pending) {
+            // item() pode acrescentar nós; a referência ao nó não sobreviveria.
+            std::vector<Message::Item> items;
+            if (m_message.m_nodes[pending.node].map) {
+                const auto& map = static_cast<const LoxMap&>(*pending.object);
+                items.reserve(map.size() * 2);
+                map.forEach([this, &items](const Value& key, const Value& entry) {
+                    items.push_back(item(key));
+                    items.push_back(item(entry));
+                });
+            } else {
+                const auto& array = static_cast<const LoxArray&>(*pending.object);
+                items.reserve(array.size());
+                for (std::size_t i = 0; i < array.size(); ++i) items.push_back(item(array.get(i)));
+            }
+            m_message.m_nodes[pending.node].items = std::move(items);
+        }
+
+        Message& m_message;
+        std::unordered_map<const GcObject*, std::uint32_t> m_nodes;
+        std::vector<Pending> m_pending;
+    };
+
+    Message Message::copy(const Value& value) {
+        Message message;
+        MessageWriter writer(message);
+        message.m_root = writer.root(value);
+        return message;
+    }
+
+    Value Message::materialize(Heap& heap) const {
+        // Primeiro todos os objetos, depois o conteúdo: um nó pode referenciar
+        // outro que ainda não foi preenchido (ciclos).
+        std::vector<Value> objects;
+        objects.reserve(m_nodes.size());
+        for (const Node& node : m_nodes) {
+            if (node.map) {
+                objects.emplace_back(heap.make<LoxMap>());
+            } else {
+                objects.emplace_back(heap.make<LoxArray>());
+            }
+        }
+        auto convert = [&objects](const Item& item) -> Value {
+            if (auto boolean = std::get_if<bool>(&item)) return *boolean;
+            if (auto number = std::get_if<double>(&item)) return *number;
+            if (auto string = std::get_if<std::string>(&item)) return String(*string);
+            if (auto ref = std::get_if<Ref>(&item)) return objects[ref->node];
+            return std::monostate{};
+        };
+        for (std::size_t i = 0; i < m_nodes.size(); ++i) {
+            const std::vector<Item>& items = m_nodes[i].items;
+            if (m_nodes[i].map) {
+                LoxMap& map = *std::get<LoxMap*>(objects[i]);
+                for (std::size_t j = 0; j + 1 < items.size(); j += 2) map.set(convert(items[j]), convert(items[j + 1]));
+            } else {
+                LoxArray& array = *std::get<LoxArray*>(objects[i]);
+                for (const Item& item : items) array.push(convert(item));
+            }
+        }
+        return convert(m_root);
+    }
+
+    bool Mailbox::send(Message& message) {
+        Backoff backoff;
+        while (!m_closed.load(std::memory_order_acquire)) {
+            if (m_queue.tryPush(message)) return true;
+            backoff.pause();
+        }
+        return false;
+    }
+
+    bool Mailbox::receive(Message& out, const std::function<void()>& onWait) {
+        Backoff backoff;
+        for (;;) {
+            if (m_queue.tryPop(out)) return true;
+            // Fechada: ainda entrega o que chegou antes do fechamento.
+            if (m_closed.load(std::memory_order_acquire)) return m_queue.tryPop(out);
+            if (onWait) onWait();
+            backoff.pause();
+        }
+    }
+
+    // Caixas de entrada por id. O mapa só é tocado em spawn, no fim de um
+    // isolate e para achar o destino de send; as mensagens em si passam
+    // pela fila sem locks.
+    namespace {
+        struct Registry {
+            std::mutex mutex;
+            std::unordered_map<Isolate::Id, std::weak_ptr<Mailbox>> mailboxes;
+        };
+
+        Registry& registry() {
+            static Registry instance;
+            return instance;
+        }
+
+        std::atomic<Isolate::Id> g_nextId{0};
+        thread_local std::unique_ptr<Isolate> t_current;
+    }
+
+    Isolate::Isolate(Id id, std::optional<Id> parent, std::shared_ptr<Mailbox> mailbox)
+        : m_id(id), m_parent(parent), m_mailbox(std::move(mailbox)) {
+        std::lock_guard<std::mutex> lock(registry().mutex);
+        registry().mailboxes[m_id] = m_mailbox;
+    }
+
+    Isolate::~Isolate() {
+        m_mailbox->close();
+        {
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            registry().mailboxes.erase(m_id);
+        }
+        for (Child& child : m_children) {
+            child.mailbox->close();
+            child.thread.join();
+        }
+    }
+
+    Isolate& Isolate::current() {
+        if (t_current == nullptr) {
+            t_current.reset(new Isolate(g_nextId++, std::nullopt, std::make_shared<Mailbox>()));
+        }
+        return *t_current;
+    }
+
+    Isolate::Id Isolate::spawn(std::string source, ExecutionLimits limits) {
+        Id id = g_nextId++;
+        auto mailbox = std::make_shared<Mailbox>();
+        {
+            // Registrada já aqui: o pai pode mandar mensagens antes de a
+            // thread começar.
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            registry().mailboxes[id] = mailbox;
+        }
+        // O SIGPROF do SamplingProfiler é do processo inteiro, mas o
+        // tratador lê a pilha do interpretador principal: a thread nasce com
+        // o sinal bloqueado (herda a máscara de quem a cria) para que ele
+        // nunca seja tratado em um isolate.
+        sigset_t profSignal;
+        sigset_t previous;
+        sigemptyset(&profSignal);
+        sigaddset(&profSignal, SIGPROF);
+        pthread_sigmask(SIG_BLOCK, &profSignal, &previous);
+        std::thread thread(&Isolate::run, id, m_id, mailbox, std::move(source), limits);
+        pthread_sigmask(SIG_SETMASK, &previous, nullptr);
+        m_children.push_back(Child{std::move(mailbox), std::move(thread)});
+        return id;
+    }
+
+    void Isolate::run(Id id, Id parent, std::shared_ptr<Mailbox> mailbox, std::string source,
+                      ExecutionLimits limits) {
+        t_current.reset(new Isolate(id, parent, std::move(mailbox)));
+        try {
+            Scanner scanner(source);
+            TokenStream tokens = scanner.scanTokens();
+            Parser parser(tokens);
+            auto statements = parser.parse();
+            if (!parser.hadError()) {
+                Interpreter interpreter;
+                interpreter.setLimits(limits);
+                interpreter.interpret(statements);
+            }
+        } catch (const std::exception& error) {
+            std::cerr << error.what() << std::endl;
+        }
+        // Fecha a caixa e espera os filhos deste isolate.
+        t_current.reset();
+    }
+
+    bool Isolate::send(Id id, Message& message) {
+        std::shared_ptr<Mailbox> mailbox;
+        {
+            std::lock_guard<std::mutex> lock(registry().mutex);
+            auto it = registry().mailboxes.find(id);
+            if (it != registry().mailboxes.end()) mailbox = it->second.lock();
+        }
+        if (mailbox == nullptr) {
+            if (id < g_nextId.load()) return false;
+            throw NativeError("send() to unknown isolate " + std::to_string(id) + ".");
+        }
+        return mailbox->send(message);
+    }
+
+    static Isolate::Id isolateArgument(const char* function, const Value& value) {
+        auto number = std::get_if<double>(&value);
+        if (number == nullptr || *number < 0 || std::floor(*number) != *number || *number > 4294967295.0) {
+            throw NativeError(std::string(function) + "() expects an isolate id.");
+        }
+        return static_cast<Isolate::Id>(*number);
+    }
+
+    Value nativeSpawn(Heap&, const std::vector<Value>& arguments) {
+        auto source = std::get_if<String>(&arguments[0]);
+        if (source == nullptr) throw NativeError("spawn() expects the source code of a script.");
+        // O filho herda os limites de quem o criou: sem isso, um spawn
+        // escaparia de --fuel, --timeout-ms e --mem-limit, e o fim do pai
+        // esperaria por ele sem prazo.
+        ExecutionBudget* budget = ExecutionBudget::running();
+        ExecutionLimits limits = budget != nullptr ? budget->limitsForChild() : ExecutionLimits{};
+        return static_cast<double>(Isolate::current().spawn(std::string(source->data(), source->size()), limits));
+    }
+
+    Value nativeSend(Heap&, const std::vector<Value>& arguments) {
+        Isolate::Id id = isolateArgument("send", arguments[0]);
+        Message message = Message::copy(arguments[1]);
+        return Isolate::send(id, message);
+    }
+
+    Value nativeReceive(Heap& heap, const std::vector<Value>&) {
+        // A espera não passa por safepoints: o orçamento é conferido a cada
+        // pausa, para um receive() sem resposta não escapar dos limites.
+        ExecutionBudget* budget = ExecutionBudget::running();
+        auto checkBudget = [budget] {
+            std::string exhausted = budget->waitTick();
+            if (!exhausted.empty()) throw NativeError(exhausted);
+        };
+        Message message;
+        bool received = budget != nullptr ? Isolate::current().mailbox().receive(message, checkBudget)
+                                          : Isolate::current().mailbox().receive(message);
+        if (!received) return std::monostate{};
+        return message.materialize(heap);
+    }
+
+    Value nativeParent(Heap&, const std::vector<Value>&) {
+        std::optional<Isolate::Id> parent = Isolate::current().parent();
+        if (!parent) return std::monostate{};
+        return static_cast<double>(*parent);
+    }
+
+}
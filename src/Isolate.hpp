@@ -0,0 +1,128 @@
+#pragma once
+
+#include "Channel.hpp"
+#include "ExecutionLimits.hpp"
+#include "Value.hpp"
+#include <atomic>
+#include <functional>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <variant>
+#include <vector>
+
+namespace lox {
+
+    class Heap;
+
+    // Valor em trânsito entre isolates: uma cópia que não aponta para nenhum
+    // heap. Arrays e mapas alcançáveis são copiados uma vez cada (ciclos e
+    // compartilhamento são preservados); funções não podem ser enviadas.
+    class Message {
+    public:
+        Message() = default;
+
+        // Lança NativeError se value alcança algo que não pode ser copiado.
+        static Message copy(const Value& value);
+
+        // Recria o valor (e os objetos) no heap de quem recebe.
+        Value materialize(Heap& heap) const;
+
+    private:
+        struct Ref {
+            std::uint32_t node;
+        };
+        using Item = std::variant<std::monostate, bool, double, std::string, Ref>;
+        struct Node {
+            bool map;
+            std::vector<Item> items;   // elementos, ou chave e valor alternados
+        };
+
+        Item m_root;
+        std::vector<Node> m_nodes;
+
+        friend class MessageWriter;
+    };
+
+    // Caixa de entrada de um isolate: fila limitada sem locks (Channel.hpp)
+    // com espera para a fila cheia (send) e vazia (receive).
+    class Mailbox {
+    public:
+        static constexpr std::size_t kCapacity = 1024;
+
+        Mailbox() : m_queue(kCapacity) {}
+
+        // false se o dono já terminou; a mensagem é descartada.
+        bool send(Message& message);
+        // Espera uma mensagem; false se a caixa foi fechada e está vazia.
+        // onWait é chamada a cada pausa da espera e pode lançar para desistir.
+        bool receive(Message& out, const std::function<void()>& onWait = {});
+        // Nenhuma mensagem nova é aceita e receive() deixa de esperar.
+        void close() { m_closed.store(true, std::memory_order_release); }
+
+    private:
+        BoundedQueue<Message> m_queue;
+        std::atomic<bool> m_closed{false};
+    };
+
+    // Isolate: um Interpreter com globais, heap e quota próprios rodando um
+    // script em uma thread. Nada é compartilhado; a comunicação é por
+    // mensagens copiadas para a caixa de entrada de outro isolate.
+    //
+    // Cada thread que usa spawn/send/receive tem um Isolate corrente. O da
+    // thread principal é criado no primeiro uso; o de um worker é o isolate
+    // que ele executa. Quando o script de um isolate termina, as caixas dos
+    // filhos são fechadas (um receive() esperando o pai retorna nil) e os
+    // filhos são aguardados. Os filhos herdam os limites de execução do
+    // interpretador que os criou (ExecutionBudget::limitsForChild), então
+    // com limites essa espera tem prazo.
+    class Isolate {
+    public:
+        using Id = std::uint32_t;
+
+        static Isolate& current();
+
+        ~Isolate();
+
+        Isolate(const Isolate&) = delete;
+        Isolate& operator=(const Isolate&) = delete;
+
+        Id id() const { return m_id; }
+        std::optional<Id> parent() const { return m_parent; }
+        Mailbox& mailbox() { return *m_mailbox; }
+
+        // Começa um isolate filho executando source com os limites dados;
+        // retorna o id dele.
+        Id spawn(std::string source, ExecutionLimits limits = {});
+
+        // Entrega message ao isolate id; false se ele já terminou. Lança
+        // NativeError se o id nunca existiu.
+        static bool send(Id id, Message& message);
+
+    private:
+        Isolate(Id id, std::optional<Id> parent, std::shared_ptr<Mailbox> mailbox);
+
+        static void run(Id id, Id parent, std::shared_ptr<Mailbox> mailbox, std::string source,
+                        ExecutionLimits limits);
+
+        struct Child {
+            std::shared_ptr<Mailbox> mailbox;
+            std::thread thread;
+        };
+
+        Id m_id;
+        std::optional<Id> m_parent;
+        std::shared_ptr<Mailbox> m_mailbox;
+        std::vector<Child> m_children;
+    };
+
+    // Funções nativas (registradas em Natives.cpp): spawn(source),
+    // send(id, value), receive() e parent().
+    Value nativeSpawn(Heap& heap, const std::vector<Value>& arguments);
+    Value nativeSend(Heap& heap, const std::vector<Value>& arguments);
+    Value nativeReceive(Heap& heap, const std::vector<Value>& arguments);
+    Value nativeParent(Heap& heap, const std::vector<Value>& arguments);
+
+}
@@ -0,0 +1,85 @@
+#include "LineProfiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+namespace lox {
+
+    void LineProfiler::enter(int line) {
+        m_stack.push_back({line, Clock::now(), Clock::duration::zero()});
+        m_active[line]++;
+        m_lines[line].count++;
+    }
+
+    void LineProfiler::exit() {
+        Frame frame = m_stack.back();
+        m_stack.pop_back();
+
+        Clock::duration elapsed = Clock::now() - frame.start;
+        LineStats& stats = m_lines[frame.line];
+        stats.exclusiveNs += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed - frame.children).count();
+        if (--m_active[frame.line] == 0) {
+            stats.inclusiveNs += std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count();
+        }
+        if (!m_stack.empty()) {
+            m_stack.back().children += elapsed;
+        }
+    }
+
+    static std::vector<std::pair<int, LineProfiler::LineStats>> sortedByExclusive(
+        const std::unordered_map<int, LineProfiler::LineStats>& lines) {
+        std::vector<std::pair<int, LineProfiler::LineStats>> sorted(lines.begin(), lines.end());
+        std::sort(sorted.begin(), sorted.end(), [](const auto& a, const auto& b) {
+            if (a.second.exclusiveNs != b.second.exclusiveNs) return a.second.exclusiveNs > b.second.exclusiveNs;
+            return a.first < b.first;
+        });
+        return sorted;
+    }
+
+    static std::vector<std::string> splitLines(const std::string& source) {
+        std::vector<std::string> result;
+        std::istringstream in(source);
+        std::string line;
+        while (std::getline(in, line)) result.push_back(line);
+        return result;
+    }
+
+    void LineProfiler::report(std::ostream& out, const std::string& source, std::size_t limit) const {
+        auto sorted = sortedByExclusive(m_lines);
+        std::vector<std::string> sourceLines = splitLines(source);
+
+        out << "--- Profile (sorted by exclusive time) ---\n";
+        char buffer[128];
+        std::snprintf(buffer, sizeof(buffer), "%6s %12s %14s %14s  %s\n", "line", "count", "incl (ms)", "excl (ms)", "source");
+        out << buffer;
+        for (std::size_t i = 0; i < sorted.size() && i < limit; ++i) {
+            const auto& [line, stats] = sorted[i];
+            std::snprintf(buffer, sizeof(buffer), "%6d %12llu %14.3f %14.3f  ", line,
+                          static_cast<unsigned long long>(stats.count),
+                          stats.inclusiveNs / 1e6, stats.exclusiveNs / 1e6);
+            out << buffer;
+            if (line >= 1 && static_cast<std::size_t>(line) <= sourceLines.size()) {
+                std::string text = sourceLines[line - 1];
+                text.erase(0, text.find_first_not_of(" \t"));
+                out << text;
+            }
+            out << "\n";
+        }
+    }
+
+    void LineProfiler::writeJson(std::ostream& out) const {
+        auto sorted = sortedByExclusive(m_lines);
+        out << "{\"lines\":[";
+        for (std::size_t i = 0; i < sorted.size(); ++i) {
+            const auto& [line, stats] = sorted[i];
+            if (i > 0) out << ",";
+            out << "{\"line\":" << line
+                << ",\"count\":" << stats.count
+                << ",\"inclusive_ns\":" << stats.inclusiveNs
+                << ",\"exclusive_ns\":" << stats.exclusiveNs << "}";
+        }
+        out << "]}\n";
+    }
+
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lox {
+
+    // Profiler por instrumentação: conta execuções e mede o tempo inclusivo
+    // (statement + filhos) e exclusivo (somente o statement) de cada linha.
+    // O Interpreter só chama enter()/exit() quando um profiler está ativo.
+    class LineProfiler {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        struct LineStats {
+            std::uint64_t count = 0;
+            std::uint64_t inclusiveNs = 0;
+            std::uint64_t exclusiveNs = 0;
+        };
+
+        void enter(int line);
+        void exit();
+
+        const std::unordered_map<int, LineStats>& lines() const { return m_lines; }
+
+        // Relatório textual com as linhas mais caras (tempo exclusivo) primeiro.
+        // Se o código-fonte for informado, cada linha é acompanhada do seu texto.
+        void report(std::ostream& out, const std::string& source = "", std::size_t limit = 20) const;
+        void writeJson(std::ostream& out) const;
+
+    private:
+        struct Frame {
+            int line;
+            Clock::time_point start;
+            Clock::duration children;
+        };
+
+        std::vector<Frame> m_stack;
+        std::unordered_map<int, LineStats> m_lines;
+        // Quantas ativações de cada linha estão abertas; evita contar duas vezes
+        // o tempo inclusivo quando statements da mesma linha se aninham.
+        std::unordered_map<int, int> m_active;
+    };
+
+}
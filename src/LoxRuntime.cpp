@@ -0,0 +1,60 @@
+#include "LoxRuntime.hpp"
+
+#include <iostream>
+
+namespace lox::rt {
+
+    void fail(int line, const std::string& message) {
+        throw RuntimeError(Token(TokenType::NIL, "", line), message);
+    }
+
+    Value add(const Value& a, const Value& b, int line) {
+        if (std::holds_alternative<double>(a) && std::holds_alternative<double>(b)) {
+            return std::get<double>(a) + std::get<double>(b);
+        }
+        if (std::holds_alternative<String>(a) && std::holds_alternative<String>(b)) {
+            return std::get<String>(a) + std::get<String>(b);
+        }
+        fail(line, "Operands must be two numbers or two strings.");
+    }
+
+    double increment(Value& variable, double step, bool plus, int line) {
+        auto number = std::get_if<double>(&variable);
+        if (number == nullptr) {
+            fail(line, plus ? "Operands must be two numbers or two strings." : "Operands must be numbers.");
+        }
+        return *number += step;
+    }
+
+    Value undefinedVariable(const char* name, int line) {
+        fail(line, std::string("Undefined variable '") + name + "'.");
+    }
+
+    // A saída fica no buffer de std::cout e é descarregada antes de um erro
+    // e no fim, o que preserva a ordem entre stdout e stderr que o
+    // interpretador (com std::endl) produz.
+    void print(const Value& value) {
+        std::cout << valueToString(value) << '\n';
+    }
+
+    void print(double value) {
+        print(Value{value});
+    }
+
+    void print(bool value) {
+        std::cout << (value ? "true" : "false") << '\n';
+    }
+
+    int run(void (*program)()) {
+        try {
+            program();
+        } catch (const RuntimeError& error) {
+            std::cout.flush();
+            std::cerr << "RuntimeError: " << error.what() << "\n[line " << error.token.line << "]" << std::endl;
+            return 70;
+        }
+        std::cout.flush();
+        return 0;
+    }
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "RuntimeError.hpp"
+#include "Value.hpp"
+#include <string>
+
+// Runtime do C++ gerado por --emit-cpp (CppEmitter.hpp). Os programas
+// gerados incluem só este cabeçalho e ligam com a biblioteca lox_runtime
+// (Value, valueToString, RuntimeError e o que eles usam). Cada função tem a
+// mesma semântica e as mesmas mensagens de erro do Interpreter.
+namespace lox::rt {
+
+    [[noreturn]] void fail(int line, const std::string& message);
+
+    inline bool truthy(bool value) { return value; }
+    inline bool truthy(double) { return true; }
+    inline bool truthy(const Value& value) {
+        if (std::holds_alternative<std::monostate>(value)) return false;
+        if (auto boolean = std::get_if<bool>(&value)) return *boolean;
+        return true;
+    }
+
+    inline bool equal(const Value& a, const Value& b) { return a == b; }
+
+    // Operando de - unário.
+    inline double number(const Value& value, int line) {
+        if (auto n = std::get_if<double>(&value)) return *n;
+        fail(line, "Operand must be a number.");
+    }
+
+    inline double checked(const Value& value, const Value& other, int line) {
+        auto n = std::get_if<double>(&value);
+        if (n == nullptr || !std::holds_alternative<double>(other)) fail(line, "Operands must be numbers.");
+        return *n;
+    }
+
+    inline double subtract(const Value& a, const Value& b, int line) {
+        return checked(a, b, line) - std::get<double>(b);
+    }
+    inline double multiply(const Value& a, const Value& b, int line) {
+        return checked(a, b, line) * std::get<double>(b);
+    }
+    inline double divide(double a, double b, int line) {
+        if (b == 0.0) fail(line, "Division by zero.");
+        return a / b;
+    }
+    inline double divide(const Value& a, const Value& b, int line) {
+        return divide(checked(a, b, line), std::get<double>(b), line);
+    }
+    inline bool less(const Value& a, const Value& b, int line) { return checked(a, b, line) < std::get<double>(b); }
+    inline bool lessEqual(const Value& a, const Value& b, int line) {
+        return checked(a, b, line) <= std::get<double>(b);
+    }
+    inline bool greater(const Value& a, const Value& b, int line) {
+        return checked(a, b, line) > std::get<double>(b);
+    }
+    inline bool greaterEqual(const Value& a, const Value& b, int line) {
+        return checked(a, b, line) >= std::get<double>(b);
+    }
+
+    Value add(const Value& a, const Value& b, int line);
+
+    // Increment (`i = i + k` em laços for) sobre uma variável não numérica.
+    double increment(Value& variable, double step, bool plus, int line);
+
+    // Leitura ou atribuição de um nome sem declaração visível.
+    [[noreturn]] Value undefinedVariable(const char* name, int line);
+
+    void print(const Value& value);
+    void print(double value);
+    void print(bool value);
+
+    // Executa o programa como o lox_cpp: um RuntimeError é impresso em
+    // stderr no mesmo formato e vira o código de saída 70.
+    int run(void (*program)());
+
+}
@@ -0,0 +1,195 @@
+#include "Map.hpp"
+
+#include <cmath>
+#include <cstring>
+#include <functional>
+#include <string_view>
+#include <utility>
+
+namespace lox {
+
+    static constexpr std::uint64_t kLsbs = 0x0101010101010101ULL;
+    static constexpr std::uint64_t kMsbs = 0x8080808080808080ULL;
+
+    // Os 8 bytes de controle de um grupo em um inteiro: o byte i do grupo
+    // ocupa os bits 8i..8i+7, seja qual for a ordem de bytes da máquina.
+    class ControlGroup {
+    public:
+        explicit ControlGroup(const std::uint8_t* control) {
+            std::memcpy(&m_bits, control, sizeof(m_bits));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            m_bits = __builtin_bswap64(m_bits);
+#endif
+        }
+
+        // Bytes iguais a h2 (bit alto de cada byte). Pode dar falso positivo
+        // em um byte vizinho de um acerto verdadeiro; a chave é comparada de
+        // qualquer forma.
+        std::uint64_t match(std::uint8_t h2) const {
+            std::uint64_t x = m_bits ^ (kLsbs * h2);
+            return (x - kLsbs) & ~x & kMsbs;
+        }
+
+        // kEmpty (0x80) tem o bit 1 zerado; kDeleted (0xFE) não.
+        std::uint64_t matchEmpty() const {
+            return m_bits & ~(m_bits << 6) & kMsbs;
+        }
+
+        std::uint64_t matchEmptyOrDeleted() const {
+            return m_bits & ~(m_bits << 7) & kMsbs;
+        }
+
+    private:
+        std::uint64_t m_bits;
+    };
+
+    static inline std::size_t firstByte(std::uint64_t mask) {
+#if defined(__GNUC__) || defined(__clang__)
+        return static_cast<std::size_t>(__builtin_ctzll(mask)) / 8;
+#else
+        std::size_t byte = 0;
+        while ((mask & 0x80) == 0) {
+            mask >>= 8;
+            ++byte;
+        }
+        return byte;
+#endif
+    }
+
+    // Finalizador do MurmurHash3: espalha bits parecidos (números inteiros
+    // próximos, por exemplo) pelo hash inteiro.
+    static inline std::uint64_t mix(std::uint64_t x) {
+        x ^= x >> 33;
+        x *= 0xff51afd7ed558ccdULL;
+        x ^= x >> 33;
+        x *= 0xc4ceb9fe1a85ec53ULL;
+        x ^= x >> 33;
+        return x;
+    }
+
+    static inline std::uint8_t h2Of(std::uint64_t hash) {
+        return static_cast<std::uint8_t>(hash & 0x7F);
+    }
+
+    // Igual a ==, sem passar pelo std::visit do operador do variant.
+    static inline bool sameKey(const Value& a, const Value& b) {
+        if (a.index() != b.index()) return false;
+        if (auto number = std::get_if<double>(&a)) return *number == *std::get_if<double>(&b);
+        return *std::get_if<String>(&a) == *std::get_if<String>(&b);
+    }
+
+    bool LoxMap::isValidKey(const Value& key) {
+        if (auto number = std::get_if<double>(&key)) return !std::isnan(*number);
+        return std::holds_alternative<String>(key);
+    }
+
+    std::uint64_t LoxMap::hashKey(const Value& key) {
+        if (auto number = std::get_if<double>(&key)) {
+            // 0 == -0, então os dois precisam do mesmo hash.
+            double normalized = *number == 0.0 ? 0.0 : *number;
+            std::uint64_t bits;
+            std::memcpy(&bits, &normalized, sizeof(bits));
+            return mix(bits);
+        }
+        const String& string = std::get<String>(key);
+        return mix(std::hash<std::string_view>{}(string) ^ 0x9e3779b97f4a7c15ULL);
+    }
+
+    std::size_t LoxMap::findIndex(const Value& key, std::uint64_t hash) const {
+        if (m_control.empty()) return kNotFound;
+        const std::size_t groupMask = m_control.size() / kGroupWidth - 1;
+        std::size_t group = (hash >> 7) & groupMask;
+        for (std::size_t step = 1;; ++step) {
+            ControlGroup control(&m_control[group * kGroupWidth]);
+            for (std::uint64_t mask = control.match(h2Of(hash)); mask != 0; mask &= mask - 1) {
+                std::size_t index = group * kGroupWidth + firstByte(mask);
+                if (sameKey(m_slots[index].key, key)) return index;
+            }
+            // A tabela sempre mantém slots vazios, então a busca termina.
+            if (control.matchEmpty() != 0) return kNotFound;
+            group = (group + step) & groupMask;
+        }
+    }
+
+    std::size_t LoxMap::findInsertIndex(std::uint64_t hash) const {
+        const std::size_t groupMask = m_control.size() / kGroupWidth - 1;
+        std::size_t group = (hash >> 7) & groupMask;
+        for (std::size_t step = 1;; ++step) {
+            ControlGroup control(&m_control[group * kGroupWidth]);
+            std::uint64_t mask = control.matchEmptyOrDeleted();
+            if (mask != 0) return group * kGroupWidth + firstByte(mask);
+            group = (group + step) & groupMask;
+        }
+    }
+
+    const Value* LoxMap::find(const Value& key) const {
+        if (!isValidKey(key)) return nullptr;
+        std::size_t index = findIndex(key, hashKey(key));
+        return index == kNotFound ? nullptr : &m_slots[index].value;
+    }
+
+    void LoxMap::set(const Value& key, const Value& value) {
+        std::uint64_t hash = hashKey(key);
+        std::size_t index = findIndex(key, hash);
+        if (index != kNotFound) {
+            m_slots[index].value = value;
+            return;
+        }
+
+        if (m_growthLeft == 0) {
+            // Com muitos removidos, um rehash do mesmo tamanho basta para
+            // recuperar os slots.
+            std::size_t capacity = m_control.size();
+            std::size_t maxLoad = capacity - capacity / 8;
+            rehash(capacity == 0 ? kGroupWidth : (m_count + 1 > maxLoad / 2 ? capacity * 2 : capacity));
+        }
+
+        index = findInsertIndex(hash);
+        if (m_control[index] == kEmpty) --m_growthLeft;
+        m_control[index] = h2Of(hash);
+        m_slots[index].key = key;
+        m_slots[index].value = value;
+        ++m_count;
+    }
+
+    bool LoxMap::remove(const Value& key) {
+        if (!isValidKey(key)) return false;
+        std::size_t index = findIndex(key, hashKey(key));
+        if (index == kNotFound) return false;
+
+        // Se o grupo tem um slot vazio, ele nunca ficou cheio: nenhuma busca
+        // passou por ele, e o slot pode voltar a ser vazio em vez de removido.
+        ControlGroup control(&m_control[index / kGroupWidth * kGroupWidth]);
+        if (control.matchEmpty() != 0) {
+            m_control[index] = kEmpty;
+            ++m_growthLeft;
+        } else {
+            m_control[index] = kDeleted;
+        }
+        m_slots[index] = Slot{};
+        --m_count;
+        return true;
+    }
+
+    void LoxMap::rehash(std::size_t capacity) {
+        decltype(m_control) oldControl(capacity, kEmpty);
+        decltype(m_slots) oldSlots(capacity);
+        oldControl.swap(m_control);
+        oldSlots.swap(m_slots);
+        m_growthLeft = capacity - capacity / 8;
+
+        for (std::size_t i = 0; i < oldControl.size(); ++i) {
+            if (!isFull(oldControl[i])) continue;
+            std::uint64_t hash = hashKey(oldSlots[i].key);
+            std::size_t index = findInsertIndex(hash);
+            m_control[index] = h2Of(hash);
+            m_slots[index] = std::move(oldSlots[i]);
+        }
+        m_growthLeft -= m_count;
+    }
+
+    void LoxMap::trace(Heap& heap) {
+        forEach([&heap](const Value&, const Value& value) { heap.markValue(value); });
+    }
+
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include "Heap.hpp"
+#include "Value.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace lox {
+
+    // Mapa Lox (chaves string ou número), alocado no heap do interpretador.
+    //
+    // Tabela hash de endereçamento aberto no estilo Swiss table: um byte de
+    // controle por slot (vazio, removido ou os 7 bits baixos do hash) e os
+    // slots agrupados de 8 em 8. A busca compara os 8 bytes de controle de um
+    // grupo de uma vez (SWAR em um uint64) e só olha as chaves dos slots cujo
+    // byte coincide; um grupo com slot vazio encerra a busca. Os grupos são
+    // sondados em sequência triangular, que percorre todos eles porque a
+    // quantidade é potência de 2.
+    class LoxMap : public GcObject {
+    public:
+        // Strings e números, exceto NaN: como NaN != NaN, uma chave NaN nunca
+        // seria encontrada.
+        static bool isValidKey(const Value& key);
+
+        // Hash coerente com Interpreter::valuesEqual: chaves iguais por ==
+        // (inclusive 0 e -0) têm o mesmo hash.
+        static std::uint64_t hashKey(const Value& key);
+
+        std::size_t size() const { return m_count; }
+        std::size_t capacity() const { return m_control.size(); }
+
+        // Retorna o valor associado à chave ou nullptr.
+        const Value* find(const Value& key) const;
+
+        // Insere ou substitui; key deve ser válida (isValidKey).
+        void set(const Value& key, const Value& value);
+
+        // Remove a chave; retorna false se ela não existia.
+        bool remove(const Value& key);
+
+        // Percorre as entradas na ordem dos slots (não é a ordem de inserção).
+        template<typename Function>
+        void forEach(Function&& function) const {
+            for (std::size_t i = 0; i < m_control.size(); ++i) {
+                if (isFull(m_control[i])) function(m_slots[i].key, m_slots[i].value);
+            }
+        }
+
+        // Marca os valores que são objetos do heap (as chaves nunca são).
+        void trace(Heap& heap) override;
+
+    private:
+        struct Slot {
+            Value key;
+            Value value;
+        };
+
+        static constexpr std::size_t kGroupWidth = 8;
+        static constexpr std::uint8_t kEmpty = 0x80;
+        static constexpr std::uint8_t kDeleted = 0xFE;
+        static constexpr std::size_t kNotFound = static_cast<std::size_t>(-1);
+
+        static bool isFull(std::uint8_t control) { return (control & 0x80) == 0; }
+
+        std::size_t findIndex(const Value& key, std::uint64_t hash) const;
+        std::size_t findInsertIndex(std::uint64_t hash) const;
+        void rehash(std::size_t capacity);
+
+        // Cobrados do MemoryQuota corrente (MemoryQuota.hpp).
+        std::vector<std::uint8_t, QuotaAllocator<std::uint8_t>> m_control;
+        std::vector<Slot, QuotaAllocator<Slot>> m_slots;
+        std::size_t m_count = 0;
+        // Slots vazios que ainda podem ser ocupados antes de um rehash
+        // (carga máxima de 7/8, contando os removidos).
+        std::size_t m_growthLeft = 0;
+    };
+
+}
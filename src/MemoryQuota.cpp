@@ -0,0 +1,30 @@
+#include "MemoryQuota.hpp"
+
+#include <algorithm>
+
+namespace lox {
+
+    MemoryQuota::Scope::Scope(std::pmr::memory_resource* resource) noexcept : m_previous(s_current) {
+        s_current = resource;
+    }
+
+    MemoryQuota::Scope::~Scope() {
+        s_current = m_previous;
+    }
+
+    void* MemoryQuota::do_allocate(std::size_t bytes, std::size_t alignment) {
+        if (m_usage.limit != 0 && bytes > m_usage.limit - std::min(m_usage.current, m_usage.limit)) {
+            throw MemoryLimitExceeded(m_usage.limit);
+        }
+        void* pointer = m_upstream->allocate(bytes, alignment);
+        m_usage.current += bytes;
+        m_usage.peak = std::max(m_usage.peak, m_usage.current);
+        return pointer;
+    }
+
+    void MemoryQuota::do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) {
+        m_upstream->deallocate(pointer, bytes, alignment);
+        m_usage.current -= bytes;
+    }
+
+}
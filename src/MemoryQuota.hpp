@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <string>
+
+namespace lox {
+
+    // Lançada por MemoryQuota quando uma alocação passaria do limite. O
+    // Interpreter a converte em RuntimeError na linha do statement.
+    class MemoryLimitExceeded : public std::bad_alloc {
+    public:
+        explicit MemoryLimitExceeded(std::size_t limit)
+            : m_message("Memory limit exceeded (" + std::to_string(limit) + " bytes).") {}
+
+        const char* what() const noexcept override { return m_message.c_str(); }
+
+    private:
+        std::string m_message;
+    };
+
+    struct MemoryUsage {
+        std::size_t current = 0;
+        std::size_t peak = 0;
+        std::size_t limit = 0;   // 0 = sem limite
+    };
+
+    // Recurso de memória (std::pmr) que conta os bytes de um Interpreter e
+    // recusa o que passar do limite. Repassa a memória para o upstream
+    // (new/delete); a contabilidade é uma soma e uma comparação.
+    //
+    // Cada thread tem um recurso corrente (Scope), que os QuotaAllocator
+    // criados sem recurso explícito usam: é assim que as strings de Value,
+    // as tabelas dos Environment e o armazenamento de arrays e mapas criados
+    // durante Interpreter::interpret() são cobrados do interpretador certo.
+    class MemoryQuota : public std::pmr::memory_resource {
+    public:
+        explicit MemoryQuota(std::size_t limit = 0,
+                             std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+            : m_upstream(upstream) { m_usage.limit = limit; }
+
+        MemoryQuota(const MemoryQuota&) = delete;
+        MemoryQuota& operator=(const MemoryQuota&) = delete;
+
+        // Vale para as próximas alocações; o que já foi alocado fica.
+        void setLimit(std::size_t limit) { m_usage.limit = limit; }
+
+        std::size_t limit() const { return m_usage.limit; }
+        std::size_t current() const { return m_usage.current; }
+        std::size_t peak() const { return m_usage.peak; }
+        const MemoryUsage& usage() const { return m_usage; }
+
+        // Recurso corrente da thread; new/delete fora de qualquer Scope.
+        static std::pmr::memory_resource* currentResource() noexcept {
+            return s_current != nullptr ? s_current : std::pmr::new_delete_resource();
+        }
+
+        // Instala um recurso como corrente enquanto o objeto existir.
+        class Scope {
+        public:
+            explicit Scope(std::pmr::memory_resource* resource) noexcept;
+            ~Scope();
+
+            Scope(const Scope&) = delete;
+            Scope& operator=(const Scope&) = delete;
+
+        private:
+            std::pmr::memory_resource* m_previous;
+        };
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t bytes, std::size_t alignment) override;
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+        // Inline: todo Value string lê o recurso corrente ao ser copiado.
+        static inline thread_local std::pmr::memory_resource* s_current = nullptr;
+
+        std::pmr::memory_resource* m_upstream;
+        MemoryUsage m_usage;
+    };
+
+    // Alocador dos contêineres do interpretador. Ao contrário de
+    // std::pmr::polymorphic_allocator, uma cópia de contêiner é cobrada do
+    // recurso corrente da thread (não do recurso padrão global), e o recurso
+    // acompanha o conteúdo em moves e swaps.
+    template<typename T>
+    class QuotaAllocator {
+    public:
+        using value_type = T;
+        using propagate_on_container_copy_assignment = std::false_type;
+        using propagate_on_container_move_assignment = std::true_type;
+        using propagate_on_container_swap = std::true_type;
+
+        QuotaAllocator() noexcept : m_resource(MemoryQuota::currentResource()) {}
+        explicit QuotaAllocator(std::pmr::memory_resource* resource) noexcept : m_resource(resource) {}
+        template<typename U>
+        QuotaAllocator(const QuotaAllocator<U>& other) noexcept : m_resource(other.resource()) {}
+
+        T* allocate(std::size_t count) {
+            return static_cast<T*>(m_resource->allocate(count * sizeof(T), alignof(T)));
+        }
+        void deallocate(T* pointer, std::size_t count) noexcept {
+            m_resource->deallocate(pointer, count * sizeof(T), alignof(T));
+        }
+
+        QuotaAllocator select_on_container_copy_construction() const { return QuotaAllocator(); }
+
+        std::pmr::memory_resource* resource() const noexcept { return m_resource; }
+
+        template<typename U>
+        bool operator==(const QuotaAllocator<U>& other) const noexcept { return m_resource == other.resource(); }
+        template<typename U>
+        bool operator!=(const QuotaAllocator<U>& other) const noexcept { return m_resource != other.resource(); }
+
+    private:
+        std::pmr::memory_resource* m_resource;
+    };
+
+    // String dos valores Lox.
+    using String = std::basic_string<char, std::char_traits<char>, QuotaAllocator<char>>;
+
+}
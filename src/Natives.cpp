@@ -0,0 +1,304 @@
+#include "Natives.hpp"
+
+#include "Array.hpp"
+#include "ArrayKernels.hpp"
+#include "Environment.hpp"
+#include "File.hpp"
+#include "Interpreter.hpp"
+#include "Isolate.hpp"
+#include "Map.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <system_error>
+#include <utility>
+
+namespace lox {
+
+    Value NativeFunction::call(Interpreter& interpreter, const std::vector<Value>& arguments) {
+        return m_function(interpreter.heap(), arguments);
+    }
+
+    static LoxArray& arrayArgument(const char* function, const Value& value) {
+        if (auto array = std::get_if<LoxArray*>(&value)) return **array;
+        throw NativeError(std::string(function) + "() expects an array.");
+    }
+
+    static LoxMap& mapArgument(const char* function, const Value& value) {
+        if (auto map = std::get_if<LoxMap*>(&value)) return **map;
+        throw NativeError(std::string(function) + "() expects a map.");
+    }
+
+    static LoxFile& fileArgument(const char* function, const Value& value) {
+        auto file = std::get_if<LoxFile*>(&value);
+        if (file == nullptr) throw NativeError(std::string(function) + "() expects a file.");
+        if (!(*file)->isOpen()) throw NativeError(std::string(function) + "() on a closed file.");
+        return **file;
+    }
+
+    static const String& pathArgument(const char* function, const Value& value) {
+        if (auto path = std::get_if<String>(&value)) return *path;
+        throw NativeError(std::string(function) + "() expects a path string.");
+    }
+
+    static const Value& keyArgument(const char* function, const Value& key) {
+        if (LoxMap::isValidKey(key)) return key;
+        throw NativeError(std::string(function) + "() keys must be strings or numbers (not NaN).");
+    }
+
+    static double numberElement(const char* function, const Value& value) {
+        if (auto number = std::get_if<double>(&value)) return *number;
+        throw NativeError(std::string(function) + "() requires an array of numbers.");
+    }
+
+    static Value nativeLen(Heap&, const std::vector<Value>& arguments) {
+        if (auto string = std::get_if<String>(&arguments[0])) {
+            return static_cast<double>(string->size());
+        }
+        if (auto map = std::get_if<LoxMap*>(&arguments[0])) {
+            return static_cast<double>((*map)->size());
+        }
+        return static_cast<double>(arrayArgument("len", arguments[0]).size());
+    }
+
+    static Value nativePush(Heap&, const std::vector<Value>& arguments) {
+        LoxArray& array = arrayArgument("push", arguments[0]);
+        array.push(arguments[1]);
+        return static_cast<double>(array.size());
+    }
+
+    static Value nativeArray(Heap& heap, const std::vector<Value>& arguments) {
+        auto size = std::get_if<double>(&arguments[0]);
+        if (size == nullptr || *size < 0 || std::floor(*size) != *size) {
+            throw NativeError("array() size must be a non-negative integer.");
+        }
+        return heap.make<LoxArray>(static_cast<std::size_t>(*size), arguments[1]);
+    }
+
+    static Value nativeSum(Heap&, const std::vector<Value>& arguments) {
+        const LoxArray& array = arrayArgument("sum", arguments[0]);
+        if (array.isNumeric()) {
+            return sumNumbers(array.numbers().data(), array.size());
+        }
+        double total = 0.0;
+        for (const Value& value : array.values()) total += numberElement("sum", value);
+        return total;
+    }
+
+    template<bool Minimum>
+    static Value extremum(const char* function, const std::vector<Value>& arguments) {
+        const LoxArray& array = arrayArgument(function, arguments[0]);
+        if (array.size() == 0) return std::monostate{};
+        if (array.isNumeric()) {
+            const double* data = array.numbers().data();
+            return Minimum ? minNumbers(data, array.size()) : maxNumbers(data, array.size());
+        }
+        double result = numberElement(function, array.values()[0]);
+        for (const Value& value : array.values()) {
+            double number = numberElement(function, value);
+            result = Minimum ? std::min(result, number) : std::max(result, number);
+        }
+        return result;
+    }
+
+    static Value nativeMin(Heap&, const std::vector<Value>& arguments) {
+        return extremum<true>("min", arguments);
+    }
+
+    static Value nativeMax(Heap&, const std::vector<Value>& arguments) {
+        return extremum<false>("max", arguments);
+    }
+
+    // Arrays genéricos só podem ser ordenados se todos os elementos forem
+    // strings (ou todos números).
+    template<typename T>
+    static bool allOf(const LoxArray::ValueVector& values) {
+        return std::all_of(values.begin(), values.end(),
+                           [](const Value& value) { return std::holds_alternative<T>(value); });
+    }
+
+    // Números com NaN no fim, como sortNumbers: < sozinho não é uma ordem
+    // fraca estrita com NaN, e std::sort exige uma.
+    static bool lessThan(const Value& a, const Value& b) {
+        if (auto number = std::get_if<double>(&a)) {
+            double other = std::get<double>(b);
+            return !std::isnan(*number) && (std::isnan(other) || *number < other);
+        }
+        return std::get<String>(a) < std::get<String>(b);
+    }
+
+    static Value nativeSort(Heap&, const std::vector<Value>& arguments) {
+        LoxArray& array = arrayArgument("sort", arguments[0]);
+        if (array.isNumeric()) {
+            sortNumbers(array.numbers().data(), array.size());
+        } else if (allOf<double>(array.values()) || allOf<String>(array.values())) {
+            std::sort(array.values().begin(), array.values().end(), lessThan);
+        } else {
+            throw NativeError("sort() requires an array of only numbers or only strings.");
+        }
+        return arguments[0];
+    }
+
+    static Value nativeBsearch(Heap&, const std::vector<Value>& arguments) {
+        const LoxArray& array = arrayArgument("bsearch", arguments[0]);
+        const Value& needle = arguments[1];
+        if (array.isNumeric()) {
+            auto number = std::get_if<double>(&needle);
+            if (number == nullptr) return -1.0;
+            return static_cast<double>(searchNumbers(array.numbers().data(), array.size(), *number));
+        }
+
+        const LoxArray::ValueVector& values = array.values();
+        bool comparable = (std::holds_alternative<double>(needle) && allOf<double>(values)) ||
+                          (std::holds_alternative<String>(needle) && allOf<String>(values));
+        if (!comparable) {
+            throw NativeError("bsearch() requires a sorted array of numbers or strings and a value of the same type.");
+        }
+        auto it = std::lower_bound(values.begin(), values.end(), needle, lessThan);
+        if (it != values.end() && *it == needle) return static_cast<double>(it - values.begin());
+        return -1.0;
+    }
+
+    static Value nativeMap(Heap& heap, const std::vector<Value>&) {
+        return heap.make<LoxMap>();
+    }
+
+    static Value nativeHas(Heap&, const std::vector<Value>& arguments) {
+        const LoxMap& map = mapArgument("has", arguments[0]);
+        return map.find(keyArgument("has", arguments[1])) != nullptr;
+    }
+
+    // get(m, k, padrão): útil para contagens, get(m, k, 0) + 1.
+    static Value nativeGet(Heap&, const std::vector<Value>& arguments) {
+        const LoxMap& map = mapArgument("get", arguments[0]);
+        const Value* value = map.find(keyArgument("get", arguments[1]));
+        return value != nullptr ? *value : arguments[2];
+    }
+
+    static Value nativeRemove(Heap&, const std::vector<Value>& arguments) {
+        LoxMap& map = mapArgument("remove", arguments[0]);
+        return map.remove(keyArgument("remove", arguments[1]));
+    }
+
+    template<bool Keys>
+    static Value mapEntries(Heap& heap, const char* function, const std::vector<Value>& arguments) {
+        const LoxMap& map = mapArgument(function, arguments[0]);
+        std::vector<Value> entries;
+        entries.reserve(map.size());
+        map.forEach([&entries](const Value& key, const Value& value) {
+            entries.push_back(Keys ? key : value);
+        });
+        return heap.make<LoxArray>(std::move(entries));
+    }
+
+    static Value nativeKeys(Heap& heap, const std::vector<Value>& arguments) {
+        return mapEntries<true>(heap, "keys", arguments);
+    }
+
+    static Value nativeValues(Heap& heap, const std::vector<Value>& arguments) {
+        return mapEntries<false>(heap, "values", arguments);
+    }
+
+    static Value nativeOpen(Heap& heap, const std::vector<Value>& arguments) {
+        const String& path = pathArgument("open", arguments[0]);
+        try {
+            return heap.make<LoxFile>(path);
+        } catch (const std::system_error& error) {
+            throw NativeError(std::string("open() could not open ") + error.what() + ".");
+        }
+    }
+
+    // Próxima linha como string, ou nil no fim do arquivo.
+    static Value nativeReadLine(Heap&, const std::vector<Value>& arguments) {
+        std::string_view line;
+        if (!fileArgument("readLine", arguments[0]).nextLine(line)) return std::monostate{};
+        return String(line.data(), line.size());
+    }
+
+    // Avança uma linha sem copiá-la e retorna o tamanho dela em bytes, ou nil
+    // no fim do arquivo: contar linhas e bytes não aloca nada.
+    static Value nativeNextLine(Heap&, const std::vector<Value>& arguments) {
+        std::string_view line;
+        if (!fileArgument("nextLine", arguments[0]).nextLine(line)) return std::monostate{};
+        return static_cast<double>(line.size());
+    }
+
+    static Value nativeClose(Heap&, const std::vector<Value>& arguments) {
+        if (auto file = std::get_if<LoxFile*>(&arguments[0])) {
+            (*file)->close();
+            return std::monostate{};
+        }
+        throw NativeError("close() expects a file.");
+    }
+
+    static Value nativeReadFile(Heap&, const std::vector<Value>& arguments) {
+        const String& path = pathArgument("readFile", arguments[0]);
+        try {
+            LoxFile file(path);
+            std::string_view contents = file.contents();
+            return String(contents.data(), contents.size());
+        } catch (const std::system_error& error) {
+            throw NativeError(std::string("readFile() could not open ") + error.what() + ".");
+        }
+    }
+
+    // Como print, mas sem a quebra de linha e sem esvaziar o buffer de
+    // std::cout a cada chamada.
+    static Value nativeWrite(Heap&, const std::vector<Value>& arguments) {
+        if (auto string = std::get_if<String>(&arguments[0])) {
+            std::cout.write(string->data(), static_cast<std::streamsize>(string->size()));
+        } else {
+            std::cout << valueToString(arguments[0]);
+        }
+        return std::monostate{};
+    }
+
+    struct NativeEntry {
+        const char* name;
+        int arity;
+        NativeFunction::Function function;
+    };
+
+    static const NativeEntry natives[] = {
+        {"len", 1, nativeLen},
+        {"push", 2, nativePush},
+        {"array", 2, nativeArray},
+        {"sum", 1, nativeSum},
+        {"min", 1, nativeMin},
+        {"max", 1, nativeMax},
+        {"sort", 1, nativeSort},
+        {"bsearch", 2, nativeBsearch},
+        {"map", 0, nativeMap},
+        {"has", 2, nativeHas},
+        {"get", 3, nativeGet},
+        {"remove", 2, nativeRemove},
+        {"keys", 1, nativeKeys},
+        {"values", 1, nativeValues},
+        {"spawn", 1, nativeSpawn},
+        {"send", 2, nativeSend},
+        {"receive", 0, nativeReceive},
+        {"parent", 0, nativeParent},
+        {"open", 1, nativeOpen},
+        {"readLine", 1, nativeReadLine},
+        {"nextLine", 1, nativeNextLine},
+        {"close", 1, nativeClose},
+        {"readFile", 1, nativeReadFile},
+        {"write", 1, nativeWrite},
+    };
+
+    void defineNatives(Heap& heap, Environment& globals) {
+        for (const NativeEntry& native : natives) {
+            LoxCallable* function = heap.make<NativeFunction>(native.name, native.arity, native.function);
+            globals.define(native.name, function);
+        }
+    }
+
+    bool isNativeName(const std::string& name) {
+        for (const NativeEntry& native : natives) {
+            if (name == native.name) return true;
+        }
+        return false;
+    }
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "Callable.hpp"
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lox {
+
+    class Environment;
+    class Heap;
+
+    // Erro lançado por uma função nativa. O Interpreter o converte em
+    // RuntimeError apontando para a chamada que falhou.
+    class NativeError : public std::runtime_error {
+    public:
+        using std::runtime_error::runtime_error;
+    };
+
+    // Função implementada em C++ e exposta como global.
+    class NativeFunction : public LoxCallable {
+    public:
+        using Function = Value (*)(Heap& heap, const std::vector<Value>& arguments);
+
+        NativeFunction(std::string name, int arity, Function function)
+            : m_name(std::move(name)), m_arity(arity), m_function(function) {}
+
+        Value call(Interpreter& interpreter, const std::vector<Value>& arguments) override;
+        int arity() const override { return m_arity; }
+        std::string toString() const override { return "<native fn " + m_name + ">"; }
+
+    private:
+        std::string m_name;
+        int m_arity;
+        Function m_function;
+    };
+
+    // Define as funções nativas no escopo global: len, push, array, sum, min,
+    // max, sort e bsearch (arrays); map, has, get, remove, keys e values
+    // (mapas); spawn, send, receive e parent (isolates, Isolate.hpp); open,
+    // readLine, nextLine, close e readFile (arquivos, File.hpp) e write.
+    void defineNatives(Heap& heap, Environment& globals);
+
+    // Nome de uma das funções acima (o backend --emit-cpp não as suporta).
+    bool isNativeName(const std::string& name);
+
+}
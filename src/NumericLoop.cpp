@@ -0,0 +1,613 @@
+#include "NumericLoop.hpp"
+
+#include "Environment.hpp"
+#include "ExecutionLimits.hpp"
+#include "RuntimeError.hpp"
+#include "TypeInference.hpp"
+#include "X64Assembler.hpp"
+#include "ast/Expr.hpp"
+
+#include <cstring>
+#include <string>
+#include <utility>
+
+namespace lox {
+
+    // Retorno do código de máquina que chegou ao Halt (os outros valores são
+    // o pc de uma divisão por zero).
+    static constexpr std::uint32_t kNativeDone = 0xFFFFFFFF;
+    // Marca o retorno de um safepoint; o resto é o pc do safepoint.
+    static constexpr std::uint32_t kNativeSafepoint = 0x80000000;
+
+    // Lançada pelo compilador ao encontrar algo que não é numérico.
+    struct NotNumeric {};
+
+    // Traduz um laço para NumericLoop. Cada variável declarada dentro do laço
+    // e cada variável externa ganham um registrador; expressões intermediárias
+    // ganham registradores temporários novos (o programa é pequeno).
+    class NumericCompiler {
+    public:
+        NumericCompiler(NumericLoop& out, const Stmt& loop, const TypeInference& types)
+            : m_out(out), m_loop(loop), m_types(types) {}
+
+        void compileLoop() {
+            statement(m_loop);
+            emit(NumericLoop::Op::Halt, 0, 0, 0);
+        }
+
+    private:
+        using Op = NumericLoop::Op;
+
+        struct Local {
+            std::string name;
+            std::uint32_t reg;
+        };
+
+        // Desvios ainda sem destino.
+        struct Label {
+            std::vector<std::size_t> jumps;
+        };
+
+        std::size_t emit(Op op, std::uint32_t a, std::uint32_t b, std::uint32_t c) {
+            m_out.m_code.push_back(NumericLoop::Instruction{op, a, b, c});
+            return m_out.m_code.size() - 1;
+        }
+
+        void jumpTo(Label& label, Op op, std::uint32_t b, std::uint32_t c) {
+            label.jumps.push_back(emit(op, 0, b, c));
+        }
+
+        void bind(Label& label) {
+            for (std::size_t jump : label.jumps) {
+                m_out.m_code[jump].a = static_cast<std::uint32_t>(m_out.m_code.size());
+            }
+            label.jumps.clear();
+        }
+
+        std::uint32_t newRegister(double initial = 0.0) {
+            m_out.m_registers.push_back(initial);
+            return static_cast<std::uint32_t>(m_out.m_registers.size() - 1);
+        }
+
+        std::uint32_t constant(double value) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            auto it = m_constants.find(bits);
+            if (it != m_constants.end()) return it->second;
+            std::uint32_t reg = newRegister(value);
+            m_constants.emplace(bits, reg);
+            return reg;
+        }
+
+        // Registrador da variável: local do laço (a declaração mais interna
+        // visível neste ponto) ou externa, que precisa ser número na cabeça.
+        std::uint32_t variable(const Token& name, bool write) {
+            for (auto local = m_locals.rbegin(); local != m_locals.rend(); ++local) {
+                if (local->name == name.lexeme) return local->reg;
+            }
+            for (NumericLoop::External& external : m_out.m_externals) {
+                if (external.name.lexeme == name.lexeme) {
+                    external.written = external.written || write;
+                    return external.reg;
+                }
+            }
+            std::optional<StaticType> type = m_types.typeAtLoopHead(m_loop, name.lexeme);
+            if (type.has_value() && *type != StaticType::Number) throw NotNumeric{};
+            std::uint32_t reg = newRegister();
+            m_out.m_externals.push_back(NumericLoop::External{name, reg, write, nullptr});
+            return reg;
+        }
+
+        bool isVariableRegister(std::uint32_t reg) const {
+            for (const Local& local : m_locals) {
+                if (local.reg == reg) return true;
+            }
+            for (const NumericLoop::External& external : m_out.m_externals) {
+                if (external.reg == reg) return true;
+            }
+            return false;
+        }
+
+        static bool writesVariables(const Expr& expr) {
+            switch (expr.kind) {
+                case ExprKind::Assign:
+                case ExprKind::Increment:
+                    return true;
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    return writesVariables(*binary.left) || writesVariables(*binary.right);
+                }
+                case ExprKind::Logical: {
+                    const auto& logical = static_cast<const Logical&>(expr);
+                    return writesVariables(*logical.left) || writesVariables(*logical.right);
+                }
+                case ExprKind::Unary:
+                    return writesVariables(*static_cast<const Unary&>(expr).right);
+                case ExprKind::Grouping:
+                    return writesVariables(*static_cast<const Grouping&>(expr).expression);
+                default:
+                    return false;
+            }
+        }
+
+        // Os dois operandos de uma operação binária. Um operando esquerdo que
+        // é o registrador de uma variável é copiado se o direito pode alterá-la:
+        // `x + (x = 5)` usa o x antigo.
+        std::pair<std::uint32_t, std::uint32_t> operands(const Expr& left, const Expr& right) {
+            std::uint32_t a = value(left);
+            if (writesVariables(right) && isVariableRegister(a)) {
+                std::uint32_t copy = newRegister();
+                emit(Op::Move, copy, a, 0);
+                a = copy;
+            }
+            return {a, value(right)};
+        }
+
+        // Compila uma expressão numérica e retorna o registrador do resultado.
+        // target, se dado, é onde aritmética deve escrever (evita um Move em
+        // `x = x + 1`).
+        std::uint32_t value(const Expr& expr, std::optional<std::uint32_t> target = std::nullopt) {
+            switch (expr.kind) {
+                case ExprKind::Literal: {
+                    auto number = std::get_if<double>(&static_cast<const Literal&>(expr).value);
+                    if (number == nullptr) throw NotNumeric{};
+                    return constant(*number);
+                }
+                case ExprKind::Variable:
+                    return variable(static_cast<const Variable&>(expr).name, false);
+                case ExprKind::Grouping:
+                    return value(*static_cast<const Grouping&>(expr).expression, target);
+                case ExprKind::Assign: {
+                    const auto& assign = static_cast<const Assign&>(expr);
+                    std::uint32_t reg = variable(assign.name, true);
+                    std::uint32_t result = value(*assign.value, reg);
+                    if (result != reg) emit(Op::Move, reg, result, 0);
+                    return reg;
+                }
+                case ExprKind::Increment: {
+                    const auto& increment = static_cast<const Increment&>(expr);
+                    std::uint32_t reg = variable(increment.name, true);
+                    emit(Op::Add, reg, reg, constant(increment.step));
+                    return reg;
+                }
+                case ExprKind::Unary: {
+                    const auto& unary = static_cast<const Unary&>(expr);
+                    if (unary.op.type != TokenType::MINUS) throw NotNumeric{};
+                    std::uint32_t operand = value(*unary.right);
+                    std::uint32_t result = target ? *target : newRegister();
+                    emit(Op::Neg, result, operand, 0);
+                    return result;
+                }
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    Op op;
+                    switch (binary.op.type) {
+                        case TokenType::PLUS: op = Op::Add; break;
+                        case TokenType::MINUS: op = Op::Sub; break;
+                        case TokenType::STAR: op = Op::Mul; break;
+                        case TokenType::SLASH: op = Op::Div; break;
+                        default: throw NotNumeric{};
+                    }
+                    auto [left, right] = operands(*binary.left, *binary.right);
+                    std::uint32_t result = target ? *target : newRegister();
+                    std::size_t pc = emit(op, result, left, right);
+                    if (op == Op::Div) m_out.m_divisions.emplace(pc, binary.op);
+                    return result;
+                }
+                default:
+                    throw NotNumeric{};
+            }
+        }
+
+        static bool comparison(TokenType type, Op& op) {
+            switch (type) {
+                case TokenType::LESS: op = Op::JumpIfLess; break;
+                case TokenType::LESS_EQUAL: op = Op::JumpIfLessEqual; break;
+                case TokenType::GREATER: op = Op::JumpIfGreater; break;
+                case TokenType::GREATER_EQUAL: op = Op::JumpIfGreaterEqual; break;
+                case TokenType::EQUAL_EQUAL: op = Op::JumpIfEqual; break;
+                case TokenType::BANG_EQUAL: op = Op::JumpIfNotEqual; break;
+                default: return false;
+            }
+            return true;
+        }
+
+        // Compila uma condição: desvia para label quando ela tem o valor
+        // jumpIfTrue e segue em frente no caso contrário.
+        void branch(const Expr& expr, bool jumpIfTrue, Label& label) {
+            switch (expr.kind) {
+                case ExprKind::Grouping:
+                    branch(*static_cast<const Grouping&>(expr).expression, jumpIfTrue, label);
+                    return;
+                case ExprKind::Unary: {
+                    const auto& unary = static_cast<const Unary&>(expr);
+                    if (unary.op.type == TokenType::BANG) {
+                        branch(*unary.right, !jumpIfTrue, label);
+                        return;
+                    }
+                    break;
+                }
+                case ExprKind::Literal: {
+                    const Value& literal = static_cast<const Literal&>(expr).value;
+                    bool truthy = true;
+                    if (std::holds_alternative<std::monostate>(literal)) truthy = false;
+                    if (auto boolean = std::get_if<bool>(&literal)) truthy = *boolean;
+                    if (truthy == jumpIfTrue) jumpTo(label, Op::Jump, 0, 0);
+                    return;
+                }
+                case ExprKind::Logical: {
+                    const auto& logical = static_cast<const Logical&>(expr);
+                    bool isOr = logical.op.type == TokenType::OR;
+                    if (isOr == jumpIfTrue) {
+                        // or verdadeiro / and falso: qualquer lado decide.
+                        branch(*logical.left, jumpIfTrue, label);
+                        branch(*logical.right, jumpIfTrue, label);
+                    } else {
+                        Label done;
+                        branch(*logical.left, !jumpIfTrue, done);
+                        branch(*logical.right, jumpIfTrue, label);
+                        bind(done);
+                    }
+                    return;
+                }
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    Op op;
+                    if (comparison(binary.op.type, op)) {
+                        auto [left, right] = operands(*binary.left, *binary.right);
+                        if (jumpIfTrue) {
+                            jumpTo(label, op, left, right);
+                        } else {
+                            // Com NaN toda comparação ordenada é falsa, então
+                            // "não menor" não é "maior ou igual": desvia por
+                            // cima do salto para label.
+                            Label skip;
+                            jumpTo(skip, op, left, right);
+                            jumpTo(label, Op::Jump, 0, 0);
+                            bind(skip);
+                        }
+                        return;
+                    }
+                    break;
+                }
+                default:
+                    break;
+            }
+            // Uma expressão numérica: números são sempre verdadeiros.
+            value(expr);
+            if (jumpIfTrue) jumpTo(label, Op::Jump, 0, 0);
+        }
+
+        void statement(const Stmt& stmt) {
+            switch (stmt.kind) {
+                case StmtKind::Expression:
+                    value(*static_cast<const ExpressionStmt&>(stmt).expression);
+                    return;
+                case StmtKind::Var: {
+                    // O initializer ainda enxerga as declarações anteriores.
+                    const auto& var = static_cast<const VarStmt&>(stmt);
+                    if (var.initializer == nullptr) throw NotNumeric{};
+                    std::uint32_t reg = newRegister();
+                    std::uint32_t result = value(*var.initializer, reg);
+                    if (result != reg) emit(Op::Move, reg, result, 0);
+                    m_locals.push_back(Local{var.name.lexeme, reg});
+                    return;
+                }
+                case StmtKind::Block: {
+                    // Mesmos safepoints da AST: entrada de bloco e desvio
+                    // para trás (com a linha do laço), para o combustível
+                    // acabar no mesmo ponto nos três níveis.
+                    emit(Op::Safepoint, static_cast<std::uint32_t>(stmt.line), 0, 0);
+                    std::size_t scope = m_locals.size();
+                    for (const auto& inner : static_cast<const BlockStmt&>(stmt).statements) {
+                        if (inner == nullptr) throw NotNumeric{};
+                        statement(*inner);
+                    }
+                    m_locals.resize(scope);
+                    return;
+                }
+                case StmtKind::If: {
+                    const auto& branchStmt = static_cast<const IfStmt&>(stmt);
+                    Label otherwise;
+                    branch(*branchStmt.condition, false, otherwise);
+                    statement(*branchStmt.thenBranch);
+                    if (branchStmt.elseBranch != nullptr) {
+                        Label done;
+                        jumpTo(done, Op::Jump, 0, 0);
+                        bind(otherwise);
+                        statement(*branchStmt.elseBranch);
+                        bind(done);
+                    } else {
+                        bind(otherwise);
+                    }
+                    return;
+                }
+                case StmtKind::While: {
+                    const auto& loop = static_cast<const WhileStmt&>(stmt);
+                    std::uint32_t top = static_cast<std::uint32_t>(m_out.m_code.size());
+                    Label exit;
+                    branch(*loop.condition, false, exit);
+                    statement(*loop.body);
+                    emit(Op::Jump, top, static_cast<std::uint32_t>(stmt.line), 0);
+                    bind(exit);
+                    return;
+                }
+                case StmtKind::For: {
+                    const auto& loop = static_cast<const ForStmt&>(stmt);
+                    std::size_t scope = m_locals.size();
+                    if (loop.initializer != nullptr) statement(*loop.initializer);
+                    std::uint32_t top = static_cast<std::uint32_t>(m_out.m_code.size());
+                    Label exit;
+                    if (loop.condition != nullptr) branch(*loop.condition, false, exit);
+                    statement(*loop.body);
+                    if (loop.increment != nullptr) value(*loop.increment);
+                    emit(Op::Jump, top, static_cast<std::uint32_t>(stmt.line), 0);
+                    bind(exit);
+                    m_locals.resize(scope);
+                    return;
+                }
+                default:
+                    throw NotNumeric{};
+            }
+        }
+
+        NumericLoop& m_out;
+        const Stmt& m_loop;
+        const TypeInference& m_types;
+        std::vector<Local> m_locals;
+        std::unordered_map<std::uint64_t, std::uint32_t> m_constants;
+    };
+
+    NumericLoop::NumericLoop() = default;
+    NumericLoop::~NumericLoop() = default;
+
+    std::unique_ptr<NumericLoop> NumericLoop::compile(const Stmt& loop, const TypeInference& types, JitOptions jit) {
+        auto compiled = std::make_unique<NumericLoop>();
+        try {
+            NumericCompiler(*compiled, loop, types).compileLoop();
+        } catch (const NotNumeric&) {
+            return nullptr;
+        }
+        compiled->m_jit = jit;
+        compiled->m_line = loop.line;
+        return compiled;
+    }
+
+    bool NumericLoop::run(Environment& environment, ExecutionBudget& budget) {
+        for (External& external : m_externals) {
+            external.slot = environment.lookup(external.name.lexeme);
+            auto number = external.slot != nullptr ? std::get_if<double>(external.slot) : nullptr;
+            if (number == nullptr) return false;
+            m_registers[external.reg] = *number;
+        }
+        // Erros (divisão por zero, limites de execução) saem com as
+        // variáveis gravadas, como se o laço tivesse rodado pela AST.
+        m_budget = &budget;
+        try {
+            execute();
+        } catch (...) {
+            writeBack();
+            throw;
+        }
+        writeBack();
+        return true;
+    }
+
+    void NumericLoop::writeBack() {
+        for (const External& external : m_externals) {
+            if (external.written) *external.slot = m_registers[external.reg];
+        }
+    }
+
+    void NumericLoop::execute() {
+        if (m_native != nullptr) {
+            executeNative(0);
+            return;
+        }
+        const Instruction* code = m_code.data();
+        double* r = m_registers.data();
+        for (std::size_t pc = 0;;) {
+            const Instruction& in = code[pc++];
+            switch (in.op) {
+                case Op::Move: r[in.a] = r[in.b]; break;
+                case Op::Add: r[in.a] = r[in.b] + r[in.c]; break;
+                case Op::Sub: r[in.a] = r[in.b] - r[in.c]; break;
+                case Op::Mul: r[in.a] = r[in.b] * r[in.c]; break;
+                case Op::Div:
+                    if (r[in.c] == 0.0) {
+                        throw RuntimeError(m_divisions.at(pc - 1), "Division by zero.");
+                    }
+                    r[in.a] = r[in.b] / r[in.c];
+                    break;
+                case Op::Neg: r[in.a] = -r[in.b]; break;
+                case Op::Jump:
+                    // Desvio para trás: fim de uma iteração e safepoint. Laço
+                    // quente continua em código de máquina a partir do destino.
+                    if (in.a < pc) {
+                        m_budget->tick(static_cast<int>(in.b));
+                        if (m_jit.enabled && ++m_backEdges >= m_jit.threshold && compileNative()) {
+                            executeNative(in.a);
+                            return;
+                        }
+                    }
+                    pc = in.a;
+                    break;
+                case Op::JumpIfLess: if (r[in.b] < r[in.c]) pc = in.a; break;
+                case Op::JumpIfLessEqual: if (r[in.b] <= r[in.c]) pc = in.a; break;
+                case Op::JumpIfGreater: if (r[in.b] > r[in.c]) pc = in.a; break;
+                case Op::JumpIfGreaterEqual: if (r[in.b] >= r[in.c]) pc = in.a; break;
+                case Op::JumpIfEqual: if (r[in.b] == r[in.c]) pc = in.a; break;
+                case Op::JumpIfNotEqual: if (r[in.b] != r[in.c]) pc = in.a; break;
+                case Op::Safepoint: m_budget->tick(static_cast<int>(in.a)); break;
+                case Op::Halt: return;
+            }
+        }
+    }
+
+    void NumericLoop::executeNative(std::size_t pc) {
+        for (;;) {
+            std::uint32_t result = m_native->call(m_registers.data(), m_nativeOffsets[pc], m_budget->countdown());
+            if (result == kNativeDone) return;
+            if ((result & kNativeSafepoint) == 0) throw RuntimeError(m_divisions.at(result), "Division by zero.");
+            // A contagem do orçamento chegou a zero no safepoint em pc.
+            const Instruction& in = m_code[result & ~kNativeSafepoint];
+            if (in.op == Op::Jump) {
+                m_budget->refill(static_cast<int>(in.b));
+                pc = in.a;
+            } else {
+                m_budget->refill(static_cast<int>(in.a));
+                pc = (result & ~kNativeSafepoint) + 1;
+            }
+        }
+    }
+
+    // Template de cada instrução, com os registradores em [rdi + 8 * n].
+    // Divisão por zero retorna o pc da Div; o resto do tratamento é o mesmo
+    // de execute(). Comparações usam ucomisd com o maior operando à
+    // esquerda (ja/jae), que é falso para NaN como em C++.
+    bool NumericLoop::compileNative() {
+        if (m_native != nullptr) return true;
+        // Uma falha não é tentada de novo.
+        m_jit.enabled = false;
+        if (!ExecutableCode::supported()) return false;
+
+        using Asm = X64Assembler;
+        Asm masm;
+        auto slot = [](std::uint32_t reg) { return static_cast<std::int32_t>(reg * sizeof(double)); };
+        std::vector<std::pair<std::size_t, std::uint32_t>> jumps;
+        auto branch = [&](std::size_t at, std::uint32_t target) { jumps.emplace_back(at, target); };
+
+        masm.jumpToRsi();
+        m_nativeOffsets.assign(m_code.size(), 0);
+        for (std::size_t pc = 0; pc < m_code.size(); ++pc) {
+            const Instruction& in = m_code[pc];
+            m_nativeOffsets[pc] = static_cast<std::uint32_t>(masm.size());
+            switch (in.op) {
+                case Op::Move:
+                    masm.load(Asm::xmm0, slot(in.b));
+                    masm.store(slot(in.a), Asm::xmm0);
+                    break;
+                case Op::Add:
+                case Op::Sub:
+                case Op::Mul: {
+                    Asm::SseOp op = in.op == Op::Add ? Asm::SseOp::Add : in.op == Op::Sub ? Asm::SseOp::Sub : Asm::SseOp::Mul;
+                    masm.load(Asm::xmm0, slot(in.b));
+                    masm.arithmetic(op, Asm::xmm0, slot(in.c));
+                    masm.store(slot(in.a), Asm::xmm0);
+                    break;
+                }
+                case Op::Div:
+                    // jp/jne pulam o retorno de erro (mov eax + ret, 6 bytes).
+                    masm.load(Asm::xmm1, slot(in.c));
+                    masm.zero(Asm::xmm0);
+                    masm.compare(Asm::xmm1, Asm::xmm0);
+                    masm.jumpShort(Asm::Condition::Parity, 8);
+                    masm.jumpShort(Asm::Condition::NotEqual, 6);
+                    masm.movEax(static_cast<std::uint32_t>(pc));
+                    masm.ret();
+                    masm.load(Asm::xmm0, slot(in.b));
+                    masm.arithmetic(Asm::SseOp::Div, Asm::xmm0, Asm::xmm1);
+                    masm.store(slot(in.a), Asm::xmm0);
+                    break;
+                case Op::Neg:
+                    masm.load(Asm::xmm0, slot(in.b));
+                    masm.negate(Asm::xmm0);
+                    masm.store(slot(in.a), Asm::xmm0);
+                    break;
+                case Op::Jump:
+                    if (in.a <= pc) {
+                        // Safepoint: decrementa a contagem do orçamento (rdx)
+                        // e só sai para o chamador quando ela chega a zero.
+                        masm.decrementRdxCounter();
+                        branch(masm.jump(Asm::Condition::NotEqual), in.a);
+                        masm.movEax(kNativeSafepoint | static_cast<std::uint32_t>(pc));
+                        masm.ret();
+                    } else {
+                        branch(masm.jump(), in.a);
+                    }
+                    break;
+                case Op::JumpIfLess:
+                case Op::JumpIfLessEqual:
+                    masm.load(Asm::xmm0, slot(in.c));
+                    masm.compare(Asm::xmm0, slot(in.b));
+                    branch(masm.jump(in.op == Op::JumpIfLess ? Asm::Condition::Above : Asm::Condition::AboveEqual), in.a);
+                    break;
+                case Op::JumpIfGreater:
+                case Op::JumpIfGreaterEqual:
+                    masm.load(Asm::xmm0, slot(in.b));
+                    masm.compare(Asm::xmm0, slot(in.c));
+                    branch(masm.jump(in.op == Op::JumpIfGreater ? Asm::Condition::Above : Asm::Condition::AboveEqual), in.a);
+                    break;
+                case Op::JumpIfEqual:
+                    // Igual e ordenado: NaN (PF=1) pula o je de 6 bytes.
+                    masm.load(Asm::xmm0, slot(in.b));
+                    masm.compare(Asm::xmm0, slot(in.c));
+                    masm.jumpShort(Asm::Condition::Parity, 6);
+                    branch(masm.jump(Asm::Condition::Equal), in.a);
+                    break;
+                case Op::JumpIfNotEqual:
+                    masm.load(Asm::xmm0, slot(in.b));
+                    masm.compare(Asm::xmm0, slot(in.c));
+                    branch(masm.jump(Asm::Condition::Parity), in.a);
+                    branch(masm.jump(Asm::Condition::NotEqual), in.a);
+                    break;
+                case Op::Safepoint:
+                    // jne pula o retorno (mov eax + ret, 6 bytes).
+                    masm.decrementRdxCounter();
+                    masm.jumpShort(Asm::Condition::NotEqual, 6);
+                    masm.movEax(kNativeSafepoint | static_cast<std::uint32_t>(pc));
+                    masm.ret();
+                    break;
+                case Op::Halt:
+                    masm.movEax(kNativeDone);
+                    masm.ret();
+                    break;
+            }
+        }
+        for (const auto& [at, target] : jumps) masm.patch(at, m_nativeOffsets[target]);
+
+        m_native = ExecutableCode::install(masm.code(), "lox::loop@line" + std::to_string(m_line), m_jit.perfMap);
+        return m_native != nullptr;
+    }
+
+    static void collectLoops(const Stmt& stmt, const TypeInference& types, JitOptions jit,
+                             std::unordered_map<const Stmt*, std::unique_ptr<NumericLoop>>& loops) {
+        switch (stmt.kind) {
+            case StmtKind::While:
+            case StmtKind::For:
+                if (auto compiled = NumericLoop::compile(stmt, types, jit)) {
+                    loops.emplace(&stmt, std::move(compiled));
+                    return;
+                }
+                if (stmt.kind == StmtKind::While) {
+                    collectLoops(*static_cast<const WhileStmt&>(stmt).body, types, jit, loops);
+                } else {
+                    collectLoops(*static_cast<const ForStmt&>(stmt).body, types, jit, loops);
+                }
+                return;
+            case StmtKind::Block:
+                for (const auto& inner : static_cast<const BlockStmt&>(stmt).statements) {
+                    if (inner != nullptr) collectLoops(*inner, types, jit, loops);
+                }
+                return;
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                collectLoops(*branch.thenBranch, types, jit, loops);
+                if (branch.elseBranch != nullptr) collectLoops(*branch.elseBranch, types, jit, loops);
+                return;
+            }
+            default:
+                return;
+        }
+    }
+
+    void compileNumericLoops(const std::vector<std::unique_ptr<Stmt>>& program,
+                             std::unordered_map<const Stmt*, std::unique_ptr<NumericLoop>>& loops, JitOptions jit) {
+        TypeInference types;
+        types.analyze(program);
+        for (const auto& stmt : program) {
+            if (stmt != nullptr) collectLoops(*stmt, types, jit, loops);
+        }
+    }
+
+}
@@ -0,0 +1,131 @@
+#pragma once
+
+#include "Token.hpp"
+#include "Value.hpp"
+#include "ast/Stmt.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace lox {
+
+    class Environment;
+    class ExecutableCode;
+    class ExecutionBudget;
+    class TypeInference;
+
+    // Segundo nível dos laços especializados: depois de threshold iterações
+    // (desvios para trás, somando todas as execuções do laço) o programa de
+    // registradores é traduzido, instrução a instrução, para código x86-64
+    // (X64Assembler.hpp) e a execução continua nele do mesmo ponto.
+    struct JitOptions {
+        bool enabled = true;
+        std::size_t threshold = 1000;
+        // Registra o código gerado em /tmp/perf-<pid>.map (--perf-map).
+        bool perfMap = false;
+    };
+
+    // Laço (while ou for) especializado para doubles sem caixa. Quando todo o
+    // código do laço é aritmética, comparações, atribuições, var, blocos e
+    // if/while/for, e a inferência (TypeInference.hpp) prova que as variáveis
+    // externas que ele usa são números na cabeça do laço, o laço é compilado
+    // para um programa de registradores double: sem Environment, sem
+    // std::any e sem checagem de tipo por operação.
+    //
+    // As variáveis globais de execuções anteriores (no REPL) não aparecem no
+    // programa analisado; para elas a compilação especula que são números. Em
+    // todo caso run() confere, na entrada, que cada variável externa existe e
+    // guarda um número; se não, nada é executado e o chamador volta para a
+    // AST (desotimização).
+    class NumericLoop {
+    public:
+        // nullptr se o laço não pode ser especializado.
+        static std::unique_ptr<NumericLoop> compile(const Stmt& loop, const TypeInference& types,
+                                                    JitOptions jit = {});
+
+        NumericLoop();
+        ~NumericLoop();
+
+        // Executa o laço inteiro no ambiente dado e grava de volta as variáveis
+        // externas alteradas. Retorna false, sem efeito, se a guarda de entrada
+        // falhar. Em divisão por zero grava as variáveis e lança RuntimeError,
+        // como a AST faria. Desvios para trás e entradas de bloco são
+        // safepoints do budget, nos mesmos pontos da AST.
+        bool run(Environment& environment, ExecutionBudget& budget);
+
+        // O laço já roda em código de máquina.
+        bool isNative() const { return m_native != nullptr; }
+
+    private:
+        friend class NumericCompiler;
+
+        enum class Op : std::uint8_t {
+            Move,
+            // Safepoint do orçamento de execução (entrada de bloco); a é a linha.
+            Safepoint,
+            Add,
+            Sub,
+            Mul,
+            Div,
+            Neg,
+            // b é a linha do laço quando o desvio é para trás (safepoint).
+            Jump,
+            // Desvia para a se a comparação de b com c der verdadeiro.
+            JumpIfLess,
+            JumpIfLessEqual,
+            JumpIfGreater,
+            JumpIfGreaterEqual,
+            JumpIfEqual,
+            JumpIfNotEqual,
+            Halt,
+        };
+
+        struct Instruction {
+            Op op;
+            std::uint32_t a;
+            std::uint32_t b;
+            std::uint32_t c;
+        };
+
+        // Variável de fora do laço: carregada na entrada, gravada na saída.
+        struct External {
+            Token name;
+            std::uint32_t reg;
+            bool written;
+            Value* slot;
+        };
+
+        void execute();
+        void writeBack();
+        // Gera o código de máquina; false se não for possível (o laço
+        // continua no programa de registradores).
+        bool compileNative();
+        // Executa o código de máquina a partir da instrução pc.
+        void executeNative(std::size_t pc);
+
+        std::vector<Instruction> m_code;
+        // Constantes já nos seus registradores; nunca são sobrescritas.
+        std::vector<double> m_registers;
+        std::vector<External> m_externals;
+        // Operador de cada Div, para o erro; indexado pelo pc da instrução.
+        std::unordered_map<std::size_t, Token> m_divisions;
+
+        JitOptions m_jit;
+        ExecutionBudget* m_budget = nullptr;
+        int m_line = 0;
+        std::size_t m_backEdges = 0;
+        std::unique_ptr<ExecutableCode> m_native;
+        // Início do código de cada instrução dentro de m_native.
+        std::vector<std::uint32_t> m_nativeOffsets;
+    };
+
+    // Infere os tipos do programa e compila os laços especializáveis. Um laço
+    // compilado não é percorrido; dentro dos outros, os laços internos são
+    // candidatos.
+    void compileNumericLoops(const std::vector<std::unique_ptr<Stmt>>& program,
+                             std::unordered_map<const Stmt*, std::unique_ptr<NumericLoop>>& loops,
+                             JitOptions jit = {});
+
+}
@@ -0,0 +1,880 @@
+#include "Optimizer.hpp"
+
+#include "TypeInference.hpp"
+#include "ast/ASTPrinter.hpp"
+
+#include <cstddef>
+#include <optional>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+
+namespace lox {
+
+    using StmtList = std::vector<std::unique_ptr<Stmt>>;
+    using ExprList = std::vector<std::unique_ptr<Expr>>;
+
+    // Reconstrói a árvore nó a nó. Cada passo sobrescreve expr()/stmt() para
+    // os nós que muda e delega o resto a copy(), que reconstrói os filhos
+    // chamando expr()/stmt() de novo.
+    class Rewriter {
+    public:
+        virtual ~Rewriter() = default;
+
+        virtual std::unique_ptr<Expr> expr(const Expr& expr) { return copy(expr); }
+
+        // nullptr remove o statement.
+        virtual std::unique_ptr<Stmt> stmt(const Stmt& stmt) { return copy(stmt); }
+
+        virtual StmtList statements(const StmtList& list) {
+            StmtList out;
+            for (const auto& stmt : list) {
+                if (stmt == nullptr) continue;
+                if (auto rewritten = this->stmt(*stmt)) out.push_back(std::move(rewritten));
+            }
+            return out;
+        }
+
+    protected:
+        std::unique_ptr<Expr> copy(const Expr& expr);
+        std::unique_ptr<Stmt> copy(const Stmt& stmt);
+
+        std::unique_ptr<Expr> maybe(const std::unique_ptr<Expr>& expr) {
+            return expr != nullptr ? this->expr(*expr) : nullptr;
+        }
+
+        // Corpo de laço e then do if não podem sumir: viram um bloco vazio.
+        std::unique_ptr<Stmt> required(const Stmt& stmt) {
+            auto rewritten = this->stmt(stmt);
+            if (rewritten == nullptr) {
+                rewritten = std::make_unique<BlockStmt>(StmtList{});
+                rewritten->line = stmt.line;
+            }
+            return rewritten;
+        }
+    };
+
+    std::unique_ptr<Expr> Rewriter::copy(const Expr& expr) {
+        switch (expr.kind) {
+            case ExprKind::ArrayLiteral: {
+                const auto& array = static_cast<const ArrayLiteral&>(expr);
+                ExprList elements;
+                for (const auto& element : array.elements) elements.push_back(this->expr(*element));
+                return std::make_unique<ArrayLiteral>(array.bracket, std::move(elements));
+            }
+            case ExprKind::Assign: {
+                const auto& assign = static_cast<const Assign&>(expr);
+                return std::make_unique<Assign>(assign.name, this->expr(*assign.value));
+            }
+            case ExprKind::Binary: {
+                const auto& binary = static_cast<const Binary&>(expr);
+                auto left = this->expr(*binary.left);
+                auto right = this->expr(*binary.right);
+                return std::make_unique<Binary>(std::move(left), binary.op, std::move(right));
+            }
+            case ExprKind::Call: {
+                const auto& call = static_cast<const Call&>(expr);
+                auto callee = this->expr(*call.callee);
+                ExprList arguments;
+                for (const auto& argument : call.arguments) arguments.push_back(this->expr(*argument));
+                return std::make_unique<Call>(std::move(callee), call.paren, std::move(arguments));
+            }
+            case ExprKind::Grouping:
+                return std::make_unique<Grouping>(this->expr(*static_cast<const Grouping&>(expr).expression));
+            case ExprKind::Increment: {
+                const auto& increment = static_cast<const Increment&>(expr);
+                return std::make_unique<Increment>(increment.name, increment.op, increment.step);
+            }
+            case ExprKind::Index: {
+                const auto& index = static_cast<const Index&>(expr);
+                auto object = this->expr(*index.object);
+                auto key = this->expr(*index.index);
+                return std::make_unique<Index>(std::move(object), index.bracket, std::move(key));
+            }
+            case ExprKind::IndexSet: {
+                const auto& set = static_cast<const IndexSet&>(expr);
+                auto object = this->expr(*set.target->object);
+                auto key = this->expr(*set.target->index);
+                auto target = std::make_unique<Index>(std::move(object), set.target->bracket, std::move(key));
+                return std::make_unique<IndexSet>(std::move(target), this->expr(*set.value));
+            }
+            case ExprKind::Literal:
+                return std::make_unique<Literal>(static_cast<const Literal&>(expr).value);
+            case ExprKind::Logical: {
+                const auto& logical = static_cast<const Logical&>(expr);
+                auto left = this->expr(*logical.left);
+                auto right = this->expr(*logical.right);
+                return std::make_unique<Logical>(std::move(left), logical.op, std::move(right));
+            }
+            case ExprKind::Unary: {
+                const auto& unary = static_cast<const Unary&>(expr);
+                return std::make_unique<Unary>(unary.op, this->expr(*unary.right));
+            }
+            case ExprKind::Variable:
+                return std::make_unique<Variable>(static_cast<const Variable&>(expr).name);
+        }
+        return nullptr;
+    }
+
+    std::unique_ptr<Stmt> Rewriter::copy(const Stmt& stmt) {
+        std::unique_ptr<Stmt> out;
+        switch (stmt.kind) {
+            case StmtKind::Block:
+                out = std::make_unique<BlockStmt>(statements(static_cast<const BlockStmt&>(stmt).statements));
+                break;
+            case StmtKind::Expression:
+                out = std::make_unique<ExpressionStmt>(expr(*static_cast<const ExpressionStmt&>(stmt).expression));
+                break;
+            case StmtKind::For: {
+                const auto& loop = static_cast<const ForStmt&>(stmt);
+                auto initializer = loop.initializer != nullptr ? this->stmt(*loop.initializer) : nullptr;
+                auto condition = maybe(loop.condition);
+                auto increment = maybe(loop.increment);
+                auto body = required(*loop.body);
+                out = std::make_unique<ForStmt>(std::move(initializer), std::move(condition), std::move(increment),
+                                                std::move(body), loop.counted);
+                break;
+            }
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                auto condition = expr(*branch.condition);
+                auto thenBranch = required(*branch.thenBranch);
+                auto elseBranch = branch.elseBranch != nullptr ? this->stmt(*branch.elseBranch) : nullptr;
+                out = std::make_unique<IfStmt>(std::move(condition), std::move(thenBranch), std::move(elseBranch));
+                break;
+            }
+            case StmtKind::Print:
+                out = std::make_unique<PrintStmt>(expr(*static_cast<const PrintStmt&>(stmt).expression));
+                break;
+            case StmtKind::Var: {
+                const auto& var = static_cast<const VarStmt&>(stmt);
+                out = std::make_unique<VarStmt>(var.name, maybe(var.initializer));
+                break;
+            }
+            case StmtKind::While: {
+                const auto& loop = static_cast<const WhileStmt&>(stmt);
+                auto condition = expr(*loop.condition);
+                out = std::make_unique<WhileStmt>(std::move(condition), required(*loop.body));
+                break;
+            }
+        }
+        out->line = stmt.line;
+        return out;
+    }
+
+    // --- Passo 1: ramos mortos ---
+
+    // Valor de verdade de uma condição que só depende de literais (e portanto
+    // não tem efeito nem lança erro); nullopt se depende de algo em execução.
+    static std::optional<bool> constantTruth(const Expr& expr) {
+        switch (expr.kind) {
+            case ExprKind::Literal: {
+                const Value& value = static_cast<const Literal&>(expr).value;
+                if (std::holds_alternative<std::monostate>(value)) return false;
+                if (auto boolean = std::get_if<bool>(&value)) return *boolean;
+                return true;
+            }
+            case ExprKind::Grouping:
+                return constantTruth(*static_cast<const Grouping&>(expr).expression);
+            case ExprKind::Unary: {
+                const auto& unary = static_cast<const Unary&>(expr);
+                if (unary.op.type != TokenType::BANG) return std::nullopt;
+                auto truth = constantTruth(*unary.right);
+                if (!truth) return std::nullopt;
+                return !*truth;
+            }
+            case ExprKind::Logical: {
+                const auto& logical = static_cast<const Logical&>(expr);
+                auto left = constantTruth(*logical.left);
+                if (!left) return std::nullopt;
+                // `true or x` e `false and x` nem avaliam x.
+                if (*left == (logical.op.type == TokenType::OR)) return *left;
+                return constantTruth(*logical.right);
+            }
+            default:
+                return std::nullopt;
+        }
+    }
+
+    // Sem break nem return em Lox, um laço de condição sempre verdadeira só
+    // termina com um erro, que encerra o programa.
+    static bool neverCompletes(const Stmt& stmt) {
+        switch (stmt.kind) {
+            case StmtKind::While:
+                return constantTruth(*static_cast<const WhileStmt&>(stmt).condition) == true;
+            case StmtKind::For: {
+                const auto& loop = static_cast<const ForStmt&>(stmt);
+                return loop.condition == nullptr || constantTruth(*loop.condition) == true;
+            }
+            case StmtKind::Block:
+                for (const auto& inner : static_cast<const BlockStmt&>(stmt).statements) {
+                    if (inner != nullptr && neverCompletes(*inner)) return true;
+                }
+                return false;
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                return branch.elseBranch != nullptr && neverCompletes(*branch.thenBranch) &&
+                       neverCompletes(*branch.elseBranch);
+            }
+            default:
+                return false;
+        }
+    }
+
+    class BranchFolder : public Rewriter {
+    public:
+        explicit BranchFolder(std::vector<OptimizationNote>& notes) : m_notes(notes) {}
+
+        std::unique_ptr<Stmt> stmt(const Stmt& stmt) override {
+            if (stmt.kind == StmtKind::If) {
+                // Os ramos são statements, não declarações: trocar o if por um
+                // deles não muda escopos.
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                auto truth = constantTruth(*branch.condition);
+                if (truth == true) {
+                    m_notes.push_back({stmt.line, "if condition is always true; kept the then branch"});
+                    return this->stmt(*branch.thenBranch);
+                }
+                if (truth == false) {
+                    if (branch.elseBranch == nullptr) {
+                        m_notes.push_back({stmt.line, "if condition is always false; removed the statement"});
+                        return nullptr;
+                    }
+                    m_notes.push_back({stmt.line, "if condition is always false; kept the else branch"});
+                    return this->stmt(*branch.elseBranch);
+                }
+            } else if (stmt.kind == StmtKind::While) {
+                if (constantTruth(*static_cast<const WhileStmt&>(stmt).condition) == false) {
+                    m_notes.push_back({stmt.line, "while condition is always false; removed the loop"});
+                    return nullptr;
+                }
+            }
+            return copy(stmt);
+        }
+
+        StmtList statements(const StmtList& list) override {
+            StmtList out;
+            for (std::size_t i = 0; i < list.size(); ++i) {
+                if (list[i] == nullptr) continue;
+                auto rewritten = stmt(*list[i]);
+                if (rewritten == nullptr) continue;
+                bool stops = neverCompletes(*rewritten);
+                out.push_back(std::move(rewritten));
+                if (!stops) continue;
+
+                std::size_t unreachable = 0;
+                int line = 0;
+                for (std::size_t j = i + 1; j < list.size(); ++j) {
+                    if (list[j] == nullptr) continue;
+                    if (unreachable++ == 0) line = list[j]->line;
+                }
+                if (unreachable > 0) {
+                    m_notes.push_back({line, "removed " + std::to_string(unreachable) +
+                                                 " unreachable statement(s) after a loop that never ends"});
+                }
+                break;
+            }
+            return out;
+        }
+
+    private:
+        std::vector<OptimizationNote>& m_notes;
+    };
+
+    // --- Passo 2: stores mortos ---
+
+    // Liga cada leitura e atribuição à declaração visível naquele ponto, do
+    // mesmo jeito que a cadeia de Environments faria em execução (não há
+    // funções, então escopo estático e dinâmico coincidem).
+    class VariableUses {
+    public:
+        VariableUses(const StmtList& program, bool trackGlobals) : m_trackGlobals(trackGlobals) {
+            for (const auto& stmt : program) {
+                if (stmt != nullptr) statement(*stmt);
+            }
+        }
+
+        bool isDead(const VarStmt& var) const {
+            auto it = m_reads.find(&var);
+            return it != m_reads.end() && it->second == 0;
+        }
+
+        const VarStmt* assignTarget(const Assign& assign) const {
+            auto it = m_assignTargets.find(&assign);
+            return it != m_assignTargets.end() ? it->second : nullptr;
+        }
+
+        // A leitura tem uma declaração visível, então nunca falha.
+        bool isDeclared(const Variable& variable) const { return m_declaredReads.count(&variable) != 0; }
+
+    private:
+        void statement(const Stmt& stmt) {
+            switch (stmt.kind) {
+                case StmtKind::Block: {
+                    std::size_t scope = m_scope.size();
+                    ++m_depth;
+                    for (const auto& inner : static_cast<const BlockStmt&>(stmt).statements) {
+                        if (inner != nullptr) statement(*inner);
+                    }
+                    --m_depth;
+                    m_scope.resize(scope);
+                    break;
+                }
+                case StmtKind::Expression:
+                    expression(*static_cast<const ExpressionStmt&>(stmt).expression);
+                    break;
+                case StmtKind::Print:
+                    expression(*static_cast<const PrintStmt&>(stmt).expression);
+                    break;
+                case StmtKind::Var: {
+                    const auto& var = static_cast<const VarStmt&>(stmt);
+                    if (var.initializer != nullptr) expression(*var.initializer);
+                    if (m_trackGlobals || m_depth > 0) m_reads.emplace(&var, 0);
+                    m_scope.emplace_back(var.name.lexeme, &var);
+                    break;
+                }
+                case StmtKind::If: {
+                    const auto& branch = static_cast<const IfStmt&>(stmt);
+                    expression(*branch.condition);
+                    nested(*branch.thenBranch);
+                    if (branch.elseBranch != nullptr) nested(*branch.elseBranch);
+                    break;
+                }
+                case StmtKind::While: {
+                    const auto& loop = static_cast<const WhileStmt&>(stmt);
+                    expression(*loop.condition);
+                    nested(*loop.body);
+                    break;
+                }
+                case StmtKind::For: {
+                    const auto& loop = static_cast<const ForStmt&>(stmt);
+                    std::size_t scope = m_scope.size();
+                    ++m_depth;
+                    if (loop.initializer != nullptr) statement(*loop.initializer);
+                    if (loop.condition != nullptr) expression(*loop.condition);
+                    if (loop.increment != nullptr) expression(*loop.increment);
+                    statement(*loop.body);
+                    --m_depth;
+                    m_scope.resize(scope);
+                    break;
+                }
+            }
+        }
+
+        void nested(const Stmt& stmt) {
+            ++m_depth;
+            statement(stmt);
+            --m_depth;
+        }
+
+        void expression(const Expr& expr) {
+            switch (expr.kind) {
+                case ExprKind::Variable: {
+                    const auto& variable = static_cast<const Variable&>(expr);
+                    if (const VarStmt* var = resolve(variable.name.lexeme)) {
+                        m_declaredReads.insert(&variable);
+                        auto it = m_reads.find(var);
+                        if (it != m_reads.end()) ++it->second;
+                    }
+                    break;
+                }
+                case ExprKind::Increment:
+                    // O incremento lê a variável.
+                    if (const VarStmt* var = resolve(static_cast<const Increment&>(expr).name.lexeme)) {
+                        auto it = m_reads.find(var);
+                        if (it != m_reads.end()) ++it->second;
+                    }
+                    break;
+                case ExprKind::Assign: {
+                    const auto& assign = static_cast<const Assign&>(expr);
+                    expression(*assign.value);
+                    if (const VarStmt* var = resolve(assign.name.lexeme)) m_assignTargets.emplace(&assign, var);
+                    break;
+                }
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    expression(*binary.left);
+                    expression(*binary.right);
+                    break;
+                }
+                case ExprKind::Logical: {
+                    const auto& logical = static_cast<const Logical&>(expr);
+                    expression(*logical.left);
+                    expression(*logical.right);
+                    break;
+                }
+                case ExprKind::Unary:
+                    expression(*static_cast<const Unary&>(expr).right);
+                    break;
+                case ExprKind::Grouping:
+                    expression(*static_cast<const Grouping&>(expr).expression);
+                    break;
+                case ExprKind::Call: {
+                    const auto& call = static_cast<const Call&>(expr);
+                    expression(*call.callee);
+                    for (const auto& argument : call.arguments) expression(*argument);
+                    break;
+                }
+                case ExprKind::Index: {
+                    const auto& index = static_cast<const Index&>(expr);
+                    expression(*index.object);
+                    expression(*index.index);
+                    break;
+                }
+                case ExprKind::IndexSet: {
+                    const auto& set = static_cast<const IndexSet&>(expr);
+                    expression(*set.target);
+                    expression(*set.value);
+                    break;
+                }
+                case ExprKind::ArrayLiteral:
+                    for (const auto& element : static_cast<const ArrayLiteral&>(expr).elements) expression(*element);
+                    break;
+                case ExprKind::Literal:
+                    break;
+            }
+        }
+
+        const VarStmt* resolve(const std::string& name) const {
+            for (auto it = m_scope.rbegin(); it != m_scope.rend(); ++it) {
+                if (it->first == name) return it->second;
+            }
+            return nullptr;
+        }
+
+        bool m_trackGlobals;
+        // Profundidade de blocos/laços/ifs: 0 é o escopo global.
+        int m_depth = 0;
+        std::vector<std::pair<std::string, const VarStmt*>> m_scope;
+        std::unordered_map<const VarStmt*, std::size_t> m_reads;
+        std::unordered_map<const Assign*, const VarStmt*> m_assignTargets;
+        std::unordered_set<const Variable*> m_declaredReads;
+    };
+
+    class DeadStoreEliminator : public Rewriter {
+    public:
+        DeadStoreEliminator(const VariableUses& uses, std::vector<OptimizationNote>& notes)
+            : m_uses(uses), m_notes(notes) {}
+
+        bool changed() const { return m_changed; }
+
+        std::unique_ptr<Stmt> stmt(const Stmt& stmt) override {
+            if (stmt.kind == StmtKind::Var) {
+                const auto& var = static_cast<const VarStmt&>(stmt);
+                if (m_uses.isDead(var)) {
+                    m_changed = true;
+                    m_notes.push_back({stmt.line, "removed unused variable '" + var.name.lexeme + "'"});
+                    if (var.initializer == nullptr || pure(*var.initializer)) return nullptr;
+                    auto effect = std::make_unique<ExpressionStmt>(expr(*var.initializer));
+                    effect->line = stmt.line;
+                    return effect;
+                }
+            } else if (stmt.kind == StmtKind::Expression) {
+                const Expr& inner = *static_cast<const ExpressionStmt&>(stmt).expression;
+                if (inner.kind == ExprKind::Assign && isDeadStore(static_cast<const Assign&>(inner)) &&
+                    pure(*static_cast<const Assign&>(inner).value)) {
+                    m_changed = true;
+                    m_notes.push_back({stmt.line, "removed store to unused variable '" +
+                                                      static_cast<const Assign&>(inner).name.lexeme + "'"});
+                    return nullptr;
+                }
+            }
+            return copy(stmt);
+        }
+
+        std::unique_ptr<Expr> expr(const Expr& expr) override {
+            if (expr.kind == ExprKind::Assign) {
+                // A atribuição vale o próprio valor; só a escrita some.
+                const auto& assign = static_cast<const Assign&>(expr);
+                if (isDeadStore(assign)) {
+                    m_changed = true;
+                    m_notes.push_back({assign.name.line, "removed store to unused variable '" + assign.name.lexeme + "'"});
+                    return this->expr(*assign.value);
+                }
+            }
+            return copy(expr);
+        }
+
+    private:
+        bool isDeadStore(const Assign& assign) const {
+            const VarStmt* target = m_uses.assignTarget(assign);
+            return target != nullptr && m_uses.isDead(*target);
+        }
+
+        // Sem efeito e sem erro possível: pode deixar de ser avaliada.
+        bool pure(const Expr& expr) const {
+            switch (expr.kind) {
+                case ExprKind::Literal:
+                    return true;
+                case ExprKind::Variable:
+                    return m_uses.isDeclared(static_cast<const Variable&>(expr));
+                case ExprKind::Grouping:
+                    return pure(*static_cast<const Grouping&>(expr).expression);
+                case ExprKind::Logical: {
+                    const auto& logical = static_cast<const Logical&>(expr);
+                    return pure(*logical.left) && pure(*logical.right);
+                }
+                case ExprKind::Unary: {
+                    const auto& unary = static_cast<const Unary&>(expr);
+                    return unary.op.type == TokenType::BANG && pure(*unary.right);
+                }
+                case ExprKind::Binary: {
+                    // == e != aceitam quaisquer tipos.
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    bool equality = binary.op.type == TokenType::EQUAL_EQUAL || binary.op.type == TokenType::BANG_EQUAL;
+                    return equality && pure(*binary.left) && pure(*binary.right);
+                }
+                case ExprKind::ArrayLiteral:
+                    for (const auto& element : static_cast<const ArrayLiteral&>(expr).elements) {
+                        if (!pure(*element)) return false;
+                    }
+                    return true;
+                default:
+                    return false;
+            }
+        }
+
+        const VariableUses& m_uses;
+        std::vector<OptimizationNote>& m_notes;
+        bool m_changed = false;
+    };
+
+    // --- Passo 3: código invariante nos while ---
+
+    static void collectWrites(const Expr& expr, std::unordered_set<std::string>& names);
+
+    static void collectWrites(const Stmt& stmt, std::unordered_set<std::string>& names) {
+        switch (stmt.kind) {
+            case StmtKind::Block:
+                for (const auto& inner : static_cast<const BlockStmt&>(stmt).statements) {
+                    if (inner != nullptr) collectWrites(*inner, names);
+                }
+                break;
+            case StmtKind::Expression:
+                collectWrites(*static_cast<const ExpressionStmt&>(stmt).expression, names);
+                break;
+            case StmtKind::Print:
+                collectWrites(*static_cast<const PrintStmt&>(stmt).expression, names);
+                break;
+            case StmtKind::Var: {
+                // Uma declaração dentro do laço esconde a variável de fora.
+                const auto& var = static_cast<const VarStmt&>(stmt);
+                names.insert(var.name.lexeme);
+                if (var.initializer != nullptr) collectWrites(*var.initializer, names);
+                break;
+            }
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                collectWrites(*branch.condition, names);
+                collectWrites(*branch.thenBranch, names);
+                if (branch.elseBranch != nullptr) collectWrites(*branch.elseBranch, names);
+                break;
+            }
+            case StmtKind::While: {
+                const auto& loop = static_cast<const WhileStmt&>(stmt);
+                collectWrites(*loop.condition, names);
+                collectWrites(*loop.body, names);
+                break;
+            }
+            case StmtKind::For: {
+                const auto& loop = static_cast<const ForStmt&>(stmt);
+                if (loop.initializer != nullptr) collectWrites(*loop.initializer, names);
+                if (loop.condition != nullptr) collectWrites(*loop.condition, names);
+                if (loop.increment != nullptr) collectWrites(*loop.increment, names);
+                collectWrites(*loop.body, names);
+                break;
+            }
+        }
+    }
+
+    static void collectWrites(const Expr& expr, std::unordered_set<std::string>& names) {
+        switch (expr.kind) {
+            case ExprKind::Assign: {
+                const auto& assign = static_cast<const Assign&>(expr);
+                names.insert(assign.name.lexeme);
+                collectWrites(*assign.value, names);
+                break;
+            }
+            case ExprKind::Increment:
+                names.insert(static_cast<const Increment&>(expr).name.lexeme);
+                break;
+            case ExprKind::Binary: {
+                const auto& binary = static_cast<const Binary&>(expr);
+                collectWrites(*binary.left, names);
+                collectWrites(*binary.right, names);
+                break;
+            }
+            case ExprKind::Logical: {
+                const auto& logical = static_cast<const Logical&>(expr);
+                collectWrites(*logical.left, names);
+                collectWrites(*logical.right, names);
+                break;
+            }
+            case ExprKind::Unary:
+                collectWrites(*static_cast<const Unary&>(expr).right, names);
+                break;
+            case ExprKind::Grouping:
+                collectWrites(*static_cast<const Grouping&>(expr).expression, names);
+                break;
+            case ExprKind::Call: {
+                const auto& call = static_cast<const Call&>(expr);
+                collectWrites(*call.callee, names);
+                for (const auto& argument : call.arguments) collectWrites(*argument, names);
+                break;
+            }
+            case ExprKind::Index: {
+                const auto& index = static_cast<const Index&>(expr);
+                collectWrites(*index.object, names);
+                collectWrites(*index.index, names);
+                break;
+            }
+            case ExprKind::IndexSet: {
+                const auto& set = static_cast<const IndexSet&>(expr);
+                collectWrites(*set.target, names);
+                collectWrites(*set.value, names);
+                break;
+            }
+            case ExprKind::ArrayLiteral:
+                for (const auto& element : static_cast<const ArrayLiteral&>(expr).elements) {
+                    collectWrites(*element, names);
+                }
+                break;
+            case ExprKind::Literal:
+            case ExprKind::Variable:
+                break;
+        }
+    }
+
+    static bool isNonZeroNumber(const Expr& expr) {
+        if (expr.kind == ExprKind::Grouping) return isNonZeroNumber(*static_cast<const Grouping&>(expr).expression);
+        if (expr.kind != ExprKind::Literal) return false;
+        auto number = std::get_if<double>(&static_cast<const Literal&>(expr).value);
+        return number != nullptr && *number != 0.0;
+    }
+
+    class LoopHoister : public Rewriter {
+    public:
+        LoopHoister(const TypeInference& types, std::vector<OptimizationNote>& notes)
+            : m_types(types), m_notes(notes) {}
+
+        std::unique_ptr<Stmt> stmt(const Stmt& stmt) override {
+            if (stmt.kind != StmtKind::While) return copy(stmt);
+
+            // De fora para dentro: o laço externo escolhe primeiro, e os
+            // internos só olham o que sobrou.
+            const auto& loop = static_cast<const WhileStmt&>(stmt);
+            Scope scope{loop, {}};
+            collectWrites(*loop.condition, scope.writes);
+            collectWrites(*loop.body, scope.writes);
+            std::vector<const Expr*> found;
+            findInExpr(*loop.condition, scope, found);
+            findInStmt(*loop.body, scope, found);
+
+            StmtList block;
+            ASTPrinter printer;
+            for (const Expr* invariant : found) {
+                std::string name = "$inv" + std::to_string(m_counter++);
+                auto hoisted = std::make_unique<VarStmt>(Token(TokenType::IDENTIFIER, name, stmt.line), copy(*invariant));
+                hoisted->line = stmt.line;
+                block.push_back(std::move(hoisted));
+                m_hoisted.emplace(invariant, Token(TokenType::IDENTIFIER, name, stmt.line));
+                m_notes.push_back({stmt.line, "hoisted " + printer.print(*invariant) + " out of the while loop as " + name});
+            }
+
+            auto condition = expr(*loop.condition);
+            auto rewritten = std::make_unique<WhileStmt>(std::move(condition), required(*loop.body));
+            rewritten->line = stmt.line;
+            if (block.empty()) return rewritten;
+
+            // O bloco só declara as $inv; o laço continua vendo as mesmas variáveis.
+            block.push_back(std::move(rewritten));
+            auto wrapper = std::make_unique<BlockStmt>(std::move(block));
+            wrapper->line = stmt.line;
+            return wrapper;
+        }
+
+        std::unique_ptr<Expr> expr(const Expr& expr) override {
+            auto it = m_hoisted.find(&expr);
+            if (it != m_hoisted.end()) return std::make_unique<Variable>(it->second);
+            return copy(expr);
+        }
+
+    private:
+        struct Scope {
+            const WhileStmt& loop;
+            std::unordered_set<std::string> writes;
+        };
+
+        // Mesmo valor em todas as iterações e sem erro possível.
+        bool invariant(const Expr& expr, const Scope& scope) const {
+            if (m_hoisted.count(&expr) != 0) return true;
+            switch (expr.kind) {
+                case ExprKind::Literal:
+                    return std::holds_alternative<double>(static_cast<const Literal&>(expr).value);
+                case ExprKind::Variable: {
+                    const std::string& name = static_cast<const Variable&>(expr).name.lexeme;
+                    return scope.writes.count(name) == 0 &&
+                           m_types.typeAtLoopHead(scope.loop, name) == StaticType::Number;
+                }
+                case ExprKind::Grouping:
+                    return invariant(*static_cast<const Grouping&>(expr).expression, scope);
+                case ExprKind::Unary: {
+                    const auto& unary = static_cast<const Unary&>(expr);
+                    return unary.op.type == TokenType::MINUS && invariant(*unary.right, scope);
+                }
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    switch (binary.op.type) {
+                        case TokenType::PLUS:
+                        case TokenType::MINUS:
+                        case TokenType::STAR:
+                            return invariant(*binary.left, scope) && invariant(*binary.right, scope);
+                        case TokenType::SLASH:
+                            return invariant(*binary.left, scope) && isNonZeroNumber(*binary.right);
+                        default:
+                            return false;
+                    }
+                }
+                default:
+                    return false;
+            }
+        }
+
+        // Vale uma variável: uma operação binária, ou um - que não é só um
+        // literal negativo.
+        static bool worthHoisting(const Expr& expr) {
+            if (expr.kind == ExprKind::Grouping) return worthHoisting(*static_cast<const Grouping&>(expr).expression);
+            if (expr.kind == ExprKind::Binary) return true;
+            if (expr.kind == ExprKind::Unary) {
+                return static_cast<const Unary&>(expr).right->kind != ExprKind::Literal;
+            }
+            return false;
+        }
+
+        void findInExpr(const Expr& expr, const Scope& scope, std::vector<const Expr*>& found) {
+            if (m_hoisted.count(&expr) != 0) return;
+            if (worthHoisting(expr) && invariant(expr, scope)) {
+                found.push_back(&expr);
+                return;
+            }
+            switch (expr.kind) {
+                case ExprKind::Assign:
+                    findInExpr(*static_cast<const Assign&>(expr).value, scope, found);
+                    break;
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    findInExpr(*binary.left, scope, found);
+                    findInExpr(*binary.right, scope, found);
+                    break;
+                }
+                case ExprKind::Logical: {
+                    const auto& logical = static_cast<const Logical&>(expr);
+                    findInExpr(*logical.left, scope, found);
+                    findInExpr(*logical.right, scope, found);
+                    break;
+                }
+                case ExprKind::Unary:
+                    findInExpr(*static_cast<const Unary&>(expr).right, scope, found);
+                    break;
+                case ExprKind::Grouping:
+                    findInExpr(*static_cast<const Grouping&>(expr).expression, scope, found);
+                    break;
+                case ExprKind::Call: {
+                    const auto& call = static_cast<const Call&>(expr);
+                    findInExpr(*call.callee, scope, found);
+                    for (const auto& argument : call.arguments) findInExpr(*argument, scope, found);
+                    break;
+                }
+                case ExprKind::Index: {
+                    const auto& index = static_cast<const Index&>(expr);
+                    findInExpr(*index.object, scope, found);
+                    findInExpr(*index.index, scope, found);
+                    break;
+                }
+                case ExprKind::IndexSet: {
+                    const auto& set = static_cast<const IndexSet&>(expr);
+                    findInExpr(*set.target->object, scope, found);
+                    findInExpr(*set.target->index, scope, found);
+                    findInExpr(*set.value, scope, found);
+                    break;
+                }
+                case ExprKind::ArrayLiteral:
+                    for (const auto& element : static_cast<const ArrayLiteral&>(expr).elements) {
+                        findInExpr(*element, scope, found);
+                    }
+                    break;
+                case ExprKind::Increment:
+                case ExprKind::Literal:
+                case ExprKind::Variable:
+                    break;
+            }
+        }
+
+        void findInStmt(const Stmt& stmt, const Scope& scope, std::vector<const Expr*>& found) {
+            switch (stmt.kind) {
+                case StmtKind::Block:
+                    for (const auto& inner : static_cast<const BlockStmt&>(stmt).statements) {
+                        if (inner != nullptr) findInStmt(*inner, scope, found);
+                    }
+                    break;
+                case StmtKind::Expression:
+                    findInExpr(*static_cast<const ExpressionStmt&>(stmt).expression, scope, found);
+                    break;
+                case StmtKind::Print:
+                    findInExpr(*static_cast<const PrintStmt&>(stmt).expression, scope, found);
+                    break;
+                case StmtKind::Var: {
+                    const auto& var = static_cast<const VarStmt&>(stmt);
+                    if (var.initializer != nullptr) findInExpr(*var.initializer, scope, found);
+                    break;
+                }
+                case StmtKind::If: {
+                    const auto& branch = static_cast<const IfStmt&>(stmt);
+                    findInExpr(*branch.condition, scope, found);
+                    findInStmt(*branch.thenBranch, scope, found);
+                    if (branch.elseBranch != nullptr) findInStmt(*branch.elseBranch, scope, found);
+                    break;
+                }
+                case StmtKind::While: {
+                    const auto& loop = static_cast<const WhileStmt&>(stmt);
+                    findInExpr(*loop.condition, scope, found);
+                    findInStmt(*loop.body, scope, found);
+                    break;
+                }
+                case StmtKind::For: {
+                    const auto& loop = static_cast<const ForStmt&>(stmt);
+                    if (loop.initializer != nullptr) findInStmt(*loop.initializer, scope, found);
+                    if (loop.condition != nullptr) findInExpr(*loop.condition, scope, found);
+                    if (loop.increment != nullptr) findInExpr(*loop.increment, scope, found);
+                    findInStmt(*loop.body, scope, found);
+                    break;
+                }
+            }
+        }
+
+        const TypeInference& m_types;
+        std::vector<OptimizationNote>& m_notes;
+        std::unordered_map<const Expr*, Token> m_hoisted;
+        std::size_t m_counter = 0;
+    };
+
+    std::vector<std::unique_ptr<Stmt>> Optimizer::optimize(const std::vector<std::unique_ptr<Stmt>>& program) {
+        m_notes.clear();
+
+        StmtList current = BranchFolder(m_notes).statements(program);
+
+        // Remover uma variável pode deixar outra sem leituras.
+        for (;;) {
+            VariableUses uses(current, m_options.wholeProgram);
+            DeadStoreEliminator eliminator(uses, m_notes);
+            StmtList next = eliminator.statements(current);
+            current = std::move(next);
+            if (!eliminator.changed()) break;
+        }
+
+        TypeInference types;
+        types.analyze(current);
+        return LoopHoister(types, m_notes).statements(current);
+    }
+
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "ast/Stmt.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lox {
+
+    // Uma mudança feita pelo otimizador, listada por --print-ast.
+    struct OptimizationNote {
+        int line;
+        std::string message;
+    };
+
+    struct OptimizerOptions {
+        // Globais nunca lidas só podem ser removidas quando o programa está
+        // inteiro (arquivo); no REPL as próximas linhas ainda podem lê-las.
+        bool wholeProgram = true;
+    };
+
+    // Otimizações sobre a AST, ligadas por -O2. Cada passo reconstrói a
+    // árvore (os nós são imutáveis):
+    //
+    // 1. Ramos mortos: if/while com condição constante (literais, !, and/or
+    //    de constantes) perdem o ramo que nunca executa, e statements depois
+    //    de um laço que nunca termina (`while (true)`, `for (;;)`) somem.
+    // 2. Stores mortos: variáveis locais nunca lidas são removidas junto com
+    //    as atribuições a elas; um initializer ou valor que pode ter efeito
+    //    ou lançar erro continua sendo avaliado, como expression statement.
+    // 3. Código invariante: em cada while, subexpressões aritméticas sobre
+    //    variáveis que o laço não altera e que a inferência de tipos
+    //    (TypeInference.hpp) prova serem números são calculadas uma vez,
+    //    antes do laço, em variáveis $invN.
+    //
+    // Só se move ou remove código que não pode lançar erro nem ter efeito
+    // visível, então os erros de execução (mensagem, linha e o que foi
+    // impresso antes deles) são os mesmos do programa original.
+    class Optimizer {
+    public:
+        explicit Optimizer(OptimizerOptions options = {}) : m_options(options) {}
+
+        std::vector<std::unique_ptr<Stmt>> optimize(const std::vector<std::unique_ptr<Stmt>>& program);
+
+        // Mudanças feitas pela última chamada de optimize().
+        const std::vector<OptimizationNote>& notes() const { return m_notes; }
+
+    private:
+        OptimizerOptions m_options;
+        std::vector<OptimizationNote> m_notes;
+    };
+
+}
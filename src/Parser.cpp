@@ -1,21 +1,42 @@
 #include "Parser.hpp"
 #include <iostream>
+#include <optional>
+#include <string>
 #include <vector>
 
 namespace lox {
 
-    template<typename F>
-    std::unique_ptr<Expr> Parser::binary_helper(F&& next_rule, const std::vector<TokenType>& types) {
-        auto expr = (this->*next_rule)();
-        while (match(types)) {
-            const Token op = previous();
-            auto right = (this->*next_rule)();
-            expr = std::make_unique<Binary>(std::move(expr), op, std::move(right));
-        }
-        return expr;
-    }
+    constexpr std::array<Parser::ParseRule, kTokenTypeCount> Parser::s_rules = [] {
+        std::array<ParseRule, kTokenTypeCount> rules{};
+        auto set = [&rules](TokenType type, PrefixFn prefix, InfixFn infix, Precedence precedence) {
+            rules[static_cast<std::size_t>(type)] = ParseRule{prefix, infix, precedence};
+        };
+        set(TokenType::LEFT_PAREN,    &Parser::grouping, &Parser::call,       Precedence::Call);
+        set(TokenType::LEFT_BRACKET,  &Parser::arrayLiteral, &Parser::index,  Precedence::Call);
+        set(TokenType::MINUS,         &Parser::unary,    &Parser::binary,     Precedence::Term);
+        set(TokenType::PLUS,          nullptr,           &Parser::binary,     Precedence::Term);
+        set(TokenType::SLASH,         nullptr,           &Parser::binary,     Precedence::Factor);
+        set(TokenType::STAR,          nullptr,           &Parser::binary,     Precedence::Factor);
+        set(TokenType::BANG,          &Parser::unary,    nullptr,             Precedence::None);
+        set(TokenType::BANG_EQUAL,    nullptr,           &Parser::binary,     Precedence::Equality);
+        set(TokenType::EQUAL_EQUAL,   nullptr,           &Parser::binary,     Precedence::Equality);
+        set(TokenType::GREATER,       nullptr,           &Parser::binary,     Precedence::Comparison);
+        set(TokenType::GREATER_EQUAL, nullptr,           &Parser::binary,     Precedence::Comparison);
+        set(TokenType::LESS,          nullptr,           &Parser::binary,     Precedence::Comparison);
+        set(TokenType::LESS_EQUAL,    nullptr,           &Parser::binary,     Precedence::Comparison);
+        set(TokenType::AND,           nullptr,           &Parser::logical,    Precedence::And);
+        set(TokenType::OR,            nullptr,           &Parser::logical,    Precedence::Or);
+        set(TokenType::EQUAL,         nullptr,           &Parser::assignment, Precedence::Assignment);
+        set(TokenType::IDENTIFIER,    &Parser::variable, nullptr,             Precedence::None);
+        set(TokenType::STRING,        &Parser::literal,  nullptr,             Precedence::None);
+        set(TokenType::NUMBER,        &Parser::literal,  nullptr,             Precedence::None);
+        set(TokenType::FALSE,         &Parser::literal,  nullptr,             Precedence::None);
+        set(TokenType::TRUE,          &Parser::literal,  nullptr,             Precedence::None);
+        set(TokenType::NIL,           &Parser::literal,  nullptr,             Precedence::None);
+        return rules;
+    }();
 
-    Parser::Parser(const std::vector<Token>& tokens) : m_tokens(tokens) {}
+    Parser::Parser(const TokenStream& tokens) : m_tokens(tokens) {}
 
     std::vector<std::unique_ptr<Stmt>> Parser::parse() {
         std::vector<std::unique_ptr<Stmt>> statements;
@@ -27,16 +48,150 @@ namespace lox {
 
     std::unique_ptr<Stmt> Parser::declaration() {
         try {
-            if (match({TokenType::VAR})) return varDeclaration();
-            return statement();
+            int line = m_tokens.line(m_current);
+            std::unique_ptr<Stmt> stmt = match({TokenType::VAR}) ? varDeclaration() : statement();
+            stmt->line = line;
+            return stmt;
         } catch (ParseError& error) {
             synchronize();
             return nullptr;
         }
     }
 
+    // --- Reconhecimento do laço for contado ---
+
+    static bool assignsTo(const Stmt& stmt, const std::string& name);
+
+    // Verdadeiro se a expressão pode atribuir à variável name.
+    static bool assignsTo(const Expr& expr, const std::string& name) {
+        switch (expr.kind) {
+            case ExprKind::ArrayLiteral:
+                for (const auto& element : static_cast<const ArrayLiteral&>(expr).elements) {
+                    if (assignsTo(*element, name)) return true;
+                }
+                return false;
+            case ExprKind::Assign: {
+                const auto& assign = static_cast<const Assign&>(expr);
+                return assign.name.lexeme == name || assignsTo(*assign.value, name);
+            }
+            case ExprKind::Binary: {
+                const auto& binary = static_cast<const Binary&>(expr);
+                return assignsTo(*binary.left, name) || assignsTo(*binary.right, name);
+            }
+            case ExprKind::Call: {
+                const auto& call = static_cast<const Call&>(expr);
+                if (assignsTo(*call.callee, name)) return true;
+                for (const auto& argument : call.arguments) {
+                    if (assignsTo(*argument, name)) return true;
+                }
+                return false;
+            }
+            case ExprKind::Grouping:
+                return assignsTo(*static_cast<const Grouping&>(expr).expression, name);
+            case ExprKind::Increment:
+                return static_cast<const Increment&>(expr).name.lexeme == name;
+            case ExprKind::Index: {
+                const auto& index = static_cast<const Index&>(expr);
+                return assignsTo(*index.object, name) || assignsTo(*index.index, name);
+            }
+            case ExprKind::IndexSet: {
+                const auto& set = static_cast<const IndexSet&>(expr);
+                return assignsTo(*set.target, name) || assignsTo(*set.value, name);
+            }
+            case ExprKind::Logical: {
+                const auto& logical = static_cast<const Logical&>(expr);
+                return assignsTo(*logical.left, name) || assignsTo(*logical.right, name);
+            }
+            case ExprKind::Unary:
+                return assignsTo(*static_cast<const Unary&>(expr).right, name);
+            case ExprKind::Literal:
+            case ExprKind::Variable:
+                return false;
+        }
+        return true;
+    }
+
+    // Um `var name` no corpo também conta: o laço contado não tenta
+    // distinguir a variável sombreada da original.
+    static bool assignsTo(const Stmt& stmt, const std::string& name) {
+        switch (stmt.kind) {
+            case StmtKind::Block:
+                for (const auto& statement : static_cast<const BlockStmt&>(stmt).statements) {
+                    if (statement != nullptr && assignsTo(*statement, name)) return true;
+                }
+                return false;
+            case StmtKind::Expression:
+                return assignsTo(*static_cast<const ExpressionStmt&>(stmt).expression, name);
+            case StmtKind::For: {
+                const auto& loop = static_cast<const ForStmt&>(stmt);
+                return (loop.initializer != nullptr && assignsTo(*loop.initializer, name)) ||
+                       (loop.condition != nullptr && assignsTo(*loop.condition, name)) ||
+                       (loop.increment != nullptr && assignsTo(*loop.increment, name)) ||
+                       assignsTo(*loop.body, name);
+            }
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                return assignsTo(*branch.condition, name) || assignsTo(*branch.thenBranch, name) ||
+                       (branch.elseBranch != nullptr && assignsTo(*branch.elseBranch, name));
+            }
+            case StmtKind::Print:
+                return assignsTo(*static_cast<const PrintStmt&>(stmt).expression, name);
+            case StmtKind::Var: {
+                const auto& var = static_cast<const VarStmt&>(stmt);
+                return var.name.lexeme == name || (var.initializer != nullptr && assignsTo(*var.initializer, name));
+            }
+            case StmtKind::While: {
+                const auto& loop = static_cast<const WhileStmt&>(stmt);
+                return assignsTo(*loop.condition, name) || assignsTo(*loop.body, name);
+            }
+        }
+        return true;
+    }
+
+    // Se o for tem a forma `var i = a; i <op> n; i = i +/- k` (k literal
+    // numérico) e nem n nem o corpo atribuem a i, retorna o incremento
+    // reescrito como Increment.
+    static std::unique_ptr<Expr> countedIncrement(const Stmt* initializer, const Expr* condition,
+                                                  const Expr* increment, const Stmt& body) {
+        if (initializer == nullptr || initializer->kind != StmtKind::Var) return nullptr;
+        const auto& var = static_cast<const VarStmt&>(*initializer);
+        const std::string& name = var.name.lexeme;
+        if (var.initializer == nullptr) return nullptr;
+
+        if (condition == nullptr || condition->kind != ExprKind::Binary) return nullptr;
+        const auto& test = static_cast<const Binary&>(*condition);
+        switch (test.op.type) {
+            case TokenType::LESS:
+            case TokenType::LESS_EQUAL:
+            case TokenType::GREATER:
+            case TokenType::GREATER_EQUAL:
+                break;
+            default:
+                return nullptr;
+        }
+        if (test.left->kind != ExprKind::Variable || static_cast<const Variable&>(*test.left).name.lexeme != name) {
+            return nullptr;
+        }
+
+        if (increment == nullptr || increment->kind != ExprKind::Assign) return nullptr;
+        const auto& assign = static_cast<const Assign&>(*increment);
+        if (assign.name.lexeme != name || assign.value->kind != ExprKind::Binary) return nullptr;
+        const auto& sum = static_cast<const Binary&>(*assign.value);
+        if (sum.op.type != TokenType::PLUS && sum.op.type != TokenType::MINUS) return nullptr;
+        if (sum.left->kind != ExprKind::Variable || static_cast<const Variable&>(*sum.left).name.lexeme != name) {
+            return nullptr;
+        }
+        if (sum.right->kind != ExprKind::Literal) return nullptr;
+        auto step = std::get_if<double>(&static_cast<const Literal&>(*sum.right).value);
+        if (step == nullptr) return nullptr;
+
+        if (assignsTo(*test.right, name) || assignsTo(body, name)) return nullptr;
+        return std::make_unique<Increment>(assign.name, sum.op, sum.op.type == TokenType::PLUS ? *step : -*step);
+    }
+
     std::unique_ptr<Stmt> Parser::varDeclaration() {
-        Token name = consume(TokenType::IDENTIFIER, "Expect variable name.");
+        consume(TokenType::IDENTIFIER, "Expect variable name.");
+        Token name = previous();
         std::unique_ptr<Expr> initializer = nullptr;
         if (match({TokenType::EQUAL})) {
             initializer = expression();
@@ -46,13 +201,50 @@ namespace lox {
     }
 
     std::unique_ptr<Stmt> Parser::statement() {
-        if (match({TokenType::IF})) return ifStatement();
-        if (match({TokenType::PRINT})) return printStatement();
-        if (match({TokenType::WHILE})) return whileStatement();
-        if (match({TokenType::LEFT_BRACE})) {
-            return std::make_unique<BlockStmt>(block());
+        int line = m_tokens.line(m_current);
+        std::unique_ptr<Stmt> stmt;
+        if (match({TokenType::FOR})) stmt = forStatement();
+        else if (match({TokenType::IF})) stmt = ifStatement();
+        else if (match({TokenType::PRINT})) stmt = printStatement();
+        else if (match({TokenType::WHILE})) stmt = whileStatement();
+        else if (match({TokenType::LEFT_BRACE})) stmt = std::make_unique<BlockStmt>(block());
+        else stmt = expressionStatement();
+        stmt->line = line;
+        return stmt;
+    }
+
+    std::unique_ptr<Stmt> Parser::forStatement() {
+        consume(TokenType::LEFT_PAREN, "Expect '(' after 'for'.");
+
+        std::unique_ptr<Stmt> initializer = nullptr;
+        int line = m_tokens.line(m_current);
+        if (match({TokenType::SEMICOLON})) {
+            // sem initializer
+        } else if (match({TokenType::VAR})) {
+            initializer = varDeclaration();
+        } else {
+            initializer = expressionStatement();
+        }
+        if (initializer != nullptr) initializer->line = line;
+
+        std::unique_ptr<Expr> condition = nullptr;
+        if (!check(TokenType::SEMICOLON)) {
+            condition = expression();
         }
-        return expressionStatement();
+        consume(TokenType::SEMICOLON, "Expect ';' after loop condition.");
+
+        std::unique_ptr<Expr> increment = nullptr;
+        if (!check(TokenType::RIGHT_PAREN)) {
+            increment = expression();
+        }
+        consume(TokenType::RIGHT_PAREN, "Expect ')' after for clauses.");
+        auto body = statement();
+
+        auto counted = countedIncrement(initializer.get(), condition.get(), increment.get(), *body);
+        bool isCounted = counted != nullptr;
+        if (isCounted) increment = std::move(counted);
+        return std::make_unique<ForStmt>(std::move(initializer), std::move(condition), std::move(increment),
+                                         std::move(body), isCounted);
     }
 
     std::unique_ptr<Stmt> Parser::ifStatement() {
@@ -100,71 +292,119 @@ namespace lox {
     }
 
     std::unique_ptr<Expr> Parser::expression() {
-        return assignment();
+        return parsePrecedence(Precedence::Assignment);
     }
 
-    std::unique_ptr<Expr> Parser::assignment() {
-        auto expr = equality();
-        if (match({TokenType::EQUAL})) {
-            Token equals = previous();
-            auto value = assignment();
-            if (auto* var = dynamic_cast<Variable*>(expr.get())) {
-                return std::make_unique<Assign>(var->name, std::move(value));
-            }
-            // CORREÇÃO CRÍTICA: Lançar a exceção de erro.
-            throw error(equals, "Invalid assignment target.");
+    // Consome um prefixo e depois todos os operadores infix cuja precedência
+    // seja pelo menos a pedida.
+    std::unique_ptr<Expr> Parser::parsePrecedence(Precedence precedence) {
+        PrefixFn prefix = s_rules[static_cast<std::size_t>(m_tokens.type(m_current))].prefix;
+        if (prefix == nullptr) {
+            throw error(peek(), "Expect expression.");
+        }
+        advance();
+        std::unique_ptr<Expr> expr = (this->*prefix)();
+
+        while (true) {
+            const ParseRule& rule = s_rules[static_cast<std::size_t>(m_tokens.type(m_current))];
+            if (rule.precedence == Precedence::None || rule.precedence < precedence) break;
+            advance();
+            expr = (this->*rule.infix)(std::move(expr));
         }
         return expr;
     }
 
-    std::unique_ptr<Expr> Parser::equality() {
-        return binary_helper(&Parser::comparison, {TokenType::BANG_EQUAL, TokenType::EQUAL_EQUAL});
+    std::unique_ptr<Expr> Parser::grouping() {
+        auto expr = expression();
+        consume(TokenType::RIGHT_PAREN, "Expect ')' after expression.");
+        return std::make_unique<Grouping>(std::move(expr));
+    }
+
+    std::unique_ptr<Expr> Parser::arrayLiteral() {
+        Token bracket = previous();
+        std::vector<std::unique_ptr<Expr>> elements;
+        if (!check(TokenType::RIGHT_BRACKET)) {
+            do {
+                elements.push_back(expression());
+            } while (match({TokenType::COMMA}));
+        }
+        consume(TokenType::RIGHT_BRACKET, "Expect ']' after array elements.");
+        return std::make_unique<ArrayLiteral>(std::move(bracket), std::move(elements));
     }
 
-    std::unique_ptr<Expr> Parser::comparison() {
-        return binary_helper(&Parser::term, {TokenType::GREATER, TokenType::GREATER_EQUAL, TokenType::LESS, TokenType::LESS_EQUAL});
+    std::unique_ptr<Expr> Parser::literal() {
+        switch (m_tokens.type(m_current - 1)) {
+            case TokenType::FALSE: return std::make_unique<Literal>(Value{false});
+            case TokenType::TRUE: return std::make_unique<Literal>(Value{true});
+            case TokenType::NIL: return std::make_unique<Literal>(Value{std::monostate{}});
+            default: return std::make_unique<Literal>(m_tokens.literal(m_current - 1));
+        }
     }
 
-    std::unique_ptr<Expr> Parser::term() {
-        return binary_helper(&Parser::factor, {TokenType::MINUS, TokenType::PLUS});
+    std::unique_ptr<Expr> Parser::unary() {
+        Token op = previous();
+        auto right = parsePrecedence(Precedence::Unary);
+        return std::make_unique<Unary>(std::move(op), std::move(right));
     }
 
-    std::unique_ptr<Expr> Parser::factor() {
-        return binary_helper(&Parser::unary, {TokenType::SLASH, TokenType::STAR});
+    std::unique_ptr<Expr> Parser::variable() {
+        return std::make_unique<Variable>(previous());
     }
 
-    std::unique_ptr<Expr> Parser::unary() {
-        if (match({TokenType::BANG, TokenType::MINUS})) {
-            Token op = previous();
-            auto right = unary();
-            return std::make_unique<Unary>(std::move(op), std::move(right));
-        }
-        return primary();
+    // Operadores binários são associativos à esquerda: o lado direito só
+    // aceita operadores de precedência estritamente maior.
+    std::unique_ptr<Expr> Parser::binary(std::unique_ptr<Expr> left) {
+        Token op = previous();
+        const ParseRule& rule = s_rules[static_cast<std::size_t>(op.type)];
+        auto next = static_cast<Precedence>(static_cast<std::uint8_t>(rule.precedence) + 1);
+        auto right = parsePrecedence(next);
+        return std::make_unique<Binary>(std::move(left), std::move(op), std::move(right));
     }
 
-    std::unique_ptr<Expr> Parser::primary() {
-        if (match({TokenType::FALSE})) return std::make_unique<Literal>(Value{false});
-        if (match({TokenType::TRUE})) return std::make_unique<Literal>(Value{true});
-        if (match({TokenType::NIL})) return std::make_unique<Literal>(Value{std::monostate{}});
-        
-        if (match({TokenType::NUMBER, TokenType::STRING})) {
-            return std::make_unique<Literal>(previous().literal);
-        }
+    std::unique_ptr<Expr> Parser::logical(std::unique_ptr<Expr> left) {
+        Token op = previous();
+        const ParseRule& rule = s_rules[static_cast<std::size_t>(op.type)];
+        auto next = static_cast<Precedence>(static_cast<std::uint8_t>(rule.precedence) + 1);
+        auto right = parsePrecedence(next);
+        return std::make_unique<Logical>(std::move(left), std::move(op), std::move(right));
+    }
 
-        if (match({TokenType::IDENTIFIER})) {
-            return std::make_unique<Variable>(previous());
+    std::unique_ptr<Expr> Parser::call(std::unique_ptr<Expr> callee) {
+        std::vector<std::unique_ptr<Expr>> arguments;
+        if (!check(TokenType::RIGHT_PAREN)) {
+            do {
+                if (arguments.size() >= 255) {
+                    error(peek(), "Can't have more than 255 arguments.");
+                }
+                arguments.push_back(expression());
+            } while (match({TokenType::COMMA}));
         }
+        consume(TokenType::RIGHT_PAREN, "Expect ')' after arguments.");
+        return std::make_unique<Call>(std::move(callee), previous(), std::move(arguments));
+    }
 
-        if (match({TokenType::LEFT_PAREN})) {
-            auto expr = expression();
-            consume(TokenType::RIGHT_PAREN, "Expect ')' after expression.");
-            return std::make_unique<Grouping>(std::move(expr));
-        }
+    std::unique_ptr<Expr> Parser::index(std::unique_ptr<Expr> object) {
+        Token bracket = previous();
+        auto position = expression();
+        consume(TokenType::RIGHT_BRACKET, "Expect ']' after index.");
+        return std::make_unique<Index>(std::move(object), std::move(bracket), std::move(position));
+    }
 
-        throw error(peek(), "Expect expression.");
+    // A atribuição é associativa à direita.
+    std::unique_ptr<Expr> Parser::assignment(std::unique_ptr<Expr> target) {
+        Token equals = previous();
+        auto value = parsePrecedence(Precedence::Assignment);
+        if (target->kind == ExprKind::Variable) {
+            return std::make_unique<Assign>(static_cast<Variable&>(*target).name, std::move(value));
+        }
+        if (target->kind == ExprKind::Index) {
+            std::unique_ptr<Index> element(static_cast<Index*>(target.release()));
+            return std::make_unique<IndexSet>(std::move(element), std::move(value));
+        }
+        throw error(equals, "Invalid assignment target.");
     }
     
-    bool Parser::match(const std::vector<TokenType>& types) {
+    bool Parser::match(std::initializer_list<TokenType> types) {
         for (TokenType type : types) {
             if (check(type)) {
                 advance();
@@ -174,34 +414,37 @@ namespace lox {
         return false;
     }
     
-    const Token& Parser::consume(TokenType type, const std::string& message) {
-        if (check(type)) return advance();
+    void Parser::consume(TokenType type, const std::string& message) {
+        if (check(type)) {
+            advance();
+            return;
+        }
         throw error(peek(), message);
     }
     
     bool Parser::check(TokenType type) const {
         if (isAtEnd()) return false;
-        return peek().type == type;
+        return m_tokens.type(m_current) == type;
     }
     
-    const Token& Parser::advance() {
+    void Parser::advance() {
         if (!isAtEnd()) m_current++;
-        return previous();
     }
     
     bool Parser::isAtEnd() const {
-        return peek().type == TokenType::END_OF_FILE;
+        return m_tokens.type(m_current) == TokenType::END_OF_FILE;
     }
     
-    const Token& Parser::peek() const {
-        return m_tokens.at(m_current);
+    Token Parser::peek() const {
+        return m_tokens.token(m_current);
     }
     
-    const Token& Parser::previous() const {
-        return m_tokens.at(m_current - 1);
+    Token Parser::previous() const {
+        return m_tokens.token(m_current - 1);
     }
     
     Parser::ParseError Parser::error(const Token& token, const std::string& message) {
+        m_hadError = true;
         std::cerr << "[line " << token.line << "] Error";
         if (token.type == TokenType::END_OF_FILE) {
             std::cerr << " at end";
@@ -215,8 +458,8 @@ namespace lox {
     void Parser::synchronize() {
         advance();
         while (!isAtEnd()) {
-            if (previous().type == TokenType::SEMICOLON) return;
-            switch (peek().type) {
+            if (m_tokens.type(m_current - 1) == TokenType::SEMICOLON) return;
+            switch (m_tokens.type(m_current)) {
                 case TokenType::CLASS:
                 case TokenType::FUN:
                 case TokenType::VAR:
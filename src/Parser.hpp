@@ -1,8 +1,13 @@
 #pragma once
 
 #include "Token.hpp"
+#include "TokenStream.hpp"
 #include "ast/Expr.hpp"
 #include "ast/Stmt.hpp"
+#include "Stats.hpp"
+#include <array>
+#include <cstdint>
+#include <initializer_list>
 #include <vector>
 #include <memory>
 #include <stdexcept>
@@ -12,29 +17,59 @@ namespace lox {
 
     class Parser {
     public:
-        Parser(const std::vector<Token>& tokens);
+        Parser(const TokenStream& tokens);
         std::vector<std::unique_ptr<Stmt>> parse();
 
+        // Verdadeiro se algum erro de sintaxe foi reportado por parse().
+        bool hadError() const { return m_hadError; }
+
         class ParseError : public std::runtime_error {
         public:
-            ParseError() : std::runtime_error("") {}
+            ParseError() : std::runtime_error("") {
+                Stats::exceptionThrown();
+            }
         };
 
     private:
-        // --- Métodos para Regras da Gramática ---
+        // --- Expressões (Pratt / precedence climbing) ---
+
+        // Níveis de precedência, do mais fraco para o mais forte.
+        enum class Precedence : std::uint8_t {
+            None, Assignment, Or, And, Equality, Comparison, Term, Factor, Unary, Call, Primary
+        };
+
+        using PrefixFn = std::unique_ptr<Expr> (Parser::*)();
+        using InfixFn = std::unique_ptr<Expr> (Parser::*)(std::unique_ptr<Expr>);
+
+        // Como cada tipo de token se comporta no início (prefix) ou no meio
+        // (infix) de uma expressão. Tokens sem infix têm Precedence::None.
+        struct ParseRule {
+            PrefixFn prefix = nullptr;
+            InfixFn infix = nullptr;
+            Precedence precedence = Precedence::None;
+        };
+
+        // Tabela indexada por TokenType, montada em tempo de compilação.
+        static const std::array<ParseRule, kTokenTypeCount> s_rules;
+
         std::unique_ptr<Expr> expression();
-        std::unique_ptr<Expr> assignment();
-        std::unique_ptr<Expr> equality();
-        std::unique_ptr<Expr> comparison();
-        std::unique_ptr<Expr> term();
-        std::unique_ptr<Expr> factor();
+        std::unique_ptr<Expr> parsePrecedence(Precedence precedence);
+
+        std::unique_ptr<Expr> grouping();
+        std::unique_ptr<Expr> arrayLiteral();
+        std::unique_ptr<Expr> literal();
         std::unique_ptr<Expr> unary();
-        std::unique_ptr<Expr> call();
-        std::unique_ptr<Expr> primary();
+        std::unique_ptr<Expr> variable();
+        std::unique_ptr<Expr> binary(std::unique_ptr<Expr> left);
+        std::unique_ptr<Expr> logical(std::unique_ptr<Expr> left);
+        std::unique_ptr<Expr> call(std::unique_ptr<Expr> callee);
+        std::unique_ptr<Expr> index(std::unique_ptr<Expr> object);
+        std::unique_ptr<Expr> assignment(std::unique_ptr<Expr> target);
         
         std::unique_ptr<Stmt> declaration();
         std::unique_ptr<Stmt> varDeclaration();
         std::unique_ptr<Stmt> statement();
+        std::unique_ptr<Stmt> forStatement();
         std::unique_ptr<Stmt> ifStatement();
         std::unique_ptr<Stmt> printStatement();
         std::unique_ptr<Stmt> whileStatement();
@@ -43,24 +78,23 @@ namespace lox {
         
         // --- Métodos Auxiliares do Parser ---
         
-        // A função binary_helper agora é um método privado.
-        template<typename F>
-        std::unique_ptr<Expr> binary_helper(F&& next_rule, const std::vector<TokenType>& types);
-        
-        bool match(const std::vector<TokenType>& types);
+        bool match(std::initializer_list<TokenType> types);
         bool check(TokenType type) const;
         bool isAtEnd() const;
-        const Token& advance();
-        const Token& peek() const;
-        const Token& previous() const;
-        const Token& consume(TokenType type, const std::string& message);
+        // peek/previous materializam um Token; use check() ou o tipo
+        // diretamente do stream quando só o tipo interessa.
+        void advance();
+        Token peek() const;
+        Token previous() const;
+        void consume(TokenType type, const std::string& message);
         
         ParseError error(const Token& token, const std::string& message);
         void synchronize();
 
         // --- Estado do Parser ---
-        const std::vector<Token>& m_tokens;
+        const TokenStream& m_tokens;
         int m_current = 0;
+        bool m_hadError = false;
     };
 
 } // Fecha o namespace lox
\ No newline at end of file
@@ -2,6 +2,7 @@
 
 #include <stdexcept>
 #include "Token.hpp"
+#include "Stats.hpp"
 
 namespace lox {
 
@@ -17,7 +18,9 @@ public:
      */
     RuntimeError(const Token& token, const std::string& message)
         // Chama o construtor da classe pai (std::runtime_error) com a mensagem
-        : std::runtime_error(message), token(token) {}
+        : std::runtime_error(message), token(token) {
+        Stats::exceptionThrown();
+    }
 };
 
 } 
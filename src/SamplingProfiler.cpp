@@ -0,0 +1,111 @@
+#include "SamplingProfiler.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <vector>
+#include <sys/time.h>
+
+namespace lox {
+
+    // Profiler ativo, lido pelo tratador de sinal.
+    static std::atomic<SamplingProfiler*> g_activeProfiler{nullptr};
+
+    SamplingProfiler::SamplingProfiler(int frequencyHz)
+        : m_table(new Entry[kTableSize]()), m_frequencyHz(std::max(1, frequencyHz)) {}
+
+    SamplingProfiler::~SamplingProfiler() {
+        stop();
+    }
+
+    bool SamplingProfiler::start() {
+        SamplingProfiler* expected = nullptr;
+        if (!g_activeProfiler.compare_exchange_strong(expected, this)) return false;
+
+        struct sigaction action = {};
+        action.sa_handler = &SamplingProfiler::handleSignal;
+        action.sa_flags = SA_RESTART;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGPROF, &action, nullptr);
+
+        long intervalUs = 1000000L / m_frequencyHz;
+        struct itimerval timer = {};
+        timer.it_interval.tv_sec = intervalUs / 1000000L;
+        timer.it_interval.tv_usec = intervalUs % 1000000L;
+        timer.it_value = timer.it_interval;
+        if (setitimer(ITIMER_PROF, &timer, nullptr) != 0) {
+            signal(SIGPROF, SIG_DFL);
+            g_activeProfiler.store(nullptr);
+            return false;
+        }
+        m_running = true;
+        return true;
+    }
+
+    void SamplingProfiler::stop() {
+        if (!m_running) return;
+        struct itimerval timer = {};
+        setitimer(ITIMER_PROF, &timer, nullptr);
+        signal(SIGPROF, SIG_IGN);
+        g_activeProfiler.store(nullptr);
+        m_running = false;
+    }
+
+    void SamplingProfiler::handleSignal(int) {
+        SamplingProfiler* profiler = g_activeProfiler.load(std::memory_order_relaxed);
+        if (profiler != nullptr) profiler->record();
+    }
+
+    // Executado dentro do tratador de sinal: apenas leituras e escritas em
+    // memória pré-alocada.
+    void SamplingProfiler::record() {
+        std::atomic_signal_fence(std::memory_order_acquire);
+        int depth = std::min(m_stack.depth(), ExecutionStack::kMaxDepth);
+
+        std::uint64_t hash = 1469598103934665603ULL;
+        for (int i = 0; i < depth; ++i) {
+            hash = (hash ^ m_stack.frame(i)) * 1099511628211ULL;
+        }
+        hash = (hash ^ static_cast<std::uint64_t>(depth)) * 1099511628211ULL;
+
+        m_samples++;
+        for (std::size_t probe = 0; probe < kTableSize; ++probe) {
+            Entry& entry = m_table[(hash + probe) & (kTableSize - 1)];
+            if (entry.count == 0) {
+                entry.hash = hash;
+                entry.depth = depth;
+                for (int i = 0; i < depth; ++i) entry.frames[i] = m_stack.frame(i);
+                entry.count = 1;
+                return;
+            }
+            if (entry.hash == hash && entry.depth == depth) {
+                int i = 0;
+                while (i < depth && entry.frames[i] == m_stack.frame(i)) ++i;
+                if (i == depth) {
+                    entry.count++;
+                    return;
+                }
+            }
+        }
+        m_dropped++;
+    }
+
+    void SamplingProfiler::writeFolded(std::ostream& out) const {
+        std::vector<const Entry*> entries;
+        for (std::size_t i = 0; i < kTableSize; ++i) {
+            if (m_table[i].count > 0) entries.push_back(&m_table[i]);
+        }
+        std::sort(entries.begin(), entries.end(), [](const Entry* a, const Entry* b) {
+            return a->count > b->count;
+        });
+
+        for (const Entry* entry : entries) {
+            out << "lox";
+            for (int i = 0; i < entry->depth; ++i) {
+                std::uint32_t frame = entry->frames[i];
+                out << ";" << stmtKindName(static_cast<StmtKind>(frame & 0xFF)) << "@" << (frame >> 8);
+            }
+            out << " " << entry->count << "\n";
+        }
+    }
+
+}
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "ast/Stmt.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+namespace lox {
+
+    // Pilha "sombra" dos statements em execução, mantida pelo Interpreter
+    // enquanto um SamplingProfiler está ativo. Cada frame ocupa 32 bits
+    // (linha << 8 | StmtKind) para que o tratador de sinal copie tudo barato.
+    class ExecutionStack {
+    public:
+        static constexpr int kMaxDepth = 64;
+
+        // Um store do frame e um da profundidade. Além de kMaxDepth os
+        // frames caem todos na posição extra, que o tratador nunca lê.
+        void push(StmtKind kind, int line) {
+            int depth = m_depth.load(std::memory_order_relaxed);
+            m_frames[depth < kMaxDepth ? depth : kMaxDepth] =
+                (static_cast<std::uint32_t>(line) << 8) | static_cast<std::uint32_t>(kind);
+            std::atomic_signal_fence(std::memory_order_release);
+            m_depth.store(depth + 1, std::memory_order_relaxed);
+        }
+
+        void pop() {
+            m_depth.store(m_depth.load(std::memory_order_relaxed) - 1, std::memory_order_relaxed);
+        }
+
+        int depth() const { return m_depth.load(std::memory_order_relaxed); }
+        std::uint32_t frame(int index) const { return m_frames[index]; }
+
+    private:
+        std::uint32_t m_frames[kMaxDepth + 1] = {};
+        std::atomic<int> m_depth{0};
+    };
+
+    // Profiler por amostragem: um timer (SIGPROF, tempo de CPU) interrompe o
+    // processo periodicamente e o tratador registra a pilha Lox atual.
+    // As amostras são agregadas por pilha em uma tabela pré-alocada, sem
+    // alocação nem locks dentro do tratador. Só um profiler pode estar ativo.
+    // As threads dos isolates bloqueiam SIGPROF (Isolate::spawn), então o
+    // tratador sempre roda na thread dona da pilha.
+    class SamplingProfiler {
+    public:
+        explicit SamplingProfiler(int frequencyHz = 997);
+        ~SamplingProfiler();
+
+        SamplingProfiler(const SamplingProfiler&) = delete;
+        SamplingProfiler& operator=(const SamplingProfiler&) = delete;
+
+        // Instala o tratador de sinal e arma o timer. Retorna false se outro
+        // profiler já estiver ativo ou se o sistema recusar o timer.
+        bool start();
+        void stop();
+
+        ExecutionStack& stack() { return m_stack; }
+
+        std::uint64_t sampleCount() const { return m_samples; }
+        std::uint64_t droppedSamples() const { return m_dropped; }
+
+        // Escreve as pilhas no formato "folded" (frame;frame;... contagem),
+        // aceito por flamegraph.pl, inferno e speedscope.
+        void writeFolded(std::ostream& out) const;
+
+    private:
+        struct Entry {
+            std::uint64_t hash;
+            std::uint64_t count;
+            int depth;
+            std::uint32_t frames[ExecutionStack::kMaxDepth];
+        };
+
+        static constexpr std::size_t kTableSize = 4096;
+
+        static void handleSignal(int signal);
+        void record();
+
+        ExecutionStack m_stack;
+        std::unique_ptr<Entry[]> m_table;
+        std::uint64_t m_samples = 0;
+        std::uint64_t m_dropped = 0;
+        int m_frequencyHz;
+        bool m_running = false;
+    };
+
+}
@@ -2,8 +2,11 @@
 #include <iostream>
 #include <map>
 #include <cctype>
+#include <charconv>
+#include <string_view>
 
-static const std::map<std::string, TokenType> keywords = {
+// std::less<> permite buscar com std::string_view sem alocar uma string.
+static const std::map<std::string, TokenType, std::less<>> keywords = {
     {"and",    TokenType::AND}, {"class",  TokenType::CLASS},
     {"else",   TokenType::ELSE}, {"false",  TokenType::FALSE},
     {"for",    TokenType::FOR}, {"fun",    TokenType::FUN},
@@ -14,32 +17,32 @@ static const std::map<std::string, TokenType> keywords = {
     {"var",    TokenType::VAR}, {"while",  TokenType::WHILE}
 };
 
-Scanner::Scanner(const std::string& source)
-    : m_source(source) {}
+Scanner::Scanner(const std::string& source, int firstLine)
+    : m_source(source), m_tokens(source, firstLine), m_line(firstLine) {}
 
-std::vector<Token> Scanner::scanTokens() {
+TokenStream Scanner::scanTokens() {
     while (!isAtEnd()) {
         m_start = m_current;
         scanToken();
     }
 
-    m_tokens.emplace_back(TokenType::END_OF_FILE, "", lox::Value{std::monostate{}}, m_line);
-    return m_tokens;
+    m_tokens.add(TokenType::END_OF_FILE, m_source.length(), 0);
+    return std::move(m_tokens);
 }
 
-void Scanner::addToken(TokenType type, const lox::Value& literal) {
-    std::string text = m_source.substr(m_start, m_current - m_start);
-    m_tokens.emplace_back(type, text, literal, m_line);
+void Scanner::addToken(TokenType type) {
+    m_tokens.add(type, m_start, m_current - m_start);
 }
 
-void Scanner::addToken(TokenType type) {
-    addToken(type, lox::Value{std::monostate{}});
+// Chamado logo após consumir um '\n'.
+void Scanner::newline() {
+    m_line++;
+    m_tokens.addLineStart(m_current);
 }
 
 void Scanner::string() {
     while (peek() != '"' && !isAtEnd()) {
-        if (peek() == '\n') m_line++;
-        advance();
+        if (advance() == '\n') newline();
     }
 
     if (isAtEnd()) {
@@ -49,8 +52,8 @@ void Scanner::string() {
 
     advance(); 
 
-    std::string value = m_source.substr(m_start + 1, m_current - m_start - 2);
-    addToken(TokenType::STRING, value);
+    // O valor (lexema sem aspas) é obtido do código-fonte quando necessário.
+    addToken(TokenType::STRING);
 }
 
 void Scanner::number() {
@@ -61,14 +64,15 @@ void Scanner::number() {
         while (isdigit(peek())) advance();
     }
     
-    double value = std::stod(m_source.substr(m_start, m_current - m_start));
-    addToken(TokenType::NUMBER, value);
+    double value = 0.0;
+    std::from_chars(m_source.data() + m_start, m_source.data() + m_current, value);
+    m_tokens.addNumber(m_start, m_current - m_start, value);
 }
 
 void Scanner::identifier() {
     while (isalnum(peek()) || peek() == '_') advance();
 
-    std::string text = m_source.substr(m_start, m_current - m_start);
+    std::string_view text(m_source.data() + m_start, m_current - m_start);
     auto it = keywords.find(text);
     TokenType type = (it == keywords.end()) ? TokenType::IDENTIFIER : it->second;
     addToken(type);
@@ -94,6 +98,8 @@ void Scanner::scanToken() {
         case ')': addToken(TokenType::RIGHT_PAREN); break;
         case '{': addToken(TokenType::LEFT_BRACE); break;
         case '}': addToken(TokenType::RIGHT_BRACE); break;
+        case '[': addToken(TokenType::LEFT_BRACKET); break;
+        case ']': addToken(TokenType::RIGHT_BRACKET); break;
         case ',': addToken(TokenType::COMMA); break;
         case '.': addToken(TokenType::DOT); break;
         case '-': addToken(TokenType::MINUS); break;
@@ -109,7 +115,7 @@ void Scanner::scanToken() {
             else { addToken(TokenType::SLASH); }
             break;
         case ' ': case '\r': case '\t': break;
-        case '\n': m_line++; break;
+        case '\n': newline(); break;
         case '"': string(); break;
         default:
             if (isdigit(c)) { number(); }
@@ -1,14 +1,13 @@
 #pragma once
 
 #include <string>
-#include <vector>
 #include "Token.hpp"
-#include "Value.hpp" 
+#include "TokenStream.hpp"
 
 class Scanner {
 public:
-    Scanner(const std::string& source);
-    std::vector<Token> scanTokens();
+    Scanner(const std::string& source, int firstLine = 1);
+    TokenStream scanTokens();
 
 private:
     bool isAtEnd() const;
@@ -16,7 +15,7 @@ private:
     char advance();
  
     void addToken(TokenType type);
-    void addToken(TokenType type, const lox::Value& literal);
+    void newline();
 
     bool match(char expected);
     char peek() const;
@@ -26,8 +25,8 @@ private:
     void identifier();
 
     const std::string& m_source;
-    std::vector<Token> m_tokens;
+    TokenStream m_tokens;
     size_t m_start = 0;
     size_t m_current = 0;
     int m_line = 1;
-};
\ No newline at end of file
+};
@@ -0,0 +1,379 @@
+#include "ScriptServer.hpp"
+
+#include "Interpreter.hpp"
+#include "Optimizer.hpp"
+#include "Parser.hpp"
+#include "Scanner.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <iostream>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <streambuf>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+namespace lox {
+
+    static constexpr std::uint32_t kMaxRequestBytes = 64u * 1024u * 1024u;
+    static constexpr std::size_t kFrameHeaderBytes = 5;
+
+    static volatile std::sig_atomic_t g_stopRequested = 0;
+
+    static void requestStop(int) {
+        g_stopRequested = 1;
+    }
+
+    // Só interrompe o ppoll; os filhos são recolhidos no laço de serve().
+    static void childExited(int) {}
+
+    static std::runtime_error systemError(const std::string& what) {
+        return std::runtime_error(what + ": " + std::strerror(errno));
+    }
+
+    // Fecha o descritor ao sair do escopo.
+    class FdGuard {
+    public:
+        explicit FdGuard(int fd) : m_fd(fd) {}
+        ~FdGuard() { if (m_fd >= 0) close(m_fd); }
+        FdGuard(const FdGuard&) = delete;
+        FdGuard& operator=(const FdGuard&) = delete;
+        int get() const { return m_fd; }
+
+    private:
+        int m_fd;
+    };
+
+    static bool writeAll(int fd, const void* data, std::size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            ssize_t written = send(fd, bytes, size, MSG_NOSIGNAL);
+            if (written < 0 && errno == EINTR) continue;
+            if (written <= 0) return false;
+            bytes += written;
+            size -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    using Deadline = std::chrono::steady_clock::time_point;
+
+    // Com um prazo, espera os dados com poll e desiste (false) quando ele
+    // passa.
+    static bool readAll(int fd, void* data, std::size_t size, Deadline deadline = Deadline::max()) {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            if (deadline != Deadline::max()) {
+                auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+                if (left.count() <= 0) return false;
+                pollfd readable = {fd, POLLIN, 0};
+                int ready = poll(&readable, 1, static_cast<int>(left.count()));
+                if (ready < 0 && errno == EINTR) continue;
+                if (ready <= 0) return false;
+            }
+            ssize_t received = recv(fd, bytes, size, 0);
+            if (received < 0 && errno == EINTR) continue;
+            if (received <= 0) return false;
+            bytes += received;
+            size -= static_cast<std::size_t>(received);
+        }
+        return true;
+    }
+
+    static bool writeFrame(int fd, FrameType type, const char* data, std::uint32_t size) {
+        char header[kFrameHeaderBytes];
+        header[0] = static_cast<char>(type);
+        std::memcpy(header + 1, &size, sizeof(size));
+        return writeAll(fd, header, sizeof(header)) && writeAll(fd, data, size);
+    }
+
+    static std::uint64_t contentHash(const std::string& source) {
+        std::uint64_t hash = 1469598103934665603ULL;
+        for (unsigned char c : source) {
+            hash = (hash ^ c) * 1099511628211ULL;
+        }
+        return hash;
+    }
+
+    static sockaddr_un socketAddress(const std::string& path) {
+        sockaddr_un address = {};
+        address.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(address.sun_path)) {
+            throw std::runtime_error("Socket path too long: " + path);
+        }
+        std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+        return address;
+    }
+
+    // streambuf que envia o que for escrito como quadros do tipo dado.
+    // Cada flush (std::endl, por exemplo) gera um quadro.
+    class FrameStreamBuf : public std::streambuf {
+    public:
+        FrameStreamBuf(int fd, FrameType type) : m_fd(fd), m_type(type) {
+            setp(m_buffer, m_buffer + sizeof(m_buffer));
+        }
+
+    protected:
+        int overflow(int ch) override {
+            if (flushBuffer() != 0) return traits_type::eof();
+            if (!traits_type::eq_int_type(ch, traits_type::eof())) {
+                *pptr() = traits_type::to_char_type(ch);
+                pbump(1);
+            }
+            return traits_type::not_eof(ch);
+        }
+
+        int sync() override {
+            return flushBuffer();
+        }
+
+    private:
+        int flushBuffer() {
+            auto size = static_cast<std::uint32_t>(pptr() - pbase());
+            setp(m_buffer, m_buffer + sizeof(m_buffer));
+            if (size == 0) return 0;
+            return writeFrame(m_fd, m_type, m_buffer, size) ? 0 : -1;
+        }
+
+        int m_fd;
+        FrameType m_type;
+        char m_buffer[4096];
+    };
+
+    ScriptServer::ScriptServer(std::string socketPath, ServeOptions options)
+        : m_socketPath(std::move(socketPath)), m_options(options) {}
+
+    ScriptServer::~ScriptServer() {
+        if (m_listenFd >= 0) {
+            close(m_listenFd);
+            unlink(m_socketPath.c_str());
+        }
+    }
+
+    void ScriptServer::listen() {
+        sockaddr_un address = socketAddress(m_socketPath);
+
+        // Remove um socket deixado por uma execução anterior, mas nunca
+        // outro tipo de arquivo.
+        struct stat info;
+        if (stat(m_socketPath.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+            unlink(m_socketPath.c_str());
+        }
+
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) throw systemError("socket");
+        if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 || ::listen(fd, 64) != 0) {
+            std::runtime_error error = systemError("Could not listen on " + m_socketPath);
+            close(fd);
+            throw error;
+        }
+        m_listenFd = fd;
+    }
+
+    void ScriptServer::serve() {
+        g_stopRequested = 0;
+        struct sigaction action = {};
+        action.sa_handler = &requestStop;
+        sigemptyset(&action.sa_mask);
+        sigaction(SIGINT, &action, nullptr);
+        sigaction(SIGTERM, &action, nullptr);
+        action.sa_handler = &childExited;
+        sigaction(SIGCHLD, &action, nullptr);
+
+        // SIGINT/SIGTERM ficam bloqueados fora do ppoll, que os libera só
+        // durante a espera: um sinal nunca se perde entre o teste da flag e
+        // o bloqueio. SIGCHLD também, para um filho que termina entre dois
+        // pedidos ser recolhido na hora, e não só no próximo pedido.
+        sigset_t stopSignals;
+        sigset_t waitMask;
+        sigemptyset(&stopSignals);
+        sigaddset(&stopSignals, SIGINT);
+        sigaddset(&stopSignals, SIGTERM);
+        sigaddset(&stopSignals, SIGCHLD);
+        sigprocmask(SIG_BLOCK, &stopSignals, &waitMask);
+
+        while (!g_stopRequested) {
+            pollfd listening = {m_listenFd, POLLIN, 0};
+            if (ppoll(&listening, 1, nullptr, &waitMask) > 0) {
+                handleOne();
+            } else {
+                reapChildren();
+            }
+        }
+
+        signal(SIGCHLD, SIG_DFL);
+        sigprocmask(SIG_SETMASK, &waitMask, nullptr);
+        while (waitpid(-1, nullptr, 0) > 0) {}
+    }
+
+    void ScriptServer::handleOne() {
+        int client = accept(m_listenFd, nullptr, nullptr);
+        if (client >= 0) {
+            handleConnection(client);
+            close(client);
+        }
+        reapChildren();
+    }
+
+    void ScriptServer::handleConnection(int client) {
+        // O pedido é lido antes do fork (o cache fica neste processo), então
+        // um cliente lento ou mudo só segura o servidor até o prazo.
+        Deadline deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(kRequestTimeoutMs);
+        std::uint32_t size = 0;
+        if (!readAll(client, &size, sizeof(size), deadline) || size > kMaxRequestBytes) return;
+        std::string source(size, '\0');
+        if (!readAll(client, source.data(), size, deadline)) return;
+
+        m_stats.requests++;
+        const Program& program = compile(source);
+
+        pid_t pid = fork();
+        if (pid == 0) runChild(client, program);
+        if (pid < 0) {
+            std::string message = std::string("fork: ") + std::strerror(errno) + "\n";
+            std::int32_t status = 71;
+            writeFrame(client, FrameType::Stderr, message.data(), static_cast<std::uint32_t>(message.size()));
+            writeFrame(client, FrameType::Exit, reinterpret_cast<const char*>(&status), sizeof(status));
+        }
+    }
+
+    const ScriptServer::Program& ScriptServer::compile(const std::string& source) {
+        std::uint64_t hash = contentHash(source);
+        auto it = m_cache.find(hash);
+        if (it != m_cache.end() && it->second->source == source) {
+            m_stats.cacheHits++;
+            return *it->second;
+        }
+        m_stats.cacheMisses++;
+
+        // Política de despejo simples: ao encher, o cache recomeça do zero.
+        if (it == m_cache.end() && m_cache.size() >= kMaxCachedPrograms) {
+            m_cache.clear();
+        }
+
+        auto program = std::make_unique<Program>();
+        program->source = source;
+
+        // Scanner e Parser reportam erros em std::cerr; o texto é guardado
+        // junto com o programa e repetido a cada execução.
+        std::ostringstream diagnostics;
+        std::streambuf* oldCerr = std::cerr.rdbuf(diagnostics.rdbuf());
+        Scanner scanner(program->source);
+        TokenStream tokens = scanner.scanTokens();
+        Parser parser(tokens);
+        program->statements = parser.parse();
+        std::cerr.rdbuf(oldCerr);
+
+        program->diagnostics = diagnostics.str();
+        program->hadError = parser.hadError();
+        if (!program->hadError) {
+            // O que o filho executa já fica pronto no cache.
+            if (m_options.optimizationLevel >= 2) {
+                program->statements = Optimizer(OptimizerOptions{true}).optimize(program->statements);
+            }
+            if (m_options.flatAst) program->flat = flattenAst(program->statements);
+        }
+
+        auto& slot = m_cache[hash];
+        slot = std::move(program);
+        return *slot;
+    }
+
+    void ScriptServer::runChild(int client, const Program& program) {
+        close(m_listenFd);
+        sigset_t stopSignals;
+        sigemptyset(&stopSignals);
+        sigaddset(&stopSignals, SIGINT);
+        sigaddset(&stopSignals, SIGTERM);
+        sigaddset(&stopSignals, SIGCHLD);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGCHLD, SIG_DFL);
+        sigprocmask(SIG_UNBLOCK, &stopSignals, nullptr);
+
+        FrameStreamBuf out(client, FrameType::Stdout);
+        FrameStreamBuf err(client, FrameType::Stderr);
+        std::cout.rdbuf(&out);
+        std::cerr.rdbuf(&err);
+
+        std::int32_t status = 0;
+        std::cerr << program.diagnostics;
+        if (program.hadError) {
+            status = 65;
+        } else {
+            try {
+                Interpreter interpreter(m_options.gc);
+                interpreter.setSpecialization(m_options.specialize);
+                interpreter.setJit(m_options.jit);
+                interpreter.setLimits(m_options.limits);
+                bool ok = m_options.flatAst ? interpreter.interpret(program.flat)
+                                            : interpreter.interpret(program.statements);
+                status = ok ? 0 : 70;
+            } catch (const std::exception& error) {
+                std::cerr << error.what() << std::endl;
+                status = 70;
+            }
+        }
+
+        std::cout.flush();
+        std::cerr.flush();
+        writeFrame(client, FrameType::Exit, reinterpret_cast<const char*>(&status), sizeof(status));
+        close(client);
+        // _exit: o filho não deve rodar destrutores nem handlers de atexit
+        // que pertencem ao servidor.
+        _exit(status);
+    }
+
+    void ScriptServer::reapChildren() {
+        while (waitpid(-1, nullptr, WNOHANG) > 0) {}
+    }
+
+    int runRemote(const std::string& socketPath, const std::string& source, std::ostream& out, std::ostream& err) {
+        if (source.size() > kMaxRequestBytes) {
+            throw std::runtime_error("Script too large for --serve.");
+        }
+        sockaddr_un address = socketAddress(socketPath);
+        FdGuard fd(socket(AF_UNIX, SOCK_STREAM, 0));
+        if (fd.get() < 0) throw systemError("socket");
+        if (connect(fd.get(), reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0) {
+            throw systemError("Could not connect to " + socketPath);
+        }
+
+        auto size = static_cast<std::uint32_t>(source.size());
+        if (!writeAll(fd.get(), &size, sizeof(size)) || !writeAll(fd.get(), source.data(), size)) {
+            throw systemError("Could not send script");
+        }
+
+        std::string data;
+        for (;;) {
+            char header[kFrameHeaderBytes];
+            std::uint32_t length = 0;
+            if (!readAll(fd.get(), header, sizeof(header))) break;
+            std::memcpy(&length, header + 1, sizeof(length));
+            data.resize(length);
+            if (!readAll(fd.get(), data.data(), length)) break;
+
+            switch (static_cast<FrameType>(header[0])) {
+                case FrameType::Stdout: out.write(data.data(), length); break;
+                case FrameType::Stderr: err.write(data.data(), length); break;
+                case FrameType::Exit: {
+                    std::int32_t status = 0;
+                    if (length != sizeof(status)) return 70;
+                    std::memcpy(&status, data.data(), sizeof(status));
+                    out.flush();
+                    return status;
+                }
+            }
+        }
+        err << "Connection closed before the script finished." << std::endl;
+        return 70;
+    }
+
+}
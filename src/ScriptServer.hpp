@@ -0,0 +1,106 @@
+#pragma once
+
+#include "ExecutionLimits.hpp"
+#include "Heap.hpp"
+#include "NumericLoop.hpp"
+#include "ast/FlatAst.hpp"
+#include "ast/Stmt.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lox {
+
+    // Protocolo do modo --serve, sobre um socket Unix (mesma máquina, então
+    // os inteiros vão na ordem de bytes nativa):
+    //
+    //   pedido:   u32 tamanho + código-fonte
+    //   resposta: sequência de quadros {u8 tipo, u32 tamanho, dados},
+    //             terminada por um quadro Exit cujos dados são o status (i32).
+    enum class FrameType : std::uint8_t {
+        Stdout = 1,
+        Stderr = 2,
+        Exit = 3,
+    };
+
+    struct ServerStats {
+        std::size_t requests = 0;
+        std::size_t cacheHits = 0;
+        std::size_t cacheMisses = 0;
+    };
+
+    // Como cada pedido é executado: as opções de execução da linha de
+    // comando, aplicadas ao Interpreter novo de cada script.
+    struct ServeOptions {
+        GcConfig gc;
+        ExecutionLimits limits;
+        int optimizationLevel = 0;   // -O2 otimiza o programa ao entrar no cache
+        bool specialize = true;
+        JitOptions jit;
+        bool flatAst = false;
+    };
+
+    // Daemon que executa scripts recebidos por um socket Unix. Os programas
+    // ficam em cache já analisados (chave: hash do conteúdo), e cada pedido
+    // roda em um processo filho criado com fork(): o filho herda a AST por
+    // copy-on-write e usa um Interpreter novo, então um script não enxerga o
+    // estado de outro. stdout e stderr do filho voltam ao cliente em quadros.
+    class ScriptServer {
+    public:
+        // Prazo para o cliente mandar o pedido inteiro. O pedido é lido antes
+        // do fork, então um cliente que conecta e não manda nada segura o
+        // servidor no máximo por esse tempo.
+        static constexpr int kRequestTimeoutMs = 1000;
+
+        // Os limites valem para cada script (um Interpreter por pedido).
+        explicit ScriptServer(std::string socketPath, ServeOptions options = {});
+        ~ScriptServer();
+
+        ScriptServer(const ScriptServer&) = delete;
+        ScriptServer& operator=(const ScriptServer&) = delete;
+
+        // Cria o socket e começa a escutar. Lança std::runtime_error em caso de falha.
+        void listen();
+
+        // Atende pedidos até receber SIGINT ou SIGTERM.
+        void serve();
+
+        // Aceita e atende uma única conexão.
+        void handleOne();
+
+        const ServerStats& stats() const { return m_stats; }
+
+    private:
+        struct Program {
+            std::string source;
+            std::vector<std::unique_ptr<Stmt>> statements;   // já otimizados com -O2
+            FlatAst flat;                                    // só com flatAst
+            std::string diagnostics;   // mensagens do scanner e do parser
+            bool hadError = false;
+        };
+
+        static constexpr std::size_t kMaxCachedPrograms = 256;
+
+        const Program& compile(const std::string& source);
+        void handleConnection(int client);
+        [[noreturn]] void runChild(int client, const Program& program);
+        void reapChildren();
+
+        std::string m_socketPath;
+        ServeOptions m_options;
+        int m_listenFd = -1;
+        std::unordered_map<std::uint64_t, std::unique_ptr<Program>> m_cache;
+        ServerStats m_stats;
+    };
+
+    // Cliente: envia o script ao servidor, repassa os quadros de saída para
+    // out/err e retorna o status de saída do script. Lança
+    // std::runtime_error se não conseguir falar com o servidor.
+    int runRemote(const std::string& socketPath, const std::string& source, std::ostream& out, std::ostream& err);
+
+}
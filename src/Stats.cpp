@@ -0,0 +1,91 @@
+#include "Stats.hpp"
+
+#include <cstdio>
+
+namespace lox {
+
+    RuntimeStats& runtimeStats() {
+        thread_local RuntimeStats stats;
+        return stats;
+    }
+
+    static const char* const kValueAlternativeNames[] = {"nil", "bool", "number", "string",
+                                                         "callable", "array", "map", "file"};
+    static_assert(sizeof(kValueAlternativeNames) / sizeof(kValueAlternativeNames[0]) == std::variant_size_v<Value>,
+                  "um nome para cada alternativa de lox::Value");
+
+    void writeStatsText(std::ostream& out, const RuntimeStats& stats, const PhaseTimes& phases,
+                        const MemoryUsage& memory) {
+        char buffer[128];
+        out << "--- Stats ---\n";
+        std::snprintf(buffer, sizeof(buffer), "phases (ms): scan %.3f, parse %.3f, interpret %.3f\n",
+                      phases.scanMs, phases.parseMs, phases.interpretMs);
+        out << buffer;
+        out << "memory (bytes): current " << memory.current << ", peak " << memory.peak << ", limit ";
+        if (memory.limit == 0) {
+            out << "none\n";
+        } else {
+            out << memory.limit << "\n";
+        }
+
+        if (!kStatsEnabled) {
+            out << "counters: not compiled in (configure with -DLOX_ENABLE_STATS=ON)\n";
+            return;
+        }
+
+        out << "expr visits:";
+        for (std::size_t i = 0; i < kExprKindCount; ++i) {
+            out << " " << exprKindName(static_cast<ExprKind>(i)) << "=" << stats.exprVisits[i];
+        }
+        out << "\nstmt visits:";
+        for (std::size_t i = 0; i < kStmtKindCount; ++i) {
+            out << " " << stmtKindName(static_cast<StmtKind>(i)) << "=" << stats.stmtVisits[i];
+        }
+        out << "\nenvironment: lookups=" << stats.envLookups
+            << " chain_depth=" << stats.envChainDepth
+            << " probes=" << stats.envProbes
+            << " allocations=" << stats.envAllocations
+            << " global_cache_hits=" << stats.globalCacheHits;
+        out << "\nvalue copies:";
+        for (std::size_t i = 0; i < stats.valueCopies.size(); ++i) {
+            out << " " << kValueAlternativeNames[i] << "=" << stats.valueCopies[i];
+        }
+        out << "\nexceptions thrown: " << stats.exceptionsThrown << "\n";
+    }
+
+    void writeStatsJson(std::ostream& out, const RuntimeStats& stats, const PhaseTimes& phases,
+                        const MemoryUsage& memory) {
+        out << "{\"phases_ms\":{\"scan\":" << phases.scanMs
+            << ",\"parse\":" << phases.parseMs
+            << ",\"interpret\":" << phases.interpretMs << "}";
+        out << ",\"memory_bytes\":{\"current\":" << memory.current
+            << ",\"peak\":" << memory.peak
+            << ",\"limit\":" << memory.limit << "}";
+        out << ",\"counters_enabled\":" << (kStatsEnabled ? "true" : "false");
+        if (kStatsEnabled) {
+            out << ",\"expr_visits\":{";
+            for (std::size_t i = 0; i < kExprKindCount; ++i) {
+                if (i > 0) out << ",";
+                out << "\"" << exprKindName(static_cast<ExprKind>(i)) << "\":" << stats.exprVisits[i];
+            }
+            out << "},\"stmt_visits\":{";
+            for (std::size_t i = 0; i < kStmtKindCount; ++i) {
+                if (i > 0) out << ",";
+                out << "\"" << stmtKindName(static_cast<StmtKind>(i)) << "\":" << stats.stmtVisits[i];
+            }
+            out << "},\"environment\":{\"lookups\":" << stats.envLookups
+                << ",\"chain_depth\":" << stats.envChainDepth
+                << ",\"probes\":" << stats.envProbes
+                << ",\"allocations\":" << stats.envAllocations
+                << ",\"global_cache_hits\":" << stats.globalCacheHits << "}";
+            out << ",\"value_copies\":{";
+            for (std::size_t i = 0; i < stats.valueCopies.size(); ++i) {
+                if (i > 0) out << ",";
+                out << "\"" << kValueAlternativeNames[i] << "\":" << stats.valueCopies[i];
+            }
+            out << "},\"exceptions_thrown\":" << stats.exceptionsThrown;
+        }
+        out << "}\n";
+    }
+
+}
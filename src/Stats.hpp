@@ -0,0 +1,86 @@
+#pragma once
+
+#include "Value.hpp"
+#include "ast/NodeKind.hpp"
+
+#include <array>
+#include <cstdint>
+#include <ostream>
+#include <variant>
+
+// Os contadores só são compilados com -DLOX_ENABLE_STATS=ON no CMake.
+// Desligados, todas as chamadas de Stats:: são funções vazias e somem.
+#ifndef LOX_ENABLE_STATS
+#define LOX_ENABLE_STATS 0
+#endif
+
+namespace lox {
+
+    inline constexpr bool kStatsEnabled = LOX_ENABLE_STATS != 0;
+
+    // Contadores de execução de uma thread.
+    struct RuntimeStats {
+        std::array<std::uint64_t, kExprKindCount> exprVisits{};
+        std::array<std::uint64_t, kStmtKindCount> stmtVisits{};
+
+        std::uint64_t envLookups = 0;      // chamadas a Environment::get/assign
+        std::uint64_t envChainDepth = 0;   // escopos percorridos nessas chamadas
+        std::uint64_t envProbes = 0;       // entradas examinadas nos buckets das tabelas hash
+        std::uint64_t envAllocations = 0;
+        std::uint64_t globalCacheHits = 0; // leituras e atribuições de globais sem busca
+
+        std::array<std::uint64_t, std::variant_size_v<Value>> valueCopies{};
+
+        std::uint64_t exceptionsThrown = 0;
+    };
+
+    // Tempos das fases de run(), medidos apenas quando --stats é usado.
+    struct PhaseTimes {
+        double scanMs = 0.0;
+        double parseMs = 0.0;
+        double interpretMs = 0.0;
+    };
+
+    // Contadores da thread atual.
+    RuntimeStats& runtimeStats();
+
+    // Política de instrumentação: a especialização desligada não faz nada.
+    template<bool Enabled>
+    struct StatsPolicy {
+        static void exprVisit(ExprKind) {}
+        static void stmtVisit(StmtKind) {}
+        static void envLookup() {}
+        static void envScope() {}
+        template<typename Map, typename Key>
+        static void envProbe(const Map&, const Key&) {}
+        static void envAllocation() {}
+        static void globalCacheHit() {}
+        static void valueCopy(const Value&) {}
+        static void exceptionThrown() {}
+    };
+
+    template<>
+    struct StatsPolicy<true> {
+        static void exprVisit(ExprKind kind) { runtimeStats().exprVisits[static_cast<std::size_t>(kind)]++; }
+        static void stmtVisit(StmtKind kind) { runtimeStats().stmtVisits[static_cast<std::size_t>(kind)]++; }
+        static void envLookup() { runtimeStats().envLookups++; }
+        static void envScope() { runtimeStats().envChainDepth++; }
+        template<typename Map, typename Key>
+        static void envProbe(const Map& map, const Key& key) {
+            if (map.bucket_count() > 0) runtimeStats().envProbes += map.bucket_size(map.bucket(key));
+        }
+        static void envAllocation() { runtimeStats().envAllocations++; }
+        static void globalCacheHit() { runtimeStats().globalCacheHits++; }
+        static void valueCopy(const Value& value) { runtimeStats().valueCopies[value.index()]++; }
+        static void exceptionThrown() { runtimeStats().exceptionsThrown++; }
+    };
+
+    using Stats = StatsPolicy<kStatsEnabled>;
+
+    // memory: uso da quota do interpretador (MemoryQuota.hpp), sempre medido.
+    void writeStatsText(std::ostream& out, const RuntimeStats& stats, const PhaseTimes& phases,
+                        const MemoryUsage& memory);
+    void writeStatsJson(std::ostream& out, const RuntimeStats& stats, const PhaseTimes& phases,
+                        const MemoryUsage& memory);
+
+}
@@ -2,9 +2,9 @@
 #include <string>
 
 
-Token::Token(TokenType type, std::string lexeme, lox::Value literal, int line)
-    : type(type), lexeme(std::move(lexeme)), literal(std::move(literal)), line(line) {}
+Token::Token(TokenType type, std::string lexeme, int line)
+    : type(type), line(line), lexeme(std::move(lexeme)) {}
 
 std::string Token::toString() const {
     return "Type: " + std::to_string(static_cast<int>(type)) + " Lexeme: '" + lexeme + "'";
-}
\ No newline at end of file
+}
@@ -1,12 +1,13 @@
 #pragma once
 
-#include "Value.hpp" // Para usar lox::Value
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
-// A definição do TokenType não muda.
-enum class TokenType {
+// O tipo do token ocupa um único byte no TokenStream.
+enum class TokenType : std::uint8_t {
     // Tokens de um caractere
-    LEFT_PAREN, RIGHT_PAREN, LEFT_BRACE, RIGHT_BRACE,
+    LEFT_PAREN, RIGHT_PAREN, LEFT_BRACE, RIGHT_BRACE, LEFT_BRACKET, RIGHT_BRACKET,
     COMMA, DOT, MINUS, PLUS, SEMICOLON, SLASH, STAR,
 
     // Tokens de um ou dois caracteres
@@ -25,16 +26,17 @@ enum class TokenType {
     END_OF_FILE
 };
 
-// O tipo LiteralValue foi removido.
+inline constexpr std::size_t kTokenTypeCount = static_cast<std::size_t>(TokenType::END_OF_FILE) + 1;
 
+// Token materializado a partir do TokenStream. Só é criado para o que
+// precisa sobreviver ao código-fonte: nós da AST e mensagens de erro.
+// O valor literal não fica aqui; ele vai direto para o nó Literal.
 struct Token {
-    const TokenType type;
-    const std::string lexeme;
-    const lox::Value literal; // <-- MUDANÇA CRÍTICA: Usa lox::Value
-    const int line;
+    TokenType type;
+    int line;
+    std::string lexeme;
 
-    // Construtor atualizado para aceitar lox::Value
-    Token(TokenType type, std::string lexeme, lox::Value literal, int line);
+    Token(TokenType type, std::string lexeme, int line);
 
     std::string toString() const;
-};
\ No newline at end of file
+};
@@ -0,0 +1,57 @@
+#include "TokenStream.hpp"
+
+#include <algorithm>
+
+TokenStream::TokenStream(const std::string& source, int firstLine) : m_source(&source), m_firstLine(firstLine) {
+    m_lineStarts.push_back(0);
+}
+
+int TokenStream::line(std::size_t index) const {
+    auto it = std::upper_bound(m_lineStarts.begin(), m_lineStarts.end(), m_offsets[index]);
+    return static_cast<int>(it - m_lineStarts.begin()) + m_firstLine - 1;
+}
+
+lox::Value TokenStream::literal(std::size_t index) const {
+    switch (m_types[index]) {
+        case TokenType::NUMBER: {
+            auto it = std::lower_bound(m_numberTokens.begin(), m_numberTokens.end(), static_cast<std::uint32_t>(index));
+            return m_numbers[static_cast<std::size_t>(it - m_numberTokens.begin())];
+        }
+        case TokenType::STRING: {
+            // Lox não tem sequências de escape: o valor é o lexema sem as aspas.
+            std::string_view text = lexeme(index);
+            return lox::String(text.substr(1, text.size() - 2));
+        }
+        default:
+            return std::monostate{};
+    }
+}
+
+Token TokenStream::token(std::size_t index) const {
+    return Token(m_types[index], std::string(lexeme(index)), line(index));
+}
+
+std::size_t TokenStream::memoryBytes() const {
+    return m_types.capacity() * sizeof(TokenType)
+         + m_offsets.capacity() * sizeof(std::uint32_t)
+         + m_lengths.capacity() * sizeof(std::uint32_t)
+         + m_numberTokens.capacity() * sizeof(std::uint32_t)
+         + m_numbers.capacity() * sizeof(double)
+         + m_lineStarts.capacity() * sizeof(std::uint32_t);
+}
+
+void TokenStream::add(TokenType type, std::size_t offset, std::size_t length) {
+    m_types.push_back(type);
+    m_offsets.push_back(static_cast<std::uint32_t>(offset));
+    m_lengths.push_back(static_cast<std::uint32_t>(length));
+}
+
+void TokenStream::addNumber(std::size_t offset, std::size_t length, double value) {
+    m_numberTokens.push_back(static_cast<std::uint32_t>(m_types.size()));
+    m_numbers.push_back(value);
+    add(TokenType::NUMBER, offset, length);
+}
+
+void TokenStream::addLineStart(std::size_t offset) {
+    m_lineStarts.push_back(static_cast<std::uint32_t>(offset));
+}
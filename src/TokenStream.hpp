@@ -0,0 +1,60 @@
+#pragma once
+
+#include "Token.hpp"
+#include "Value.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Sequência de tokens em estrutura de arrays (SoA): cada token ocupa 9 bytes
+// (tipo, deslocamento e comprimento no código-fonte). Os números literais
+// ficam em uma tabela à parte e a linha de cada token é calculada sob demanda
+// a partir do índice de inícios de linha.
+//
+// O TokenStream aponta para o código-fonte, que deve sobreviver a ele.
+class TokenStream {
+public:
+    // firstLine: linha do primeiro caractere de source (um trecho de um
+    // arquivo maior começa no meio dele).
+    explicit TokenStream(const std::string& source, int firstLine = 1);
+
+    std::size_t size() const { return m_types.size(); }
+
+    TokenType type(std::size_t index) const { return m_types[index]; }
+    std::uint32_t offset(std::size_t index) const { return m_offsets[index]; }
+    std::string_view lexeme(std::size_t index) const {
+        return std::string_view(*m_source).substr(m_offsets[index], m_lengths[index]);
+    }
+    int line(std::size_t index) const;
+    lox::Value literal(std::size_t index) const;
+
+    // Cria um Token independente do código-fonte (para a AST ou erros).
+    Token token(std::size_t index) const;
+    Token operator[](std::size_t index) const { return token(index); }
+
+    // Bytes ocupados pelos arrays do stream (capacidade reservada incluída).
+    std::size_t memoryBytes() const;
+
+    // --- Usados pelo Scanner ---
+    void add(TokenType type, std::size_t offset, std::size_t length);
+    void addNumber(std::size_t offset, std::size_t length, double value);
+    void addLineStart(std::size_t offset);
+
+private:
+    const std::string* m_source;
+
+    std::vector<TokenType> m_types;
+    std::vector<std::uint32_t> m_offsets;
+    std::vector<std::uint32_t> m_lengths;
+
+    // Tabela de literais numéricos: índice do token (crescente) e valor.
+    std::vector<std::uint32_t> m_numberTokens;
+    std::vector<double> m_numbers;
+
+    // Deslocamento do primeiro caractere de cada linha; a linha firstLine
+    // começa em 0.
+    std::vector<std::uint32_t> m_lineStarts;
+    int m_firstLine;
+};
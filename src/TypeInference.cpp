@@ -0,0 +1,208 @@
+#include "TypeInference.hpp"
+
+namespace lox {
+
+    static StaticType join(StaticType a, StaticType b) {
+        return a == b ? a : StaticType::Unknown;
+    }
+
+    void TypeInference::analyze(const std::vector<std::unique_ptr<Stmt>>& program) {
+        m_state.clear();
+        m_scopes.clear();
+        m_loopHeads.clear();
+        for (const auto& stmt : program) {
+            if (stmt != nullptr) statement(*stmt);
+        }
+    }
+
+    std::optional<StaticType> TypeInference::typeAtLoopHead(const Stmt& loop, const std::string& name) const {
+        auto it = m_loopHeads.find(&loop);
+        if (it == m_loopHeads.end()) return StaticType::Unknown;
+        for (auto binding = it->second.rbegin(); binding != it->second.rend(); ++binding) {
+            if (binding->name == name) return binding->type;
+        }
+        return std::nullopt;
+    }
+
+    void TypeInference::statement(const Stmt& stmt) {
+        switch (stmt.kind) {
+            case StmtKind::Expression:
+                expression(*static_cast<const ExpressionStmt&>(stmt).expression);
+                break;
+            case StmtKind::Print:
+                expression(*static_cast<const PrintStmt&>(stmt).expression);
+                break;
+            case StmtKind::Var: {
+                const auto& var = static_cast<const VarStmt&>(stmt);
+                StaticType type = var.initializer != nullptr ? expression(*var.initializer) : StaticType::Unknown;
+                declare(var.name.lexeme, type);
+                break;
+            }
+            case StmtKind::Block:
+                beginScope();
+                for (const auto& inner : static_cast<const BlockStmt&>(stmt).statements) {
+                    if (inner != nullptr) statement(*inner);
+                }
+                endScope();
+                break;
+            case StmtKind::If: {
+                const auto& branch = static_cast<const IfStmt&>(stmt);
+                expression(*branch.condition);
+                State beforeBranches = m_state;
+                statement(*branch.thenBranch);
+                State afterThen = m_state;
+                m_state = std::move(beforeBranches);
+                if (branch.elseBranch != nullptr) statement(*branch.elseBranch);
+                joinWith(afterThen);
+                break;
+            }
+            case StmtKind::While: {
+                const auto& loopStmt = static_cast<const WhileStmt&>(stmt);
+                loop(stmt, loopStmt.condition.get(), *loopStmt.body, nullptr);
+                break;
+            }
+            case StmtKind::For: {
+                const auto& loopStmt = static_cast<const ForStmt&>(stmt);
+                beginScope();
+                if (loopStmt.initializer != nullptr) statement(*loopStmt.initializer);
+                loop(stmt, loopStmt.condition.get(), *loopStmt.body, loopStmt.increment.get());
+                endScope();
+                break;
+            }
+        }
+    }
+
+    void TypeInference::loop(const Stmt& stmt, const Expr* condition, const Stmt& body, const Expr* increment) {
+        // O reticulado tem altura 2, então o ponto fixo chega em poucas voltas.
+        for (;;) {
+            State head = m_state;
+            if (condition != nullptr) expression(*condition);
+            State exit = m_state;
+            statement(body);
+            if (increment != nullptr) expression(*increment);
+            joinWith(head);
+
+            bool stable = true;
+            for (std::size_t i = 0; i < head.size(); ++i) {
+                if (head[i].type != m_state[i].type) stable = false;
+            }
+            if (stable) {
+                // A última volta partiu do ponto fixo: laços internos também
+                // ficaram registrados com os estados finais.
+                m_loopHeads[&stmt] = std::move(head);
+                m_state = std::move(exit);
+                return;
+            }
+        }
+    }
+
+    StaticType TypeInference::expression(const Expr& expr) {
+        switch (expr.kind) {
+            case ExprKind::Literal:
+                return std::holds_alternative<double>(static_cast<const Literal&>(expr).value)
+                           ? StaticType::Number
+                           : StaticType::Unknown;
+            case ExprKind::Variable:
+                return lookup(static_cast<const Variable&>(expr).name.lexeme);
+            case ExprKind::Assign: {
+                const auto& assignExpr = static_cast<const Assign&>(expr);
+                StaticType type = expression(*assignExpr.value);
+                assign(assignExpr.name.lexeme, type);
+                return type;
+            }
+            case ExprKind::Increment:
+                assign(static_cast<const Increment&>(expr).name.lexeme, StaticType::Number);
+                return StaticType::Number;
+            case ExprKind::Binary: {
+                const auto& binary = static_cast<const Binary&>(expr);
+                StaticType left = expression(*binary.left);
+                StaticType right = expression(*binary.right);
+                switch (binary.op.type) {
+                    case TokenType::MINUS:
+                    case TokenType::STAR:
+                    case TokenType::SLASH:
+                        return StaticType::Number;
+                    case TokenType::PLUS:
+                        return left == StaticType::Number && right == StaticType::Number ? StaticType::Number
+                                                                                          : StaticType::Unknown;
+                    default:
+                        return StaticType::Unknown;
+                }
+            }
+            case ExprKind::Unary: {
+                const auto& unary = static_cast<const Unary&>(expr);
+                expression(*unary.right);
+                return unary.op.type == TokenType::MINUS ? StaticType::Number : StaticType::Unknown;
+            }
+            case ExprKind::Grouping:
+                return expression(*static_cast<const Grouping&>(expr).expression);
+            case ExprKind::Logical: {
+                // O lado direito pode não executar.
+                const auto& logical = static_cast<const Logical&>(expr);
+                StaticType left = expression(*logical.left);
+                State afterLeft = m_state;
+                StaticType right = expression(*logical.right);
+                joinWith(afterLeft);
+                return join(left, right);
+            }
+            case ExprKind::Call: {
+                const auto& call = static_cast<const Call&>(expr);
+                expression(*call.callee);
+                for (const auto& argument : call.arguments) expression(*argument);
+                return StaticType::Unknown;
+            }
+            case ExprKind::Index: {
+                const auto& index = static_cast<const Index&>(expr);
+                expression(*index.object);
+                expression(*index.index);
+                return StaticType::Unknown;
+            }
+            case ExprKind::IndexSet: {
+                const auto& set = static_cast<const IndexSet&>(expr);
+                expression(*set.target->object);
+                expression(*set.target->index);
+                return expression(*set.value);
+            }
+            case ExprKind::ArrayLiteral:
+                for (const auto& element : static_cast<const ArrayLiteral&>(expr).elements) expression(*element);
+                return StaticType::Unknown;
+        }
+        return StaticType::Unknown;
+    }
+
+    void TypeInference::declare(const std::string& name, StaticType type) {
+        m_state.push_back(Binding{name, type});
+    }
+
+    void TypeInference::assign(const std::string& name, StaticType type) {
+        for (auto binding = m_state.rbegin(); binding != m_state.rend(); ++binding) {
+            if (binding->name == name) {
+                binding->type = type;
+                return;
+            }
+        }
+    }
+
+    StaticType TypeInference::lookup(const std::string& name) const {
+        for (auto binding = m_state.rbegin(); binding != m_state.rend(); ++binding) {
+            if (binding->name == name) return binding->type;
+        }
+        return StaticType::Unknown;
+    }
+
+    void TypeInference::beginScope() {
+        m_scopes.push_back(m_state.size());
+    }
+
+    void TypeInference::endScope() {
+        m_state.resize(m_scopes.back());
+        m_scopes.pop_back();
+    }
+
+    void TypeInference::joinWith(const State& other) {
+        for (std::size_t i = 0; i < m_state.size() && i < other.size(); ++i) {
+            m_state[i].type = join(m_state[i].type, other[i].type);
+        }
+    }
+
+}
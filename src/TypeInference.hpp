@@ -0,0 +1,64 @@
+#pragma once
+
+#include "ast/Expr.hpp"
+#include "ast/Stmt.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lox {
+
+    // O que se sabe estaticamente sobre um valor em um ponto do programa.
+    enum class StaticType : std::uint8_t {
+        Number,    // sempre double
+        Unknown,   // qualquer outro caso (ou não se sabe)
+    };
+
+    // Inferência de tipos sensível ao fluxo. Percorre o programa como um
+    // interpretador abstrato: cada variável declarada tem um StaticType que
+    // muda a cada atribuição; nos ifs os dois ramos são unidos, e nos laços o
+    // estado da cabeça é iterado até um ponto fixo (entrada unida ao fim do
+    // corpo). Aritmética (- * / e - unário) sempre produz Number (ou lança
+    // erro); + só quando os dois lados são Number.
+    //
+    // O resultado guardado é o estado na cabeça de cada while/for, usado para
+    // decidir quais laços especializar (NumericLoop.hpp).
+    class TypeInference {
+    public:
+        void analyze(const std::vector<std::unique_ptr<Stmt>>& program);
+
+        // Tipo de name na cabeça do laço (depois do ponto fixo). nullopt se o
+        // nome não foi declarado no programa analisado: uma global de uma
+        // execução anterior, no REPL, sobre a qual nada se sabe aqui.
+        std::optional<StaticType> typeAtLoopHead(const Stmt& loop, const std::string& name) const;
+
+    private:
+        struct Binding {
+            std::string name;
+            StaticType type;
+        };
+        using State = std::vector<Binding>;
+
+        void statement(const Stmt& stmt);
+        void loop(const Stmt& stmt, const Expr* condition, const Stmt& body, const Expr* increment);
+        StaticType expression(const Expr& expr);
+
+        void declare(const std::string& name, StaticType type);
+        void assign(const std::string& name, StaticType type);
+        StaticType lookup(const std::string& name) const;
+        void beginScope();
+        void endScope();
+        // Une o estado atual com other (mesmas declarações, na mesma ordem).
+        void joinWith(const State& other);
+
+        // Declarações visíveis, da mais externa para a mais interna.
+        State m_state;
+        std::vector<std::size_t> m_scopes;
+        std::unordered_map<const Stmt*, State> m_loopHeads;
+    };
+
+}
@@ -1,13 +1,19 @@
 #include "Value.hpp"
+#include "Array.hpp"
+#include "Callable.hpp"
+#include "Map.hpp"
+#include "File.hpp"
 #include <string>
-#include <variant> 
-#include <memory>  
+#include <unordered_set>
+#include <variant>
+#include <vector>
 
 class LoxCallable;
 
 namespace lox {
 
-    std::string valueToString(const Value& value) {
+    // Texto de um valor que não é array nem mapa.
+    static std::string scalarToString(const Value& value) {
         return std::visit([](const auto& v) -> std::string {
             using T = std::decay_t<decltype(v)>;
             if constexpr (std::is_same_v<T, std::monostate>) {
@@ -19,13 +25,102 @@ namespace lox {
                 s.erase(s.find_last_not_of('0') + 1, std::string::npos);
                 if (s.back() == '.') s.pop_back();
                 return s;
-            } else if constexpr (std::is_same_v<T, std::string>) {
-                return v;
-            } else if constexpr (std::is_same_v<T, std::shared_ptr<LoxCallable>>) {
-                return "<fn>";
+            } else if constexpr (std::is_same_v<T, String>) {
+                return std::string(v.data(), v.size());
+            } else if constexpr (std::is_same_v<T, LoxCallable*>) {
+                return v->toString();
+            } else if constexpr (std::is_same_v<T, LoxFile*>) {
+                return v->toString();
             }
             return "unknown value";
         }, value);
     }
 
+    // Impressão de arrays e mapas com uma pilha explícita, um frame por
+    // contêiner aberto, para que a profundidade de aninhamento não dependa
+    // da pilha de chamadas. Arrays e mapas podem conter a si mesmos; os que
+    // já estão sendo impressos aparecem como [...] e {...}.
+    class ContainerPrinter {
+    public:
+        std::string print(const Value& value) {
+            append(value);
+            while (!m_frames.empty()) {
+                Frame& frame = m_frames.back();
+                if (frame.array != nullptr) {
+                    if (frame.next == frame.array->size()) {
+                        close(frame.array, ']');
+                        continue;
+                    }
+                    if (frame.next > 0) m_result += ", ";
+                    Value element = frame.array->get(frame.next++);
+                    append(element);   // pode empilhar: frame deixa de valer
+                } else {
+                    if (frame.next == frame.entries.size()) {
+                        close(frame.map, '}');
+                        continue;
+                    }
+                    // entries alterna chave e valor; as chaves nunca são objetos.
+                    const Value& key = *frame.entries[frame.next];
+                    const Value& entry = *frame.entries[frame.next + 1];
+                    if (frame.next > 0) m_result += ", ";
+                    frame.next += 2;
+                    m_result += scalarToString(key) + ": ";
+                    append(entry);
+                }
+            }
+            return std::move(m_result);
+        }
+
+    private:
+        struct Frame {
+            const LoxArray* array = nullptr;
+            const LoxMap* map = nullptr;
+            std::vector<const Value*> entries;
+            std::size_t next = 0;
+        };
+
+        void append(const Value& value) {
+            if (auto array = std::get_if<LoxArray*>(&value)) {
+                if (!m_printing.insert(*array).second) {
+                    m_result += "[...]";
+                    return;
+                }
+                m_result += '[';
+                m_frames.push_back(Frame{*array, nullptr, {}, 0});
+            } else if (auto map = std::get_if<LoxMap*>(&value)) {
+                if (!m_printing.insert(*map).second) {
+                    m_result += "{...}";
+                    return;
+                }
+                m_result += '{';
+                Frame frame{nullptr, *map, {}, 0};
+                frame.entries.reserve((*map)->size() * 2);
+                (*map)->forEach([&frame](const Value& key, const Value& value) {
+                    frame.entries.push_back(&key);
+                    frame.entries.push_back(&value);
+                });
+                m_frames.push_back(std::move(frame));
+            } else {
+                m_result += scalarToString(value);
+            }
+        }
+
+        void close(const void* container, char bracket) {
+            m_result += bracket;
+            m_printing.erase(container);
+            m_frames.pop_back();
+        }
+
+        std::string m_result;
+        std::vector<Frame> m_frames;
+        std::unordered_set<const void*> m_printing;
+    };
+
+    std::string valueToString(const Value& value) {
+        if (std::holds_alternative<LoxArray*>(value) || std::holds_alternative<LoxMap*>(value)) {
+            return ContainerPrinter().print(value);
+        }
+        return scalarToString(value);
+    }
+
 } 
\ No newline at end of file
@@ -1,22 +1,38 @@
 #pragma once
 
+#include "MemoryQuota.hpp"
+#include <cstdint>
 #include <string>
 #include <variant>
-#include <memory>
 
 // Forward declaration
 class LoxCallable;
 
 namespace lox {
 
+    class LoxArray;
+    class LoxMap;
+    class LoxFile;
+
     using Value = std::variant<
         std::monostate, // nil
         bool,
         double,
-        std::string,
-        std::shared_ptr<LoxCallable>
+        String,   // cobrada do MemoryQuota corrente (MemoryQuota.hpp)
+        LoxCallable*, // objetos no heap gerenciado pelo coletor
+        LoxArray*,
+        LoxMap*,
+        LoxFile*
     >;
 
     std::string valueToString(const Value& value);
 
+    // Cache de uma variável global nos nós Variable e Assign: o endereço do
+    // valor no escopo global e a versão dos globais em que ele foi resolvido
+    // (Environment::getRef). Versão 0 é um cache vazio.
+    struct GlobalCache {
+        Value* slot = nullptr;
+        std::uint64_t version = 0;
+    };
+
 } 
\ No newline at end of file
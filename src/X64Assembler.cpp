@@ -0,0 +1,144 @@
+#include "X64Assembler.hpp"
+
+#include <cstring>
+#include <fstream>
+
+#if defined(__x86_64__) && defined(__unix__)
+#define LOX_JIT_X64 1
+#include <sys/mman.h>
+#include <unistd.h>
+#else
+#define LOX_JIT_X64 0
+#endif
+
+namespace lox {
+
+    void X64Assembler::int32(std::uint32_t value) {
+        for (int i = 0; i < 4; ++i) byte(static_cast<std::uint8_t>(value >> (8 * i)));
+    }
+
+    // ModRM com mod=10 (disp32) e rm=111 (rdi); rdi não precisa de SIB.
+    void X64Assembler::memoryOperand(std::uint8_t reg, std::int32_t disp) {
+        byte(static_cast<std::uint8_t>(0x80 | (reg << 3) | 0x7));
+        int32(static_cast<std::uint32_t>(disp));
+    }
+
+    void X64Assembler::load(Xmm dst, std::int32_t disp) {
+        byte(0xF2); byte(0x0F); byte(0x10);
+        memoryOperand(dst, disp);
+    }
+
+    void X64Assembler::store(std::int32_t disp, Xmm src) {
+        byte(0xF2); byte(0x0F); byte(0x11);
+        memoryOperand(src, disp);
+    }
+
+    void X64Assembler::arithmetic(SseOp op, Xmm dst, std::int32_t disp) {
+        byte(0xF2); byte(0x0F); byte(static_cast<std::uint8_t>(op));
+        memoryOperand(dst, disp);
+    }
+
+    void X64Assembler::arithmetic(SseOp op, Xmm dst, Xmm src) {
+        byte(0xF2); byte(0x0F); byte(static_cast<std::uint8_t>(op));
+        byte(static_cast<std::uint8_t>(0xC0 | (dst << 3) | src));
+    }
+
+    void X64Assembler::compare(Xmm left, std::int32_t disp) {
+        byte(0x66); byte(0x0F); byte(0x2E);
+        memoryOperand(left, disp);
+    }
+
+    void X64Assembler::compare(Xmm left, Xmm right) {
+        byte(0x66); byte(0x0F); byte(0x2E);
+        byte(static_cast<std::uint8_t>(0xC0 | (left << 3) | right));
+    }
+
+    void X64Assembler::zero(Xmm dst) {
+        // xorpd dst, dst
+        byte(0x66); byte(0x0F); byte(0x57);
+        byte(static_cast<std::uint8_t>(0xC0 | (dst << 3) | dst));
+    }
+
+    void X64Assembler::negate(Xmm dst) {
+        // movq rax, dst; btc rax, 63; movq dst, rax
+        byte(0x66); byte(0x48); byte(0x0F); byte(0x7E); byte(static_cast<std::uint8_t>(0xC0 | (dst << 3)));
+        byte(0x48); byte(0x0F); byte(0xBA); byte(0xF8); byte(63);
+        byte(0x66); byte(0x48); byte(0x0F); byte(0x6E); byte(static_cast<std::uint8_t>(0xC0 | (dst << 3)));
+    }
+
+    void X64Assembler::decrementRdxCounter() {
+        byte(0x48); byte(0x83); byte(0x2A); byte(0x01);
+    }
+
+    void X64Assembler::movEax(std::uint32_t value) {
+        byte(0xB8);
+        int32(value);
+    }
+
+    void X64Assembler::ret() {
+        byte(0xC3);
+    }
+
+    void X64Assembler::jumpToRsi() {
+        byte(0xFF); byte(0xE6);
+    }
+
+    std::size_t X64Assembler::jump() {
+        byte(0xE9);
+        int32(0);
+        return m_code.size() - 4;
+    }
+
+    std::size_t X64Assembler::jump(Condition condition) {
+        byte(0x0F); byte(static_cast<std::uint8_t>(0x80 | static_cast<std::uint8_t>(condition)));
+        int32(0);
+        return m_code.size() - 4;
+    }
+
+    void X64Assembler::jumpShort(Condition condition, std::int8_t distance) {
+        byte(static_cast<std::uint8_t>(0x70 | static_cast<std::uint8_t>(condition)));
+        byte(static_cast<std::uint8_t>(distance));
+    }
+
+    // O deslocamento é relativo ao fim do campo de 4 bytes.
+    void X64Assembler::patch(std::size_t at, std::size_t target) {
+        auto relative = static_cast<std::int32_t>(static_cast<std::int64_t>(target) - static_cast<std::int64_t>(at + 4));
+        std::uint32_t bits = static_cast<std::uint32_t>(relative);
+        for (int i = 0; i < 4; ++i) m_code[at + i] = static_cast<std::uint8_t>(bits >> (8 * i));
+    }
+
+    bool ExecutableCode::supported() {
+        return LOX_JIT_X64 != 0;
+    }
+
+#if LOX_JIT_X64
+    std::unique_ptr<ExecutableCode> ExecutableCode::install(const std::vector<std::uint8_t>& code,
+                                                            const std::string& name, bool perfMap) {
+        std::size_t page = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        std::size_t mapped = (code.size() + page - 1) / page * page;
+        void* memory = mmap(nullptr, mapped, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (memory == MAP_FAILED) return nullptr;
+        std::memcpy(memory, code.data(), code.size());
+        if (mprotect(memory, mapped, PROT_READ | PROT_EXEC) != 0) {
+            munmap(memory, mapped);
+            return nullptr;
+        }
+        if (perfMap) {
+            std::ofstream map("/tmp/perf-" + std::to_string(getpid()) + ".map", std::ios::app);
+            map << std::hex << reinterpret_cast<std::uintptr_t>(memory) << " " << code.size() << " " << name << "\n";
+        }
+        return std::unique_ptr<ExecutableCode>(new ExecutableCode(memory, mapped, code.size()));
+    }
+
+    ExecutableCode::~ExecutableCode() {
+        munmap(m_memory, m_mapped);
+    }
+#else
+    std::unique_ptr<ExecutableCode> ExecutableCode::install(const std::vector<std::uint8_t>&, const std::string&, bool) {
+        return nullptr;
+    }
+
+    ExecutableCode::~ExecutableCode() = default;
+#endif
+
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lox {
+
+    // Montador mínimo de x86-64 para o JIT dos laços numéricos
+    // (NumericLoop.hpp). Só conhece as instruções que os templates usam:
+    // movsd/addsd/subsd/mulsd/divsd/ucomisd entre xmm0/xmm1 e [rdi + disp32],
+    // desvios rel32 e as poucas instruções inteiras em volta.
+    class X64Assembler {
+    public:
+        enum Xmm : std::uint8_t { xmm0 = 0, xmm1 = 1 };
+
+        enum class SseOp : std::uint8_t { Add = 0x58, Mul = 0x59, Sub = 0x5C, Div = 0x5E };
+
+        // Códigos das condições (o nibble baixo de jcc).
+        enum class Condition : std::uint8_t { AboveEqual = 0x3, Equal = 0x4, NotEqual = 0x5, Above = 0x7, Parity = 0xA };
+
+        // xmm <- [rdi + disp]
+        void load(Xmm dst, std::int32_t disp);
+        // [rdi + disp] <- xmm
+        void store(std::int32_t disp, Xmm src);
+        // xmm <- xmm op [rdi + disp]
+        void arithmetic(SseOp op, Xmm dst, std::int32_t disp);
+        // xmm <- xmm op xmm
+        void arithmetic(SseOp op, Xmm dst, Xmm src);
+        void compare(Xmm left, std::int32_t disp);
+        void compare(Xmm left, Xmm right);
+        void zero(Xmm dst);
+        // Inverte o bit de sinal (via rax), como o - unário do C++.
+        void negate(Xmm dst);
+
+        // sub qword [rdx], 1
+        void decrementRdxCounter();
+
+        void movEax(std::uint32_t value);
+        void ret();
+        // jmp rsi: entrada no meio do código (ver ExecutableCode::call).
+        void jumpToRsi();
+
+        // Desvio rel32 com destino a definir; retorna a posição a corrigir
+        // com patch().
+        std::size_t jump();
+        std::size_t jump(Condition condition);
+        // Desvio curto para frente, de distance bytes depois dele.
+        void jumpShort(Condition condition, std::int8_t distance);
+        void patch(std::size_t at, std::size_t target);
+
+        std::size_t size() const { return m_code.size(); }
+        const std::vector<std::uint8_t>& code() const { return m_code; }
+
+    private:
+        void byte(std::uint8_t value) { m_code.push_back(value); }
+        void int32(std::uint32_t value);
+        void memoryOperand(std::uint8_t reg, std::int32_t disp);
+
+        std::vector<std::uint8_t> m_code;
+    };
+
+    // Código de máquina em páginas próprias: escrito com PROT_WRITE e então
+    // trocado para PROT_EXEC (nunca os dois ao mesmo tempo).
+    class ExecutableCode {
+    public:
+        // Função gerada: recebe o banco de registradores em rdi, o endereço
+        // por onde começar em rsi e um contador em rdx; retorna em eax.
+        using Function = std::uint32_t (*)(double* registers, const void* entry, std::uint64_t* counter);
+
+        // Disponível só em x86-64 com mmap (Linux e outros Unix).
+        static bool supported();
+
+        // nullptr se não for suportado ou o sistema recusar a memória. Com
+        // perfMap, acrescenta "início tamanho nome" a /tmp/perf-<pid>.map
+        // para o perf atribuir amostras ao código gerado.
+        static std::unique_ptr<ExecutableCode> install(const std::vector<std::uint8_t>& code, const std::string& name,
+                                                       bool perfMap);
+
+        ExecutableCode(const ExecutableCode&) = delete;
+        ExecutableCode& operator=(const ExecutableCode&) = delete;
+        ~ExecutableCode();
+
+        // Executa a partir do byte offset do código.
+        std::uint32_t call(double* registers, std::size_t offset, std::uint64_t* counter) const {
+            return reinterpret_cast<Function>(m_memory)(registers, static_cast<std::uint8_t*>(m_memory) + offset, counter);
+        }
+
+        std::size_t size() const { return m_size; }
+
+    private:
+        ExecutableCode(void* memory, std::size_t mapped, std::size_t size)
+            : m_memory(memory), m_mapped(mapped), m_size(size) {}
+
+        void* m_memory;
+        std::size_t m_mapped;
+        std::size_t m_size;
+    };
+
+}
@@ -10,80 +10,197 @@
 
 namespace lox {
 
+    void ASTPrinter::print(const Expr& expr, std::ostream& out) {
+        m_out = &out;
+        write(expr);
+    }
+
+    void ASTPrinter::print(const Stmt& stmt, std::ostream& out) {
+        m_out = &out;
+        write(stmt);
+    }
+
     std::string ASTPrinter::print(const Expr& expr) {
-        auto result = expr.accept(*this);
-        return std::any_cast<std::string>(result);
+        std::ostringstream out;
+        print(expr, out);
+        return out.str();
     }
 
     std::string ASTPrinter::print(const Stmt& stmt) {
-        auto result = stmt.accept(*this);
-        return std::any_cast<std::string>(result);
+        std::ostringstream out;
+        print(stmt, out);
+        return out.str();
+    }
+
+    void ASTPrinter::write(const Expr& expr) {
+        expr.accept(*this);
+    }
+
+    void ASTPrinter::write(const Stmt& stmt) {
+        stmt.accept(*this);
+    }
+
+    std::any ASTPrinter::visitArrayLiteralExpr(const ArrayLiteral& expr) {
+        *m_out << "(array";
+        for (const auto& element : expr.elements) {
+            *m_out << ' ';
+            write(*element);
+        }
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitAssignExpr(const Assign& expr) {
-        return "(assign " + expr.name.lexeme + " = " + print(*expr.value) + ")";
+        *m_out << "(assign " << expr.name.lexeme << " = ";
+        write(*expr.value);
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitBinaryExpr(const Binary& expr) {
-        return "(" + expr.op.lexeme + " " + print(*expr.left) + " " + print(*expr.right) + ")";
+        *m_out << '(' << expr.op.lexeme << ' ';
+        write(*expr.left);
+        *m_out << ' ';
+        write(*expr.right);
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitCallExpr(const Call& expr) {
-        return "(call " + print(*expr.callee) + ")";
+        *m_out << "(call ";
+        write(*expr.callee);
+        for (const auto& argument : expr.arguments) {
+            *m_out << ' ';
+            write(*argument);
+        }
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitGroupingExpr(const Grouping& expr) {
-        return "(group " + print(*expr.expression) + ")";
+        *m_out << "(group ";
+        write(*expr.expression);
+        *m_out << ')';
+        return {};
+    }
+
+    std::any ASTPrinter::visitIncrementExpr(const Increment& expr) {
+        *m_out << "(+= " << expr.name.lexeme << ' ' << valueToString(expr.step) << ')';
+        return {};
+    }
+
+    std::any ASTPrinter::visitIndexExpr(const Index& expr) {
+        *m_out << "(index ";
+        write(*expr.object);
+        *m_out << ' ';
+        write(*expr.index);
+        *m_out << ')';
+        return {};
+    }
+
+    std::any ASTPrinter::visitIndexSetExpr(const IndexSet& expr) {
+        *m_out << "(assign ";
+        write(*expr.target);
+        *m_out << " = ";
+        write(*expr.value);
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitLiteralExpr(const Literal& expr) {
-        return valueToString(expr.value);
+        *m_out << valueToString(expr.value);
+        return {};
+    }
+
+    std::any ASTPrinter::visitLogicalExpr(const Logical& expr) {
+        *m_out << '(' << expr.op.lexeme << ' ';
+        write(*expr.left);
+        *m_out << ' ';
+        write(*expr.right);
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitUnaryExpr(const Unary& expr) {
-        return "(" + expr.op.lexeme + " " + print(*expr.right) + ")";
+        *m_out << '(' << expr.op.lexeme << ' ';
+        write(*expr.right);
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitVariableExpr(const Variable& expr) {
-        return expr.name.lexeme;
+        *m_out << expr.name.lexeme;
+        return {};
     }
 
     std::any ASTPrinter::visitBlockStmt(const BlockStmt& stmt) {
-        std::stringstream ss;
-        ss << "(block";
+        *m_out << "(block";
         for (const auto& statement : stmt.statements) {
-            ss << " " << print(*statement);
+            *m_out << ' ';
+            write(*statement);
         }
-        ss << ")";
-        return ss.str();
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitExpressionStmt(const ExpressionStmt& stmt) {
-        return "(; " + print(*stmt.expression) + ")";
+        *m_out << "(; ";
+        write(*stmt.expression);
+        *m_out << ')';
+        return {};
+    }
+
+    // Partes ausentes do for aparecem como _.
+    std::any ASTPrinter::visitForStmt(const ForStmt& stmt) {
+        *m_out << "(for ";
+        if (stmt.initializer != nullptr) write(*stmt.initializer); else *m_out << '_';
+        *m_out << ' ';
+        if (stmt.condition != nullptr) write(*stmt.condition); else *m_out << '_';
+        *m_out << ' ';
+        if (stmt.increment != nullptr) write(*stmt.increment); else *m_out << '_';
+        *m_out << ' ';
+        write(*stmt.body);
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitIfStmt(const IfStmt& stmt) {
-        std::string ifStr = "(if " + print(*stmt.condition) + " " + print(*stmt.thenBranch);
+        *m_out << "(if ";
+        write(*stmt.condition);
+        *m_out << ' ';
+        write(*stmt.thenBranch);
         if (stmt.elseBranch != nullptr) {
-            ifStr += " else " + print(*stmt.elseBranch);
+            *m_out << " else ";
+            write(*stmt.elseBranch);
         }
-        ifStr += ")";
-        return ifStr;
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitPrintStmt(const PrintStmt& stmt) {
-        return "(print " + print(*stmt.expression) + ")";
+        *m_out << "(print ";
+        write(*stmt.expression);
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitVarStmt(const VarStmt& stmt) {
-        if (stmt.initializer == nullptr) {
-            return "(var " + stmt.name.lexeme + ")";
+        *m_out << "(var " << stmt.name.lexeme;
+        if (stmt.initializer != nullptr) {
+            *m_out << " = ";
+            write(*stmt.initializer);
         }
-        return "(var " + stmt.name.lexeme + " = " + print(*stmt.initializer) + ")";
+        *m_out << ')';
+        return {};
     }
 
     std::any ASTPrinter::visitWhileStmt(const WhileStmt& stmt) {
-        return "(while " + print(*stmt.condition) + " " + print(*stmt.body) + ")";
+        *m_out << "(while ";
+        write(*stmt.condition);
+        *m_out << ' ';
+        write(*stmt.body);
+        *m_out << ')';
+        return {};
     }
 
-} 
\ No newline at end of file
+}
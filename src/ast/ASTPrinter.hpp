@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Visitor.hpp"
+#include <ostream>
 #include <string>
 #include <any>
 
@@ -9,39 +10,64 @@ namespace lox {
     // Forward-declarations
     struct Expr;
     struct Stmt;
+    struct ArrayLiteral;
     struct Assign;
     struct Binary;
     struct Call;
     struct Grouping;
+    struct Increment;
+    struct Index;
+    struct IndexSet;
     struct Literal;
+    struct Logical;
     struct Unary;
     struct Variable;
     struct BlockStmt;
     struct ExpressionStmt;
+    struct ForStmt;
     struct IfStmt;
     struct PrintStmt;
     struct VarStmt;
     struct WhileStmt;
 
+    // Imprime a AST em notação de S-expressions. A saída é escrita aos
+    // poucos no stream, sem montar strings intermediárias: o custo é linear
+    // no tamanho da árvore mesmo para árvores muito profundas.
     class ASTPrinter : public Visitor {
     public:
+        void print(const Expr& expr, std::ostream& out);
+        void print(const Stmt& stmt, std::ostream& out);
+
+        // Conveniência para textos curtos (testes, notas do otimizador).
         std::string print(const Expr& expr);
         std::string print(const Stmt& stmt);
 
         // Métodos de visita
+        std::any visitArrayLiteralExpr(const ArrayLiteral& expr) override;
         std::any visitAssignExpr(const Assign& expr) override;
         std::any visitBinaryExpr(const Binary& expr) override;
         std::any visitCallExpr(const Call& expr) override;
         std::any visitGroupingExpr(const Grouping& expr) override;
+        std::any visitIncrementExpr(const Increment& expr) override;
+        std::any visitIndexExpr(const Index& expr) override;
+        std::any visitIndexSetExpr(const IndexSet& expr) override;
         std::any visitLiteralExpr(const Literal& expr) override;
+        std::any visitLogicalExpr(const Logical& expr) override;
         std::any visitUnaryExpr(const Unary& expr) override;
         std::any visitVariableExpr(const Variable& expr) override;
         std::any visitBlockStmt(const BlockStmt& stmt) override;
         std::any visitExpressionStmt(const ExpressionStmt& stmt) override;
+        std::any visitForStmt(const ForStmt& stmt) override;
         std::any visitIfStmt(const IfStmt& stmt) override;
         std::any visitPrintStmt(const PrintStmt& stmt) override;
         std::any visitVarStmt(const VarStmt& stmt) override;
         std::any visitWhileStmt(const WhileStmt& stmt) override;
+
+    private:
+        void write(const Expr& expr);
+        void write(const Stmt& stmt);
+
+        std::ostream* m_out = nullptr;
     };
 
 } 
\ No newline at end of file
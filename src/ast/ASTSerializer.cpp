@@ -0,0 +1,798 @@
+#include "ASTSerializer.hpp"
+#include "Expr.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <pthread.h>
+#include <string_view>
+#include <unordered_map>
+
+namespace lox {
+
+    // Os dois escritores juntam a saída em um buffer e o descarregam no
+    // stream em blocos.
+    class BufferedWriter {
+    public:
+        explicit BufferedWriter(std::ostream& out) : m_out(out) { m_buffer.reserve(kFlushBytes + 256); }
+        ~BufferedWriter() { flush(); }
+
+    protected:
+        static constexpr std::size_t kFlushBytes = 64 * 1024;
+
+        void put(char c) {
+            m_buffer.push_back(c);
+            if (m_buffer.size() >= kFlushBytes) flush();
+        }
+
+        void put(const char* data, std::size_t size) {
+            m_buffer.append(data, size);
+            if (m_buffer.size() >= kFlushBytes) flush();
+        }
+
+        void put(const char* text) { put(text, std::strlen(text)); }
+        void put(const std::string& text) { put(text.data(), text.size()); }
+
+        void flush() {
+            m_out.write(m_buffer.data(), static_cast<std::streamsize>(m_buffer.size()));
+            m_buffer.clear();
+        }
+
+    private:
+        std::ostream& m_out;
+        std::string m_buffer;
+    };
+
+    // --- JSON ---
+
+    class JsonAstWriter : public BufferedWriter {
+    public:
+        using BufferedWriter::BufferedWriter;
+
+        void program(const std::vector<std::unique_ptr<Stmt>>& statements) {
+            put("{\"format\":\"lox-ast\",\"version\":1,\"statements\":[");
+            bool first = true;
+            for (const auto& stmt : statements) {
+                if (stmt == nullptr) continue;
+                put(first ? "\n" : ",\n");
+                first = false;
+                this->stmt(*stmt);
+            }
+            put("\n]}\n");
+        }
+
+    private:
+        void key(const char* name) {
+            put(',');
+            put('"');
+            put(name);
+            put("\":");
+        }
+
+        void string(const std::string& text) {
+            put('"');
+            for (char c : text) {
+                if (c == '"' || c == '\\') {
+                    put('\\');
+                    put(c);
+                } else if (static_cast<unsigned char>(c) < 0x20) {
+                    static const char* digits = "0123456789abcdef";
+                    char escaped[] = {'\\', 'u', '0', '0', digits[(c >> 4) & 0xF], digits[c & 0xF]};
+                    put(escaped, sizeof(escaped));
+                } else {
+                    put(c);
+                }
+            }
+            put('"');
+        }
+
+        void number(double value) {
+            char buffer[32];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            put(buffer, static_cast<std::size_t>(result.ptr - buffer));
+        }
+
+        void integer(long long value) {
+            char buffer[24];
+            auto result = std::to_chars(buffer, buffer + sizeof(buffer), value);
+            put(buffer, static_cast<std::size_t>(result.ptr - buffer));
+        }
+
+        void open(const char* field, const char* kind) {
+            put("{\"");
+            put(field);
+            put("\":\"");
+            put(kind);
+            put('"');
+        }
+
+        void token(const char* name, const Token& token) {
+            key(name);
+            string(token.lexeme);
+        }
+
+        void line(int value) {
+            key("line");
+            integer(value);
+        }
+
+        void child(const char* name, const Expr* expr) {
+            key(name);
+            if (expr != nullptr) this->expr(*expr); else put("null");
+        }
+
+        void child(const char* name, const Stmt* stmt) {
+            key(name);
+            if (stmt != nullptr) this->stmt(*stmt); else put("null");
+        }
+
+        template<typename Node>
+        void list(const char* name, const std::vector<std::unique_ptr<Node>>& nodes) {
+            key(name);
+            put('[');
+            for (std::size_t i = 0; i < nodes.size(); ++i) {
+                if (i > 0) put(',');
+                child(nodes[i].get());
+            }
+            put(']');
+        }
+
+        void child(const Expr* expr) { expr != nullptr ? this->expr(*expr) : put("null"); }
+        void child(const Stmt* stmt) { stmt != nullptr ? this->stmt(*stmt) : put("null"); }
+
+        void expr(const Expr& expr) {
+            open("expr", exprKindName(expr.kind));
+            switch (expr.kind) {
+                case ExprKind::ArrayLiteral: {
+                    const auto& array = static_cast<const ArrayLiteral&>(expr);
+                    line(array.bracket.line);
+                    list("elements", array.elements);
+                    break;
+                }
+                case ExprKind::Assign: {
+                    const auto& assign = static_cast<const Assign&>(expr);
+                    line(assign.name.line);
+                    token("name", assign.name);
+                    child("value", assign.value.get());
+                    break;
+                }
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    line(binary.op.line);
+                    token("op", binary.op);
+                    child("left", binary.left.get());
+                    child("right", binary.right.get());
+                    break;
+                }
+                case ExprKind::Call: {
+                    const auto& call = static_cast<const Call&>(expr);
+                    line(call.paren.line);
+                    child("callee", call.callee.get());
+                    list("arguments", call.arguments);
+                    break;
+                }
+                case ExprKind::Grouping:
+                    child("expression", static_cast<const Grouping&>(expr).expression.get());
+                    break;
+                case ExprKind::Increment: {
+                    const auto& increment = static_cast<const Increment&>(expr);
+                    line(increment.name.line);
+                    token("name", increment.name);
+                    token("op", increment.op);
+                    key("step");
+                    number(increment.step);
+                    break;
+                }
+                case ExprKind::Index: {
+                    const auto& index = static_cast<const Index&>(expr);
+                    line(index.bracket.line);
+                    child("object", index.object.get());
+                    child("index", index.index.get());
+                    break;
+                }
+                case ExprKind::IndexSet: {
+                    const auto& set = static_cast<const IndexSet&>(expr);
+                    child("target", static_cast<const Expr*>(set.target.get()));
+                    child("value", set.value.get());
+                    break;
+                }
+                case ExprKind::Literal: {
+                    const Value& value = static_cast<const Literal&>(expr).value;
+                    key("value");
+                    if (auto boolean = std::get_if<bool>(&value)) {
+                        put(*boolean ? "true" : "false");
+                    } else if (auto number = std::get_if<double>(&value)) {
+                        this->number(*number);
+                    } else if (auto text = std::get_if<String>(&value)) {
+                        string(std::string(text->data(), text->size()));
+                    } else {
+                        put("null");
+                    }
+                    break;
+                }
+                case ExprKind::Logical: {
+                    const auto& logical = static_cast<const Logical&>(expr);
+                    line(logical.op.line);
+                    token("op", logical.op);
+                    child("left", logical.left.get());
+                    child("right", logical.right.get());
+                    break;
+                }
+                case ExprKind::Unary: {
+                    const auto& unary = static_cast<const Unary&>(expr);
+                    line(unary.op.line);
+                    token("op", unary.op);
+                    child("right", unary.right.get());
+                    break;
+                }
+                case ExprKind::Variable: {
+                    const auto& variable = static_cast<const Variable&>(expr);
+                    line(variable.name.line);
+                    token("name", variable.name);
+                    break;
+                }
+            }
+            put('}');
+        }
+
+        void stmt(const Stmt& stmt) {
+            open("stmt", stmtKindName(stmt.kind));
+            line(stmt.line);
+            switch (stmt.kind) {
+                case StmtKind::Block:
+                    list("statements", static_cast<const BlockStmt&>(stmt).statements);
+                    break;
+                case StmtKind::Expression:
+                    child("expression", static_cast<const ExpressionStmt&>(stmt).expression.get());
+                    break;
+                case StmtKind::For: {
+                    const auto& loop = static_cast<const ForStmt&>(stmt);
+                    child("initializer", loop.initializer.get());
+                    child("condition", loop.condition.get());
+                    child("increment", loop.increment.get());
+                    child("body", loop.body.get());
+                    key("counted");
+                    put(loop.counted ? "true" : "false");
+                    break;
+                }
+                case StmtKind::If: {
+                    const auto& branch = static_cast<const IfStmt&>(stmt);
+                    child("condition", branch.condition.get());
+                    child("thenBranch", branch.thenBranch.get());
+                    child("elseBranch", branch.elseBranch.get());
+                    break;
+                }
+                case StmtKind::Print:
+                    child("expression", static_cast<const PrintStmt&>(stmt).expression.get());
+                    break;
+                case StmtKind::Var: {
+                    const auto& var = static_cast<const VarStmt&>(stmt);
+                    token("name", var.name);
+                    child("initializer", var.initializer.get());
+                    break;
+                }
+                case StmtKind::While: {
+                    const auto& loop = static_cast<const WhileStmt&>(stmt);
+                    child("condition", loop.condition.get());
+                    child("body", loop.body.get());
+                    break;
+                }
+            }
+            put('}');
+        }
+    };
+
+    void writeAstJson(std::ostream& out, const std::vector<std::unique_ptr<Stmt>>& statements) {
+        JsonAstWriter(out).program(statements);
+    }
+
+    // --- Binário ---
+
+    static constexpr char kMagic[] = {'L', 'O', 'X', 'A', 'S', 'T'};
+    static constexpr std::uint8_t kVersion = 1;
+    static constexpr std::uint8_t kAbsent = 0xFF;
+
+    enum class LiteralTag : std::uint8_t { Nil, False, True, Number, String, Integer };
+
+    static std::uint64_t zigzag(std::int64_t value) {
+        return (static_cast<std::uint64_t>(value) << 1) ^ static_cast<std::uint64_t>(value >> 63);
+    }
+
+    static std::int64_t unzigzag(std::uint64_t value) {
+        return static_cast<std::int64_t>(value >> 1) ^ -static_cast<std::int64_t>(value & 1);
+    }
+
+    class BinaryAstWriter : public BufferedWriter {
+    public:
+        using BufferedWriter::BufferedWriter;
+
+        void program(const std::vector<std::unique_ptr<Stmt>>& statements) {
+            put(kMagic, sizeof(kMagic));
+            byte(kVersion);
+            std::size_t count = 0;
+            for (const auto& stmt : statements) count += stmt != nullptr;
+            varint(count);
+            for (const auto& stmt : statements) {
+                if (stmt) this->stmt(*stmt);
+            }
+        }
+
+    private:
+        void byte(std::uint8_t value) { put(static_cast<char>(value)); }
+
+        void varint(std::uint64_t value) {
+            while (value >= 0x80) {
+                byte(static_cast<std::uint8_t>(value | 0x80));
+                value >>= 7;
+            }
+            byte(static_cast<std::uint8_t>(value));
+        }
+
+        void float64(double value) {
+            std::uint64_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            for (int i = 0; i < 8; ++i) byte(static_cast<std::uint8_t>(bits >> (8 * i)));
+        }
+
+        void line(int value) {
+            varint(zigzag(static_cast<std::int64_t>(value) - m_line));
+            m_line = value;
+        }
+
+        void string(const std::string& text) {
+            auto [it, inserted] = m_strings.emplace(text, m_strings.size());
+            if (!inserted) {
+                varint(it->second + 1);
+                return;
+            }
+            varint(0);
+            varint(text.size());
+            put(text);
+        }
+
+        void token(const Token& token) {
+            byte(static_cast<std::uint8_t>(token.type));
+            line(token.line);
+            string(token.lexeme);
+        }
+
+        void optional(const Expr* expr) { expr != nullptr ? this->expr(*expr) : byte(kAbsent); }
+        void optional(const Stmt* stmt) { stmt != nullptr ? this->stmt(*stmt) : byte(kAbsent); }
+
+        void literal(const Value& value) {
+            if (auto boolean = std::get_if<bool>(&value)) {
+                byte(static_cast<std::uint8_t>(*boolean ? LiteralTag::True : LiteralTag::False));
+            } else if (auto number = std::get_if<double>(&value)) {
+                // Inteiros pequenos (o caso comum) cabem em um ou dois bytes.
+                bool integral = *number >= -1e15 && *number <= 1e15 && std::trunc(*number) == *number
+                                && !(*number == 0 && std::signbit(*number));
+                if (integral) {
+                    byte(static_cast<std::uint8_t>(LiteralTag::Integer));
+                    varint(zigzag(static_cast<std::int64_t>(*number)));
+                } else {
+                    byte(static_cast<std::uint8_t>(LiteralTag::Number));
+                    float64(*number);
+                }
+            } else if (auto text = std::get_if<String>(&value)) {
+                byte(static_cast<std::uint8_t>(LiteralTag::String));
+                string(std::string(text->data(), text->size()));
+            } else {
+                byte(static_cast<std::uint8_t>(LiteralTag::Nil));
+            }
+        }
+
+        void expr(const Expr& expr) {
+            byte(static_cast<std::uint8_t>(expr.kind));
+            switch (expr.kind) {
+                case ExprKind::ArrayLiteral: {
+                    const auto& array = static_cast<const ArrayLiteral&>(expr);
+                    token(array.bracket);
+                    varint(array.elements.size());
+                    for (const auto& element : array.elements) this->expr(*element);
+                    break;
+                }
+                case ExprKind::Assign: {
+                    const auto& assign = static_cast<const Assign&>(expr);
+                    token(assign.name);
+                    this->expr(*assign.value);
+                    break;
+                }
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    this->expr(*binary.left);
+                    token(binary.op);
+                    this->expr(*binary.right);
+                    break;
+                }
+                case ExprKind::Call: {
+                    const auto& call = static_cast<const Call&>(expr);
+                    this->expr(*call.callee);
+                    token(call.paren);
+                    varint(call.arguments.size());
+                    for (const auto& argument : call.arguments) this->expr(*argument);
+                    break;
+                }
+                case ExprKind::Grouping:
+                    this->expr(*static_cast<const Grouping&>(expr).expression);
+                    break;
+                case ExprKind::Increment: {
+                    const auto& increment = static_cast<const Increment&>(expr);
+                    token(increment.name);
+                    token(increment.op);
+                    float64(increment.step);
+                    break;
+                }
+                case ExprKind::Index: {
+                    const auto& index = static_cast<const Index&>(expr);
+                    this->expr(*index.object);
+                    token(index.bracket);
+                    this->expr(*index.index);
+                    break;
+                }
+                case ExprKind::IndexSet: {
+                    const auto& set = static_cast<const IndexSet&>(expr);
+                    this->expr(*set.target);
+                    this->expr(*set.value);
+                    break;
+                }
+                case ExprKind::Literal:
+                    literal(static_cast<const Literal&>(expr).value);
+                    break;
+                case ExprKind::Logical: {
+                    const auto& logical = static_cast<const Logical&>(expr);
+                    this->expr(*logical.left);
+                    token(logical.op);
+                    this->expr(*logical.right);
+                    break;
+                }
+                case ExprKind::Unary: {
+                    const auto& unary = static_cast<const Unary&>(expr);
+                    token(unary.op);
+                    this->expr(*unary.right);
+                    break;
+                }
+                case ExprKind::Variable:
+                    token(static_cast<const Variable&>(expr).name);
+                    break;
+            }
+        }
+
+        void stmt(const Stmt& stmt) {
+            byte(static_cast<std::uint8_t>(stmt.kind));
+            line(stmt.line);
+            switch (stmt.kind) {
+                case StmtKind::Block: {
+                    const auto& block = static_cast<const BlockStmt&>(stmt);
+                    varint(block.statements.size());
+                    for (const auto& inner : block.statements) this->stmt(*inner);
+                    break;
+                }
+                case StmtKind::Expression:
+                    expr(*static_cast<const ExpressionStmt&>(stmt).expression);
+                    break;
+                case StmtKind::For: {
+                    const auto& loop = static_cast<const ForStmt&>(stmt);
+                    optional(loop.initializer.get());
+                    optional(loop.condition.get());
+                    optional(loop.increment.get());
+                    this->stmt(*loop.body);
+                    byte(loop.counted ? 1 : 0);
+                    break;
+                }
+                case StmtKind::If: {
+                    const auto& branch = static_cast<const IfStmt&>(stmt);
+                    expr(*branch.condition);
+                    this->stmt(*branch.thenBranch);
+                    optional(branch.elseBranch.get());
+                    break;
+                }
+                case StmtKind::Print:
+                    expr(*static_cast<const PrintStmt&>(stmt).expression);
+                    break;
+                case StmtKind::Var: {
+                    const auto& var = static_cast<const VarStmt&>(stmt);
+                    token(var.name);
+                    optional(var.initializer.get());
+                    break;
+                }
+                case StmtKind::While: {
+                    const auto& loop = static_cast<const WhileStmt&>(stmt);
+                    expr(*loop.condition);
+                    this->stmt(*loop.body);
+                    break;
+                }
+            }
+        }
+
+        std::int64_t m_line = 0;
+        std::unordered_map<std::string, std::size_t> m_strings;
+    };
+
+    void writeAstBinary(std::ostream& out, const std::vector<std::unique_ptr<Stmt>>& statements) {
+        BinaryAstWriter(out).program(statements);
+    }
+
+    // Endereço do frame atual (a pilha cresce para baixo). Com o ASan,
+    // __builtin_frame_address continua dando a pilha real, não a pilha falsa
+    // de detect_stack_use_after_return.
+    static std::uintptr_t stackAddress() {
+        return reinterpret_cast<std::uintptr_t>(__builtin_frame_address(0));
+    }
+
+    // Bytes livres na pilha da thread atual abaixo de here; 0 se o sistema
+    // não informar os limites dela.
+    static std::size_t freeStack(std::uintptr_t here) {
+        pthread_attr_t attributes;
+        if (pthread_getattr_np(pthread_self(), &attributes) != 0) return 0;
+        void* low = nullptr;
+        std::size_t size = 0;
+        int error = pthread_attr_getstack(&attributes, &low, &size);
+        pthread_attr_destroy(&attributes);
+        auto bottom = reinterpret_cast<std::uintptr_t>(low);
+        return error == 0 && here > bottom ? here - bottom : 0;
+    }
+
+    class BinaryAstReader {
+    public:
+        explicit BinaryAstReader(std::string_view data) : m_data(data) {
+            std::uintptr_t here = stackAddress();
+            std::size_t budget = freeStack(here) / 2;
+            if (budget == 0) budget = kFallbackStackBudget;
+            m_stackLimit = budget < here ? here - budget : 0;
+        }
+
+        std::vector<std::unique_ptr<Stmt>> program() {
+            if (m_data.size() < sizeof(kMagic) || std::memcmp(m_data.data(), kMagic, sizeof(kMagic)) != 0) {
+                throw AstFormatError("missing LOXAST header.");
+            }
+            m_position = sizeof(kMagic);
+            if (byte() != kVersion) throw AstFormatError("unsupported version.");
+            std::vector<std::unique_ptr<Stmt>> statements(count());
+            for (auto& stmt : statements) stmt = this->stmt();
+            if (m_position != m_data.size()) throw AstFormatError("trailing data.");
+            return statements;
+        }
+
+    private:
+        // A leitura é recursiva: sem um limite, poucos bytes de nós aninhados
+        // (um Unary dentro do outro, por exemplo) estourariam a pilha. Além
+        // de kMaxDepth níveis, o leitor não usa mais que metade da pilha
+        // livre quando começa: o tamanho de cada frame muda com o compilador
+        // e com sanitizers (o ASan os deixa várias vezes maiores), então o
+        // limite é medido em bytes, e a outra metade fica para quem percorre
+        // a árvore depois.
+        static constexpr int kMaxDepth = 4096;
+        static constexpr std::size_t kFallbackStackBudget = 256 * 1024;
+
+        struct Nesting {
+            explicit Nesting(BinaryAstReader& reader) : reader(reader) {
+                if (++reader.m_depth > kMaxDepth || stackAddress() < reader.m_stackLimit) {
+                    throw AstFormatError("nesting too deep.");
+                }
+            }
+            ~Nesting() { --reader.m_depth; }
+            BinaryAstReader& reader;
+        };
+
+        std::uint8_t byte() {
+            if (m_position >= m_data.size()) throw AstFormatError("truncated.");
+            return static_cast<std::uint8_t>(m_data[m_position++]);
+        }
+
+        std::uint8_t peek() {
+            if (m_position >= m_data.size()) throw AstFormatError("truncated.");
+            return static_cast<std::uint8_t>(m_data[m_position]);
+        }
+
+        std::uint64_t varint() {
+            std::uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7) {
+                std::uint8_t part = byte();
+                value |= static_cast<std::uint64_t>(part & 0x7F) << shift;
+                if ((part & 0x80) == 0) return value;
+            }
+            throw AstFormatError("bad varint.");
+        }
+
+        // Quantidade de itens de uma lista; cada item ocupa pelo menos um
+        // byte, o que limita reservas absurdas em dados corrompidos.
+        std::size_t count() {
+            std::uint64_t value = varint();
+            if (value > m_data.size() - m_position) throw AstFormatError("bad list size.");
+            return static_cast<std::size_t>(value);
+        }
+
+        double float64() {
+            std::uint64_t bits = 0;
+            for (int i = 0; i < 8; ++i) bits |= static_cast<std::uint64_t>(byte()) << (8 * i);
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            return value;
+        }
+
+        int line() {
+            m_line += unzigzag(varint());
+            return static_cast<int>(m_line);
+        }
+
+        const std::string& string() {
+            std::uint64_t reference = varint();
+            if (reference != 0) {
+                if (reference > m_strings.size()) throw AstFormatError("bad string reference.");
+                return m_strings[reference - 1];
+            }
+            std::uint64_t size = varint();
+            if (size > m_data.size() - m_position) throw AstFormatError("truncated.");
+            m_strings.emplace_back(m_data.substr(m_position, static_cast<std::size_t>(size)));
+            m_position += static_cast<std::size_t>(size);
+            return m_strings.back();
+        }
+
+        Token token() {
+            std::uint8_t type = byte();
+            if (type >= kTokenTypeCount) throw AstFormatError("bad token type.");
+            int tokenLine = line();
+            return Token(static_cast<TokenType>(type), string(), tokenLine);
+        }
+
+        Value literal() {
+            switch (static_cast<LiteralTag>(byte())) {
+                case LiteralTag::Nil: return std::monostate{};
+                case LiteralTag::False: return false;
+                case LiteralTag::True: return true;
+                case LiteralTag::Number: return float64();
+                case LiteralTag::String: {
+                    const std::string& text = string();
+                    return String(text.data(), text.size());
+                }
+                case LiteralTag::Integer: return static_cast<double>(unzigzag(varint()));
+            }
+            throw AstFormatError("bad literal.");
+        }
+
+        std::unique_ptr<Expr> optionalExpr() {
+            if (peek() == kAbsent) {
+                ++m_position;
+                return nullptr;
+            }
+            return expr();
+        }
+
+        std::unique_ptr<Stmt> optionalStmt() {
+            if (peek() == kAbsent) {
+                ++m_position;
+                return nullptr;
+            }
+            return stmt();
+        }
+
+        std::vector<std::unique_ptr<Expr>> exprs() {
+            std::vector<std::unique_ptr<Expr>> list(count());
+            for (auto& expr : list) expr = this->expr();
+            return list;
+        }
+
+        std::unique_ptr<Expr> expr() {
+            Nesting nesting(*this);
+            std::uint8_t kind = byte();
+            if (kind >= kExprKindCount) throw AstFormatError("bad expression kind.");
+            switch (static_cast<ExprKind>(kind)) {
+                case ExprKind::ArrayLiteral: {
+                    Token bracket = token();
+                    return std::make_unique<ArrayLiteral>(std::move(bracket), exprs());
+                }
+                case ExprKind::Assign: {
+                    Token name = token();
+                    return std::make_unique<Assign>(std::move(name), expr());
+                }
+                case ExprKind::Binary: {
+                    auto left = expr();
+                    Token op = token();
+                    return std::make_unique<Binary>(std::move(left), std::move(op), expr());
+                }
+                case ExprKind::Call: {
+                    auto callee = expr();
+                    Token paren = token();
+                    return std::make_unique<Call>(std::move(callee), std::move(paren), exprs());
+                }
+                case ExprKind::Grouping:
+                    return std::make_unique<Grouping>(expr());
+                case ExprKind::Increment: {
+                    Token name = token();
+                    Token op = token();
+                    return std::make_unique<Increment>(std::move(name), std::move(op), float64());
+                }
+                case ExprKind::Index: {
+                    auto object = expr();
+                    Token bracket = token();
+                    return std::make_unique<Index>(std::move(object), std::move(bracket), expr());
+                }
+                case ExprKind::IndexSet: {
+                    auto target = expr();
+                    if (target->kind != ExprKind::Index) throw AstFormatError("index assignment without an index.");
+                    std::unique_ptr<Index> index(static_cast<Index*>(target.release()));
+                    return std::make_unique<IndexSet>(std::move(index), expr());
+                }
+                case ExprKind::Literal:
+                    return std::make_unique<Literal>(literal());
+                case ExprKind::Logical: {
+                    auto left = expr();
+                    Token op = token();
+                    return std::make_unique<Logical>(std::move(left), std::move(op), expr());
+                }
+                case ExprKind::Unary: {
+                    Token op = token();
+                    return std::make_unique<Unary>(std::move(op), expr());
+                }
+                case ExprKind::Variable:
+                    return std::make_unique<Variable>(token());
+            }
+            throw AstFormatError("bad expression kind.");
+        }
+
+        std::unique_ptr<Stmt> stmt() {
+            Nesting nesting(*this);
+            std::uint8_t kind = byte();
+            if (kind >= kStmtKindCount) throw AstFormatError("bad statement kind.");
+            int stmtLine = line();
+            std::unique_ptr<Stmt> result;
+            switch (static_cast<StmtKind>(kind)) {
+                case StmtKind::Block: {
+                    std::vector<std::unique_ptr<Stmt>> statements(count());
+                    for (auto& inner : statements) inner = stmt();
+                    result = std::make_unique<BlockStmt>(std::move(statements));
+                    break;
+                }
+                case StmtKind::Expression:
+                    result = std::make_unique<ExpressionStmt>(expr());
+                    break;
+                case StmtKind::For: {
+                    auto initializer = optionalStmt();
+                    auto condition = optionalExpr();
+                    auto increment = optionalExpr();
+                    auto body = stmt();
+                    bool counted = byte() != 0;
+                    result = std::make_unique<ForStmt>(std::move(initializer), std::move(condition), std::move(increment),
+                                                       std::move(body), counted);
+                    break;
+                }
+                case StmtKind::If: {
+                    auto condition = expr();
+                    auto thenBranch = stmt();
+                    result = std::make_unique<IfStmt>(std::move(condition), std::move(thenBranch), optionalStmt());
+                    break;
+                }
+                case StmtKind::Print:
+                    result = std::make_unique<PrintStmt>(expr());
+                    break;
+                case StmtKind::Var: {
+                    Token name = token();
+                    result = std::make_unique<VarStmt>(std::move(name), optionalExpr());
+                    break;
+                }
+                case StmtKind::While: {
+                    auto condition = expr();
+                    result = std::make_unique<WhileStmt>(std::move(condition), stmt());
+                    break;
+                }
+            }
+            result->line = stmtLine;
+            return result;
+        }
+
+        std::string_view m_data;
+        std::size_t m_position = 0;
+        std::int64_t m_line = 0;
+        int m_depth = 0;
+        std::uintptr_t m_stackLimit = 0;
+        std::vector<std::string> m_strings;
+    };
+
+    std::vector<std::unique_ptr<Stmt>> readAstBinary(std::istream& in) {
+        std::string data(std::istreambuf_iterator<char>(in), {});
+        return BinaryAstReader(data).program();
+    }
+
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include "Stmt.hpp"
+
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace lox {
+
+    // Formatos de --dump-ast, para ferramentas externas lerem a AST sem
+    // passar pelo front-end de Lox. Os dois são escritos aos poucos no
+    // stream, em uma passada só pela árvore.
+    //
+    // JSON: {"format":"lox-ast","version":1,"statements":[...]}. Cada
+    // statement tem "stmt" (nomes de stmtKindName) e "line"; cada expressão
+    // tem "expr" (nomes de exprKindName) e, quando tem um token, "line". Os
+    // demais campos têm o nome dos membros dos nós em Expr.hpp e Stmt.hpp;
+    // filhos ausentes são null.
+    //
+    // Binário (little-endian):
+    //
+    //   arquivo:   "LOXAST" u8 versão, lista de statements
+    //   lista:     varint n, n nós
+    //   statement: u8 StmtKind, linha, campos
+    //   expressão: u8 ExprKind, campos
+    //   ausente:   u8 0xFF no lugar de um filho opcional
+    //   token:     u8 TokenType, linha, string (o lexema)
+    //   linha:     varint zigzag com a diferença para a última linha escrita
+    //   string:    varint 0, varint tamanho, bytes (nova; recebe o próximo
+    //              índice) ou varint i + 1 (repete a string de índice i)
+    //   literal:   u8 0 nil, 1 false, 2 true, 3 f64, 4 string, 5 inteiro
+    //              (varint zigzag)
+    //
+    // Os campos seguem a ordem dos construtores dos nós.
+    void writeAstJson(std::ostream& out, const std::vector<std::unique_ptr<Stmt>>& statements);
+    void writeAstBinary(std::ostream& out, const std::vector<std::unique_ptr<Stmt>>& statements);
+
+    class AstFormatError : public std::runtime_error {
+    public:
+        explicit AstFormatError(const std::string& message) : std::runtime_error("Invalid AST file: " + message) {}
+    };
+
+    // Lê o formato binário. Lança AstFormatError se os dados não forem uma
+    // AST válida, inclusive se os nós se aninharem mais de 4096 níveis ou
+    // mais do que cabe em metade da pilha livre da thread.
+    std::vector<std::unique_ptr<Stmt>> readAstBinary(std::istream& in);
+
+}
@@ -3,6 +3,7 @@
 #include "Token.hpp"
 #include "Value.hpp"
 #include "Visitor.hpp"
+#include "NodeKind.hpp"
 #include <memory>
 #include <vector>
 #include <any>
@@ -10,18 +11,37 @@
 namespace lox {
 
     struct Expr {
+        const ExprKind kind;
+
+        explicit Expr(ExprKind kind) : kind(kind) {}
         virtual ~Expr() = default;
         virtual std::any accept(Visitor& visitor) const = 0;
     };
 
     // --- Classes Concretas de Expressão ---
+    //
+    // Os Tokens dos nós não são const: o IncrementalParser corrige as linhas
+    // de declarações reaproveitadas quando o texto acima delas muda.
+
+    struct ArrayLiteral : public Expr {
+        Token bracket;
+        const std::vector<std::unique_ptr<Expr>> elements;
+
+        ArrayLiteral(Token bracket, std::vector<std::unique_ptr<Expr>> elements)
+            : Expr(ExprKind::ArrayLiteral), bracket(std::move(bracket)), elements(std::move(elements)) {}
+
+        std::any accept(Visitor& visitor) const override {
+            return visitor.visitArrayLiteralExpr(*this);
+        }
+    };
 
     struct Assign : public Expr {
-        const Token name;
+        Token name;
         const std::unique_ptr<Expr> value;
+        mutable GlobalCache cache;   // preenchido pelo Interpreter
 
         Assign(Token name, std::unique_ptr<Expr> value)
-            : name(std::move(name)), value(std::move(value)) {}
+            : Expr(ExprKind::Assign), name(std::move(name)), value(std::move(value)) {}
 
         std::any accept(Visitor& visitor) const override {
             return visitor.visitAssignExpr(*this);
@@ -30,11 +50,11 @@ namespace lox {
 
     struct Binary : public Expr {
         const std::unique_ptr<Expr> left;
-        const Token op;
+        Token op;
         const std::unique_ptr<Expr> right;
 
         Binary(std::unique_ptr<Expr> left, Token op, std::unique_ptr<Expr> right)
-            : left(std::move(left)), op(std::move(op)), right(std::move(right)) {}
+            : Expr(ExprKind::Binary), left(std::move(left)), op(std::move(op)), right(std::move(right)) {}
 
         std::any accept(Visitor& visitor) const override {
             return visitor.visitBinaryExpr(*this);
@@ -43,11 +63,11 @@ namespace lox {
 
     struct Call : public Expr {
         const std::unique_ptr<Expr> callee;
-        const Token paren;
+        Token paren;
         const std::vector<std::unique_ptr<Expr>> arguments;
 
         Call(std::unique_ptr<Expr> callee, Token paren, std::vector<std::unique_ptr<Expr>> arguments)
-            : callee(std::move(callee)), paren(std::move(paren)), arguments(std::move(arguments)) {}
+            : Expr(ExprKind::Call), callee(std::move(callee)), paren(std::move(paren)), arguments(std::move(arguments)) {}
 
         std::any accept(Visitor& visitor) const override {
             return visitor.visitCallExpr(*this);
@@ -58,29 +78,86 @@ namespace lox {
         const std::unique_ptr<Expr> expression;
 
         explicit Grouping(std::unique_ptr<Expr> expression)
-            : expression(std::move(expression)) {}
+            : Expr(ExprKind::Grouping), expression(std::move(expression)) {}
 
         std::any accept(Visitor& visitor) const override {
             return visitor.visitGroupingExpr(*this);
         }
     };
 
+    // `name = name + step` (ou `- step`) com step literal, reescrito pelo
+    // Parser no incremento de um laço for contado: soma no lugar, sem
+    // avaliar um Binary e um Assign.
+    struct Increment : public Expr {
+        Token name;
+        Token op;      // + ou - da expressão original, para erros
+        const double step;   // já com o sinal de op
+
+        Increment(Token name, Token op, double step)
+            : Expr(ExprKind::Increment), name(std::move(name)), op(std::move(op)), step(step) {}
+
+        std::any accept(Visitor& visitor) const override {
+            return visitor.visitIncrementExpr(*this);
+        }
+    };
+
+    struct Index : public Expr {
+        const std::unique_ptr<Expr> object;
+        Token bracket;
+        const std::unique_ptr<Expr> index;
+
+        Index(std::unique_ptr<Expr> object, Token bracket, std::unique_ptr<Expr> index)
+            : Expr(ExprKind::Index), object(std::move(object)), bracket(std::move(bracket)), index(std::move(index)) {}
+
+        std::any accept(Visitor& visitor) const override {
+            return visitor.visitIndexExpr(*this);
+        }
+    };
+
+    // Atribuição a um elemento: target[index] = value.
+    struct IndexSet : public Expr {
+        const std::unique_ptr<Index> target;
+        const std::unique_ptr<Expr> value;
+
+        IndexSet(std::unique_ptr<Index> target, std::unique_ptr<Expr> value)
+            : Expr(ExprKind::IndexSet), target(std::move(target)), value(std::move(value)) {}
+
+        std::any accept(Visitor& visitor) const override {
+            return visitor.visitIndexSetExpr(*this);
+        }
+    };
+
     struct Literal : public Expr {
         const Value value;
 
-        explicit Literal(Value value) : value(std::move(value)) {}
+        explicit Literal(Value value) : Expr(ExprKind::Literal), value(std::move(value)) {}
 
         std::any accept(Visitor& visitor) const override {
             return visitor.visitLiteralExpr(*this);
         }
     };
 
+    // and/or: o lado direito só é avaliado se o esquerdo não decidir o
+    // resultado, que é o valor de um dos dois lados (não um bool).
+    struct Logical : public Expr {
+        const std::unique_ptr<Expr> left;
+        Token op;
+        const std::unique_ptr<Expr> right;
+
+        Logical(std::unique_ptr<Expr> left, Token op, std::unique_ptr<Expr> right)
+            : Expr(ExprKind::Logical), left(std::move(left)), op(std::move(op)), right(std::move(right)) {}
+
+        std::any accept(Visitor& visitor) const override {
+            return visitor.visitLogicalExpr(*this);
+        }
+    };
+
     struct Unary : public Expr {
-        const Token op;
+        Token op;
         const std::unique_ptr<Expr> right;
 
         Unary(Token op, std::unique_ptr<Expr> right)
-            : op(std::move(op)), right(std::move(right)) {}
+            : Expr(ExprKind::Unary), op(std::move(op)), right(std::move(right)) {}
 
         std::any accept(Visitor& visitor) const override {
             return visitor.visitUnaryExpr(*this);
@@ -88,9 +165,10 @@ namespace lox {
     };
 
     struct Variable : public Expr {
-        const Token name;
+        Token name;
+        mutable GlobalCache cache;   // preenchido pelo Interpreter
 
-        explicit Variable(Token name) : name(std::move(name)) {}
+        explicit Variable(Token name) : Expr(ExprKind::Variable), name(std::move(name)) {}
 
         std::any accept(Visitor& visitor) const override {
             return visitor.visitVariableExpr(*this);
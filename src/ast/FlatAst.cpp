@@ -0,0 +1,337 @@
+#include "FlatAst.hpp"
+#include "Expr.hpp"
+
+#include <type_traits>
+
+namespace lox {
+
+    class FlatAstBuilder {
+    public:
+        explicit FlatAstBuilder(FlatAst& ast) : m_ast(ast) {}
+
+        NodeIndex stmt(const Stmt& stmt) {
+            NodeIndex index = node(flatTag(stmt.kind), stmt.line);
+            switch (stmt.kind) {
+                case StmtKind::Block:
+                    list(index, static_cast<const BlockStmt&>(stmt).statements);
+                    break;
+                case StmtKind::Expression:
+                    m_ast.nodes[index].a = expr(*static_cast<const ExpressionStmt&>(stmt).expression);
+                    break;
+                case StmtKind::For: {
+                    const auto& loop = static_cast<const ForStmt&>(stmt);
+                    NodeIndex initializer = loop.initializer ? this->stmt(*loop.initializer) : kNoNode;
+                    NodeIndex condition = optional(loop.condition.get());
+                    NodeIndex increment = optional(loop.increment.get());
+                    NodeIndex body = this->stmt(*loop.body);
+                    FlatNode& node = m_ast.nodes[index];
+                    node.counted = loop.counted;
+                    node.data = body;
+                    node.a = initializer;
+                    node.b = condition;
+                    node.c = increment;
+                    break;
+                }
+                case StmtKind::If: {
+                    const auto& branch = static_cast<const IfStmt&>(stmt);
+                    NodeIndex condition = expr(*branch.condition);
+                    NodeIndex thenBranch = this->stmt(*branch.thenBranch);
+                    NodeIndex elseBranch = branch.elseBranch ? this->stmt(*branch.elseBranch) : kNoNode;
+                    set(index, condition, thenBranch, elseBranch);
+                    break;
+                }
+                case StmtKind::Print:
+                    m_ast.nodes[index].a = expr(*static_cast<const PrintStmt&>(stmt).expression);
+                    break;
+                case StmtKind::Var: {
+                    const auto& var = static_cast<const VarStmt&>(stmt);
+                    std::uint32_t name = token(var.name);
+                    NodeIndex initializer = optional(var.initializer.get());
+                    m_ast.nodes[index].data = name;
+                    m_ast.nodes[index].a = initializer;
+                    break;
+                }
+                case StmtKind::While: {
+                    const auto& loop = static_cast<const WhileStmt&>(stmt);
+                    NodeIndex condition = expr(*loop.condition);
+                    NodeIndex body = this->stmt(*loop.body);
+                    set(index, condition, body);
+                    break;
+                }
+            }
+            return index;
+        }
+
+        NodeIndex expr(const Expr& expr) {
+            NodeIndex index = node(flatTag(expr.kind), 0);
+            switch (expr.kind) {
+                case ExprKind::ArrayLiteral: {
+                    const auto& array = static_cast<const ArrayLiteral&>(expr);
+                    withToken(index, array.bracket);
+                    list(index, array.elements);
+                    break;
+                }
+                case ExprKind::Assign: {
+                    const auto& assign = static_cast<const Assign&>(expr);
+                    withToken(index, assign.name);
+                    NodeIndex value = this->expr(*assign.value);
+                    m_ast.nodes[index].a = value;
+                    m_ast.nodes[index].b = cache();
+                    break;
+                }
+                case ExprKind::Binary: {
+                    const auto& binary = static_cast<const Binary&>(expr);
+                    withToken(index, binary.op);
+                    NodeIndex left = this->expr(*binary.left);
+                    NodeIndex right = this->expr(*binary.right);
+                    set(index, left, right);
+                    break;
+                }
+                case ExprKind::Call: {
+                    const auto& call = static_cast<const Call&>(expr);
+                    withToken(index, call.paren);
+                    NodeIndex callee = this->expr(*call.callee);
+                    m_ast.nodes[index].a = callee;
+                    std::vector<NodeIndex> arguments;
+                    arguments.reserve(call.arguments.size());
+                    for (const auto& argument : call.arguments) arguments.push_back(this->expr(*argument));
+                    m_ast.nodes[index].b = static_cast<std::uint32_t>(m_ast.lists.size());
+                    m_ast.nodes[index].c = static_cast<std::uint32_t>(arguments.size());
+                    m_ast.lists.insert(m_ast.lists.end(), arguments.begin(), arguments.end());
+                    break;
+                }
+                case ExprKind::Grouping:
+                    m_ast.nodes[index].a = this->expr(*static_cast<const Grouping&>(expr).expression);
+                    break;
+                case ExprKind::Increment: {
+                    const auto& increment = static_cast<const Increment&>(expr);
+                    withToken(index, increment.name);
+                    std::uint32_t op = token(increment.op);
+                    m_ast.nodes[index].a = op;
+                    m_ast.nodes[index].b = constant(Value{increment.step});
+                    break;
+                }
+                case ExprKind::Index:
+                    index = this->index(static_cast<const Index&>(expr), index);
+                    break;
+                case ExprKind::IndexSet: {
+                    const auto& set = static_cast<const IndexSet&>(expr);
+                    NodeIndex target = this->index(*set.target, node(FlatTag::Index, 0));
+                    NodeIndex value = this->expr(*set.value);
+                    this->set(index, target, value);
+                    break;
+                }
+                case ExprKind::Literal:
+                    m_ast.nodes[index].data = constant(static_cast<const Literal&>(expr).value);
+                    break;
+                case ExprKind::Logical: {
+                    const auto& logical = static_cast<const Logical&>(expr);
+                    withToken(index, logical.op);
+                    NodeIndex left = this->expr(*logical.left);
+                    NodeIndex right = this->expr(*logical.right);
+                    set(index, left, right);
+                    break;
+                }
+                case ExprKind::Unary: {
+                    const auto& unary = static_cast<const Unary&>(expr);
+                    withToken(index, unary.op);
+                    m_ast.nodes[index].a = this->expr(*unary.right);
+                    break;
+                }
+                case ExprKind::Variable:
+                    withToken(index, static_cast<const Variable&>(expr).name);
+                    m_ast.nodes[index].b = cache();
+                    break;
+            }
+            return index;
+        }
+
+    private:
+        FlatAst& m_ast;
+
+        // Reserva o nó antes dos filhos, para que fiquem em pré-ordem. Os
+        // filhos são gravados com m_ast.nodes[index]: o vetor pode ter
+        // crescido enquanto eles eram convertidos.
+        NodeIndex node(FlatTag tag, int line) {
+            m_ast.nodes.push_back(FlatNode{tag, TokenType::END_OF_FILE, false, line, 0, kNoNode, kNoNode, kNoNode});
+            return static_cast<NodeIndex>(m_ast.nodes.size() - 1);
+        }
+
+        NodeIndex optional(const Expr* expr) {
+            return expr ? this->expr(*expr) : kNoNode;
+        }
+
+        NodeIndex index(const Index& index, NodeIndex at) {
+            withToken(at, index.bracket);
+            NodeIndex object = expr(*index.object);
+            NodeIndex key = expr(*index.index);
+            set(at, object, key);
+            return at;
+        }
+
+        void set(NodeIndex index, NodeIndex a, NodeIndex b, NodeIndex c = kNoNode) {
+            FlatNode& node = m_ast.nodes[index];
+            node.a = a;
+            node.b = b;
+            node.c = c;
+        }
+
+        std::uint32_t token(const Token& token) {
+            m_ast.tokens.push_back(token);
+            return static_cast<std::uint32_t>(m_ast.tokens.size() - 1);
+        }
+
+        void withToken(NodeIndex index, const Token& token) {
+            std::uint32_t data = this->token(token);
+            FlatNode& node = m_ast.nodes[index];
+            node.data = data;
+            node.op = token.type;
+            node.line = token.line;
+        }
+
+        std::uint32_t cache() {
+            m_ast.globalCaches.emplace_back();
+            return static_cast<std::uint32_t>(m_ast.globalCaches.size() - 1);
+        }
+
+        std::uint32_t constant(const Value& value) {
+            m_ast.constants.push_back(value);
+            return static_cast<std::uint32_t>(m_ast.constants.size() - 1);
+        }
+
+        // Os filhos de uma lista não ficam seguidos em nodes (cada um vem
+        // com a própria subárvore), então os índices vão para lists.
+        template<typename Node>
+        void list(NodeIndex index, const std::vector<std::unique_ptr<Node>>& children) {
+            std::vector<NodeIndex> converted;
+            converted.reserve(children.size());
+            for (const auto& child : children) {
+                if constexpr (std::is_same_v<Node, Stmt>) {
+                    converted.push_back(stmt(*child));
+                } else {
+                    converted.push_back(expr(*child));
+                }
+            }
+            FlatNode& node = m_ast.nodes[index];
+            node.a = static_cast<std::uint32_t>(m_ast.lists.size());
+            node.b = static_cast<std::uint32_t>(converted.size());
+            m_ast.lists.insert(m_ast.lists.end(), converted.begin(), converted.end());
+        }
+    };
+
+    FlatAst flattenAst(const std::vector<std::unique_ptr<Stmt>>& statements) {
+        FlatAst ast;
+        FlatAstBuilder builder(ast);
+        ast.statements.reserve(statements.size());
+        for (const auto& stmt : statements) {
+            if (stmt) ast.statements.push_back(builder.stmt(*stmt));
+        }
+        return ast;
+    }
+
+    class FlatAstExpander {
+    public:
+        explicit FlatAstExpander(const FlatAst& ast) : m_ast(ast) {}
+
+        std::unique_ptr<Stmt> stmt(NodeIndex index) {
+            const FlatNode& node = m_ast.nodes[index];
+            std::unique_ptr<Stmt> stmt;
+            switch (stmtKind(node.tag)) {
+                case StmtKind::Block:
+                    stmt = std::make_unique<BlockStmt>(list<Stmt>(node.a, node.b));
+                    break;
+                case StmtKind::Expression:
+                    stmt = std::make_unique<ExpressionStmt>(expr(node.a));
+                    break;
+                case StmtKind::For:
+                    stmt = std::make_unique<ForStmt>(optionalStmt(node.a), optionalExpr(node.b), optionalExpr(node.c),
+                                                     this->stmt(node.data), node.counted);
+                    break;
+                case StmtKind::If:
+                    stmt = std::make_unique<IfStmt>(expr(node.a), this->stmt(node.b), optionalStmt(node.c));
+                    break;
+                case StmtKind::Print:
+                    stmt = std::make_unique<PrintStmt>(expr(node.a));
+                    break;
+                case StmtKind::Var:
+                    stmt = std::make_unique<VarStmt>(m_ast.tokens[node.data], optionalExpr(node.a));
+                    break;
+                case StmtKind::While:
+                    stmt = std::make_unique<WhileStmt>(expr(node.a), this->stmt(node.b));
+                    break;
+            }
+            stmt->line = node.line;
+            return stmt;
+        }
+
+        std::unique_ptr<Expr> expr(NodeIndex index) {
+            const FlatNode& node = m_ast.nodes[index];
+            switch (exprKind(node.tag)) {
+                case ExprKind::ArrayLiteral:
+                    return std::make_unique<ArrayLiteral>(m_ast.tokens[node.data], list<Expr>(node.a, node.b));
+                case ExprKind::Assign:
+                    return std::make_unique<Assign>(m_ast.tokens[node.data], expr(node.a));
+                case ExprKind::Binary:
+                    return std::make_unique<Binary>(expr(node.a), m_ast.tokens[node.data], expr(node.b));
+                case ExprKind::Call:
+                    return std::make_unique<Call>(expr(node.a), m_ast.tokens[node.data], list<Expr>(node.b, node.c));
+                case ExprKind::Grouping:
+                    return std::make_unique<Grouping>(expr(node.a));
+                case ExprKind::Increment:
+                    return std::make_unique<Increment>(m_ast.tokens[node.data], m_ast.tokens[node.a],
+                                                       std::get<double>(m_ast.constants[node.b]));
+                case ExprKind::Index:
+                    return this->index(node);
+                case ExprKind::IndexSet:
+                    return std::make_unique<IndexSet>(this->index(m_ast.nodes[node.a]), expr(node.b));
+                case ExprKind::Literal:
+                    return std::make_unique<Literal>(m_ast.constants[node.data]);
+                case ExprKind::Logical:
+                    return std::make_unique<Logical>(expr(node.a), m_ast.tokens[node.data], expr(node.b));
+                case ExprKind::Unary:
+                    return std::make_unique<Unary>(m_ast.tokens[node.data], expr(node.a));
+                case ExprKind::Variable:
+                    return std::make_unique<Variable>(m_ast.tokens[node.data]);
+            }
+            return nullptr;
+        }
+
+    private:
+        const FlatAst& m_ast;
+
+        std::unique_ptr<Index> index(const FlatNode& node) {
+            return std::make_unique<Index>(expr(node.a), m_ast.tokens[node.data], expr(node.b));
+        }
+
+        std::unique_ptr<Stmt> optionalStmt(NodeIndex index) {
+            return index == kNoNode ? nullptr : stmt(index);
+        }
+
+        std::unique_ptr<Expr> optionalExpr(NodeIndex index) {
+            return index == kNoNode ? nullptr : expr(index);
+        }
+
+        template<typename Node>
+        std::vector<std::unique_ptr<Node>> list(std::uint32_t start, std::uint32_t count) {
+            std::vector<std::unique_ptr<Node>> nodes;
+            nodes.reserve(count);
+            for (const NodeIndex* child = m_ast.list(start); child != m_ast.list(start + count); ++child) {
+                if constexpr (std::is_same_v<Node, Stmt>) {
+                    nodes.push_back(stmt(*child));
+                } else {
+                    nodes.push_back(expr(*child));
+                }
+            }
+            return nodes;
+        }
+    };
+
+    std::vector<std::unique_ptr<Stmt>> expandFlatAst(const FlatAst& ast) {
+        FlatAstExpander expander(ast);
+        std::vector<std::unique_ptr<Stmt>> statements;
+        statements.reserve(ast.statements.size());
+        for (NodeIndex index : ast.statements) statements.push_back(expander.stmt(index));
+        return statements;
+    }
+
+}
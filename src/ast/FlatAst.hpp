@@ -0,0 +1,93 @@
+#pragma once
+
+#include "Stmt.hpp"
+#include "NodeKind.hpp"
+#include "../Token.hpp"
+#include "../Value.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lox {
+
+    // Representação da AST em arrays: os nós ficam lado a lado em um único
+    // vetor, em pré-ordem (cada nó antes dos filhos), e se referem uns aos
+    // outros por índices de 32 bits. O Interpreter a executa com um switch
+    // na tag (Interpreter::interpret(const FlatAst&)), sem chamada virtual
+    // nem std::any por nó. A árvore de Expr.hpp/Stmt.hpp continua sendo a
+    // forma de trabalho do Parser, do Optimizer e das ferramentas; esta é
+    // só de execução, convertida por flattenAst e desfeita por expandFlatAst.
+
+    using NodeIndex = std::uint32_t;
+    inline constexpr NodeIndex kNoNode = 0xFFFFFFFF;
+
+    // Expressões na ordem de ExprKind, depois statements na ordem de StmtKind.
+    enum class FlatTag : unsigned char {
+        ArrayLiteral, Assign, Binary, Call, Grouping, Increment, Index, IndexSet, Literal, Logical, Unary, Variable,
+        Block, Expression, For, If, Print, Var, While
+    };
+
+    inline FlatTag flatTag(ExprKind kind) { return static_cast<FlatTag>(kind); }
+    inline FlatTag flatTag(StmtKind kind) { return static_cast<FlatTag>(kExprKindCount + static_cast<std::size_t>(kind)); }
+    inline bool isStatement(FlatTag tag) { return static_cast<std::size_t>(tag) >= kExprKindCount; }
+    inline ExprKind exprKind(FlatTag tag) { return static_cast<ExprKind>(tag); }
+    inline StmtKind stmtKind(FlatTag tag) { return static_cast<StmtKind>(static_cast<std::size_t>(tag) - kExprKindCount); }
+
+    // Uso dos campos por tag (token: índice em FlatAst::tokens; constante:
+    // em FlatAst::constants; cache: em FlatAst::globalCaches; lista: início
+    // em FlatAst::lists e quantidade, em dois campos seguidos; filhos
+    // opcionais ausentes são kNoNode):
+    //
+    //   ArrayLiteral  data token [      a, b lista de elementos
+    //   Assign        data token nome   a valor, b cache
+    //   Binary        data token op     a esquerda, b direita
+    //   Call          data token (      a callee, b, c lista de argumentos
+    //   Grouping                        a expressão
+    //   Increment     data token nome   a token op, b constante step
+    //   Index         data token [      a objeto, b índice
+    //   IndexSet                        a alvo (um Index), b valor
+    //   Literal       data constante
+    //   Logical       data token op     a esquerda, b direita
+    //   Unary         data token op     a operando
+    //   Variable      data token nome   b cache
+    //   Block                           a, b lista de statements
+    //   Expression                      a expressão
+    //   For           data corpo        a initializer, b condição, c incremento
+    //   If                              a condição, b then, c else
+    //   Print                           a expressão
+    //   Var           data token nome   a initializer
+    //   While                           a condição, b corpo
+    //
+    // op repete o tipo do token de Binary, Logical e Unary, para o switch
+    // não precisar ler o token. line é a do statement (Stmt::line) ou a do
+    // token da expressão (0 em Literal e Grouping).
+    struct FlatNode {
+        FlatTag tag;
+        TokenType op;
+        bool counted;   // For: ForStmt::counted
+        int line;
+        std::uint32_t data;
+        NodeIndex a;
+        NodeIndex b;
+        NodeIndex c;
+    };
+
+    struct FlatAst {
+        std::vector<FlatNode> nodes;
+        std::vector<NodeIndex> lists;
+        std::vector<Token> tokens;
+        std::vector<Value> constants;
+        std::vector<NodeIndex> statements;   // statements de topo
+        // Caches de globais de Variable e Assign, preenchidos na execução.
+        mutable std::vector<GlobalCache> globalCaches;
+
+        const NodeIndex* list(std::uint32_t start) const { return lists.data() + start; }
+    };
+
+    FlatAst flattenAst(const std::vector<std::unique_ptr<Stmt>>& statements);
+
+    // Reconstrói a árvore (para o ASTPrinter, o Optimizer e os testes).
+    std::vector<std::unique_ptr<Stmt>> expandFlatAst(const FlatAst& ast);
+
+}
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+
+namespace lox {
+
+    // Identificam o tipo concreto de um nó sem precisar de dynamic_cast.
+    enum class ExprKind : unsigned char {
+        ArrayLiteral, Assign, Binary, Call, Grouping, Increment, Index, IndexSet, Literal, Logical, Unary, Variable
+    };
+
+    enum class StmtKind : unsigned char {
+        Block, Expression, For, If, Print, Var, While
+    };
+
+    constexpr std::size_t kExprKindCount = 12;
+    constexpr std::size_t kStmtKindCount = 7;
+
+    inline const char* exprKindName(ExprKind kind) {
+        switch (kind) {
+            case ExprKind::ArrayLiteral: return "array";
+            case ExprKind::Assign: return "assign";
+            case ExprKind::Binary: return "binary";
+            case ExprKind::Call: return "call";
+            case ExprKind::Grouping: return "grouping";
+            case ExprKind::Increment: return "increment";
+            case ExprKind::Index: return "index";
+            case ExprKind::IndexSet: return "index_set";
+            case ExprKind::Literal: return "literal";
+            case ExprKind::Logical: return "logical";
+            case ExprKind::Unary: return "unary";
+            case ExprKind::Variable: return "variable";
+        }
+        return "expr";
+    }
+
+    inline const char* stmtKindName(StmtKind kind) {
+        switch (kind) {
+            case StmtKind::Block: return "block";
+            case StmtKind::Expression: return "expr";
+            case StmtKind::For: return "for";
+            case StmtKind::If: return "if";
+            case StmtKind::Print: return "print";
+            case StmtKind::Var: return "var";
+            case StmtKind::While: return "while";
+        }
+        return "stmt";
+    }
+
+}
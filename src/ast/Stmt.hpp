@@ -2,6 +2,7 @@
 
 #include "ast/Visitor.hpp"
 #include "ast/Expr.hpp"
+#include "ast/NodeKind.hpp"
 #include <vector>
 #include <memory>
 #include <any> 
@@ -12,9 +13,15 @@ namespace lox {
 // Classe base para todos os Statements (comandos).
 struct Stmt {
 public:
+    const StmtKind kind;
+
+    explicit Stmt(StmtKind kind) : kind(kind) {}
     virtual ~Stmt() = default;
     // Assinatura corrigida para usar std::any e Visitor não-template.
     virtual std::any accept(Visitor& visitor) const = 0;
+
+    // Linha do primeiro token do statement (preenchida pelo Parser).
+    int line = 0;
 };
 
 // --- Classes Concretas de Statement ---
@@ -23,7 +30,7 @@ struct ExpressionStmt : public Stmt {
     const std::unique_ptr<Expr> expression;
 
     explicit ExpressionStmt(std::unique_ptr<Expr> expression)
-        : expression(std::move(expression)) {}
+        : Stmt(StmtKind::Expression), expression(std::move(expression)) {}
 
     std::any accept(Visitor& visitor) const override {
         return visitor.visitExpressionStmt(*this);
@@ -34,7 +41,7 @@ struct PrintStmt : public Stmt {
     const std::unique_ptr<Expr> expression;
 
     explicit PrintStmt(std::unique_ptr<Expr> expression)
-        : expression(std::move(expression)) {}
+        : Stmt(StmtKind::Print), expression(std::move(expression)) {}
 
     std::any accept(Visitor& visitor) const override {
         return visitor.visitPrintStmt(*this);
@@ -45,7 +52,7 @@ struct BlockStmt : public Stmt {
     const std::vector<std::unique_ptr<Stmt>> statements;
 
     explicit BlockStmt(std::vector<std::unique_ptr<Stmt>> statements)
-        : statements(std::move(statements)) {}
+        : Stmt(StmtKind::Block), statements(std::move(statements)) {}
 
     std::any accept(Visitor& visitor) const override {
         return visitor.visitBlockStmt(*this);
@@ -53,24 +60,47 @@ struct BlockStmt : public Stmt {
 };
 
 struct VarStmt : public Stmt {
-    const Token name;
+    Token name;
     const std::unique_ptr<Expr> initializer;
 
     VarStmt(Token name, std::unique_ptr<Expr> initializer)
-        : name(std::move(name)), initializer(std::move(initializer)) {}
+        : Stmt(StmtKind::Var), name(std::move(name)), initializer(std::move(initializer)) {}
 
     std::any accept(Visitor& visitor) const override {
         return visitor.visitVarStmt(*this);
     }
 };
 
+// for (initializer; condition; increment) body. As três partes são
+// opcionais (nullptr). O initializer fica em um escopo próprio do laço.
+struct ForStmt : public Stmt {
+    const std::unique_ptr<Stmt> initializer;
+    const std::unique_ptr<Expr> condition;
+    const std::unique_ptr<Expr> increment;
+    const std::unique_ptr<Stmt> body;
+    // Laço contado, reconhecido pelo Parser: `var i = a; i < n; i = i + k`
+    // (também <=, >, >= e -k) e nenhuma atribuição a i no corpo ou em n.
+    // Nesse caso condition é um Binary com Variable i à esquerda e
+    // increment é um Increment, e o Interpreter mantém i em um double.
+    const bool counted;
+
+    ForStmt(std::unique_ptr<Stmt> initializer, std::unique_ptr<Expr> condition, std::unique_ptr<Expr> increment,
+            std::unique_ptr<Stmt> body, bool counted)
+        : Stmt(StmtKind::For), initializer(std::move(initializer)), condition(std::move(condition)),
+          increment(std::move(increment)), body(std::move(body)), counted(counted) {}
+
+    std::any accept(Visitor& visitor) const override {
+        return visitor.visitForStmt(*this);
+    }
+};
+
 struct IfStmt : public Stmt {
     const std::unique_ptr<Expr> condition;
     const std::unique_ptr<Stmt> thenBranch;
     const std::unique_ptr<Stmt> elseBranch;
 
     IfStmt(std::unique_ptr<Expr> condition, std::unique_ptr<Stmt> thenBranch, std::unique_ptr<Stmt> elseBranch)
-        : condition(std::move(condition)), thenBranch(std::move(thenBranch)), elseBranch(std::move(elseBranch)) {}
+        : Stmt(StmtKind::If), condition(std::move(condition)), thenBranch(std::move(thenBranch)), elseBranch(std::move(elseBranch)) {}
 
     std::any accept(Visitor& visitor) const override {
         return visitor.visitIfStmt(*this);
@@ -82,7 +112,7 @@ struct WhileStmt : public Stmt {
     const std::unique_ptr<Stmt> body;
 
     WhileStmt(std::unique_ptr<Expr> condition, std::unique_ptr<Stmt> body)
-        : condition(std::move(condition)), body(std::move(body)) {}
+        : Stmt(StmtKind::While), condition(std::move(condition)), body(std::move(body)) {}
 
     std::any accept(Visitor& visitor) const override {
         return visitor.visitWhileStmt(*this);
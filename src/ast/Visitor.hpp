@@ -5,17 +5,23 @@
 namespace lox {
 
     // Expressões
+    struct ArrayLiteral;
     struct Assign;
     struct Binary;
     struct Call;
     struct Grouping;
+    struct Increment;
+    struct Index;
+    struct IndexSet;
     struct Literal;
+    struct Logical;
     struct Unary;
     struct Variable;
 
     // Statements
     struct BlockStmt;
     struct ExpressionStmt;
+    struct ForStmt;
     struct IfStmt;
     struct PrintStmt;
     struct VarStmt;
@@ -27,17 +33,23 @@ namespace lox {
         virtual ~Visitor() = default;
 
         // Métodos para visitar expressões retornam std::any.
+        virtual std::any visitArrayLiteralExpr(const ArrayLiteral& expr) = 0;
         virtual std::any visitAssignExpr(const Assign& expr) = 0;
         virtual std::any visitBinaryExpr(const Binary& expr) = 0;
         virtual std::any visitCallExpr(const Call& expr) = 0;
         virtual std::any visitGroupingExpr(const Grouping& expr) = 0;
+        virtual std::any visitIncrementExpr(const Increment& expr) = 0;
+        virtual std::any visitIndexExpr(const Index& expr) = 0;
+        virtual std::any visitIndexSetExpr(const IndexSet& expr) = 0;
         virtual std::any visitLiteralExpr(const Literal& expr) = 0;
+        virtual std::any visitLogicalExpr(const Logical& expr) = 0;
         virtual std::any visitUnaryExpr(const Unary& expr) = 0;
         virtual std::any visitVariableExpr(const Variable& expr) = 0;
 
         // Métodos para visitar statements retornam std::any.
         virtual std::any visitBlockStmt(const BlockStmt& stmt) = 0;
         virtual std::any visitExpressionStmt(const ExpressionStmt& stmt) = 0;
+        virtual std::any visitForStmt(const ForStmt& stmt) = 0;
         virtual std::any visitIfStmt(const IfStmt& stmt) = 0;
         virtual std::any visitPrintStmt(const PrintStmt& stmt) = 0;
         virtual std::any visitVarStmt(const VarStmt& stmt) = 0;
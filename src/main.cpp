@@ -1,45 +1,215 @@
 #include "Scanner.hpp"
 #include "ast/ASTPrinter.hpp"
+#include "ast/ASTSerializer.hpp"
+#include "ast/FlatAst.hpp"
 #include "Parser.hpp"
 #include "Interpreter.hpp"
+#include "Optimizer.hpp"
+#include "CppEmitter.hpp"
+#include "LineProfiler.hpp"
+#include "SamplingProfiler.hpp"
+#include "Stats.hpp"
+#include "ScriptServer.hpp"
+#include "IncrementalParser.hpp"
 
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <sstream>
+#include <thread>
 
 using namespace lox;
 
-static Interpreter interpreter;
+// Opções de linha de comando compartilhadas pelos modos de execução.
+struct Options {
+    bool printAst = false;
+    bool gcStats = false;
+    GcConfig gc;
+    bool profile = false;
+    std::string profileJson = "lox-profile.json";
+    bool sample = false;
+    int sampleHz = 997;
+    std::string sampleOut = "lox-samples.folded";
+    bool stats = false;
+    bool statsJson = false;
+    std::string serveSocket;
+    bool specialize = true;
+    JitOptions jit;
+    ExecutionLimits limits;
+    int optimizationLevel = 0;
+    bool emitCpp = false;
+    std::string emitCppOut;   // vazio: stdout
+    bool watch = false;
+    std::string dumpAst;      // "json" ou "binary"; vazio: executa
+    bool flatAst = false;     // executa a AST em arrays (ast/FlatAst.hpp)
+};
+
 static bool hadError = false;
+static bool hadRuntimeError = false;
+static PhaseTimes phaseTimes;
+
+static double elapsedMs(std::chrono::steady_clock::time_point start, std::chrono::steady_clock::time_point end) {
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+// Gera o C++ do programa em vez de executá-lo (--emit-cpp).
+static void emitCpp(const std::vector<std::unique_ptr<Stmt>>& statements, const Options& options) {
+    std::string code;
+    try {
+        code = CppEmitter().emit(statements);
+    } catch (const CppEmitError& error) {
+        std::cerr << "[line " << error.line << "] Error: " << error.what() << std::endl;
+        hadError = true;
+        return;
+    }
+    if (options.emitCppOut.empty()) {
+        std::cout << code;
+        return;
+    }
+    std::ofstream out(options.emitCppOut);
+    if (!out) {
+        std::cerr << "Could not write C++ output: " << options.emitCppOut << std::endl;
+        exit(74);
+    }
+    out << code;
+}
 
-void run(const std::string& source, bool printAst) {
+// wholeProgram: o código não continua em outra chamada (arquivo, não REPL).
+void run(Interpreter& interpreter, const std::string& source, const Options& options, bool wholeProgram) {
     hadError = false;
+    hadRuntimeError = false;
+    auto scanStart = std::chrono::steady_clock::now();
 
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
+    auto parseStart = std::chrono::steady_clock::now();
 
     Parser parser(tokens);
     auto statements = parser.parse();
+    hadError = parser.hadError();
+    phaseTimes.scanMs += elapsedMs(scanStart, parseStart);
+    phaseTimes.parseMs += elapsedMs(parseStart, std::chrono::steady_clock::now());
 
     if (hadError) return;
 
-    if (printAst) {
+    Optimizer optimizer(OptimizerOptions{wholeProgram});
+    if (options.optimizationLevel >= 2) {
+        statements = optimizer.optimize(statements);
+    }
+
+    if (options.printAst) {
         std::cout << "--- AST ---\n";
         ASTPrinter printer;
         for (const auto& stmt : statements) {
             if (stmt) {
-                std::cout << printer.print(*stmt) << std::endl;
+                printer.print(*stmt, std::cout);
+                std::cout << '\n';
+            }
+        }
+        if (options.optimizationLevel >= 2) {
+            std::cout << "\n--- Optimizations (-O2) ---\n";
+            for (const OptimizationNote& note : optimizer.notes()) {
+                std::cout << "[line " << note.line << "] " << note.message << "\n";
             }
         }
-        std::cout << "\n--- Output ---\n";
+        if (!options.emitCpp && options.dumpAst.empty()) std::cout << "\n--- Output ---\n";
     }
 
-    interpreter.interpret(statements);
+    if (options.emitCpp) {
+        emitCpp(statements, options);
+        return;
+    }
+
+    if (options.dumpAst == "json") {
+        writeAstJson(std::cout, statements);
+        return;
+    }
+    if (options.dumpAst == "binary") {
+        writeAstBinary(std::cout, statements);
+        return;
+    }
+
+    if (options.flatAst) {
+        FlatAst program = flattenAst(statements);
+        auto interpretStart = std::chrono::steady_clock::now();
+        hadRuntimeError = !interpreter.interpret(program);
+        phaseTimes.interpretMs += elapsedMs(interpretStart, std::chrono::steady_clock::now());
+        return;
+    }
+
+    auto interpretStart = std::chrono::steady_clock::now();
+    hadRuntimeError = !interpreter.interpret(statements);
+    phaseTimes.interpretMs += elapsedMs(interpretStart, std::chrono::steady_clock::now());
+}
+
+void printStats(const Interpreter& interpreter, const Options& options) {
+    if (options.statsJson) {
+        writeStatsJson(std::cerr, runtimeStats(), phaseTimes, interpreter.memoryUsage());
+    } else {
+        writeStatsText(std::cerr, runtimeStats(), phaseTimes, interpreter.memoryUsage());
+    }
+}
+
+void printGcStats(const Interpreter& interpreter) {
+    const GcStats& stats = interpreter.heap().stats();
+    std::fprintf(stderr,
+        "[gc] %zu collections, %zu objects freed (%zu bytes), pause total %.3f ms, max %.3f ms, live %zu objects (%zu bytes)\n",
+        stats.collections, stats.objectsFreed, stats.bytesFreed,
+        stats.totalPauseMs, stats.maxPauseMs,
+        interpreter.heap().objectCount(), interpreter.heap().bytesAllocated());
 }
 
-void runFile(const std::string& path, bool printAst) {
+// Imprime o relatório do profiler em stderr e grava a versão JSON.
+void reportProfile(const LineProfiler& profiler, const std::string& source, const Options& options) {
+    profiler.report(std::cerr, source);
+    std::ofstream json(options.profileJson);
+    if (!json) {
+        std::cerr << "Could not write profile: " << options.profileJson << std::endl;
+        return;
+    }
+    profiler.writeJson(json);
+    std::cerr << "Profile written to " << options.profileJson << std::endl;
+}
+
+// Liga o profiler por amostragem durante o tempo de vida do objeto e grava
+// as pilhas agregadas no formato folded ao final.
+class SamplingSession {
+public:
+    SamplingSession(Interpreter& interpreter, const Options& options)
+        : m_interpreter(interpreter), m_options(options), m_profiler(options.sampleHz) {
+        if (!m_options.sample) return;
+        if (!m_profiler.start()) {
+            std::cerr << "Could not start sampling profiler." << std::endl;
+            return;
+        }
+        m_interpreter.setSampler(&m_profiler);
+    }
+
+    ~SamplingSession() {
+        if (!m_options.sample) return;
+        m_profiler.stop();
+        m_interpreter.setSampler(nullptr);
+        std::ofstream out(m_options.sampleOut);
+        if (!out) {
+            std::cerr << "Could not write samples: " << m_options.sampleOut << std::endl;
+            return;
+        }
+        m_profiler.writeFolded(out);
+        std::cerr << m_profiler.sampleCount() << " samples written to " << m_options.sampleOut << std::endl;
+    }
+
+private:
+    Interpreter& m_interpreter;
+    const Options& m_options;
+    SamplingProfiler m_profiler;
+};
+
+void runFile(Interpreter& interpreter, const std::string& path, const Options& options) {
     std::ifstream file(path);
     if (!file) {
         std::cerr << "Could not open file: " << path << std::endl;
@@ -47,12 +217,27 @@ void runFile(const std::string& path, bool printAst) {
     }
     std::stringstream buffer;
     buffer << file.rdbuf();
-    run(buffer.str(), printAst);
+
+    LineProfiler profiler;
+    if (options.profile) interpreter.setProfiler(&profiler);
+    {
+        SamplingSession sampling(interpreter, options);
+        run(interpreter, buffer.str(), options, true);
+    }
+    interpreter.setProfiler(nullptr);
+
+    if (options.profile) reportProfile(profiler, buffer.str(), options);
+    if (options.gcStats) printGcStats(interpreter);
+    if (options.stats) printStats(interpreter, options);
     if (hadError) exit(65);
+    if (hadRuntimeError) exit(70);
 }
 
-void runPrompt(bool printAst) {
+void runPrompt(Interpreter& interpreter, const Options& options) {
     std::string line;
+    LineProfiler profiler;
+    if (options.profile) interpreter.setProfiler(&profiler);
+    SamplingSession sampling(interpreter, options);
     std::cout << "Lox C++ Interpreter\n";
     for (;;) {
         std::cout << "> ";
@@ -60,32 +245,201 @@ void runPrompt(bool printAst) {
             std::cout << "\n";
             break;
         }
-        run(line, printAst);
+        run(interpreter, line, options, false);
+    }
+    interpreter.setProfiler(nullptr);
+    if (options.profile) reportProfile(profiler, "", options);
+    if (options.gcStats) printGcStats(interpreter);
+    if (options.stats) printStats(interpreter, options);
+}
+
+// Modo --watch: executa o script de novo a cada mudança no arquivo. Só as
+// declarações de topo alteradas passam outra vez pelo Scanner e Parser; o
+// resto vem do IncrementalParser. Cada execução usa um Interpreter novo.
+void watchFile(const std::string& path, const Options& options) {
+    namespace fs = std::filesystem;
+    constexpr auto kPollInterval = std::chrono::milliseconds(100);
+
+    IncrementalParser parser;
+    fs::file_time_type lastWrite;
+    bool loaded = false;
+    for (;; std::this_thread::sleep_for(kPollInterval)) {
+        std::error_code error;
+        fs::file_time_type write = fs::last_write_time(path, error);
+        if (error || (loaded && write == lastWrite)) continue;
+
+        std::ifstream file(path);
+        if (!file) continue;   // editores que salvam trocando o arquivo
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        lastWrite = write;
+        loaded = true;
+
+        ReparseStats stats = parser.update(buffer.str());
+        std::fprintf(stderr, "[watch] parse %.3f ms: %zu declarations, %zu re-parsed, %zu from cache\n",
+                     stats.milliseconds, stats.declarations, stats.reparsed, stats.fromCache);
+        std::cerr << parser.diagnostics();
+        if (parser.hadError()) continue;
+
+        Interpreter interpreter(options.gc);
+        interpreter.setSpecialization(options.specialize);
+        interpreter.setJit(options.jit);
+        interpreter.setLimits(options.limits);
+        std::vector<std::unique_ptr<Stmt>> optimized;
+        if (options.optimizationLevel >= 2) {
+            optimized = Optimizer(OptimizerOptions{true}).optimize(parser.statements());
+        }
+        const auto& program = options.optimizationLevel >= 2 ? optimized : parser.statements();
+        if (options.flatAst) {
+            interpreter.interpret(flattenAst(program));
+        } else {
+            interpreter.interpret(program);
+        }
+        std::cout << std::flush;
+    }
+}
+
+// Modo daemon: atende scripts pelo socket até receber SIGINT/SIGTERM.
+int serve(const Options& options) {
+    ServeOptions serveOptions;
+    serveOptions.gc = options.gc;
+    serveOptions.limits = options.limits;
+    serveOptions.optimizationLevel = options.optimizationLevel;
+    serveOptions.specialize = options.specialize;
+    serveOptions.jit = options.jit;
+    serveOptions.flatAst = options.flatAst;
+    ScriptServer server(options.serveSocket, serveOptions);
+    try {
+        server.listen();
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 74;
     }
+    std::cerr << "Serving on " << options.serveSocket << std::endl;
+    server.serve();
+
+    const ServerStats& stats = server.stats();
+    std::fprintf(stderr, "[serve] %zu requests, %zu cache hits, %zu cache misses\n",
+                 stats.requests, stats.cacheHits, stats.cacheMisses);
+    return 0;
+}
+
+// Lê o valor de uma opção no formato --nome=valor.
+static bool optionValue(const std::string& arg, const std::string& name, std::string& value) {
+    if (arg.rfind(name + "=", 0) != 0) return false;
+    value = arg.substr(name.size() + 1);
+    return true;
+}
+
+static int usage() {
+    std::cout << "Usage: cpplox [--print-ast] [--gc-stats] [--gc-threshold=<bytes>] [--gc-growth=<factor>] [--profile] [--profile-json=<file>] [--sample] [--sample-hz=<n>] [--sample-out=<file>] [--stats[=json]] [-O0|-O2] [--no-specialize] [--no-jit] [--jit-threshold=<n>] [--perf-map] [--fuel=<n>] [--timeout-ms=<n>] [--mem-limit=<bytes>] [--emit-cpp[=<file>]] [--dump-ast=json|binary] [--flat-ast] [--watch] [--serve <socket>] [script]" << std::endl;
+    return 64;
 }
 
 int main(int argc, char* argv[]) {
-    bool printAst = false;
+    Options options;
     std::string filePath;
 
     for (int i = 1; i < argc; ++i) {
         std::string arg = argv[i];
-        if (arg == "--print-ast") {
-            printAst = true;
-        } else {
-            if (!filePath.empty()) {
-                std::cout << "Usage: cpplox [--print-ast] [script]" << std::endl;
-                return 64;
+        std::string value;
+        try {
+            if (arg == "--print-ast") {
+                options.printAst = true;
+            } else if (arg == "--gc-stats") {
+                options.gcStats = true;
+            } else if (arg == "--profile") {
+                options.profile = true;
+            } else if (optionValue(arg, "--profile-json", value)) {
+                options.profile = true;
+                options.profileJson = value;
+            } else if (arg == "--stats" || arg == "--stats=text") {
+                options.stats = true;
+            } else if (arg == "--stats=json") {
+                options.stats = true;
+                options.statsJson = true;
+            } else if (arg == "--sample") {
+                options.sample = true;
+            } else if (optionValue(arg, "--sample-hz", value)) {
+                options.sample = true;
+                options.sampleHz = std::stoi(value);
+            } else if (optionValue(arg, "--sample-out", value)) {
+                options.sample = true;
+                options.sampleOut = value;
+            } else if (arg == "-O0" || arg == "-O2") {
+                options.optimizationLevel = arg[2] - '0';
+            } else if (arg == "--emit-cpp") {
+                options.emitCpp = true;
+            } else if (optionValue(arg, "--emit-cpp", value)) {
+                options.emitCpp = true;
+                options.emitCppOut = value;
+            } else if (arg == "--no-specialize") {
+                options.specialize = false;
+            } else if (arg == "--no-jit") {
+                options.jit.enabled = false;
+            } else if (optionValue(arg, "--jit-threshold", value)) {
+                options.jit.threshold = std::stoul(value);
+            } else if (arg == "--perf-map") {
+                options.jit.perfMap = true;
+            } else if (optionValue(arg, "--fuel", value)) {
+                options.limits.fuel = std::stoull(value);
+            } else if (optionValue(arg, "--timeout-ms", value)) {
+                options.limits.timeoutMs = std::stoull(value);
+            } else if (optionValue(arg, "--mem-limit", value)) {
+                options.limits.memoryBytes = std::stoull(value);
+            } else if (arg == "--dump-ast=json" || arg == "--dump-ast=binary") {
+                options.dumpAst = arg.substr(std::string("--dump-ast=").size());
+            } else if (arg == "--flat-ast") {
+                options.flatAst = true;
+            } else if (arg == "--watch") {
+                options.watch = true;
+            } else if (arg == "--serve") {
+                if (i + 1 >= argc) return usage();
+                options.serveSocket = argv[++i];
+            } else if (optionValue(arg, "--serve", value)) {
+                options.serveSocket = value;
+            } else if (optionValue(arg, "--gc-threshold", value)) {
+                options.gc.initialThreshold = std::stoul(value);
+            } else if (optionValue(arg, "--gc-growth", value)) {
+                options.gc.growthFactor = std::stod(value);
+            } else {
+                if (!filePath.empty()) return usage();
+                filePath = arg;
             }
-            filePath = arg;
+        } catch (const std::exception&) {
+            return usage();
         }
     }
 
+    // O C++ gerado é de um programa inteiro, não do REPL.
+    if ((options.emitCpp || !options.dumpAst.empty()) && filePath.empty()) return usage();
+    if (options.watch && (filePath.empty() || options.emitCpp || !options.dumpAst.empty() || !options.serveSocket.empty())) return usage();
+
+    // Os scripts do servidor rodam em processos filhos: relatórios e AST
+    // impressa não teriam para onde ir.
+    if (!options.serveSocket.empty() &&
+        (options.printAst || options.gcStats || options.profile || options.sample || options.stats)) return usage();
+
+    if (!options.serveSocket.empty()) {
+        if (!filePath.empty()) return usage();
+        return serve(options);
+    }
+
+    if (options.watch) {
+        watchFile(filePath, options);
+        return 0;
+    }
+
+    Interpreter interpreter(options.gc);
+    interpreter.setSpecialization(options.specialize);
+    interpreter.setJit(options.jit);
+    interpreter.setLimits(options.limits);
+
     if (!filePath.empty()) {
-        runFile(filePath, printAst);
+        runFile(interpreter, filePath, options);
     } else {
-        runPrompt(printAst);
+        runPrompt(interpreter, options);
     }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,184 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "ast/ASTPrinter.hpp"
+#include "ast/ASTSerializer.hpp"
+#include <iostream>
+#include <pthread.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::vector<std::unique_ptr<lox::Stmt>> parseForDump(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    return parser.parse();
+}
+
+static std::string printWithLines(const std::vector<std::unique_ptr<lox::Stmt>>& statements) {
+    lox::ASTPrinter printer;
+    std::ostringstream out;
+    for (const auto& stmt : statements) {
+        out << stmt->line << ' ';
+        printer.print(*stmt, out);
+        out << '\n';
+    }
+    return out.str();
+}
+
+static std::string interpretStatements(const std::vector<std::unique_ptr<lox::Stmt>>& statements) {
+    CapturedOutput output;
+    lox::Interpreter interpreter;
+    interpreter.interpret(statements);
+    return output.str();
+}
+
+static const char* kDumpProgram =
+    "var a = [1, -2.5, 123456.789, \"texto\", nil, true];\n"
+    "var m = map(); m[\"k\"] = len(a);\n"
+    "for (var i = 0; i < 4; i = i + 1) {\n"
+    "  if (i > 1 and !false) print a[i]; else a[0] = a[0] * (i + 1);\n"
+    "}\n"
+    "var j = 3;\n"
+    "while (j > 0 or false) { j = j - 1; }\n"
+    "for (;;) { print \"uma vez\"; a[10] = 1; }\n";
+
+TEST(ASTSerializerTests, TestBinaryRoundTrip) {
+    auto statements = parseForDump(kDumpProgram);
+    std::stringstream binary;
+    lox::writeAstBinary(binary, statements);
+
+    auto loaded = lox::readAstBinary(binary);
+    ASSERT_EQ(loaded.size(), statements.size());
+    EXPECT_EQ(printWithLines(loaded), printWithLines(statements));
+    // A AST carregada executa igual, inclusive a linha do erro.
+    std::string expected = interpretStatements(statements);
+    EXPECT_NE(expected.find("[line 8]"), std::string::npos) << expected;
+    EXPECT_EQ(interpretStatements(loaded), expected);
+}
+
+TEST(ASTSerializerTests, TestBinaryIsCompact) {
+    std::string source;
+    for (int i = 0; i < 1000; ++i) source += "total = total + values[" + std::to_string(i % 10) + "];\n";
+    auto statements = parseForDump(source);
+    std::stringstream binary;
+    lox::writeAstBinary(binary, statements);
+    // Nomes repetidos viram referências e as linhas, diferenças.
+    EXPECT_LT(binary.str().size(), source.size());
+}
+
+TEST(ASTSerializerTests, TestInvalidBinaryIsRejected) {
+    std::stringstream notAst("print 1;");
+    EXPECT_THROW(lox::readAstBinary(notAst), lox::AstFormatError);
+
+    auto statements = parseForDump(kDumpProgram);
+    std::stringstream binary;
+    lox::writeAstBinary(binary, statements);
+    std::string data = binary.str();
+    for (std::size_t size : {data.size() / 2, data.size() - 1}) {
+        std::stringstream truncated(data.substr(0, size));
+        EXPECT_THROW(lox::readAstBinary(truncated), lox::AstFormatError) << size;
+    }
+}
+
+static std::string dumpBinary(const std::string& source) {
+    std::stringstream binary;
+    lox::writeAstBinary(binary, parseForDump(source));
+    return binary.str();
+}
+
+// Arquivo binário de "print -...-1;" com depth Unary aninhados. "print --1;"
+// e "print ---1;" diferem por um Unary repetido; repeti-lo dá arquivos
+// pequenos com qualquer profundidade, sem passar pelo Parser.
+static std::string deeplyNestedBinary(int depth) {
+    std::string two = dumpBinary("print --1;");
+    std::string three = dumpBinary("print ---1;");
+    std::size_t unit = three.size() - two.size();
+    std::size_t split = 0;
+    while (two[split] == three[split]) ++split;
+    EXPECT_EQ(two.substr(split), three.substr(split + unit));
+
+    std::string deep = two.substr(0, split);
+    for (int i = 2; i < depth; ++i) deep.append(three, split, unit);
+    deep += two.substr(split);
+    return deep;
+}
+
+// Resultado de readAstBinary: "" se leu, a mensagem do AstFormatError se não.
+static std::string readError(const std::string& data) {
+    std::stringstream in(data);
+    try {
+        lox::readAstBinary(in);
+        return "";
+    } catch (const lox::AstFormatError& error) {
+        return error.what();
+    }
+}
+
+TEST(ASTSerializerTests, TestDeepNestingIsRejected) {
+    // Sem limite de profundidade, um milhão de Unary estouraria a pilha.
+    EXPECT_EQ(readError(deeplyNestedBinary(1000000)), "Invalid AST file: nesting too deep.");
+
+    // Programas aninhados dentro do limite continuam sendo lidos.
+    std::stringstream nested(dumpBinary("print " + std::string(1000, '-') + "1;"));
+    EXPECT_EQ(lox::readAstBinary(nested).size(), 1u);
+}
+
+TEST(ASTSerializerTests, TestDeepNestingRespectsStackSize) {
+    // Abaixo de kMaxDepth, mas numa thread com 256 KiB de pilha: o limite
+    // em bytes tem de falar antes, como aconteceria com os frames maiores
+    // de um build com ASan.
+    struct Job {
+        std::string data;
+        std::string error;
+    } job{deeplyNestedBinary(4000), ""};
+
+    pthread_attr_t attributes;
+    ASSERT_EQ(pthread_attr_init(&attributes), 0);
+    ASSERT_EQ(pthread_attr_setstacksize(&attributes, 256 * 1024), 0);
+    pthread_t thread;
+    int created = pthread_create(&thread, &attributes, [](void* arg) -> void* {
+        auto* job = static_cast<Job*>(arg);
+        job->error = readError(job->data);
+        return nullptr;
+    }, &job);
+    pthread_attr_destroy(&attributes);
+    ASSERT_EQ(created, 0);
+    pthread_join(thread, nullptr);
+
+    EXPECT_EQ(job.error, "Invalid AST file: nesting too deep.");
+}
+
+TEST(ASTSerializerTests, TestJson) {
+    auto statements = parseForDump("print -x + 1.5;\nvar s = \"a\tb\\\";");
+    std::ostringstream json;
+    lox::writeAstJson(json, statements);
+    EXPECT_EQ(json.str(),
+              "{\"format\":\"lox-ast\",\"version\":1,\"statements\":[\n"
+              "{\"stmt\":\"print\",\"line\":1,\"expression\":{\"expr\":\"binary\",\"line\":1,\"op\":\"+\","
+              "\"left\":{\"expr\":\"unary\",\"line\":1,\"op\":\"-\",\"right\":{\"expr\":\"variable\",\"line\":1,\"name\":\"x\"}},"
+              "\"right\":{\"expr\":\"literal\",\"value\":1.5}}},\n"
+              "{\"stmt\":\"var\",\"line\":2,\"name\":\"s\",\"initializer\":{\"expr\":\"literal\",\"value\":\"a\\u0009b\\\\\"}}\n"
+              "]}\n");
+}
+
+TEST(ASTSerializerTests, TestPrinterStreamsDeepTrees) {
+    // Árvore com profundidade 5000 à esquerda: com strings concatenadas a
+    // cada nível o custo seria quadrático.
+    std::string source = "print 0";
+    for (int i = 0; i < 5000; ++i) source += " + 1";
+    source += ";";
+    auto statements = parseForDump(source);
+    ASSERT_EQ(statements.size(), 1u);
+
+    lox::ASTPrinter printer;
+    std::ostringstream out;
+    printer.print(*statements[0], out);
+    std::string printed = out.str();
+    EXPECT_EQ(printed.size(), std::string("(print )").size() + 1 + 5000 * std::string("(+  1)").size());
+    EXPECT_EQ(printed.substr(0, 12), "(print (+ (+");
+    EXPECT_EQ(printer.print(*statements[0]), printed);
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "ArrayKernels.hpp"
+#include "ast/ASTPrinter.hpp"
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+TEST(ArrayTests, TestParsesLiteralsIndexingAndCalls) {
+    std::string source = "a[i + 1] = f([1, 2], x)[0];";
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    auto statements = parser.parse();
+    ASSERT_EQ(statements.size(), 1u);
+    ASSERT_NE(statements[0], nullptr);
+
+    lox::ASTPrinter printer;
+    EXPECT_EQ(printer.print(*statements[0]),
+              "(; (assign (index a (+ i 1)) = (index (call f (array 1 2) x) 0)))");
+}
+
+TEST(ArrayTests, TestIndexingAndMixedStorage) {
+    std::string source =
+        "var a = [1, 2, 3];"
+        "a[0] = a[1] + a[2];"
+        "print a;"
+        "a[1] = \"dois\";"
+        "push(a, nil);"
+        "print a;"
+        "print len(a);";
+    EXPECT_EQ(runSource(source), "[5, 2, 3]\n[5, dois, 3, nil]\n4\n");
+}
+
+TEST(ArrayTests, TestNumericBuiltins) {
+    std::string source =
+        "var a = [4, -2, 9, 7, 1, 3, 8, 0, 5];"
+        "print sum(a);"
+        "print min(a);"
+        "print max(a);"
+        "sort(a);"
+        "print a;"
+        "print bsearch(a, 7);"
+        "print bsearch(a, 6);"
+        "print sum(array(1000, 0.5));"
+        "print min([]);";
+    EXPECT_EQ(runSource(source), "35\n-2\n9\n[-2, 0, 1, 3, 4, 5, 7, 8, 9]\n6\n-1\n500\nnil\n");
+}
+
+TEST(ArrayTests, TestStringSortAndSearch) {
+    std::string source =
+        "var a = [\"uva\", \"pera\", \"banana\"];"
+        "sort(a);"
+        "print a;"
+        "print bsearch(a, \"pera\");";
+    EXPECT_EQ(runSource(source), "[banana, pera, uva]\n1\n");
+}
+
+TEST(ArrayTests, TestRuntimeErrors) {
+    EXPECT_NE(runSource("var a = [1]; print a[1];").find("Array index out of range."), std::string::npos);
+    EXPECT_NE(runSource("var a = [1]; print a[0.5];").find("Array index must be an integer."), std::string::npos);
+    EXPECT_NE(runSource("print 3[0];").find("Only arrays and maps can be indexed."), std::string::npos);
+    EXPECT_NE(runSource("print sum([1, \"x\"]);").find("sum() requires an array of numbers."), std::string::npos);
+    EXPECT_NE(runSource("print len(1, 2);").find("Expected 1 arguments but got 2."), std::string::npos);
+    EXPECT_NE(runSource("print sort([1, \"x\"]);").find("[line 1]"), std::string::npos);
+}
+
+TEST(ArrayTests, TestKernelsMatchScalarLoops) {
+    for (std::size_t count : {1u, 3u, 4u, 7u, 8u, 9u, 31u, 100u}) {
+        std::vector<double> data(count);
+        for (std::size_t i = 0; i < count; ++i) {
+            data[i] = static_cast<double>((i * 37) % 23) - 11.0;
+        }
+        double total = 0.0;
+        double smallest = data[0];
+        double largest = data[0];
+        for (double value : data) {
+            total += value;
+            smallest = std::min(smallest, value);
+            largest = std::max(largest, value);
+        }
+        EXPECT_DOUBLE_EQ(lox::sumNumbers(data.data(), count), total) << count;
+        EXPECT_EQ(lox::minNumbers(data.data(), count), smallest) << count;
+        EXPECT_EQ(lox::maxNumbers(data.data(), count), largest) << count;
+    }
+}
+
+TEST(ArrayTests, TestSearchFindsEveryElement) {
+    std::vector<double> data;
+    for (int i = 0; i < 100; ++i) data.push_back(i * 2.0);
+    lox::sortNumbers(data.data(), data.size());
+    for (int i = 0; i < 100; ++i) {
+        EXPECT_EQ(lox::searchNumbers(data.data(), data.size(), i * 2.0), i);
+        EXPECT_EQ(lox::searchNumbers(data.data(), data.size(), i * 2.0 + 1.0), -1);
+    }
+    EXPECT_EQ(lox::searchNumbers(data.data(), data.size(), -1.0), -1);
+    EXPECT_EQ(lox::searchNumbers(data.data(), 0, 0.0), -1);
+}
+
+TEST(ArrayTests, TestSortPutsNaNLast) {
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> data;
+    for (int i = 0; i < 200; ++i) data.push_back(i % 7 == 0 ? nan : static_cast<double>((i * 37) % 101));
+    lox::sortNumbers(data.data(), data.size());
+    std::size_t numbers = 0;
+    while (numbers < data.size() && !std::isnan(data[numbers])) ++numbers;
+    EXPECT_EQ(numbers, 200u - 29u);
+    EXPECT_TRUE(std::is_sorted(data.begin(), data.begin() + static_cast<long>(numbers)));
+    for (std::size_t i = numbers; i < data.size(); ++i) EXPECT_TRUE(std::isnan(data[i])) << i;
+
+    // O mesmo no armazenamento genérico (o array deixou de ser numérico).
+    std::string output = runSource(
+        "var inf = 1; while (inf < inf * 2) inf = inf * 2;"
+        "var nan = inf - inf;"
+        "var a = [\"x\", 3, 1, nan, 2]; a[0] = nan;"
+        "sort(a); print a[0]; print a[1]; print a[2]; print a[3] != a[3]; print a[4] != a[4];"
+        "print bsearch(a, 2); print bsearch(a, nan);");
+    EXPECT_EQ(output, "1\n2\n3\ntrue\ntrue\n1\n-1\n");
+}
+
+TEST(ArrayTests, TestPrintDeeplyNestedValues) {
+    // A impressão não usa uma chamada por nível de aninhamento.
+    std::string source =
+        "var a = [];"
+        "for (var i = 0; i < 100000; i = i + 1) { a = [a]; }"
+        "print a;"
+        "var b = [];"
+        "for (var i = 0; i < 1000; i = i + 1) { var m = map(); m[\"k\"] = b; b = [m]; }"
+        "print b;"
+        "var c = [1, 2];"
+        "push(c, c);"
+        "var d = map();"
+        "d[\"self\"] = d;"
+        "print [c, d, c, [], map()];";
+    std::string output = runSource(source);
+    std::string expected = std::string(100001, '[') + std::string(100001, ']') + "\n";
+    for (int i = 0; i < 1000; ++i) expected += "[{k: ";
+    expected += "[]";
+    for (int i = 0; i < 1000; ++i) expected += "}]";
+    expected += "\n[[1, 2, [...]], {self: {...}}, [1, 2, [...]], [], {}]\n";
+    EXPECT_EQ(output, expected);
+}
+
+TEST(ArrayTests, TestNestedArraysSurviveCollection) {
+    CapturedOutput output;
+    std::string source =
+        "var rows = [];"
+        "var i = 0;"
+        "while (i < 20) {"
+        "  var row = [i, [i * 2]];"
+        "  push(rows, row);"
+        "  i = i + 1;"
+        "}"
+        "print rows[19][1][0];";
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    auto statements = parser.parse();
+
+    lox::GcConfig config;
+    config.stress = true;
+    lox::Interpreter interpreter(config);
+    interpreter.interpret(statements);
+
+    EXPECT_EQ(output.str(), "38\n");
+    EXPECT_GT(interpreter.heap().stats().collections, 20u);
+}
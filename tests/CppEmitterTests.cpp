@@ -0,0 +1,135 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "Optimizer.hpp"
+#include "CppEmitter.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static std::vector<std::unique_ptr<lox::Stmt>> parseForEmit(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    auto statements = parser.parse();
+    EXPECT_FALSE(parser.hadError());
+    return statements;
+}
+
+struct ProgramResult {
+    std::string output;   // stdout e stderr, na ordem em que foram escritos
+    int status;
+};
+
+static ProgramResult interpretProgram(const std::string& source) {
+    CapturedOutput output;
+    auto statements = parseForEmit(source);
+    lox::Interpreter interpreter;
+    bool ok = interpreter.interpret(statements);
+    return {output.str(), ok ? 0 : 70};
+}
+
+// Gera o C++, compila com o compilador do build contra a lox_runtime e
+// executa o binário.
+static ProgramResult compileAndRun(const std::string& source, bool optimize = false) {
+    auto statements = parseForEmit(source);
+    if (optimize) statements = lox::Optimizer().optimize(statements);
+    std::string code = lox::CppEmitter().emit(statements);
+
+    static int counter = 0;
+    std::string base = "/tmp/lox-emit-test-" + std::to_string(getpid()) + "-" + std::to_string(++counter);
+    std::ofstream(base + ".cpp") << code;
+    std::string compile = std::string(LOX_CXX_COMPILER) + " -std=c++17 -I " + LOX_SOURCE_DIR + " " + base + ".cpp " +
+                          LOX_RUNTIME_LIB + " -o " + base;
+    if (std::system(compile.c_str()) != 0) {
+        ADD_FAILURE() << "generated code does not compile:\n" << code;
+        return {"", -1};
+    }
+
+    ProgramResult result{"", -1};
+    FILE* pipe = popen((base + " 2>&1").c_str(), "r");
+    char chunk[256];
+    size_t size;
+    while ((size = fread(chunk, 1, sizeof chunk, pipe)) > 0) result.output.append(chunk, size);
+    int status = pclose(pipe);
+    if (WIFEXITED(status)) result.status = WEXITSTATUS(status);
+    std::remove((base + ".cpp").c_str());
+    std::remove(base.c_str());
+    return result;
+}
+
+static void expectSameAsInterpreter(const std::string& source, bool optimize = false) {
+    ProgramResult expected = interpretProgram(source);
+    ProgramResult actual = compileAndRun(source, optimize);
+    EXPECT_EQ(actual.output, expected.output) << source;
+    EXPECT_EQ(actual.status, expected.status) << source;
+}
+
+TEST(CppEmitterTests, TestOutputMatchesInterpreter) {
+    std::string source =
+        "var a = 3; var s = \"olá\"; var i = 0; var acc = 0;"
+        "while (i < 10) { acc = acc + a * i / 4; i = i + 1; }"
+        "print acc; print -a; print 7 / 2; print 0.1 + 0.2;"
+        "for (var j = 0; j < 3; j = j + 1) print s + \"!\";"
+        "var m; print m; print !m or 2; print nil and 1; print a == 3 and i != 0;"
+        "var q = nil; q = 1 + 2; print q; print (q = \"x\") + \"y\"; print q;"
+        "print 1 == true; print \"a\" == \"a\"; print nil == nil;"
+        "{ var a = \"inner\"; print a; } print a;"
+        "var k = 5; print (k = k + 1) * k;"
+        "for (var n = 10; n > 0; n = n - 3) { if (n > 5) print n; else { print \"small\"; } }";
+    expectSameAsInterpreter(source);
+
+    // As variáveis $invN do otimizador também viram locais C++.
+    expectSameAsInterpreter(
+        "var a = 3; var b = 4; var i = 0; var acc = 0;"
+        "while (i < 5) { acc = acc + a * b - i; i = i + 1; } print acc;",
+        true);
+}
+
+TEST(CppEmitterTests, TestRuntimeErrorsMatchInterpreter) {
+    const char* sources[] = {
+        "print 1; missing = 1 + 1; print 2;",
+        "var d = 0; var i = 0;\nwhile (i < 3) {\n  print i;\n  i = i + 1 / (d + 2 - i);\n}",
+        "var s = \"a\"; for (var i = 0; i < 3; i = i + 1) { print i; s = s + i; }",
+    };
+    for (const char* source : sources) expectSameAsInterpreter(source);
+}
+
+TEST(CppEmitterTests, TestNumericVariablesAreDoubles) {
+    std::string code = lox::CppEmitter().emit(parseForEmit(
+        "var n = 10; var s = \"s\"; var x = 0; var y = x; var z;"
+        "for (var i = 0; i < n; i = i + 1) { x = x + i * 2; y = -y; }"
+        "print x + y; z = 1;"));
+    EXPECT_NE(code.find("double v1_n = 10.0;"), std::string::npos) << code;
+    EXPECT_NE(code.find("Value v2_s = "), std::string::npos) << code;
+    EXPECT_NE(code.find("double v3_x = 0.0;"), std::string::npos) << code;
+    EXPECT_NE(code.find("double v4_y = v3_x;"), std::string::npos) << code;
+    EXPECT_NE(code.find("Value v5_z;"), std::string::npos) << code;
+    EXPECT_NE(code.find("double v6_i = 0.0;"), std::string::npos) << code;
+    // O laço numérico não passa pelo runtime.
+    EXPECT_NE(code.find("while ((v6_i < v1_n))"), std::string::npos) << code;
+    EXPECT_NE(code.find("(v3_x = (v3_x + (v6_i * 2.0)))"), std::string::npos) << code;
+}
+
+TEST(CppEmitterTests, TestUnsupportedConstructsReportLine) {
+    auto lineOf = [](const std::string& source) {
+        try {
+            lox::CppEmitter().emit(parseForEmit(source));
+        } catch (const lox::CppEmitError& error) {
+            return error.line;
+        }
+        return -1;
+    };
+    EXPECT_EQ(lineOf("print 1;\nvar a = [1, 2];"), 2);
+    EXPECT_EQ(lineOf("var m = 1;\n\nprint len(m);"), 3);
+    EXPECT_EQ(lineOf("var len = 1; print len;"), -1);
+}
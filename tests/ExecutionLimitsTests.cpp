@@ -0,0 +1,136 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include <chrono>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+
+static lox::ExecutionLimits fuel(std::uint64_t safepoints) {
+    lox::ExecutionLimits limits;
+    limits.fuel = safepoints;
+    return limits;
+}
+
+TEST(ExecutionLimitsTests, TestFuelReportsLoopLine) {
+    lox::Interpreter interpreter;
+    interpreter.setLimits(fuel(100));
+    std::string output = runSource(interpreter, "var i = 0;\nwhile (true)\n  i = i + 1;");
+    EXPECT_NE(output.find("Execution fuel exhausted (100 safepoints)."), std::string::npos) << output;
+    EXPECT_NE(output.find("[line 2]"), std::string::npos) << output;
+}
+
+TEST(ExecutionLimitsTests, TestFuelStopsAtTheSamePointInEveryTier) {
+    const char* source =
+        "var i = 0; var s = 0;"
+        "while (true) {"
+        "  for (var j = 0; j < 3; j = j + 1) { s = s + j; }"
+        "  i = i + 1;"
+        "}";
+    // Mais de uma fatia de combustível, para passar pelo caminho lento.
+    for (std::uint64_t amount : {1, 7, 2500}) {
+        lox::Interpreter tree;
+        tree.setSpecialization(false);
+        tree.setLimits(fuel(amount));
+        runSource(tree, source);
+        tree.setLimits({});
+        std::string expected = runSource(tree, "print i; print s;");
+
+        lox::Interpreter vm;
+        lox::JitOptions off;
+        off.enabled = false;
+        vm.setJit(off);
+        vm.setLimits(fuel(amount));
+        runSource(vm, source);
+        vm.setLimits({});
+        EXPECT_EQ(runSource(vm, "print i; print s;"), expected) << "fuel " << amount;
+
+        lox::Interpreter jit;
+        lox::JitOptions hot;
+        hot.threshold = 1;
+        jit.setJit(hot);
+        jit.setLimits(fuel(amount));
+        runSource(jit, source);
+        jit.setLimits({});
+        EXPECT_EQ(runSource(jit, "print i; print s;"), expected) << "fuel " << amount;
+    }
+}
+
+TEST(ExecutionLimitsTests, TestTimeoutStopsInfiniteLoop) {
+    for (bool specialize : {false, true}) {
+        lox::Interpreter interpreter;
+        interpreter.setSpecialization(specialize);
+        lox::ExecutionLimits limits;
+        limits.timeoutMs = 50;
+        interpreter.setLimits(limits);
+
+        auto start = std::chrono::steady_clock::now();
+        std::string output = runSource(interpreter, "var i = 0; while (true) { i = i + 1; }");
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        EXPECT_NE(output.find("Execution timed out after 50 ms."), std::string::npos) << output;
+        EXPECT_LT(elapsed, std::chrono::seconds(5));
+    }
+}
+
+TEST(ExecutionLimitsTests, TestWithinLimitsRunsNormally) {
+    lox::Interpreter interpreter;
+    lox::ExecutionLimits limits;
+    limits.fuel = 1000;
+    limits.timeoutMs = 10000;
+    interpreter.setLimits(limits);
+    EXPECT_EQ(runSource(interpreter, "var s = 0; for (var i = 0; i < 100; i = i + 1) { s = s + i; } print s;"),
+              "4950\n");
+    // O orçamento recomeça a cada interpret().
+    EXPECT_EQ(runSource(interpreter, "var t = 0; while (t < 900) t = t + 1; print t;"), "900\n");
+}
+
+// Executa o script em uma thread nova e espera por ela. O isolate principal
+// da thread é destruído quando ela termina, esperando os isolates filhos;
+// a saída fica redirecionada até lá, porque os filhos também escrevem.
+static std::string runInOwnThread(lox::ExecutionLimits limits, const std::string& source) {
+    CapturedOutput output;
+    std::thread thread([&limits, &source] {
+        lox::Interpreter interpreter;
+        interpreter.setLimits(limits);
+        interpreter.interpret(parseSource(source));
+    });
+    thread.join();
+    return output.str();
+}
+
+TEST(ExecutionLimitsTests, TestSpawnedIsolatesInheritLimits) {
+    auto start = std::chrono::steady_clock::now();
+    lox::ExecutionLimits limits = fuel(100);
+    limits.timeoutMs = 60000;
+    std::string output = runInOwnThread(limits, "print \"parent done\"; spawn(\"while (true) {}\");");
+    EXPECT_EQ(output, "parent done\nRuntimeError: Execution fuel exhausted (100 safepoints).\n[line 1]\n");
+
+    limits = {};
+    limits.timeoutMs = 100;
+    output = runInOwnThread(limits, "spawn(\"while (true) {}\");");
+    EXPECT_NE(output.find("RuntimeError: Execution timed out after"), std::string::npos) << output;
+
+    limits = {};
+    limits.memoryBytes = 1 << 20;
+    output = runInOwnThread(limits, "spawn(\"var a = []; while (true) push(a, 1);\");");
+    EXPECT_NE(output.find("RuntimeError: Memory limit exceeded (1048576 bytes)."), std::string::npos) << output;
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+}
+
+TEST(ExecutionLimitsTests, TestReceiveStopsAtLimits) {
+    lox::Interpreter interpreter;
+    lox::ExecutionLimits limits;
+    limits.timeoutMs = 100;
+    interpreter.setLimits(limits);
+    auto start = std::chrono::steady_clock::now();
+    EXPECT_EQ(runSource(interpreter, "print \"a\";\nreceive();\nprint \"b\";"),
+              "a\nRuntimeError: Execution timed out after 100 ms.\n[line 2]\n");
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::seconds(5));
+
+    // Cada pausa da espera conta como um safepoint.
+    interpreter.setLimits(fuel(50));
+    EXPECT_EQ(runSource(interpreter, "receive();"), "RuntimeError: Execution fuel exhausted (50 safepoints).\n[line 1]\n");
+}
@@ -0,0 +1,84 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "File.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <unistd.h>
+
+// Arquivo temporário com o conteúdo dado, apagado no fim do teste.
+class TempFile {
+public:
+    explicit TempFile(const std::string& contents) {
+        static int counter = 0;
+        m_path = "/tmp/lox-file-test-" + std::to_string(getpid()) + "-" + std::to_string(++counter);
+        std::ofstream(m_path, std::ios::binary) << contents;
+    }
+    ~TempFile() { std::remove(m_path.c_str()); }
+
+    const std::string& path() const { return m_path; }
+
+private:
+    std::string m_path;
+};
+
+TEST(FileTests, TestLinesAreViewsIntoTheMapping) {
+    TempFile temp("um\r\n\ndois\ntrês");
+    lox::LoxFile file(lox::String(temp.path().c_str()));
+    std::string_view contents = file.contents();
+    std::vector<std::string_view> lines;
+    std::string_view line;
+    while (file.nextLine(line)) lines.push_back(line);
+
+    ASSERT_EQ(lines.size(), 4u);
+    EXPECT_EQ(lines[0], "um");
+    EXPECT_EQ(lines[1], "");
+    EXPECT_EQ(lines[2], "dois");
+    EXPECT_EQ(lines[3], "três");
+    // Nenhuma cópia: as linhas apontam para dentro do mapeamento.
+    EXPECT_EQ(lines[2].data(), contents.data() + 5);
+    EXPECT_FALSE(file.nextLine(line));
+
+    file.close();
+    EXPECT_FALSE(file.isOpen());
+    EXPECT_TRUE(file.contents().empty());
+}
+
+TEST(FileTests, TestOpenErrors) {
+    EXPECT_THROW(lox::LoxFile(lox::String("/tmp/lox-no-such-file")), std::system_error);
+    EXPECT_THROW(lox::LoxFile(lox::String("/tmp")), std::system_error);
+
+    TempFile empty("");
+    lox::LoxFile file(lox::String(empty.path().c_str()));
+    std::string_view line;
+    EXPECT_FALSE(file.nextLine(line));
+}
+
+TEST(FileTests, TestReadLinesFromLox) {
+    TempFile temp("a,1\nbb,22\n\nccc,333\n");
+    std::string source =
+        "var f = open(\"" + temp.path() + "\");\n"
+        "print readLine(f);\n"
+        "var lines = 1; var bytes = 0; var n = nextLine(f);\n"
+        "while (n != nil) { lines = lines + 1; bytes = bytes + n; n = nextLine(f); }\n"
+        "print lines; print bytes; print readLine(f);\n"
+        "write(\"total \"); write(len(readFile(\"" + temp.path() + "\"))); print \"\";\n"
+        "close(f); close(f);\n"
+        "readLine(f);\n";
+    EXPECT_EQ(runSource(source),
+              "a,1\n4\n12\nnil\ntotal 19\n"
+              "RuntimeError: readLine() on a closed file.\n[line 8]\n");
+}
+
+TEST(FileTests, TestNativeErrors) {
+    EXPECT_EQ(runSource("open(\"/tmp/lox-no-such-file\");"),
+              "RuntimeError: open() could not open /tmp/lox-no-such-file: No such file or directory.\n[line 1]\n");
+    EXPECT_EQ(runSource("readFile(1);"), "RuntimeError: readFile() expects a path string.\n[line 1]\n");
+    EXPECT_EQ(runSource("nextLine([]);"), "RuntimeError: nextLine() expects a file.\n[line 1]\n");
+}
@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "ast/ASTPrinter.hpp"
+#include "ast/FlatAst.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::vector<std::unique_ptr<lox::Stmt>> parseForFlat(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    return parser.parse();
+}
+
+static std::string printTree(const std::vector<std::unique_ptr<lox::Stmt>>& statements) {
+    lox::ASTPrinter printer;
+    std::ostringstream out;
+    for (const auto& stmt : statements) {
+        out << stmt->line << ' ';
+        printer.print(*stmt, out);
+        out << '\n';
+    }
+    return out.str();
+}
+
+// Executa o programa pela árvore ou pela FlatAst e devolve stdout e stderr.
+static std::string interpretBothWays(const std::string& source, bool flat, lox::GcConfig gc = {}) {
+    auto statements = parseForFlat(source);
+    CapturedOutput output;
+    lox::Interpreter interpreter(gc);
+    if (flat) {
+        interpreter.interpret(lox::flattenAst(statements));
+    } else {
+        interpreter.interpret(statements);
+    }
+    return output.str();
+}
+
+static const char* kFlatProgram =
+    "var a = [1, -2.5, \"texto\", nil, true];\n"
+    "var m = map(); m[\"k\"] = len(a);\n"
+    "for (var i = 0; i < 4; i = i + 1) {\n"
+    "  if (i > 1 and !false) print a[i]; else a[0] = a[0] * (i + 1);\n"
+    "}\n"
+    "var j = 3;\n"
+    "while (j > 0 or false) { j = j - 1; print j == 1 or \"x\"; }\n"
+    "var s = \"\"; for (var k = 5; k >= 0; k = k - 2) s = s + \"-\";\n"
+    "print s; print m[\"k\"]; print -(a[0] / 4);\n"
+    "for (;;) { print \"uma vez\"; a[10] = 1; }\n";
+
+TEST(FlatAstTests, TestExpandRoundTrip) {
+    auto statements = parseForFlat(kFlatProgram);
+    lox::FlatAst flat = lox::flattenAst(statements);
+    EXPECT_EQ(printTree(lox::expandFlatAst(flat)), printTree(statements));
+}
+
+TEST(FlatAstTests, TestNodesArePreorder) {
+    auto statements = parseForFlat("print 1 + x;\nvar y;");
+    lox::FlatAst flat = lox::flattenAst(statements);
+    ASSERT_EQ(flat.nodes.size(), 5u);
+    EXPECT_EQ(flat.nodes[0].tag, lox::FlatTag::Print);
+    EXPECT_EQ(flat.nodes[1].tag, lox::FlatTag::Binary);
+    EXPECT_EQ(flat.nodes[1].op, TokenType::PLUS);
+    EXPECT_EQ(flat.nodes[2].tag, lox::FlatTag::Literal);
+    EXPECT_EQ(flat.nodes[3].tag, lox::FlatTag::Variable);
+    EXPECT_EQ(flat.nodes[4].tag, lox::FlatTag::Var);
+    EXPECT_EQ(flat.nodes[4].a, lox::kNoNode);
+    EXPECT_EQ(flat.nodes[4].line, 2);
+    EXPECT_EQ(flat.statements, (std::vector<lox::NodeIndex>{0, 4}));
+    EXPECT_EQ(flat.tokens[flat.nodes[3].data].lexeme, "x");
+}
+
+TEST(FlatAstTests, TestExecutesLikeTree) {
+    std::string expected = interpretBothWays(kFlatProgram, false);
+    // O programa termina com o erro de índice, na linha 10.
+    EXPECT_NE(expected.find("uma vez\nRuntimeError: Array index out of range.\n[line 10]"), std::string::npos)
+        << expected;
+    EXPECT_EQ(interpretBothWays(kFlatProgram, true), expected);
+    EXPECT_EQ(interpretBothWays("print undefinedName;", true), interpretBothWays("print undefinedName;", false));
+}
+
+TEST(FlatAstTests, TestCollectsDuringFlatExecution) {
+    // Uma coleta em cada safepoint da FlatAst, com arrays e blocos vivos
+    // nas raízes.
+    lox::GcConfig gc;
+    gc.stress = true;
+    std::string source =
+        "var keep = [0];\n"
+        "for (var i = 0; i < 500; i = i + 1) {\n"
+        "  var garbage = [i, i, i];\n"
+        "  { var inner = [garbage[0]]; keep[0] = keep[0] + inner[0]; }\n"
+        "}\n"
+        "print keep[0];\n";
+    EXPECT_EQ(interpretBothWays(source, true, gc), "124750\n");
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "ast/ASTPrinter.hpp"
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static const lox::ForStmt& parseFor(const std::string& source, std::vector<std::unique_ptr<lox::Stmt>>& statements) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    statements = parser.parse();
+    EXPECT_FALSE(parser.hadError());
+    EXPECT_EQ(statements.back()->kind, lox::StmtKind::For);
+    return static_cast<const lox::ForStmt&>(*statements.back());
+}
+
+TEST(ForLoopTests, TestRecognizesCountedLoops) {
+    std::vector<std::unique_ptr<lox::Stmt>> statements;
+    lox::ASTPrinter printer;
+
+    const lox::ForStmt& up = parseFor("for (var i = 0; i < 10; i = i + 2) print i;", statements);
+    EXPECT_TRUE(up.counted);
+    EXPECT_EQ(printer.print(up), "(for (var i = 0) (< i 10) (+= i 2) (print i))");
+
+    const lox::ForStmt& down = parseFor("var n = 3; for (var i = n; i >= 0; i = i - 1) { print i; }", statements);
+    EXPECT_TRUE(down.counted);
+    EXPECT_EQ(printer.print(*down.increment), "(+= i -1)");
+}
+
+TEST(ForLoopTests, TestOtherShapesUseTheGenericLoop) {
+    const char* sources[] = {
+        "for (var i = 0; i < 10; i = i + 1) { i = 3; }",            // corpo atribui a i
+        "for (var i = 0; i < 10; i = i + 1) { var i = 2; }",        // corpo redeclara i
+        "for (var i = 0; i < (i = 5); i = i + 1) print i;",         // limite atribui a i
+        "for (var i = 0; i < 10; i = i * 2) print i;",              // incremento não é soma
+        "for (var i = 0; i < 10; i = 1 + i) print i;",              // i não está à esquerda
+        "var k = 1; for (var i = 0; i < 10; i = i + k) print i;",   // passo não é literal
+        "for (var i = 0; i != 10; i = i + 1) print i;",             // != não é ordem
+        "var i = 0; for (i = 0; i < 10; i = i + 1) print i;",       // sem var
+        "for (var i = 0; ; i = i + 1) print i;",
+    };
+    for (const char* source : sources) {
+        std::vector<std::unique_ptr<lox::Stmt>> statements;
+        const lox::ForStmt& loop = parseFor(source, statements);
+        EXPECT_FALSE(loop.counted) << source;
+        if (loop.increment != nullptr) {
+            EXPECT_NE(loop.increment->kind, lox::ExprKind::Increment) << source;
+        }
+    }
+}
+
+TEST(ForLoopTests, TestCountedLoopSemantics) {
+    std::string source =
+        "for (var i = 0; i < 3; i = i + 1) print i;"
+        "var total = 0;"
+        "for (var i = 10; i > 0; i = i - 2.5) total = total + i;"
+        "print total;"
+        "for (var i = 1; i <= 2; i = i + 1) { var j = i * 10; print j; }"
+        // O limite é reavaliado a cada volta.
+        "var a = [1, 2];"
+        "for (var i = 0; i < len(a); i = i + 1) { if (len(a) < 4) push(a, i); }"
+        "print a;";
+    EXPECT_EQ(runSource(source), "0\n1\n2\n25\n10\n20\n[1, 2, 0, 1]\n");
+}
+
+TEST(ForLoopTests, TestGenericLoopAndScope) {
+    std::string source =
+        "var j = 0;"
+        "for (; j < 2;) { print j; j = j + 1; }"
+        "for (var k = 0; k < 3; k = k + 1) { if (k == 1) k = 5; print k; }"
+        "var i = \"fora\";"
+        "for (var i = 0; i < 1; i = i + 1) {}"
+        "print i;"
+        "for (j = 0; j < 2; j = j + 1) {}"
+        "print j;";
+    EXPECT_EQ(runSource(source), "0\n1\n0\n5\nfora\n2\n");
+}
+
+TEST(ForLoopTests, TestErrors) {
+    EXPECT_NE(runSource("for (var i = 0; i < \"x\"; i = i + 1) {}").find("Operands must be numbers."),
+              std::string::npos);
+    EXPECT_NE(runSource("for (var i = \"a\"; i < 3; i = i + 1) {}").find("Operands must be numbers."),
+              std::string::npos);
+    EXPECT_NE(runSource("for (var i = 0 i < 3; i = i + 1) {}").find("Expect ';' after variable declaration."),
+              std::string::npos);
+    EXPECT_NE(runSource("for (var i = 0; i < 3; i = i + 1 {}").find("Expect ')' after for clauses."),
+              std::string::npos);
+}
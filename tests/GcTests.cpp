@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include <string>
+#include <vector>
+#include <sstream>
+
+TEST(GcTests, TestBlockEnvironmentsAreCollected) {
+    lox::GcConfig config;
+    config.initialThreshold = 0;
+    lox::Interpreter interpreter(config);
+    // O laço especializado não cria escopos; aqui queremos os da AST.
+    interpreter.setSpecialization(false);
+    // O escopo global e as funções nativas definidas nele.
+    std::size_t globalObjects = interpreter.heap().objectCount();
+
+    std::string source =
+        "var i = 0;"
+        "while (i < 50) {"
+        "  var tmp = i * 2;"
+        "  i = i + 1;"
+        "}"
+        "print i;";
+    EXPECT_EQ(runSource(interpreter, source), "50\n");
+
+    // Ao final, apenas o escopo global continua alcançável.
+    interpreter.collectGarbage();
+    EXPECT_EQ(interpreter.heap().objectCount(), globalObjects);
+    EXPECT_GE(interpreter.heap().stats().objectsFreed, 50u);
+}
+
+TEST(GcTests, TestStressModeKeepsLiveScopes) {
+    lox::GcConfig config;
+    config.stress = true;
+    lox::Interpreter interpreter(config);
+
+    std::string source =
+        "var a = \"global\";"
+        "{"
+        "  var b = \"outer\";"
+        "  {"
+        "    var c = \"inner\";"
+        "    print a + b + c;"
+        "  }"
+        "  print b;"
+        "}";
+    EXPECT_EQ(runSource(interpreter, source), "globalouterinner\nouter\n");
+    EXPECT_GT(interpreter.heap().stats().collections, 0u);
+}
+
+TEST(GcTests, TestPauseTimesAreRecorded) {
+    lox::Interpreter interpreter;
+    runSource(interpreter, "{ var x = 1; } { var y = 2; }");
+    interpreter.collectGarbage();
+    interpreter.collectGarbage();
+
+    const lox::GcStats& stats = interpreter.heap().stats();
+    EXPECT_EQ(stats.collections, 2u);
+    EXPECT_GE(stats.maxPauseMs, stats.lastPauseMs);
+    EXPECT_GE(stats.totalPauseMs, stats.maxPauseMs);
+}
+
+TEST(GcTests, TestGrowingArrayPushesBackCollections) {
+    // O armazenamento do array conta para o limite da próxima coleta: com o
+    // array crescendo, as coletas se espaçam (growthFactor) em vez de
+    // acontecer a cada poucos escopos descartados.
+    lox::GcConfig config;
+    config.initialThreshold = 64 * 1024;
+    lox::Interpreter interpreter(config);
+    std::string source =
+        "var a = []; var s = \"x\"; var i = 0;"
+        "while (i < 200000) { push(a, s); i = i + 1; }"
+        "print len(a);";
+    EXPECT_EQ(runSource(interpreter, source), "200000\n");
+    EXPECT_GT(interpreter.heap().stats().collections, 0u);
+    EXPECT_LT(interpreter.heap().stats().collections, 30u);
+}
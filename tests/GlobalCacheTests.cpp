@@ -0,0 +1,72 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "ast/FlatAst.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::vector<std::unique_ptr<lox::Stmt>> parseWithCaches(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    return parser.parse();
+}
+
+static std::string runWithCaches(lox::Interpreter& interpreter, const std::vector<std::unique_ptr<lox::Stmt>>& statements,
+                                 bool flat = false) {
+    CapturedOutput output;
+    if (flat) {
+        interpreter.interpret(lox::flattenAst(statements));
+    } else {
+        interpreter.interpret(statements);
+    }
+    return output.str();
+}
+
+TEST(GlobalCacheTests, TestShadowingLocalInvalidatesCache) {
+    // Cada volta lê o global (preenchendo o cache) antes de defini-lo de
+    // novo como local no mesmo bloco.
+    auto statements = parseWithCaches(
+        "var x = \"g\"; var out = \"\";\n"
+        "for (var i = 0; i < 3; i = i + 1) {\n"
+        "  out = out + x;\n"
+        "  var x = \"l\";\n"
+        "  out = out + x;\n"
+        "  x = \"m\";\n"
+        "  { out = out + x; }\n"
+        "}\n"
+        "print out; print x;\n");
+    for (bool flat : {false, true}) {
+        lox::Interpreter interpreter;
+        EXPECT_EQ(runWithCaches(interpreter, statements, flat), "glmglmglm\ng\n") << flat;
+    }
+}
+
+TEST(GlobalCacheTests, TestCachesAreNotSharedBetweenInterpreters) {
+    auto statements = parseWithCaches("var g = 1; { g = g + 1; print g; }");
+    {
+        lox::Interpreter first;
+        EXPECT_EQ(runWithCaches(first, statements), "2\n");
+    }
+    // Os nós ainda têm os endereços do primeiro interpretador, já destruído.
+    lox::Interpreter second;
+    EXPECT_EQ(runWithCaches(second, statements), "2\n");
+    EXPECT_EQ(runWithCaches(second, statements), "2\n");
+}
+
+TEST(GlobalCacheTests, TestRedefinedGlobalKeepsSlot) {
+    // No REPL um global pode ser definido de novo em outra linha; o valor
+    // fica no mesmo lugar e o cache continua valendo.
+    lox::Interpreter interpreter;
+    auto read = parseWithCaches("{ print v; }");
+    auto first = parseWithCaches("var v = 1;");
+    auto second = parseWithCaches("var v = \"dois\";");
+    runWithCaches(interpreter, first);
+    EXPECT_EQ(runWithCaches(interpreter, read), "1\n");
+    runWithCaches(interpreter, second);
+    EXPECT_EQ(runWithCaches(interpreter, read), "dois\n");
+}
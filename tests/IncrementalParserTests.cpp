@@ -0,0 +1,118 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "IncrementalParser.hpp"
+#include "ast/ASTPrinter.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Linha e AST de cada statement de topo.
+static std::string renderProgram(const std::vector<std::unique_ptr<lox::Stmt>>& statements) {
+    lox::ASTPrinter printer;
+    std::string result;
+    for (const auto& stmt : statements) {
+        if (stmt) result += std::to_string(stmt->line) + " " + printer.print(*stmt) + "\n";
+    }
+    return result;
+}
+
+static std::string renderFullParse(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    auto statements = parser.parse();
+    return renderProgram(statements);
+}
+
+static std::string runIncremental(const lox::IncrementalParser& parser) {
+    CapturedOutput output;
+    lox::Interpreter interpreter;
+    interpreter.interpret(parser.statements());
+    return output.str();
+}
+
+TEST(IncrementalParserTests, TestMatchesFullParseAcrossEdits) {
+    std::vector<std::string> versions = {
+        "var a = 1;\nvar b = 2;\nprint a + b;\n",
+        // linha nova no começo: tudo abaixo desloca
+        "// topo\nvar a = 1;\nvar b = 2;\nprint a + b;\n",
+        // edição no meio, sem mudar linhas
+        "// topo\nvar a = 1;\nvar b = 20;\nprint a + b;\n",
+        // else acrescentado a um if existente
+        "// topo\nvar a = 1;\nif (a > 0) print a;\nvar b = 20;\nprint a + b;\n",
+        "// topo\nvar a = 1;\nif (a > 0) print a;\nelse print -a;\nvar b = 20;\nprint a + b;\n",
+        // laço com ';' dentro dos parênteses e blocos aninhados
+        "// topo\nvar a = 1;\nfor (var i = 0; i < 3; i = i + 1) {\n  { a = a + i; }\n}\nprint a; // \"fim;\"\n",
+        // duas edições distantes e uma string com ';' e '}'
+        "// topo!\nvar a = 1;\nfor (var i = 0; i < 3; i = i + 1) {\n  { a = a + i; }\n}\nprint \"a; }\";\nprint a * 2;",
+        // tudo apagado menos o fim
+        "print a * 2;",
+        "",
+    };
+    lox::IncrementalParser parser;
+    for (const std::string& version : versions) {
+        parser.update(version);
+        EXPECT_FALSE(parser.hadError()) << version;
+        EXPECT_EQ(renderProgram(parser.statements()), renderFullParse(version)) << version;
+    }
+}
+
+TEST(IncrementalParserTests, TestOnlyChangedDeclarationsAreReparsed) {
+    std::string source;
+    for (int i = 0; i < 1000; ++i) {
+        source += "var v" + std::to_string(i) + " = " + std::to_string(i) + ";\n";
+    }
+    lox::IncrementalParser parser;
+    lox::ReparseStats first = parser.update(source);
+    EXPECT_EQ(first.declarations, 1000u);
+    EXPECT_EQ(first.reparsed, 1000u);
+
+    // Altera a declaração 500 (e acrescenta uma linha depois dela).
+    std::string edited = source;
+    std::size_t at = edited.find("var v500 = 500;");
+    edited.replace(at, 15, "var v500 = 5;\nprint v500;");
+    lox::ReparseStats second = parser.update(edited);
+    EXPECT_EQ(second.declarations, 1001u);
+    EXPECT_LE(second.reparsed, 3u);
+    EXPECT_EQ(renderProgram(parser.statements()), renderFullParse(edited));
+
+    // Desfazer: as declarações antigas voltam do cache.
+    lox::ReparseStats third = parser.update(source);
+    EXPECT_EQ(third.declarations, 1000u);
+    EXPECT_EQ(third.reparsed, 0u);
+    EXPECT_GE(third.fromCache, 1u);
+    EXPECT_EQ(renderProgram(parser.statements()), renderFullParse(source));
+}
+
+TEST(IncrementalParserTests, TestRuntimeErrorLinesFollowTheEdit) {
+    lox::IncrementalParser parser;
+    parser.update("var a = 1;\nif (a > 0) {\n  print a;\n  print -\"x\";\n}\n");
+    EXPECT_NE(runIncremental(parser).find("[line 4]"), std::string::npos);
+
+    // Duas linhas novas acima do if: o erro, dentro do bloco, vai para a 6.
+    lox::ReparseStats stats = parser.update("var a = 1;\n\nprint a;\nif (a > 0) {\n  print a;\n  print -\"x\";\n}\n");
+    EXPECT_EQ(stats.declarations, 3u);
+    std::string output = runIncremental(parser);
+    EXPECT_NE(output.find("[line 6]"), std::string::npos) << output;
+}
+
+TEST(IncrementalParserTests, TestSyntaxErrorsAreReportedUntilFixed) {
+    lox::IncrementalParser parser;
+    parser.update("var a = 1;\nprint a +;\nprint a;\n");
+    EXPECT_TRUE(parser.hadError());
+    EXPECT_NE(parser.diagnostics().find("[line 2] Error at ';': Expect expression."), std::string::npos)
+        << parser.diagnostics();
+
+    // Uma linha acima do erro: a mensagem acompanha.
+    parser.update("var a = 1;\n\nprint a +;\nprint a;\n");
+    EXPECT_NE(parser.diagnostics().find("[line 3] Error at ';'"), std::string::npos) << parser.diagnostics();
+
+    parser.update("var a = 1;\n\nprint a + 1;\nprint a;\n");
+    EXPECT_FALSE(parser.hadError());
+    EXPECT_EQ(parser.diagnostics(), "");
+    EXPECT_EQ(runIncremental(parser), "2\n1\n");
+}
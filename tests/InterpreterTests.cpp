@@ -13,7 +13,7 @@ void runInterpreter(const std::string& source, std::stringstream& buffer) {
 
     lox::Interpreter interpreter;
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
     lox::Parser parser(tokens);
     auto statements = parser.parse();
     interpreter.interpret(statements);
@@ -0,0 +1,102 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "Channel.hpp"
+#include <atomic>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST(IsolateTests, TestWorkerRepliesToParent) {
+    EXPECT_EQ(runSource("var w = spawn(\"send(parent(), receive() * 6);\"); send(w, 7); print receive();"), "42\n");
+}
+
+TEST(IsolateTests, TestWorkersHaveTheirOwnGlobals) {
+    std::string output = runSource(
+        "var x = 1;"
+        "spawn(\"var x = 100; x = x + 1; send(parent(), x);\");"
+        "print receive(); print x;");
+    EXPECT_EQ(output, "101\n1\n");
+}
+
+TEST(IsolateTests, TestMessagesAreDeepCopies) {
+    // O worker recebe uma cópia (com o ciclo preservado) e a altera; o
+    // original não muda.
+    std::string output = runSource(
+        "var w = spawn(\"var a = receive(); a[0] = 99; a[3][1] = 0; var m = a[4]; m[5] = a[3] == a; send(parent(), a);\");"
+        "var a = [1, 2, 3]; push(a, a); var m = map(); m[\"k\"] = 1; push(a, m);"
+        "send(w, a);"
+        "var b = receive();"
+        "print a[0]; print a[1]; print b[0]; print b[1]; print b[4][5]; print b[3] == b;");
+    EXPECT_EQ(output, "1\n2\n99\n0\ntrue\ntrue\n");
+}
+
+TEST(IsolateTests, TestDeeplyNestedMessages) {
+    // A cópia e a reconstrução não usam uma chamada por nível.
+    std::string output = runSource(
+        "var w = spawn(\"var a = receive(); send(parent(), a); var d = 0;"
+        " while (len(a) > 0) { a = a[0]; d = d + 1; } send(parent(), d);\");"
+        "var a = [];"
+        "for (var i = 0; i < 50000; i = i + 1) { a = [a]; }"
+        "send(w, a);"
+        "var back = receive();"
+        "var d = 0;"
+        "while (len(back) > 0) { back = back[0]; d = d + 1; }"
+        "print d; print receive();");
+    EXPECT_EQ(output, "50000\n50000\n");
+}
+
+TEST(IsolateTests, TestManyWorkers) {
+    std::string output = runSource(
+        "var n = 0;"
+        "while (n < 8) { send(spawn(\"var k = receive(); send(parent(), k * k);\"), n); n = n + 1; }"
+        "var total = 0;"
+        "while (n > 0) { total = total + receive(); n = n - 1; }"
+        "print total;");
+    EXPECT_EQ(output, "140\n");
+}
+
+TEST(IsolateTests, TestErrors) {
+    EXPECT_NE(runSource("send(parent, 1);").find("send() expects an isolate id."), std::string::npos);
+    EXPECT_NE(runSource("send(4000000000, 1);").find("send() to unknown isolate 4000000000."), std::string::npos);
+    EXPECT_NE(runSource("var w = spawn(\"receive();\"); send(w, len);")
+                  .find("send() can only send nil, booleans, numbers, strings, arrays and maps."),
+              std::string::npos);
+    EXPECT_NE(runSource("spawn(1);").find("spawn() expects the source code of a script."), std::string::npos);
+}
+
+TEST(IsolateTests, TestBoundedQueueManyProducersAndConsumers) {
+    lox::BoundedQueue<long> queue(64);
+    const long perProducer = 20000;
+    std::atomic<long> sum{0};
+    std::atomic<long> count{0};
+    std::vector<std::thread> threads;
+    for (int p = 0; p < 4; ++p) {
+        threads.emplace_back([&queue, perProducer] {
+            for (long i = 1; i <= perProducer; ++i) {
+                long value = i;
+                while (!queue.tryPush(value)) std::this_thread::yield();
+            }
+        });
+    }
+    for (int c = 0; c < 4; ++c) {
+        threads.emplace_back([&] {
+            long value = 0;
+            while (count.load() < 4 * perProducer) {
+                if (queue.tryPop(value)) {
+                    sum += value;
+                    ++count;
+                } else {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) thread.join();
+    EXPECT_EQ(count.load(), 4 * perProducer);
+    EXPECT_EQ(sum.load(), 4 * perProducer * (perProducer + 1) / 2);
+}
@@ -0,0 +1,116 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "X64Assembler.hpp"
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+
+static lox::JitOptions jitAfter(std::size_t threshold) {
+    lox::JitOptions options;
+    options.threshold = threshold;
+    return options;
+}
+
+TEST(JitTests, TestNativeLoopsMatchTheTree) {
+    if (!lox::ExecutableCode::supported()) GTEST_SKIP() << "JIT only on x86-64";
+    const char* sources[] = {
+        "var i = 0; var acc = 0;"
+        "while (i < 100) { acc = acc + i * 2 - acc / 3; i = i + 1; }"
+        "print acc;",
+
+        "var total = 0;"
+        "for (var i = 0; i < 10; i = i + 1) {"
+        "  var sq = i * i;"
+        "  if (sq > 4 and !(sq == 9) or i == 1) total = total + sq; else { total = total - (i = i + 0); }"
+        "  for (var j = i; j >= 0; j = j - 3) total = total + j;"
+        "  if (sq <= 16) total = -total;"
+        "}"
+        "print total;",
+
+        // NaN e -0: comparações ordenadas são falsas, == e != seguem o IEEE.
+        "var inf = 10; var k = 0; while (k < 10) { inf = inf * inf; k = k + 1; }"
+        "var nan = inf - inf; var hits = 0; var z = 0;"
+        "while (k > 0) {"
+        "  if (!(nan < 1)) hits = hits + 1; if (!(nan <= 1)) hits = hits + 2;"
+        "  if (!(nan > 1)) hits = hits + 4; if (!(nan >= 1)) hits = hits + 8;"
+        "  if (nan != nan) hits = hits + 16; if (!(nan == nan)) hits = hits + 32;"
+        "  z = -z; k = k - 1;"
+        "}"
+        "print hits; print z; print 1 / (z - 1);",
+
+        // Divisão por zero no código de máquina: variáveis gravadas e erro na
+        // linha do operador.
+        "var a = 0; var d = 40;\nwhile (true) {\n  d = d - 1;\n  a = a + 1 / d;\n}",
+    };
+    for (const char* source : sources) {
+        lox::Interpreter tree;
+        tree.setSpecialization(false);
+        std::string expected = runSource(tree, source);
+
+        for (std::size_t threshold : {1, 5, 1000000}) {
+            lox::Interpreter interpreter;
+            interpreter.setJit(jitAfter(threshold));
+            EXPECT_EQ(runSource(interpreter, source), expected) << source << " threshold " << threshold;
+        }
+    }
+}
+
+TEST(JitTests, TestTiersUpAfterThreshold) {
+    if (!lox::ExecutableCode::supported()) GTEST_SKIP() << "JIT only on x86-64";
+    lox::Interpreter interpreter;
+    interpreter.setJit(jitAfter(50));
+
+    // 20 iterações: fica no programa de registradores.
+    EXPECT_EQ(runSource(interpreter, "var i = 0; while (i < 20) i = i + 1; print i;"), "20\n");
+    EXPECT_EQ(interpreter.specializationStats().nativeLoops, 0u);
+
+    // Passa para código de máquina no meio da execução e termina nele.
+    EXPECT_EQ(runSource(interpreter, "var i = 0; var s = 0; while (i < 200) { s = s + i; i = i + 1; } print s;"),
+              "19900\n");
+    EXPECT_EQ(interpreter.specializationStats().nativeLoops, 1u);
+
+    // Desligado, nunca sai do programa de registradores.
+    lox::JitOptions off;
+    off.enabled = false;
+    interpreter.setJit(off);
+    runSource(interpreter, "var i = 0; while (i < 200) i = i + 1;");
+    EXPECT_EQ(interpreter.specializationStats().nativeLoops, 1u);
+}
+
+TEST(JitTests, TestGuardStillDeoptimizes) {
+    if (!lox::ExecutableCode::supported()) GTEST_SKIP() << "JIT only on x86-64";
+    lox::Interpreter interpreter;
+    interpreter.setJit(jitAfter(1));
+    // n vem de outra execução: o laço especula que é número e a guarda de
+    // entrada pega a troca de tipo antes de qualquer código de máquina.
+    runSource(interpreter, "var n = 0; n = \"x\";");
+    std::string output = runSource(interpreter, "while (n < 3) n = n + 1;");
+    EXPECT_NE(output.find("Operands must be numbers."), std::string::npos);
+    EXPECT_EQ(interpreter.specializationStats().deopts, 1u);
+    EXPECT_EQ(interpreter.specializationStats().nativeLoops, 0u);
+}
+
+TEST(JitTests, TestWritesPerfMap) {
+    if (!lox::ExecutableCode::supported()) GTEST_SKIP() << "JIT only on x86-64";
+    std::string path = "/tmp/perf-" + std::to_string(getpid()) + ".map";
+    std::remove(path.c_str());
+
+    lox::Interpreter interpreter;
+    lox::JitOptions options = jitAfter(1);
+    options.perfMap = true;
+    interpreter.setJit(options);
+    runSource(interpreter, "var i = 0;\n\nwhile (i < 10) i = i + 1;");
+
+    std::ifstream map(path);
+    std::string start, size, name;
+    ASSERT_TRUE(map >> start >> size >> name);
+    EXPECT_EQ(name, "lox::loop@line3");
+    EXPECT_GT(std::stoul(size, nullptr, 16), 0u);
+    std::remove(path.c_str());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "Stats.hpp"
+#include "ast/ASTPrinter.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static std::string printLogical(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    auto statements = parser.parse();
+    lox::ASTPrinter printer;
+    return statements.size() == 1 && statements[0] ? printer.print(*statements[0]) : "";
+}
+
+TEST(LogicalTests, TestPrecedence) {
+    // and liga mais forte que or, e ambos mais fraco que comparações.
+    EXPECT_EQ(printLogical("a or b and c;"), "(; (or a (and b c)))");
+    EXPECT_EQ(printLogical("a and b or c;"), "(; (or (and a b) c))");
+    EXPECT_EQ(printLogical("a < 1 or b == 2 and !c;"), "(; (or (< a 1) (and (== b 2) (! c))))");
+    EXPECT_EQ(printLogical("x = a or b;"), "(; (assign x = (or a b)))");
+}
+
+TEST(LogicalTests, TestValuesAndShortCircuit) {
+    std::string source =
+        "print nil or \"padrão\";"
+        "print 1 and 2;"
+        "print false and 2;"
+        "print 0 or 1;"
+        "var calls = [];"
+        "var r = false and push(calls, 1);"
+        "r = true or push(calls, 2);"
+        "r = true and push(calls, 3);"
+        "r = nil or push(calls, 4);"
+        "print calls;";
+    EXPECT_EQ(runSource(source), "padrão\n2\nfalse\n0\n[3, 4]\n");
+}
+
+TEST(LogicalTests, TestConditions) {
+    std::string source =
+        "var hits = 0;"
+        "var i = 0;"
+        "while (i < 20 and !(i == 15)) {"
+        "  if ((i > 3 and i <= 6) or i == 10 or \"s\") hits = hits + 1;"
+        "  if (i != 2 and nil) hits = hits + 100;"
+        "  i = i + 1;"
+        "}"
+        "print i;"
+        "print hits;"
+        "var calls = [];"
+        "if (false and push(calls, 1)) print \"não\";"
+        "if (1 < 2 or push(calls, 2)) print \"sim\";"
+        "print calls;"
+        "for (var j = 0; j < 3 and j != 1; j = j + 1) print j;";
+    EXPECT_EQ(runSource(source), "15\n15\nsim\n[]\n0\n");
+}
+
+TEST(LogicalTests, TestConditionErrors) {
+    EXPECT_NE(runSource("if (1 < \"a\") print 1;").find("Operands must be numbers."), std::string::npos);
+    EXPECT_NE(runSource("while (true and x) print 1;").find("Undefined variable 'x'."), std::string::npos);
+    // O erro só aparece se o lado direito for avaliado.
+    EXPECT_EQ(runSource("if (false and 1 < \"a\") print 1; print 2;"), "2\n");
+}
+
+TEST(LogicalTests, TestConditionCountersMatchEvaluation) {
+    if (!lox::kStatsEnabled) GTEST_SKIP() << "configure with -DLOX_ENABLE_STATS=ON";
+
+    lox::runtimeStats() = lox::RuntimeStats{};
+    runSource("var a = 1; if (a < 2 and !(a == 3)) print a;");
+    const lox::RuntimeStats& stats = lox::runtimeStats();
+    EXPECT_EQ(stats.exprVisits[static_cast<size_t>(lox::ExprKind::Logical)], 1u);
+    EXPECT_EQ(stats.exprVisits[static_cast<size_t>(lox::ExprKind::Binary)], 2u);
+    EXPECT_EQ(stats.exprVisits[static_cast<size_t>(lox::ExprKind::Variable)], 3u);
+}
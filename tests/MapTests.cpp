@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "Map.hpp"
+#include <cmath>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+
+TEST(MapTests, TestInsertFindRemoveThroughGrowth) {
+    lox::LoxMap map;
+    for (int i = 0; i < 1000; ++i) {
+        map.set(static_cast<double>(i), lox::String("v" + std::to_string(i)));
+        map.set(lox::String("k" + std::to_string(i)), static_cast<double>(i));
+    }
+    EXPECT_EQ(map.size(), 2000u);
+    EXPECT_EQ(map.capacity() % 8, 0u);
+    EXPECT_LE(map.size(), map.capacity() - map.capacity() / 8);
+
+    for (int i = 0; i < 1000; i += 2) {
+        EXPECT_TRUE(map.remove(static_cast<double>(i)));
+        EXPECT_FALSE(map.remove(static_cast<double>(i)));
+    }
+    EXPECT_EQ(map.size(), 1500u);
+    for (int i = 0; i < 1000; ++i) {
+        const lox::Value* number = map.find(static_cast<double>(i));
+        if (i % 2 == 0) {
+            EXPECT_EQ(number, nullptr) << i;
+        } else {
+            ASSERT_NE(number, nullptr) << i;
+            EXPECT_EQ(*number, lox::Value{lox::String("v" + std::to_string(i))});
+        }
+        const lox::Value* string = map.find(lox::String("k" + std::to_string(i)));
+        ASSERT_NE(string, nullptr) << i;
+        EXPECT_EQ(*string, lox::Value{static_cast<double>(i)});
+    }
+
+    std::size_t visited = 0;
+    map.forEach([&visited](const lox::Value&, const lox::Value&) { ++visited; });
+    EXPECT_EQ(visited, 1500u);
+}
+
+TEST(MapTests, TestRemovedSlotsAreReused) {
+    // Inserir e remover sem parar não pode fazer a tabela crescer.
+    lox::LoxMap map;
+    for (int i = 0; i < 10000; ++i) {
+        map.set(static_cast<double>(i), true);
+        EXPECT_TRUE(map.remove(static_cast<double>(i)));
+    }
+    EXPECT_EQ(map.size(), 0u);
+    EXPECT_LE(map.capacity(), 16u);
+}
+
+TEST(MapTests, TestKeysFollowValueEquality) {
+    EXPECT_EQ(lox::LoxMap::hashKey(0.0), lox::LoxMap::hashKey(-0.0));
+    EXPECT_NE(lox::LoxMap::hashKey(1.0), lox::LoxMap::hashKey(lox::String("1")));
+    EXPECT_FALSE(lox::LoxMap::isValidKey(std::numeric_limits<double>::quiet_NaN()));
+    EXPECT_FALSE(lox::LoxMap::isValidKey(true));
+    EXPECT_FALSE(lox::LoxMap::isValidKey(std::monostate{}));
+
+    lox::LoxMap map;
+    map.set(-0.0, "zero");
+    map.set(1.0, "number");
+    map.set(lox::String("1"), "string");
+    EXPECT_EQ(map.size(), 3u);
+    ASSERT_NE(map.find(0.0), nullptr);
+    EXPECT_EQ(*map.find(0.0), lox::Value{lox::String("zero")});
+    EXPECT_EQ(*map.find(1.0), lox::Value{lox::String("number")});
+    EXPECT_EQ(*map.find(lox::String("1")), lox::Value{lox::String("string")});
+    EXPECT_EQ(map.find(std::numeric_limits<double>::quiet_NaN()), nullptr);
+}
+
+TEST(MapTests, TestCountingByKey) {
+    std::string source =
+        "var words = [\"a\", \"b\", \"a\", \"c\", \"a\", \"b\"];"
+        "var counts = map();"
+        "var i = 0;"
+        "while (i < len(words)) {"
+        "  counts[words[i]] = get(counts, words[i], 0) + 1;"
+        "  i = i + 1;"
+        "}"
+        "print counts[\"a\"];"
+        "print counts[\"b\"];"
+        "print counts[\"z\"];"
+        "print len(counts);"
+        "print has(counts, \"c\");"
+        "print remove(counts, \"c\");"
+        "print has(counts, \"c\");"
+        "var k = keys(counts);"
+        "sort(k);"
+        "print k;"
+        "var v = values(counts);"
+        "sort(v);"
+        "print v;";
+    EXPECT_EQ(runSource(source), "3\n2\nnil\n3\ntrue\ntrue\nfalse\n[a, b]\n[2, 3]\n");
+}
+
+TEST(MapTests, TestPrintAndNumericKeys) {
+    std::string source =
+        "var m = map();"
+        "m[-0] = \"zero\";"
+        "print m[0];"
+        "m[\"self\"] = m;"
+        "remove(m, 0);"
+        "print m;";
+    EXPECT_EQ(runSource(source), "zero\n{self: {...}}\n");
+}
+
+TEST(MapTests, TestRuntimeErrors) {
+    EXPECT_NE(runSource("var m = map(); m[true] = 1;").find("Map keys must be strings or numbers (not NaN)."),
+              std::string::npos);
+    EXPECT_NE(runSource("var m = map(); print m[nil];").find("[line 1]"), std::string::npos);
+    EXPECT_NE(runSource("print has([1], 1);").find("has() expects a map."), std::string::npos);
+    EXPECT_NE(runSource("print get(map(), [], 0);").find("get() keys must be strings or numbers"), std::string::npos);
+}
+
+TEST(MapTests, TestValuesSurviveCollection) {
+    CapturedOutput output;
+    std::string source =
+        "var index = map();"
+        "var i = 0;"
+        "while (i < 50) {"
+        "  var entry = map();"
+        "  entry[\"items\"] = [i, i + 1];"
+        "  index[i] = entry;"
+        "  i = i + 1;"
+        "}"
+        "print index[49][\"items\"][1];";
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    auto statements = parser.parse();
+
+    lox::GcConfig config;
+    config.stress = true;
+    lox::Interpreter interpreter(config);
+    interpreter.interpret(statements);
+
+    EXPECT_EQ(output.str(), "50\n");
+    EXPECT_GT(interpreter.heap().stats().collections, 50u);
+}
@@ -0,0 +1,87 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "MemoryQuota.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static lox::ExecutionLimits memoryLimit(std::uint64_t bytes) {
+    lox::ExecutionLimits limits;
+    limits.memoryBytes = bytes;
+    return limits;
+}
+
+TEST(MemoryQuotaTests, TestCountsAndRefusesOverLimit) {
+    lox::MemoryQuota quota(1000);
+    void* a = quota.allocate(600);
+    EXPECT_EQ(quota.current(), 600u);
+    EXPECT_THROW(static_cast<void>(quota.allocate(500)), lox::MemoryLimitExceeded);
+    EXPECT_EQ(quota.current(), 600u);
+    quota.deallocate(a, 600);
+    void* b = quota.allocate(900);
+    EXPECT_EQ(quota.current(), 900u);
+    EXPECT_EQ(quota.peak(), 900u);
+    quota.deallocate(b, 900);
+    EXPECT_EQ(quota.current(), 0u);
+}
+
+TEST(MemoryQuotaTests, TestStringsFollowTheCurrentScope) {
+    lox::MemoryQuota quota;
+    std::string text(100, 'x');
+    lox::String outside(text);
+    EXPECT_EQ(quota.current(), 0u);
+    {
+        lox::MemoryQuota::Scope scope(&quota);
+        // A cópia é cobrada de quem está executando, não da origem.
+        lox::String copy = outside;
+        EXPECT_GE(quota.current(), 100u);
+        lox::String moved = std::move(copy);
+        EXPECT_GE(quota.current(), 100u);
+    }
+    EXPECT_EQ(quota.current(), 0u);
+}
+
+TEST(MemoryQuotaTests, TestInterpreterReportsUsage) {
+    lox::Interpreter interpreter;
+    std::size_t initial = interpreter.memoryUsage().current;
+    EXPECT_GT(initial, 0u);   // ambiente global e nativas
+
+    runSource(interpreter, "var s = \"ab\"; var i = 0; while (i < 12) { s = s + s; i = i + 1; } var a = [1, 2, 3];");
+    EXPECT_GE(interpreter.memoryUsage().current, initial + 8192u);
+    EXPECT_GE(interpreter.memoryUsage().peak, interpreter.memoryUsage().current);
+
+    runSource(interpreter, "s = nil; a = nil;");
+    interpreter.collectGarbage();
+    EXPECT_LT(interpreter.memoryUsage().current, initial + 8192u);
+}
+
+TEST(MemoryQuotaTests, TestOverQuotaIsRuntimeError) {
+    lox::Interpreter interpreter;
+    interpreter.setLimits(memoryLimit(100000));
+    std::string output = runSource(interpreter,
+        "var s = \"0123456789\";\n"
+        "while (true) {\n"
+        "  s = s + s;\n"
+        "}");
+    EXPECT_NE(output.find("RuntimeError: Memory limit exceeded (100000 bytes)."), std::string::npos) << output;
+    EXPECT_NE(output.find("[line 3]"), std::string::npos) << output;
+    EXPECT_LE(interpreter.memoryUsage().peak, 100000u);
+
+    // O interpretador continua utilizável depois do erro.
+    EXPECT_EQ(runSource(interpreter, "s = nil; print 1 + 2;"), "3\n");
+}
+
+TEST(MemoryQuotaTests, TestGarbageIsCollectedBeforeTheLimit) {
+    lox::Interpreter interpreter;
+    interpreter.setLimits(memoryLimit(200000));
+    // Muito mais que o limite ao todo, mas pouco vivo de cada vez.
+    std::string output = runSource(interpreter,
+        "var i = 0;"
+        "while (i < 5000) { var a = [i, i, i, i, i, i, i, i]; var m = map(); m[\"k\"] = a; i = i + 1; }"
+        "print i;");
+    EXPECT_EQ(output, "5000\n");
+    EXPECT_LE(interpreter.memoryUsage().peak, 200000u);
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "Optimizer.hpp"
+#include "ast/ASTPrinter.hpp"
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::vector<std::unique_ptr<lox::Stmt>> parseProgram(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    auto statements = parser.parse();
+    EXPECT_FALSE(parser.hadError());
+    return statements;
+}
+
+static std::string printProgram(const std::vector<std::unique_ptr<lox::Stmt>>& statements) {
+    lox::ASTPrinter printer;
+    std::string out;
+    for (const auto& stmt : statements) out += printer.print(*stmt) + "\n";
+    return out;
+}
+
+static std::string optimizedAst(const std::string& source, lox::OptimizerOptions options = {}) {
+    lox::Optimizer optimizer(options);
+    return printProgram(optimizer.optimize(parseProgram(source)));
+}
+
+// Saída (stdout e stderr) do programa, otimizado ou não.
+static std::string runOptimized(const std::string& source, bool optimize) {
+    CapturedOutput output;
+    auto statements = parseProgram(source);
+    if (optimize) statements = lox::Optimizer().optimize(statements);
+    lox::Interpreter interpreter;
+    interpreter.interpret(statements);
+    return output.str();
+}
+
+TEST(OptimizerTests, TestFoldsConstantBranches) {
+    EXPECT_EQ(optimizedAst("var x = 1; if (false) print x; else print -x; if (!nil or x) print 1;"
+                           "if (false and x) print 2; while (nil) print 3; print x;"),
+              "(var x = 1)\n(print (- x))\n(print 1)\n(print x)\n");
+
+    // Nada depois de um laço que nunca termina executa.
+    EXPECT_EQ(optimizedAst("var i = 0; while (true) { i = i + 1; print i; } print i; i = 2;"),
+              "(var i = 0)\n(while true (block (; (assign i = (+ i 1))) (print i)))\n");
+}
+
+TEST(OptimizerTests, TestRemovesDeadStores) {
+    EXPECT_EQ(optimizedAst("var a = 1; var b = a; var c = [a, nil]; print a;"), "(var a = 1)\n(print a)\n");
+
+    // O initializer e o valor atribuído ainda são avaliados se podem ter
+    // efeito ou lançar erro; atribuições usadas como valor viram o valor.
+    EXPECT_EQ(optimizedAst("var a = 1; { var t = a + 1; t = a * 2; print (t = 3) + a; }"),
+              "(var a = 1)\n(block (; (+ a 1)) (; (* a 2)) (print (+ (group 3) a)))\n");
+
+    // No REPL as globais ficam para as próximas linhas.
+    lox::OptimizerOptions repl;
+    repl.wholeProgram = false;
+    EXPECT_EQ(optimizedAst("var g = 1; { var t = g; }", repl), "(var g = 1)\n(block)\n");
+}
+
+TEST(OptimizerTests, TestHoistsLoopInvariants) {
+    std::string source =
+        "var a = 3; var b = 4; var i = 0; var acc = 0;"
+        "while (i < 4) {"
+        "  acc = acc + a * b - i * 2 + (a - 1) / 2;"
+        "  var j = 0;"
+        "  while (j < 2) { acc = acc + (a + b) * j; j = j + 1; }"
+        "  i = i + 1;"
+        "}"
+        "print acc;";
+    EXPECT_EQ(optimizedAst(source),
+              "(var a = 3)\n(var b = 4)\n(var i = 0)\n(var acc = 0)\n"
+              "(block (var $inv0 = (* a b)) (var $inv1 = (/ (group (- a 1)) 2)) (var $inv2 = (group (+ a b)))"
+              " (while (< i 4) (block (; (assign acc = (+ (- (+ acc $inv0) (* i 2)) $inv1))) (var j = 0)"
+              " (while (< j 2) (block (; (assign acc = (+ acc (* $inv2 j)))) (; (assign j = (+ j 1)))))"
+              " (; (assign i = (+ i 1))))))\n"
+              "(print acc)\n");
+    EXPECT_EQ(runOptimized(source, true), runOptimized(source, false));
+}
+
+TEST(OptimizerTests, TestKeepsExpressionsThatMayFail) {
+    // Tipos desconhecidos, divisão por variável e variáveis alteradas no laço
+    // ficam onde estão.
+    EXPECT_EQ(optimizedAst("var s = \"a\"; var d = 2; var i = 0;"
+                           "while (i < 2) { print s + s; print 1 / d; print i * d; i = i + 1; }"),
+              "(var s = a)\n(var d = 2)\n(var i = 0)\n"
+              "(while (< i 2) (block (print (+ s s)) (print (/ 1 d)) (print (* i d)) (; (assign i = (+ i 1)))))\n");
+}
+
+TEST(OptimizerTests, TestRuntimeErrorsArePreserved) {
+    const char* sources[] = {
+        "var u = missing + 1; print \"unreachable\";",
+        "print 1; var t = \"a\" - 1;",
+        "var s = \"a\"; var i = 0; while (i < 3) { print i; i = i + s * 2; }",
+        "var d = 0; var i = 0; while (i < 3) { print i; i = i + 1 / d; }",
+        "var i = 0; while (true) { i = i + 1; print i; if (i > 2) print nil + 1; } print \"after\";",
+        "var n = 0; while (n < 2) { n = n + 1; var dead = n / (n - 2); }",
+        "var x = 1; while (x < 3) { x = x + 1; } if (false) print y; else print x + nil;",
+    };
+    for (const char* source : sources) {
+        EXPECT_EQ(runOptimized(source, true), runOptimized(source, false)) << source;
+    }
+}
@@ -8,7 +8,7 @@
 std::string parseAndPrint(const std::string& source) {
     lox::ASTPrinter printer;
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
     lox::Parser parser(tokens);
     auto statements = parser.parse();
     if (!statements.empty()) {
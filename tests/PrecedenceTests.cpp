@@ -0,0 +1,47 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "TestSupport.hpp"
+#include "ast/ASTPrinter.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+static std::string printExpressions(const std::string& source) {
+    lox::ASTPrinter printer;
+    std::vector<std::unique_ptr<lox::Stmt>> statements;
+    {
+        CapturedOutput errors;   // os erros de sintaxe são descartados
+        statements = parseSource(source);
+    }
+    std::string result;
+    for (const auto& stmt : statements) {
+        result += stmt ? printer.print(*stmt) : "<error>";
+    }
+    return result;
+}
+
+TEST(PrecedenceTests, TestArithmeticBindsTighterThanComparison) {
+    EXPECT_EQ(printExpressions("print 1 + 2 * 3 < 4 == true;"),
+              "(print (== (< (+ 1 (* 2 3)) 4) true))");
+}
+
+TEST(PrecedenceTests, TestBinaryOperatorsAreLeftAssociative) {
+    EXPECT_EQ(printExpressions("print 8 - 4 - 2;"), "(print (- (- 8 4) 2))");
+    EXPECT_EQ(printExpressions("print 8 / 4 * 2;"), "(print (* (/ 8 4) 2))");
+}
+
+TEST(PrecedenceTests, TestUnaryAndGrouping) {
+    EXPECT_EQ(printExpressions("print -(1 + 2) * !x;"), "(print (* (- (group (+ 1 2))) (! x)))");
+    EXPECT_EQ(printExpressions("print --1;"), "(print (- (- 1)))");
+}
+
+TEST(PrecedenceTests, TestAssignmentIsRightAssociative) {
+    EXPECT_EQ(printExpressions("a = b = 1 + 2;"), "(; (assign a = (assign b = (+ 1 2))))");
+}
+
+TEST(PrecedenceTests, TestInvalidTargetsAndMissingOperands) {
+    EXPECT_EQ(printExpressions("a + b = 1;"), "<error>");
+    EXPECT_EQ(printExpressions("-a = 1;"), "<error>");
+    EXPECT_EQ(printExpressions("print 1 +;"), "<error>");
+}
@@ -0,0 +1,167 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "LineProfiler.hpp"
+#include "SamplingProfiler.hpp"
+#include "Isolate.hpp"
+#include <csignal>
+#include <dirent.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <thread>
+#include <unistd.h>
+
+static void runProfiled(const std::string& source, lox::LineProfiler& profiler) {
+    lox::Interpreter interpreter;
+    interpreter.setProfiler(&profiler);
+    runSource(interpreter, source);
+}
+
+TEST(ProfilerTests, TestCountsPerLine) {
+    std::string source =
+        "var i = 0;\n"
+        "while (i < 3)\n"
+        "  i = i + 1;\n"
+        "print i;\n";
+    lox::LineProfiler profiler;
+    runProfiled(source, profiler);
+
+    const auto& lines = profiler.lines();
+    EXPECT_EQ(lines.at(1).count, 1u);
+    EXPECT_EQ(lines.at(2).count, 1u);
+    EXPECT_EQ(lines.at(3).count, 3u);
+    EXPECT_EQ(lines.at(4).count, 1u);
+}
+
+TEST(ProfilerTests, TestInclusiveCoversChildren) {
+    std::string source =
+        "var i = 0;\n"
+        "while (i < 100) {\n"
+        "  i = i + 1;\n"
+        "}\n";
+    lox::LineProfiler profiler;
+    runProfiled(source, profiler);
+
+    const auto& lines = profiler.lines();
+    const auto& loop = lines.at(2);
+    const auto& body = lines.at(3);
+    EXPECT_GE(loop.inclusiveNs, loop.exclusiveNs);
+    EXPECT_GE(loop.inclusiveNs, body.inclusiveNs);
+    EXPECT_EQ(body.inclusiveNs, body.exclusiveNs);
+}
+
+TEST(ProfilerTests, TestReports) {
+    lox::LineProfiler profiler;
+    runProfiled("print 1;\nprint 2;\n", profiler);
+
+    std::stringstream text;
+    profiler.report(text, "print 1;\nprint 2;\n");
+    EXPECT_NE(text.str().find("print 2;"), std::string::npos);
+
+    std::stringstream json;
+    profiler.writeJson(json);
+    EXPECT_NE(json.str().find("{\"line\":1,\"count\":1,"), std::string::npos);
+    EXPECT_NE(json.str().find("{\"line\":2,\"count\":1,"), std::string::npos);
+}
+
+TEST(ProfilerTests, TestSamplingProfilerFoldedStacks) {
+    lox::SamplingProfiler sampler(1000);
+    ASSERT_TRUE(sampler.start());
+
+    lox::Interpreter interpreter;
+    interpreter.setSampler(&sampler);
+    // Sem especialização o laço é percorrido na AST, statement a statement.
+    interpreter.setSpecialization(false);
+    std::string source =
+        "var i = 0;\n"
+        "while (i < 300000) {\n"
+        "  i = i + 1;\n"
+        "}\n";
+    runSource(interpreter, source);
+
+    sampler.stop();
+    EXPECT_EQ(sampler.stack().depth(), 0);
+    ASSERT_GT(sampler.sampleCount(), 0u);
+
+    std::stringstream folded;
+    sampler.writeFolded(folded);
+    EXPECT_EQ(folded.str().rfind("lox;while@2", 0), 0u);
+}
+
+TEST(ProfilerTests, TestSamplerKeepsLoopsSpecialized) {
+    lox::SamplingProfiler sampler(1000);
+    ASSERT_TRUE(sampler.start());
+
+    lox::Interpreter interpreter;
+    interpreter.setSampler(&sampler);
+    std::string source =
+        "var i = 0;\n"
+        "while (i < 100000000) {\n"
+        "  i = i + 1;\n"
+        "}\n"
+        "print i;\n";
+    std::string output = runSource(interpreter, source);
+
+    sampler.stop();
+    EXPECT_EQ(output, "100000000\n");
+    EXPECT_EQ(interpreter.specializationStats().runs, 1u);
+    EXPECT_EQ(sampler.stack().depth(), 0);
+    ASSERT_GT(sampler.sampleCount(), 0u);
+
+    // O corpo não passa pela AST: as amostras ficam no frame do laço.
+    std::stringstream folded;
+    sampler.writeFolded(folded);
+    EXPECT_NE(folded.str().find("lox;while@2 "), std::string::npos);
+    EXPECT_EQ(folded.str().find("lox;while@2;"), std::string::npos);
+}
+
+TEST(ProfilerTests, TestSamplerStackUnwindsOnRuntimeError) {
+    lox::SamplingProfiler sampler;
+    lox::Interpreter interpreter;
+    interpreter.setSampler(&sampler);
+    runSource(interpreter, "{ { print 1 / 0; } }");
+
+    EXPECT_EQ(sampler.stack().depth(), 0);
+}
+
+// SigBlk de /proc/self/task/<tid>/status tem o bit (sinal - 1) ligado
+// para cada sinal bloqueado na thread.
+static bool blocksSignal(const std::string& tid, int signal) {
+    std::ifstream status("/proc/self/task/" + tid + "/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.rfind("SigBlk:", 0) == 0) {
+            unsigned long long mask = std::stoull(line.substr(7), nullptr, 16);
+            return (mask >> (signal - 1)) & 1;
+        }
+    }
+    return false;
+}
+
+TEST(ProfilerTests, TestIsolateThreadsBlockSamplerSignal) {
+    std::thread parent([] {
+        lox::Isolate::current().spawn("receive();");
+        std::string self = std::to_string(gettid());
+        EXPECT_FALSE(blocksSignal(self, SIGPROF));
+
+        // Além desta e da thread principal, só existe o isolate filho. A
+        // principal fica de fora: ela pode ainda estar dentro do
+        // pthread_create desta thread, com todos os sinais bloqueados.
+        std::string main = std::to_string(getpid());
+        int blocked = 0;
+        DIR* tasks = opendir("/proc/self/task");
+        ASSERT_NE(tasks, nullptr);
+        while (dirent* entry = readdir(tasks)) {
+            if (entry->d_name[0] == '.' || entry->d_name == self || entry->d_name == main) continue;
+            if (blocksSignal(entry->d_name, SIGPROF)) ++blocked;
+        }
+        closedir(tasks);
+        EXPECT_EQ(blocked, 1);
+    });
+    // Ao terminar, a thread fecha a caixa do filho e espera por ele.
+    parent.join();
+}
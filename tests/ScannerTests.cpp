@@ -6,14 +6,14 @@
 TEST(ScannerTests, TestVariableDeclaration) {
     std::string source = "var language = \"Lox\";";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     ASSERT_EQ(tokens.size(), 6);
     EXPECT_EQ(tokens[0].type, TokenType::VAR);
     EXPECT_EQ(tokens[1].type, TokenType::IDENTIFIER);
     EXPECT_EQ(tokens[2].type, TokenType::EQUAL);
     EXPECT_EQ(tokens[3].type, TokenType::STRING);
-    EXPECT_EQ(std::get<std::string>(tokens[3].literal), "Lox");
+    EXPECT_EQ(std::get<lox::String>(tokens.literal(3)), "Lox");
     EXPECT_EQ(tokens[4].type, TokenType::SEMICOLON);
     EXPECT_EQ(tokens[5].type, TokenType::END_OF_FILE);
 }
@@ -21,7 +21,7 @@ TEST(ScannerTests, TestVariableDeclaration) {
 TEST(ScannerTests, TestArithmeticOperators) {
     std::string source = "1 + 2 * (3 - 4) / 5";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     std::vector<TokenType> expected_types = {
         TokenType::NUMBER, TokenType::PLUS, TokenType::NUMBER, TokenType::STAR,
@@ -39,7 +39,7 @@ TEST(ScannerTests, TestArithmeticOperators) {
 TEST(ScannerTests, TestAllSingleCharTokens) {
     std::string source = "(){},.-+;*/! < = >";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     std::vector<TokenType> expected_types = {
         TokenType::LEFT_PAREN, TokenType::RIGHT_PAREN, TokenType::LEFT_BRACE,
@@ -58,7 +58,7 @@ TEST(ScannerTests, TestAllSingleCharTokens) {
 TEST(ScannerTests, TestTwoCharTokens) {
     std::string source = "!= == <= >=";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     std::vector<TokenType> expected_types = {
         TokenType::BANG_EQUAL, TokenType::EQUAL_EQUAL,
@@ -79,7 +79,7 @@ TEST(ScannerTests, TestCommentsAndLineNumbers) {
         "var b = 2;\n"
         "// another one";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
 
     ASSERT_EQ(tokens.size(), 11);
     EXPECT_EQ(tokens[0].line, 1);
@@ -92,7 +92,7 @@ TEST(ScannerTests, TestCommentsAndLineNumbers) {
 TEST(ScannerTests, TestKeywords) {
     std::string source = "and class else false for fun if nil or print return super this true var while";
     Scanner scanner(source);
-    std::vector<Token> tokens = scanner.scanTokens();
+    TokenStream tokens = scanner.scanTokens();
     
     std::vector<TokenType> expected_types = {
         TokenType::AND, TokenType::CLASS, TokenType::ELSE, TokenType::FALSE, TokenType::FOR,
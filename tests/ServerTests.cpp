@@ -0,0 +1,147 @@
+#include <gtest/gtest.h>
+#include "ScriptServer.hpp"
+#include <chrono>
+#include <csignal>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+// Sobe um ScriptServer em um processo filho durante o teste.
+class ServerTests : public ::testing::Test {
+protected:
+    void SetUp() override {
+        m_socketPath = "/tmp/lox-server-test-" + std::to_string(getpid()) + ".sock";
+        m_server = fork();
+        ASSERT_GE(m_server, 0);
+        if (m_server == 0) {
+            lox::ScriptServer server(m_socketPath, serveOptions());
+            server.listen();
+            server.serve();
+            _exit(0);
+        }
+        // Espera o servidor aceitar conexões (um script vazio serve de ping).
+        for (int attempt = 0; attempt < 400; ++attempt) {
+            std::ostringstream out, err;
+            try {
+                lox::runRemote(m_socketPath, "", out, err);
+                break;
+            } catch (const std::runtime_error&) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+            }
+        }
+    }
+
+    void TearDown() override {
+        if (m_server > 0) {
+            kill(m_server, SIGTERM);
+            waitpid(m_server, nullptr, 0);
+        }
+    }
+
+    virtual lox::ServeOptions serveOptions() const { return {}; }
+
+    int run(const std::string& source, std::string& out, std::string& err) {
+        std::ostringstream outStream, errStream;
+        int status = lox::runRemote(m_socketPath, source, outStream, errStream);
+        out = outStream.str();
+        err = errStream.str();
+        return status;
+    }
+
+    std::string m_socketPath;
+    pid_t m_server = -1;
+};
+
+TEST_F(ServerTests, TestRunsScriptAndStreamsOutput) {
+    std::string out, err;
+    EXPECT_EQ(run("var a = 2; print a * 21; print \"ok\";", out, err), 0);
+    EXPECT_EQ(out, "42\nok\n");
+    EXPECT_EQ(err, "");
+
+    // Segunda execução do mesmo programa (vinda do cache) em um interpretador novo.
+    EXPECT_EQ(run("var a = 2; print a * 21; print \"ok\";", out, err), 0);
+    EXPECT_EQ(out, "42\nok\n");
+}
+
+TEST_F(ServerTests, TestScriptsDoNotShareState) {
+    std::string out, err;
+    EXPECT_EQ(run("var shared = 1;", out, err), 0);
+    EXPECT_EQ(run("print shared;", out, err), 70);
+    EXPECT_NE(err.find("Undefined variable"), std::string::npos);
+}
+
+TEST_F(ServerTests, TestReportsErrorStatus) {
+    std::string out, err;
+    EXPECT_EQ(run("print 1;\nprint 1 + nil;\nprint 2;", out, err), 70);
+    EXPECT_EQ(out, "1\n");
+    EXPECT_NE(err.find("[line 2]"), std::string::npos);
+
+    EXPECT_EQ(run("print (1;", out, err), 65);
+    EXPECT_NE(err.find("Expect ')'"), std::string::npos);
+}
+
+// As opções de execução de main (-O2, --flat-ast, ...) valem nos filhos.
+class ServerOptionsTests : public ServerTests {
+protected:
+    lox::ServeOptions serveOptions() const override {
+        lox::ServeOptions options;
+        options.optimizationLevel = 2;
+        options.flatAst = true;
+        options.specialize = false;
+        options.limits.fuel = 1000;
+        return options;
+    }
+};
+
+TEST_F(ServerOptionsTests, TestChildrenUseServeOptions) {
+    std::string out, err;
+    EXPECT_EQ(run("var a = [1, 2]; if (false) print 0; else print a[1] * 21;\nprint a[5];", out, err), 70);
+    EXPECT_EQ(out, "42\n");
+    EXPECT_NE(err.find("[line 2]"), std::string::npos);
+
+    EXPECT_EQ(run("var i = 0; while (true) i = i + 1;", out, err), 70);
+    EXPECT_NE(err.find("fuel"), std::string::npos);
+}
+
+TEST(ServerClientTests, TestConnectFailureThrows) {
+    std::ostringstream out, err;
+    EXPECT_THROW(lox::runRemote("/tmp/lox-no-such-server.sock", "print 1;", out, err), std::runtime_error);
+}
+
+TEST_F(ServerTests, TestSilentClientDoesNotStallServer) {
+    // Um cliente conecta e não manda nada: o servidor desiste dele no prazo
+    // e atende o próximo.
+    int silent = socket(AF_UNIX, SOCK_STREAM, 0);
+    ASSERT_GE(silent, 0);
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, m_socketPath.c_str(), sizeof(address.sun_path) - 1);
+    ASSERT_EQ(connect(silent, reinterpret_cast<sockaddr*>(&address), sizeof(address)), 0);
+
+    auto start = std::chrono::steady_clock::now();
+    std::string out, err;
+    EXPECT_EQ(run("print 1;", out, err), 0);
+    EXPECT_EQ(out, "1\n");
+    EXPECT_LT(std::chrono::steady_clock::now() - start,
+              std::chrono::milliseconds(lox::ScriptServer::kRequestTimeoutMs) + std::chrono::seconds(2));
+    close(silent);
+}
+
+TEST_F(ServerTests, TestFinishedChildrenAreReaped) {
+    std::string out, err;
+    EXPECT_EQ(run("print 1;", out, err), 0);
+    // Sem outro pedido, o SIGCHLD basta para o filho ser recolhido.
+    std::string children = "?";
+    for (int attempt = 0; attempt < 200 && !children.empty(); ++attempt) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::ifstream file("/proc/" + std::to_string(m_server) + "/task/" + std::to_string(m_server) + "/children");
+        std::getline(file, children);
+    }
+    EXPECT_EQ(children, "");
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Apoio comum aos testes que executam programas Lox e conferem a saída.
+
+// Redireciona std::cout e std::cerr para um único buffer enquanto existe.
+// O destrutor devolve os buffers originais, mesmo se o teste lançar.
+class CapturedOutput {
+public:
+    CapturedOutput()
+        : m_oldCout(std::cout.rdbuf(m_buffer.rdbuf())), m_oldCerr(std::cerr.rdbuf(m_buffer.rdbuf())) {}
+    ~CapturedOutput() {
+        std::cout.rdbuf(m_oldCout);
+        std::cerr.rdbuf(m_oldCerr);
+    }
+
+    CapturedOutput(const CapturedOutput&) = delete;
+    CapturedOutput& operator=(const CapturedOutput&) = delete;
+
+    // stdout e stderr, na ordem em que foram escritos.
+    std::string str() const { return m_buffer.str(); }
+
+private:
+    std::stringstream m_buffer;   // declarado antes: é usado na inicialização
+    std::streambuf* m_oldCout;
+    std::streambuf* m_oldCerr;
+};
+
+// Scanner e Parser; os erros de sintaxe vão para std::cerr.
+inline std::vector<std::unique_ptr<lox::Stmt>> parseSource(const std::string& source) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    return parser.parse();
+}
+
+// Faz scan, parse e interpret de source e devolve stdout e stderr, incluindo
+// os erros de sintaxe e de execução.
+inline std::string runSource(lox::Interpreter& interpreter, const std::string& source) {
+    CapturedOutput output;
+    auto statements = parseSource(source);
+    interpreter.interpret(statements);
+    return output.str();
+}
+
+inline std::string runSource(const std::string& source) {
+    lox::Interpreter interpreter;
+    return runSource(interpreter, source);
+}
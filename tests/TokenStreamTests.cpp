@@ -0,0 +1,48 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "TokenStream.hpp"
+#include <string>
+
+TEST(TokenStreamTests, TestLexemesPointIntoSource) {
+    std::string source = "var total = 12.5 + count;";
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+
+    ASSERT_EQ(tokens.size(), 8);
+    EXPECT_EQ(tokens.lexeme(1), "total");
+    EXPECT_EQ(tokens.lexeme(3), "12.5");
+    EXPECT_EQ(std::get<double>(tokens.literal(3)), 12.5);
+    EXPECT_EQ(tokens.lexeme(5), "count");
+    EXPECT_TRUE(std::holds_alternative<std::monostate>(tokens.literal(5)));
+    EXPECT_EQ(tokens.lexeme(7), "");
+    EXPECT_EQ(tokens.offset(7), source.size());
+}
+
+TEST(TokenStreamTests, TestNumberLiteralsKeepTheirOrder) {
+    std::string source = "1 + 2 * 3.25 - 40";
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+
+    EXPECT_EQ(std::get<double>(tokens.literal(0)), 1.0);
+    EXPECT_EQ(std::get<double>(tokens.literal(2)), 2.0);
+    EXPECT_EQ(std::get<double>(tokens.literal(4)), 3.25);
+    EXPECT_EQ(std::get<double>(tokens.literal(6)), 40.0);
+}
+
+TEST(TokenStreamTests, TestLinesAfterMultilineString) {
+    std::string source =
+        "print \"a\nb\";\n"
+        "print x;";
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+
+    ASSERT_EQ(tokens.size(), 7);
+    EXPECT_EQ(tokens.line(1), 1);
+    EXPECT_EQ(std::get<lox::String>(tokens.literal(1)), "a\nb");
+    EXPECT_EQ(tokens.line(3), 3);
+
+    Token materialized = tokens[4];
+    EXPECT_EQ(materialized.type, TokenType::IDENTIFIER);
+    EXPECT_EQ(materialized.lexeme, "x");
+    EXPECT_EQ(materialized.line, 3);
+}
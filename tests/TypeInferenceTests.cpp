@@ -0,0 +1,144 @@
+#include <gtest/gtest.h>
+#include "Scanner.hpp"
+#include "Parser.hpp"
+#include "Interpreter.hpp"
+#include "TestSupport.hpp"
+#include "TypeInference.hpp"
+#include <initializer_list>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Executa cada programa em sequência no mesmo interpretador, como o REPL.
+static std::string runPrograms(lox::Interpreter& interpreter, std::initializer_list<const char*> sources) {
+    std::string output;
+    for (const char* source : sources) output += runSource(interpreter, source);
+    return output;
+}
+
+static std::string runSpecialized(const std::string& source, bool specialize) {
+    lox::Interpreter interpreter;
+    interpreter.setSpecialization(specialize);
+    return runPrograms(interpreter, {source.c_str()});
+}
+
+// Analisa o programa e retorna o último statement (o laço examinado).
+static const lox::Stmt& analyzeLoop(const std::string& source, std::vector<std::unique_ptr<lox::Stmt>>& statements,
+                                    lox::TypeInference& types) {
+    Scanner scanner(source);
+    TokenStream tokens = scanner.scanTokens();
+    lox::Parser parser(tokens);
+    statements = parser.parse();
+    EXPECT_FALSE(parser.hadError());
+    types.analyze(statements);
+    return *statements.back();
+}
+
+TEST(TypeInferenceTests, TestLoopHeadTypes) {
+    std::vector<std::unique_ptr<lox::Stmt>> statements;
+    lox::TypeInference types;
+    const lox::Stmt& loop = analyzeLoop(
+        "var a = 1; var s = \"x\"; var b = a; var c = 2;"
+        "while (a < 10) { a = a + 1; b = b + s; c = -c; }",
+        statements, types);
+
+    EXPECT_EQ(types.typeAtLoopHead(loop, "a"), lox::StaticType::Number);
+    EXPECT_EQ(types.typeAtLoopHead(loop, "s"), lox::StaticType::Unknown);
+    // b começa número, mas o corpo o transforma: o ponto fixo é Unknown.
+    EXPECT_EQ(types.typeAtLoopHead(loop, "b"), lox::StaticType::Unknown);
+    EXPECT_EQ(types.typeAtLoopHead(loop, "c"), lox::StaticType::Number);
+    // Nome não declarado no programa (global de uma execução anterior).
+    EXPECT_FALSE(types.typeAtLoopHead(loop, "outside").has_value());
+}
+
+TEST(TypeInferenceTests, TestFlowSensitivity) {
+    std::vector<std::unique_ptr<lox::Stmt>> statements;
+    lox::TypeInference types;
+
+    // Reatribuir antes do laço muda o tipo na cabeça.
+    const lox::Stmt& reassigned = analyzeLoop("var x = \"s\"; x = 1; while (x < 3) x = x + 1;", statements, types);
+    EXPECT_EQ(types.typeAtLoopHead(reassigned, "x"), lox::StaticType::Number);
+
+    // Os dois ramos de um if são unidos.
+    const lox::Stmt& branched =
+        analyzeLoop("var x = 1; if (x > 0) x = \"s\"; while (x < 3) x = x + 1;", statements, types);
+    EXPECT_EQ(types.typeAtLoopHead(branched, "x"), lox::StaticType::Unknown);
+
+    // O lado direito de and/or pode não executar.
+    const lox::Stmt& logical =
+        analyzeLoop("var x = 1; var y = 1; x > 0 or (y = \"s\"); while (x < 3) x = x + y;", statements, types);
+    EXPECT_EQ(types.typeAtLoopHead(logical, "y"), lox::StaticType::Unknown);
+}
+
+TEST(TypeInferenceTests, TestSpecializedLoopsMatchTheTree) {
+    const char* sources[] = {
+        "var i = 0; var acc = 0;"
+        "while (i < 100) { acc = acc + i * 2 - acc / 3; i = i + 1; }"
+        "print acc;",
+
+        "var total = 0;"
+        "for (var i = 0; i < 10; i = i + 1) {"
+        "  var sq = i * i;"
+        "  if (sq > 4 and !(sq == 9) or i == 1) total = total + sq; else { total = total - (i = i + 0); }"
+        "  for (var j = i; j > 0; j = j - 3) total = total + j;"
+        "}"
+        "print total;",
+
+        // O operando esquerdo usa o x antigo mesmo com uma atribuição à direita.
+        "var x = 1; var y = 0; var n = 0;"
+        "while (n < 4) { y = x + (x = x * 2); n = n + 1; }"
+        "print x; print y;",
+
+        // NaN: comparações ordenadas são falsas nos dois sentidos.
+        "var inf = 10; var k = 0; while (k < 10) { inf = inf * inf; k = k + 1; }"
+        "var nan = inf - inf; var hits = 0;"
+        "while (k > 0) { if (!(nan < 1)) hits = hits + 1; if (nan != nan) hits = hits + 10; k = k - 1; }"
+        "print hits;",
+    };
+    for (const char* source : sources) {
+        EXPECT_EQ(runSpecialized(source, true), runSpecialized(source, false)) << source;
+    }
+}
+
+TEST(TypeInferenceTests, TestOnlyNumericLoopsAreCompiled) {
+    lox::Interpreter interpreter;
+    runPrograms(interpreter, {"var i = 0; while (i < 3) { print i; i = i + 1; }"});
+    EXPECT_EQ(interpreter.specializationStats().compiledLoops, 0u);
+
+    runPrograms(interpreter, {"var s = \"a\"; var i = 0; while (i < 3) { s = s + \"b\"; i = i + 1; }"});
+    EXPECT_EQ(interpreter.specializationStats().compiledLoops, 0u);
+
+    // O laço externo imprime; o interno é numérico e é compilado sozinho.
+    EXPECT_EQ(runPrograms(interpreter, {"for (var i = 0; i < 2; i = i + 1) {"
+                                        "  var acc = 0;"
+                                        "  for (var j = 0; j < 4; j = j + 1) acc = acc + j;"
+                                        "  print acc;"
+                                        "}"}),
+              "6\n6\n");
+    EXPECT_EQ(interpreter.specializationStats().compiledLoops, 1u);
+    EXPECT_EQ(interpreter.specializationStats().runs, 2u);
+}
+
+TEST(TypeInferenceTests, TestGuardDeoptimizesWhenAGlobalChangesType) {
+    lox::Interpreter interpreter;
+    // n vem de uma execução anterior: o laço especula que é número.
+    EXPECT_EQ(runPrograms(interpreter, {"var n = 0;", "while (n < 3) n = n + 1; print n;"}), "3\n");
+    EXPECT_EQ(interpreter.specializationStats().runs, 1u);
+    EXPECT_EQ(interpreter.specializationStats().deopts, 0u);
+
+    // Outra execução troca o tipo; a guarda falha e a AST reporta o erro.
+    std::string output = runPrograms(interpreter, {"n = \"x\";", "while (n < 3) n = n + 1;"});
+    EXPECT_NE(output.find("Operands must be numbers."), std::string::npos);
+    EXPECT_EQ(interpreter.specializationStats().deopts, 1u);
+}
+
+TEST(TypeInferenceTests, TestDivisionByZeroWritesVariablesBack) {
+    lox::Interpreter interpreter;
+    std::string output =
+        runPrograms(interpreter, {"var a = 0; var d = 2; while (true) { d = d - 1; a = a + 1; a = a / d; }"});
+    EXPECT_EQ(output, "RuntimeError: Division by zero.\n[line 1]\n");
+    EXPECT_EQ(interpreter.specializationStats().compiledLoops, 1u);
+    EXPECT_EQ(runPrograms(interpreter, {"print a; print d;"}), "2\n0\n");
+}
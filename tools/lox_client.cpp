@@ -0,0 +1,34 @@
+#include "ScriptServer.hpp"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Cliente mínimo do modo --serve: envia um script (arquivo ou stdin) ao
+// servidor e sai com o mesmo status que o script teria em lox_cpp.
+int main(int argc, char* argv[]) {
+    if (argc < 2 || argc > 3) {
+        std::cerr << "Usage: lox_client <socket> [script]" << std::endl;
+        return 64;
+    }
+
+    std::stringstream buffer;
+    if (argc == 3) {
+        std::ifstream file(argv[2]);
+        if (!file) {
+            std::cerr << "Could not open file: " << argv[2] << std::endl;
+            return 74;
+        }
+        buffer << file.rdbuf();
+    } else {
+        buffer << std::cin.rdbuf();
+    }
+
+    try {
+        return lox::runRemote(argv[1], buffer.str(), std::cout, std::cerr);
+    } catch (const std::exception& error) {
+        std::cerr << error.what() << std::endl;
+        return 69;
+    }
+}